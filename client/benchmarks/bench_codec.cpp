@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include "audio/opus_codec.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace voip;
+
+namespace {
+
+constexpr uint32_t SAMPLE_RATE = 48000;
+constexpr size_t FRAME_SIZE = 960;  // 20ms
+
+// Voiced-speech stand-in: harmonics of a wobbling pitch plus a little noise
+std::vector<float> speech_like_frame() {
+    std::vector<float> pcm(FRAME_SIZE);
+    std::mt19937 rng(42);
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    for (size_t i = 0; i < FRAME_SIZE; ++i) {
+        const float t = static_cast<float>(i) / SAMPLE_RATE;
+        const float pitch = 140.0f + 20.0f * std::sin(2.0f * 3.14159265f * 3.0f * t);
+        float sample = 0.0f;
+        for (int harmonic = 1; harmonic <= 5; ++harmonic) {
+            sample += 0.3f / harmonic * std::sin(2.0f * 3.14159265f * pitch * harmonic * t);
+        }
+        pcm[i] = sample + noise(rng);
+    }
+    return pcm;
+}
+
+std::unique_ptr<audio::OpusEncoder> make_encoder(benchmark::State& state) {
+    OpusConfig config;
+    config.sample_rate = SAMPLE_RATE;
+    config.bitrate = static_cast<uint32_t>(state.range(0));
+    config.complexity = static_cast<int>(state.range(1));
+    auto encoder = audio::OpusEncoder::create(config);
+    if (!encoder.is_ok()) {
+        state.SkipWithError(encoder.error().message().c_str());
+        return nullptr;
+    }
+    return std::move(encoder.value());
+}
+
+void bitrate_complexity_args(benchmark::internal::Benchmark* bench) {
+    for (int64_t bitrate : {16000, 32000, 64000}) {
+        for (int64_t complexity : {0, 5, 10}) {
+            bench->Args({bitrate, complexity});
+        }
+    }
+    bench->ArgNames({"bitrate", "complexity"});
+}
+
+} // namespace
+
+static void BM_OpusEncode(benchmark::State& state) {
+    auto encoder = make_encoder(state);
+    if (!encoder) {
+        return;
+    }
+    const auto pcm = speech_like_frame();
+
+    size_t bytes = 0;
+    for (auto _ : state) {
+        auto packet = encoder->encode(pcm.data(), FRAME_SIZE);
+        benchmark::DoNotOptimize(packet);
+        if (packet.is_ok()) {
+            bytes += packet.value().data.size();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["bytes_per_frame"] = benchmark::Counter(
+        static_cast<double>(bytes) / static_cast<double>(std::max<int64_t>(1, state.iterations())));
+}
+BENCHMARK(BM_OpusEncode)->Apply(bitrate_complexity_args);
+
+static void BM_OpusDecode(benchmark::State& state) {
+    auto encoder = make_encoder(state);
+    if (!encoder) {
+        return;
+    }
+    auto decoder = audio::OpusDecoder::create(SAMPLE_RATE, 1);
+    if (!decoder.is_ok()) {
+        state.SkipWithError(decoder.error().message().c_str());
+        return;
+    }
+
+    const auto pcm = speech_like_frame();
+    auto packet = encoder->encode(pcm.data(), FRAME_SIZE);
+    if (!packet.is_ok()) {
+        state.SkipWithError(packet.error().message().c_str());
+        return;
+    }
+    const auto& data = packet.value().data;
+
+    std::vector<float> out(FRAME_SIZE);
+    for (auto _ : state) {
+        auto decoded = decoder.value()->decode(data.data(), data.size(), out.data(), FRAME_SIZE);
+        benchmark::DoNotOptimize(decoded);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OpusDecode)->Apply(bitrate_complexity_args);
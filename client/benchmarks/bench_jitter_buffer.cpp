@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include "audio/jitter_buffer.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace voip;
+using namespace voip::audio;
+
+namespace {
+
+constexpr uint32_t FRAME_SIZE = 960;
+constexpr uint32_t BUFFER_FRAMES = 5;
+constexpr size_t STREAM_PACKETS = 1024;
+
+// Sequence numbers in arrival order: each packet is swapped with a later
+// one with probability reorder_percent, and dropped with loss_percent
+std::vector<SequenceNumber> arrival_order(int reorder_percent, int loss_percent) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::vector<SequenceNumber> order;
+    for (SequenceNumber seq = 0; seq < STREAM_PACKETS; ++seq) {
+        if (percent(rng) >= loss_percent) {
+            order.push_back(seq);
+        }
+    }
+    for (size_t i = 0; i + 2 < order.size(); ++i) {
+        if (percent(rng) < reorder_percent) {
+            std::swap(order[i], order[i + 1 + static_cast<size_t>(percent(rng) % 2)]);
+        }
+    }
+    return order;
+}
+
+} // namespace
+
+// One packet in, one frame out - the steady-state voice path
+static void BM_JitterBufferPushPop(benchmark::State& state) {
+    const auto order = arrival_order(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    const std::vector<float> samples(FRAME_SIZE, 0.25f);
+
+    JitterBuffer buffer(BUFFER_FRAMES, FRAME_SIZE);
+    SequenceNumber base = 0;
+    size_t next = 0;
+    for (auto _ : state) {
+        if (next == order.size()) {
+            // Start a fresh stream well past the old one (the buffer resyncs)
+            state.PauseTiming();
+            buffer.reset();
+            base += STREAM_PACKETS * 4;
+            next = 0;
+            state.ResumeTiming();
+        }
+
+        AudioPacket packet;
+        packet.sequence = base + order[next++];
+        packet.timestamp = Timestamp(packet.sequence * 20000);
+        packet.samples = samples;
+        packet.frame_size = FRAME_SIZE;
+        benchmark::DoNotOptimize(buffer.push(std::move(packet)));
+
+        auto frame = buffer.pop();
+        benchmark::DoNotOptimize(frame);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_JitterBufferPushPop)
+    ->Args({0, 0})
+    ->Args({10, 0})
+    ->Args({0, 5})
+    ->Args({10, 5})
+    ->Args({30, 20})
+    ->ArgNames({"reorder_pct", "loss_pct"});
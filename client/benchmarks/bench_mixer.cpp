@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+#include "audio/audio_mixer.h"
+#include <cmath>
+#include <vector>
+
+using namespace voip;
+using namespace voip::audio;
+
+namespace {
+
+constexpr size_t FRAME_SIZE = 960;
+
+} // namespace
+
+static void BM_AudioMixerMix(benchmark::State& state) {
+    const auto stream_count = static_cast<size_t>(state.range(0));
+
+    std::vector<std::vector<float>> pcm(stream_count, std::vector<float>(FRAME_SIZE));
+    std::vector<AudioMixer::ChannelStream> inputs(stream_count);
+    for (size_t s = 0; s < stream_count; ++s) {
+        for (size_t i = 0; i < FRAME_SIZE; ++i) {
+            pcm[s][i] = 0.2f * std::sin(0.01f * static_cast<float>((s + 1) * i));
+        }
+        inputs[s].id = static_cast<ChannelId>(s + 1);
+        inputs[s].samples = pcm[s].data();
+        inputs[s].sample_count = FRAME_SIZE;
+        inputs[s].priority = static_cast<int>(s % 3);
+    }
+
+    AudioMixer mixer;
+    std::vector<float> output(FRAME_SIZE);
+    for (auto _ : state) {
+        mixer.mix(inputs, output.data(), FRAME_SIZE);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(stream_count));
+}
+BENCHMARK(BM_AudioMixerMix)->RangeMultiplier(2)->Range(1, 64)->ArgName("streams");
@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+#include "network/udp_socket.h"
+#include <vector>
+
+using namespace voip;
+using namespace voip::network;
+
+namespace {
+
+VoicePacket make_packet(size_t payload_size) {
+    VoicePacket packet;
+    packet.header.magic = VOICE_PACKET_MAGIC;
+    packet.header.sequence = 123456;
+    packet.header.timestamp = 987654321;
+    packet.header.channel_id = 7;
+    packet.header.user_id = 42;
+    packet.encrypted_payload.assign(payload_size, 0xAB);
+    return packet;
+}
+
+} // namespace
+
+static void BM_VoicePacketSerialize(benchmark::State& state) {
+    const auto packet = make_packet(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto bytes = packet.serialize();
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VoicePacketSerialize)->Arg(40)->Arg(80)->Arg(160)->ArgName("payload");
+
+static void BM_VoicePacketDeserialize(benchmark::State& state) {
+    const auto bytes = make_packet(static_cast<size_t>(state.range(0))).serialize();
+    for (auto _ : state) {
+        auto packet = VoicePacket::deserialize(bytes.data(), bytes.size());
+        benchmark::DoNotOptimize(packet);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VoicePacketDeserialize)->Arg(40)->Arg(80)->Arg(160)->ArgName("payload");
@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+#include "common/lock_free_queue.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace voip;
+
+namespace {
+
+constexpr size_t FRAME_SIZE = 960;
+
+} // namespace
+
+// Push and pop on one thread: the cost of the queue operations themselves
+static void BM_LockFreeQueueSingleThread(benchmark::State& state) {
+    LockFreeQueue<uint64_t> queue(1024);
+    uint64_t value = 0;
+    for (auto _ : state) {
+        queue.try_push(value);
+        queue.try_pop(value);
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LockFreeQueueSingleThread);
+
+// Producer and consumer on separate threads, as between audio and worker
+static void BM_LockFreeQueueProducerConsumer(benchmark::State& state) {
+    constexpr uint64_t ITEMS = 1 << 16;
+    for (auto _ : state) {
+        LockFreeQueue<uint64_t> queue(static_cast<size_t>(state.range(0)));
+        std::thread producer([&queue] {
+            for (uint64_t i = 0; i < ITEMS;) {
+                if (queue.try_push(i)) {
+                    ++i;
+                } else {
+                    std::this_thread::yield();  // Don't starve the consumer on small machines
+                }
+            }
+        });
+        uint64_t value = 0;
+        for (uint64_t received = 0; received < ITEMS;) {
+            if (queue.try_pop(value)) {
+                ++received;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ITEMS));
+}
+BENCHMARK(BM_LockFreeQueueProducerConsumer)->Arg(64)->Arg(1024)->ArgName("capacity")->UseRealTime();
+
+static void BM_AudioBufferQueueSingleThread(benchmark::State& state) {
+    AudioBufferQueue queue(8, FRAME_SIZE);
+    std::vector<float> in(FRAME_SIZE, 0.5f);
+    std::vector<float> out(FRAME_SIZE);
+    uint64_t time_us = 0;
+    for (auto _ : state) {
+        queue.try_push(in.data(), FRAME_SIZE, time_us);
+        queue.try_pop(out.data(), FRAME_SIZE, &time_us);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(FRAME_SIZE * sizeof(float)));
+}
+BENCHMARK(BM_AudioBufferQueueSingleThread);
+
+static void BM_AudioBufferQueueProducerConsumer(benchmark::State& state) {
+    constexpr int FRAMES = 4096;
+    std::vector<float> in(FRAME_SIZE, 0.5f);
+    std::vector<float> out(FRAME_SIZE);
+    for (auto _ : state) {
+        AudioBufferQueue queue(8, FRAME_SIZE);
+        std::thread producer([&queue, &in] {
+            for (int i = 0; i < FRAMES;) {
+                if (queue.try_push(in.data(), FRAME_SIZE)) {
+                    ++i;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        for (int received = 0; received < FRAMES;) {
+            if (queue.try_pop(out.data(), FRAME_SIZE)) {
+                ++received;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * FRAMES);
+    state.SetBytesProcessed(state.iterations() * FRAMES * static_cast<int64_t>(FRAME_SIZE * sizeof(float)));
+}
+BENCHMARK(BM_AudioBufferQueueProducerConsumer)->UseRealTime();
@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+"""Compare two Google Benchmark JSON runs and flag regressions.
+
+Record runs with:
+    voip-benchmarks --benchmark_repetitions=5 --benchmark_out=run.json --benchmark_out_format=json
+
+Then:
+    compare_benchmarks.py baseline.json run.json [--threshold 0.10] [--metric cpu_time]
+
+With repetitions the median aggregate is compared, otherwise the single
+result. Exits 1 if any benchmark is slower than the baseline by more than
+the threshold, so it can gate CI.
+"""
+
+import argparse
+import json
+import sys
+
+TIME_UNITS_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load_results(path, metric):
+    """Benchmark name -> time in nanoseconds."""
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+
+    plain = {}
+    medians = {}
+    for bench in data.get("benchmarks", []):
+        if bench.get("error_occurred"):
+            continue
+        value = bench[metric] * TIME_UNITS_NS[bench.get("time_unit", "ns")]
+        if bench.get("run_type") == "aggregate":
+            if bench.get("aggregate_name") == "median":
+                medians[bench["run_name"]] = value
+        else:
+            plain.setdefault(bench.get("run_name", bench["name"]), value)
+
+    plain.update(medians)
+    return plain
+
+
+def format_ns(value):
+    for unit in ("s", "ms", "us"):
+        if value >= TIME_UNITS_NS[unit]:
+            return f"{value / TIME_UNITS_NS[unit]:.2f}{unit}"
+    return f"{value:.1f}ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="relative slowdown that counts as a regression (default 0.10)")
+    parser.add_argument("--metric", choices=("cpu_time", "real_time"), default="cpu_time")
+    args = parser.parse_args()
+
+    baseline = load_results(args.baseline, args.metric)
+    current = load_results(args.current, args.metric)
+
+    regressions = []
+    width = max((len(name) for name in [*current, *baseline]), default=20)
+    print(f"{'benchmark':<{width}}  {'baseline':>10}  {'current':>10}  {'change':>8}")
+    for name, value in current.items():
+        if name not in baseline:
+            print(f"{name:<{width}}  {'-':>10}  {format_ns(value):>10}  {'new':>8}")
+            continue
+        change = value / baseline[name] - 1.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions.append(name)
+        elif change < -args.threshold:
+            flag = "  improved"
+        print(f"{name:<{width}}  {format_ns(baseline[name]):>10}  {format_ns(value):>10}  {change:>+7.1%}{flag}")
+
+    for name in baseline:
+        if name not in current:
+            print(f"{name:<{width}}  {format_ns(baseline[name]):>10}  {'-':>10}  {'missing':>8}")
+
+    if regressions:
+        print(f"\n{len(regressions)} regression(s) over {args.threshold:.0%}:", ", ".join(regressions))
+        return 1
+    print(f"\nNo regressions over {args.threshold:.0%}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
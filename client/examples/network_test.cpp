@@ -1,13 +1,14 @@
 /**
  * Simple network test - Connect to server and send test packet
  * 
- * Usage: network_test.exe [server_ip] [port]
+ * Usage: network_test.exe [server_ip_or_hostname] [port]
  * Example: network_test.exe 127.0.0.1 9001
  */
 
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <future>
 #include "network/udp_socket.h"
 
 using namespace voip;
@@ -44,13 +45,23 @@ int main(int argc, char* argv[]) {
         std::cout << "  Payload size: " << packet.encrypted_payload.size() << " bytes\n\n";
     });
     
-    // Connect to server
+    // Connect to server (hostnames resolve and pick a path in the background)
+    std::promise<std::string> connected;
+    socket.set_connect_callback([&connected](const Result<void>& outcome) {
+        connected.set_value(outcome.is_ok() ? std::string() : outcome.error().to_string());
+    });
+    
     std::cout << "Connecting to server...\n";
     auto result = socket.connect(server, port);
     if (!result.is_ok()) {
         std::cerr << "Failed to connect: " << result.error().to_string() << "\n";
         return 1;
     }
+    const std::string connect_error = connected.get_future().get();
+    if (!connect_error.empty()) {
+        std::cerr << "Failed to connect: " << connect_error << "\n";
+        return 1;
+    }
     
     std::cout << "Connected!\n\n";
     
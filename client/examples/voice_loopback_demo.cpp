@@ -4,16 +4,34 @@
  * Full end-to-end voice transmission test:
  * Microphone → Encode → Network → Decode → Speakers
  * 
- * Usage: voice_loopback_demo.exe [server_ip] [port]
- * Example: voice_loopback_demo.exe 127.0.0.1 9001
+ * Usage: voice_loopback_demo.exe [--latency-probe] [--metrics file] [--trace dir] [server_ip] [port] [frame_ms] [input.wav] [output.wav]
+ * Example: voice_loopback_demo.exe 127.0.0.1 9001 10
+ *
+ * frame_ms: Opus frame duration (2.5, 5, 10, 20, 40 or 60; default 20)
+ * input/output: use a virtual file device instead of the sound card
+ * (headless runs); the demo stops once the input file has been sent
+ * --latency-probe: send a marker tone once a second instead of the
+ * microphone and time its return (needs an echoing server)
+ * --metrics: write all pipeline metrics on exit (JSON if the file name
+ * ends in .json, Prometheus text otherwise)
+ * --trace: record audio callback stages and write dir/xrun-<n>.json
+ * (Chrome trace-event format) around every xrun or deadline miss
  */
 
 #include "session/voice_session.h"
+#include "audio/virtual_audio_backend.h"
+#include "common/metrics.h"
+#include "common/trace.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <csignal>
 #include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
 
 using namespace voip;
 using namespace voip::session;
@@ -40,6 +58,9 @@ void print_stats(const VoiceSession::Stats& stats) {
     std::cout << "Play:" << stats.frames_played << " ";
     std::cout << "Lat:" << static_cast<int>(stats.estimated_latency_ms) << "ms ";
     std::cout << "Jit:" << stats.jitter_ms << "ms ";
+    if (stats.probe.samples > 0) {
+        std::cout << "Probe:" << static_cast<int>(stats.probe.p50_ms) << "ms ";
+    }
     
     if (stats.plc_frames > 0) {
         std::cout << "PLC:" << stats.plc_frames << " ";
@@ -54,6 +75,16 @@ void print_stats(const VoiceSession::Stats& stats) {
     std::cout << std::flush;
 }
 
+void print_latency(const char* label, const VoiceSession::LatencyPercentiles& latency) {
+    std::cout << label;
+    if (latency.samples == 0) {
+        std::cout << "n/a\n";
+        return;
+    }
+    std::cout << "p50 " << latency.p50_ms << " / p95 " << latency.p95_ms
+              << " / p99 " << latency.p99_ms << " ms (" << latency.samples << " samples)\n";
+}
+
 int main(int argc, char* argv[]) {
     std::cout << "═══════════════════════════════════════════════\n";
     std::cout << "  🎤 VoIP Voice Loopback Demo 🔊\n";
@@ -62,20 +93,58 @@ int main(int argc, char* argv[]) {
     // Parse arguments
     std::string server = "127.0.0.1";
     uint16_t port = 9001;
+    double frame_ms = 20.0;
+    bool latency_probe = false;
+    std::string metrics_file;
+    std::string trace_dir;
     
-    if (argc >= 2) {
-        server = argv[1];
+    std::vector<const char*> args;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--latency-probe") == 0) {
+            latency_probe = true;
+        } else if (std::strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+            metrics_file = argv[++i];
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_dir = argv[++i];
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    
+    if (args.size() >= 1) {
+        server = args[0];
+    }
+    if (args.size() >= 2) {
+        port = static_cast<uint16_t>(std::atoi(args[1]));
     }
-    if (argc >= 3) {
-        port = static_cast<uint16_t>(std::atoi(argv[2]));
+    if (args.size() >= 3) {
+        frame_ms = std::atof(args[2]);
+    }
+    std::string input_file;
+    std::string output_file;
+    if (args.size() >= 4) {
+        input_file = args[3];
+    }
+    if (args.size() >= 5) {
+        output_file = args[4];
     }
     
+    const uint32_t frame_size = frame_size_for_duration_us(48000, static_cast<uint32_t>(frame_ms * 1000.0));
+    
     std::cout << "Configuration:\n";
     std::cout << "  Server: " << server << ":" << port << "\n";
     std::cout << "  Sample Rate: 48000 Hz\n";
-    std::cout << "  Frame Size: 960 samples (20ms)\n";
+    std::cout << "  Frame Size: " << frame_size << " samples (" << frame_ms << "ms)\n";
     std::cout << "  Bitrate: 32 kbps\n";
-    std::cout << "  Codec: Opus (FEC enabled)\n\n";
+    std::cout << "  Codec: Opus (FEC enabled)\n";
+    if (!input_file.empty()) {
+        std::cout << "  Audio: virtual device (" << input_file << " -> "
+                  << (output_file.empty() ? "discard" : output_file) << ")\n";
+    }
+    if (latency_probe) {
+        std::cout << "  Latency probe: marker tone every 1s\n";
+    }
+    std::cout << "\n";
     
     // Install signal handler for clean shutdown
     std::signal(SIGINT, signal_handler);
@@ -89,17 +158,41 @@ int main(int argc, char* argv[]) {
     config.server_port = port;
     config.sample_rate = 48000;
     config.channels = 1;
-    config.frame_size = 960;  // 20ms
+    config.frame_size = frame_size;
     config.bitrate = 32000;
     config.enable_fec = true;
     config.enable_dtx = false;
     config.channel_id = 1;
     config.user_id = 42;
-    config.jitter_buffer_frames = 5;  // 100ms buffer
+    config.jitter_buffer_frames = 5;  // 5 frames (100ms at 20ms/frame)
+    config.latency_probe = latency_probe;
     
+    // Headless: file-backed audio device
+    std::unique_ptr<audio::AudioBackend> audio_backend;
+    audio::VirtualAudioBackend* virtual_device = nullptr;
+    if (!input_file.empty()) {
+        audio::VirtualAudioBackend::Config device_config;
+        device_config.input_path = input_file;
+        device_config.output_path = output_file;
+        auto device_result = audio::VirtualAudioBackend::create(device_config);
+        if (!device_result.is_ok()) {
+            std::cerr << "\n❌ " << device_result.error().to_string() << "\n\n";
+            return 1;
+        }
+        virtual_device = device_result.value().get();
+        audio_backend = std::move(device_result.value());
+    }
+    
+    if (!trace_dir.empty()) {
+        Tracer::Config trace_config;
+        trace_config.output_dir = trace_dir;
+        Tracer::enable(trace_config);
+        std::cout << "🔬 Tracing audio callbacks; xrun traces go to " << trace_dir << "\n";
+    }
+
     // Initialize
     std::cout << "Initializing session...\n";
-    auto init_result = session.initialize(config);
+    auto init_result = session.initialize(config, std::move(audio_backend));
     if (!init_result.is_ok()) {
         std::cerr << "\n❌ Failed to initialize session:\n";
         std::cerr << "   " << init_result.error().to_string() << "\n\n";
@@ -121,6 +214,15 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    // Talk and listen on the loopback channel
+    auto join_result = session.join_channel(config.channel_id);
+    if (!join_result.is_ok()) {
+        std::cerr << "\n❌ Failed to join channel:\n";
+        std::cerr << "   " << join_result.error().to_string() << "\n\n";
+        return 1;
+    }
+    session.set_hot_mic_channel(config.channel_id);
+    
     std::cout << "\n╔═══════════════════════════════════════════════╗\n";
     std::cout << "║  🎤 VOICE SESSION ACTIVE 🔊                   ║\n";
     std::cout << "╚═══════════════════════════════════════════════╝\n\n";
@@ -134,6 +236,11 @@ int main(int argc, char* argv[]) {
     auto last_print = std::chrono::steady_clock::now();
     
     while (g_running && session.is_active()) {
+        if (virtual_device && virtual_device->input_finished()) {
+            std::this_thread::sleep_for(500ms);  // Let the tail play out
+            break;
+        }
+        
         std::this_thread::sleep_for(100ms);
         
         // Print stats every second
@@ -171,6 +278,21 @@ int main(int argc, char* argv[]) {
     std::cout << "  Buffer underruns:   " << final_stats.jitter_buffer_underruns << "\n";
     std::cout << "  Jitter:             " << final_stats.jitter_ms << " ms\n";
     std::cout << "  Est. latency:       " << final_stats.estimated_latency_ms << " ms\n";
+    print_latency("  Mouth-to-ear:       ", final_stats.mouth_to_ear);
+    print_latency("  Playout delay:      ", final_stats.playout_delay);
+    if (latency_probe) {
+        print_latency("  Probe latency:      ", final_stats.probe);
+        std::cout << "  Probe markers:      " << final_stats.probe_markers_detected << " / "
+                  << final_stats.probe_markers_sent << " returned\n";
+    }
+    
+    std::cout << "\nVoice worker:\n";
+    std::cout << "  Real-time priority: " << (final_stats.worker_realtime ? "yes" : "no") << "\n";
+    std::cout << "  Wake-up lateness:   p50 " << final_stats.worker_lateness_p50_us << " us, p99 "
+              << final_stats.worker_lateness_p99_us << " us, max " << final_stats.worker_lateness_max_us << " us\n";
+    std::cout << "  Missed ticks:       " << final_stats.worker_missed_ticks << "\n";
+    std::cout << "  Queue drops:        " << final_stats.worker_queue_drops << "\n";
+    std::cout << "  Playback underruns: " << final_stats.playback_underruns << "\n";
     
     // Calculate packet loss
     if (final_stats.packets_sent > 0) {
@@ -204,5 +326,22 @@ int main(int argc, char* argv[]) {
     // Shutdown
     session.shutdown();
     
+    if (!trace_dir.empty()) {
+        Tracer::disable();
+        std::cout << "🔬 Xrun traces written: " << Tracer::dumps_written() << "\n";
+        if (Tracer::dump_failures() > 0) {
+            std::cout << "⚠️ Xrun traces that could not be written: " << Tracer::dump_failures() << "\n";
+        }
+    }
+    
+    if (!metrics_file.empty()) {
+        const auto snapshot = MetricsRegistry::global().snapshot();
+        const bool json = metrics_file.size() >= 5 &&
+                          metrics_file.compare(metrics_file.size() - 5, 5, ".json") == 0;
+        std::ofstream out(metrics_file);
+        out << (json ? snapshot.to_json() + "\n" : snapshot.to_prometheus());
+        std::cout << (out ? "📈 Metrics written to " : "❌ Failed to write metrics to ") << metrics_file << "\n";
+    }
+    
     return 0;
 }
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "common/types.h"
+#include "common/result.h"
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace voip::audio {
+
+/**
+ * Device-side callbacks (device rate, device buffer size)
+ * time_us is steady_time_us() at which the buffer's first sample entered
+ * the ADC (capture) or will leave the DAC (playback), as reported by the
+ * device; overflow/underflow report that the device dropped or starved samples
+ */
+using DeviceCaptureCallback = std::function<void(const float* pcm, size_t frame_count, uint64_t time_us, bool overflow)>;
+using DevicePlaybackCallback = std::function<void(float* pcm, size_t frame_count, uint64_t time_us, bool underflow)>;
+
+/**
+ * Parameters for opening a mono float32 device stream
+ */
+struct DeviceStreamConfig {
+    DeviceId device = NO_DEVICE;   // NO_DEVICE = backend default
+    uint32_t sample_rate = 48000;  // As returned by select_sample_rate()
+    uint32_t buffer_frames = 0;    // 0 = backend chooses
+};
+
+/**
+ * AudioBackend - Source and sink of device audio for AudioEngine
+ *
+ * Implementations own at most one capture and one playback stream. The
+ * engine does the resampling and re-blocking, so a backend only has to
+ * deliver mono float samples at the rate it negotiated.
+ *
+ * Thread Safety: Control methods are called from one thread. Device
+ * callbacks run on a backend-owned thread and must follow RT safety rules.
+ */
+class AudioBackend {
+public:
+    virtual ~AudioBackend() = default;
+
+    /**
+     * Acquire/release the underlying audio system
+     */
+    virtual Result<void> initialize() = 0;
+    virtual void terminate() = 0;
+
+    /**
+     * Backend name for logs and diagnostics
+     */
+    [[nodiscard]] virtual const char* name() const noexcept = 0;
+
+    /**
+     * Whether the callbacks keep pace with the wall clock. Virtual devices
+     * running scaled, unthrottled or by hand do not, and then pace the
+     * voice worker themselves.
+     */
+    [[nodiscard]] virtual bool wall_clock() const noexcept { return true; }
+
+    /**
+     * Enumerate devices
+     */
+    virtual std::vector<AudioDevice> enumerate_input_devices() = 0;
+    virtual std::vector<AudioDevice> enumerate_output_devices() = 0;
+    virtual DeviceId default_input_device() = 0;
+    virtual DeviceId default_output_device() = 0;
+
+    /**
+     * Rate a stream on this device will run at: the preferred rate if the
+     * device supports it, else the device's native rate
+     */
+    virtual uint32_t select_sample_rate(DeviceId device, bool is_input, uint32_t preferred) = 0;
+
+    /**
+     * Open and start a stream; callbacks start arriving immediately
+     */
+    virtual Result<void> open_capture(const DeviceStreamConfig& config, DeviceCaptureCallback callback) = 0;
+    virtual Result<void> open_playback(const DeviceStreamConfig& config, DevicePlaybackCallback callback) = 0;
+
+    /**
+     * Stop and close a stream
+     * No callback is running or will run once these return
+     */
+    virtual void close_capture() = 0;
+    virtual void close_playback() = 0;
+};
+
+} // namespace voip::audio
@@ -3,7 +3,9 @@
 #include "common/types.h"
 #include "common/result.h"
 #include "common/lock_free_queue.h"
-#include <portaudio.h>
+#include "common/metrics.h"
+#include "audio/resampler.h"
+#include "audio/audio_backend.h"
 #include <vector>
 #include <functional>
 #include <atomic>
@@ -12,18 +14,31 @@
 namespace voip::audio {
 
 // Callback types
-using CaptureCallback = std::function<void(const float* pcm, size_t frame_count)>;
-using PlaybackCallback = std::function<void(float* pcm, size_t frame_count)>;
+// capture_time_us: steady_time_us() at which the frame's first sample hit the ADC
+// playout_time_us: steady_time_us() at which the frame's first sample will reach the DAC
+using CaptureCallback = std::function<void(const float* pcm, size_t frame_count, uint64_t capture_time_us)>;
+using PlaybackCallback = std::function<void(float* pcm, size_t frame_count, uint64_t playout_time_us)>;
 
 /**
- * AudioEngine - Manages audio capture and playback via PortAudio
+ * AudioEngine - Manages audio capture and playback
+ * 
+ * Device I/O goes through an AudioBackend: PortAudio by default, or a
+ * VirtualAudioBackend for headless runs (CI, load tests). Devices run at their native rate and callback size. A FIFO layer between
+ * the device and the user callbacks resamples to the codec rate and
+ * re-blocks the stream, so callbacks always see exactly
+ * AudioConfig::frame_size samples at AudioConfig::sample_rate.
+ * 
+ * Device ADC/DAC timestamps are carried through the FIFOs and resamplers,
+ * so each codec frame is stamped with when it was actually captured or
+ * will actually be heard.
  * 
  * Thread Safety: Public methods are thread-safe.
  * Audio callbacks run on real-time threads - must follow RT safety rules!
  */
 class AudioEngine {
 public:
-    AudioEngine();
+    AudioEngine();  // PortAudio backend
+    explicit AudioEngine(std::unique_ptr<AudioBackend> backend);
     ~AudioEngine();
     
     // Disable copy
@@ -98,62 +113,89 @@ public:
     void set_input_volume(float volume) noexcept;
     void set_output_volume(float volume) noexcept;
     
+    /**
+     * Device backend in use
+     */
+    [[nodiscard]] AudioBackend* backend() noexcept { return backend_.get(); }
+    
 private:
-    // PortAudio callback functions (static, call member functions)
-    static int capture_callback_static(
-        const void* input,
-        void* output,
-        unsigned long frame_count,
-        const PaStreamCallbackTimeInfo* time_info,
-        PaStreamCallbackFlags status_flags,
-        void* user_data
-    );
-    
-    static int playback_callback_static(
-        const void* input,
-        void* output,
-        unsigned long frame_count,
-        const PaStreamCallbackTimeInfo* time_info,
-        PaStreamCallbackFlags status_flags,
-        void* user_data
-    );
-    
-    // Member callback handlers
-    int handle_capture(
-        const float* input,
-        unsigned long frame_count,
-        PaStreamCallbackFlags status_flags
-    );
-    
-    int handle_playback(
-        float* output,
-        unsigned long frame_count,
-        PaStreamCallbackFlags status_flags
-    );
+    // Device callback handlers
+    void handle_capture(const float* input, size_t frame_count, uint64_t adc_time_us, bool overflow);
+    void handle_playback(float* output, size_t frame_count, uint64_t dac_time_us, bool underflow);
     
     // Helper methods
     float calculate_rms(const float* pcm, size_t count) const noexcept;
     
+    // Append resampled capture samples, pushing completed codec frames
+    // end_time_us: capture time just past the last sample in pcm
+    void append_capture_samples(const float* pcm, size_t count, float volume, uint64_t end_time_us) noexcept;
+    
+    // Pull one codec frame from the playback callback and resample it
+    // into the device-rate playback FIFO
+    void render_playback_frame(uint64_t playout_time_us) noexcept;
+
+    // Record callback duration; flag it as an xrun if it outlasted the buffer period
+    void finish_callback(Histogram& duration_metric, uint64_t start_us, size_t frame_count,
+                         uint32_t device_rate, const char* deadline_reason) noexcept;
+
+    // Samples at rate as microseconds
+    static uint64_t samples_to_us(size_t samples, uint32_t rate) noexcept {
+        return rate == 0 ? 0 : static_cast<uint64_t>(samples) * 1000000 / rate;
+    }
+    
+    // Largest block fed to a resampler at once (device callbacks are chunked)
+    static constexpr size_t MAX_RESAMPLER_BLOCK = 1024;    
     // Configuration
     AudioConfig config_;
     
-    // PortAudio streams
-    PaStream* capture_stream_ = nullptr;
-    PaStream* playback_stream_ = nullptr;
+    // Device I/O
+    std::unique_ptr<AudioBackend> backend_;
     
     // Selected devices
-    DeviceId input_device_id_ = paNoDevice;
-    DeviceId output_device_id_ = paNoDevice;
+    DeviceId input_device_id_ = NO_DEVICE;
+    DeviceId output_device_id_ = NO_DEVICE;
     
     // Callbacks
     CaptureCallback capture_callback_;
     PlaybackCallback playback_callback_;
     
+    // Capture FIFO: device rate/size -> codec rate/frame_size
+    std::unique_ptr<Resampler> capture_resampler_;
+    std::unique_ptr<AudioBufferQueue> capture_queue_;
+    std::vector<float> capture_resampled_;   // Resampler output scratch
+    std::vector<float> capture_frame_;       // Codec frame being assembled
+    size_t capture_frame_fill_ = 0;
+    std::vector<float> capture_deliver_;     // Frame handed to capture callback
+    std::vector<uint64_t> capture_times_;    // Capture time of each queued frame
+    size_t capture_times_count_ = 0;
+    
+    // Playback FIFO: codec frames -> device rate/size
+    std::unique_ptr<Resampler> playback_resampler_;
+    std::vector<float> playback_frame_;      // Codec frame from playback callback
+    std::vector<float> playback_fifo_;       // Device-rate samples awaiting output
+    size_t playback_fifo_read_ = 0;
+    size_t playback_fifo_fill_ = 0;
+    
+    // Negotiated device rates
+    std::atomic<uint32_t> capture_device_rate_{0};
+    std::atomic<uint32_t> playback_device_rate_{0};
+    
     // Statistics (atomic for thread safety)
     mutable std::atomic<uint64_t> input_overflows_{0};
     mutable std::atomic<uint64_t> output_underflows_{0};
+    mutable std::atomic<uint64_t> queue_full_errors_{0};
+    mutable std::atomic<uint64_t> queue_empty_errors_{0};
     mutable std::atomic<float> current_input_level_{0.0f};
     mutable std::atomic<float> current_output_level_{0.0f};
+    std::atomic<uint32_t> input_latency_us_{0};
+    std::atomic<uint32_t> output_latency_us_{0};
+    
+    // Process-wide metrics (shared by every engine)
+    Histogram& capture_callback_metric_;
+    Histogram& playback_callback_metric_;
+    Counter& input_overflow_metric_;
+    Counter& output_underflow_metric_;
+    Counter& deadline_miss_metric_;
     
     // Volume controls (atomic)
     std::atomic<float> input_volume_{1.0f};
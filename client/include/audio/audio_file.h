@@ -0,0 +1,73 @@
+#pragma once
+
+#include "common/result.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+
+namespace voip::audio {
+
+/**
+ * Mono audio loaded into memory
+ */
+struct AudioClip {
+    std::vector<float> samples;
+    uint32_t sample_rate = 48000;
+};
+
+/**
+ * Load a WAV (16-bit PCM or 32-bit float) or raw file
+ *
+ * Files not ending in ".wav" are read as raw 16-bit little-endian mono at
+ * raw_sample_rate. Multi-channel WAVs are downmixed to mono.
+ */
+Result<AudioClip> read_audio_file(const std::string& path, uint32_t raw_sample_rate = 48000);
+
+/**
+ * AudioFileWriter - Streams mono audio to a WAV or raw file
+ *
+ * Writes 16-bit PCM: a WAV file if the path ends in ".wav", raw
+ * little-endian samples otherwise. The WAV header is finalized on close()
+ * or destruction.
+ */
+class AudioFileWriter {
+public:
+    static Result<std::unique_ptr<AudioFileWriter>> create(
+        const std::string& path,
+        uint32_t sample_rate
+    );
+
+    ~AudioFileWriter();
+
+    // Disable copy
+    AudioFileWriter(const AudioFileWriter&) = delete;
+    AudioFileWriter& operator=(const AudioFileWriter&) = delete;
+
+    /**
+     * Append samples (clipped to [-1, 1])
+     */
+    void write(const float* pcm, size_t count);
+
+    /**
+     * Finalize the header and close the file
+     */
+    void close();
+
+    [[nodiscard]] uint64_t samples_written() const noexcept { return samples_written_; }
+
+private:
+    AudioFileWriter(std::ofstream file, uint32_t sample_rate, bool is_wav);
+
+    void write_wav_header();
+
+    std::ofstream file_;
+    uint32_t sample_rate_;
+    bool is_wav_;
+    uint64_t samples_written_ = 0;
+    std::vector<int16_t> scratch_;
+};
+
+} // namespace voip::audio
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace voip::audio {
+
+/**
+ * Encode time percentiles over the last evaluation window (microseconds)
+ */
+struct EncodeTimePercentiles {
+    uint32_t p50_us = 0;
+    uint32_t p95_us = 0;
+    uint32_t p99_us = 0;
+};
+
+/**
+ * CpuBudgetMonitor - Keeps encoder cost within a share of the frame period
+ *
+ * Fed with the measured time of every encode call. At the end of each
+ * window, if the 95th percentile exceeds the budget the complexity cap is
+ * lowered one step; it is raised again only after several consecutive
+ * windows with plenty of headroom, so it doesn't oscillate.
+ *
+ * Thread Safety: Not thread-safe. Driven by the capture thread.
+ * record() is RT-safe (no allocation, no locks).
+ */
+class CpuBudgetMonitor {
+public:
+    struct Config {
+        uint32_t frame_duration_us = 20000;
+        float budget_fraction = 0.25f;   // Max share of the frame period for encoding
+        float raise_fraction = 0.5f;     // Raise when p95 is below this share of the budget
+        int min_complexity = 0;
+        int max_complexity = 10;
+        uint32_t window_frames = 50;     // Frames per evaluation
+        uint32_t raise_after_windows = 3;
+    };
+
+    explicit CpuBudgetMonitor(const Config& config);
+
+    /**
+     * Record one encode duration
+     * Returns true if the complexity cap changed
+     */
+    bool record(uint32_t encode_us) noexcept;
+
+    /**
+     * Highest complexity the encoder should currently use
+     */
+    [[nodiscard]] int complexity_cap() const noexcept { return complexity_cap_; }
+
+    /**
+     * Percentiles from the last completed window
+     */
+    [[nodiscard]] const EncodeTimePercentiles& percentiles() const noexcept { return percentiles_; }
+
+    /**
+     * Encode time budget per frame
+     */
+    [[nodiscard]] uint32_t budget_us() const noexcept { return budget_us_; }
+
+private:
+    void evaluate() noexcept;
+
+    static constexpr size_t MAX_WINDOW = 512;
+
+    Config config_;
+    uint32_t budget_us_;
+    int complexity_cap_;
+
+    std::array<uint32_t, MAX_WINDOW> samples_{};
+    size_t sample_count_ = 0;
+    uint32_t headroom_windows_ = 0;
+    EncodeTimePercentiles percentiles_;
+};
+
+} // namespace voip::audio
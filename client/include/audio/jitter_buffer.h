@@ -2,8 +2,11 @@
 
 #include "common/types.h"
 #include "common/result.h"
+#include "common/metrics.h"
+#include "common/interarrival_jitter.h"
 #include <vector>
 #include <deque>
+#include <map>
 #include <optional>
 #include <chrono>
 #include <mutex>
@@ -15,9 +18,11 @@ namespace voip::audio {
  */
 struct AudioPacket {
     SequenceNumber sequence;
-    Timestamp timestamp;
+    Timestamp timestamp;       // Sender's capture time (VoicePacketHeader::timestamp)
     std::vector<float> samples;
-    size_t frame_size;
+    size_t frame_size;  // Samples in this packet (0 = buffer default)
+    UserId sender = 0;
+    uint64_t arrival_us = 0;   // Local receive time (steady_time_us())
 };
 
 /**
@@ -31,7 +36,8 @@ struct JitterStats {
     uint64_t underruns = 0;
     uint32_t current_buffer_size = 0;
     uint32_t max_buffer_size = 0;
-    float jitter_ms = 0.0f;
+    float jitter_ms = 0.0f;          // RFC 3550 interarrival jitter, worst sender
+    uint32_t frame_duration_us = 0;  // Duration of the stream's latest frame
 };
 
 /**
@@ -51,9 +57,13 @@ public:
      * Create jitter buffer
      * 
      * @param buffer_frames Number of frames to buffer (affects latency)
-     * @param frame_size Samples per frame
+     * @param frame_size Default samples per frame (until packets say otherwise)
+     * @param sample_rate Sample rate of decoded audio (for frame timing)
+     *
+     * Packets may carry any Opus frame duration; the expected playout
+     * interval follows each packet's own frame_size.
      */
-    JitterBuffer(uint32_t buffer_frames, uint32_t frame_size);
+    JitterBuffer(uint32_t buffer_frames, uint32_t frame_size, uint32_t sample_rate = 48000);
     
     /**
      * Add packet to buffer
@@ -63,7 +73,9 @@ public:
     
     /**
      * Get next packet for playback
-     * Returns nullopt if buffer is empty (underrun)
+     * Returns nullopt until the buffer first holds buffer_frames packets,
+     * and again after it runs empty (underrun) until it has refilled;
+     * in between every call plays a packet.
      * Returns packet with empty samples if packet was lost (for PLC)
      */
     std::optional<AudioPacket> pop();
@@ -99,6 +111,9 @@ private:
         SequenceNumber sequence;
         Timestamp timestamp;
         std::vector<float> samples;
+        size_t frame_size;
+        UserId sender;
+        uint64_t arrival_us;
     };
     
     // Find insertion position for packet (maintains sorted order)
@@ -110,6 +125,7 @@ private:
     // Configuration
     const uint32_t max_packets_;
     const uint32_t frame_size_;
+    const uint32_t sample_rate_;
     const uint32_t target_buffer_size_;  // Packets to buffer before ready
     
     // Buffer storage (sorted by sequence number)
@@ -118,14 +134,20 @@ private:
     // State tracking
     SequenceNumber next_sequence_ = 0;
     bool initialized_ = false;
+    bool playing_ = false;    // Filled to target; cleared when it runs empty
+    size_t last_frame_size_;  // Latest frame size seen on the stream (for PLC)
     
-    // Timing
-    std::optional<Timestamp> last_pop_time_;
-    std::vector<float> recent_jitter_;  // For jitter calculation
+    // Network jitter per sender, from packet arrival times (not playout)
+    std::map<UserId, InterarrivalJitter> sender_jitter_;
     
     // Statistics
     mutable JitterStats stats_;
     
+    // Process-wide metrics (shared by every buffer)
+    Histogram& depth_metric_;
+    Histogram& queue_wait_metric_;
+    Counter& underrun_metric_;
+    
     // Thread safety
     mutable std::mutex mutex_;
 };
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace voip::audio {
+
+/**
+ * LatencyProbe - Measures mouth-to-ear latency with a marker tone
+ *
+ * Loopback test mode: the capture side replaces the microphone with
+ * silence and a short tone burst once per interval; the playback side
+ * watches the output for the burst's onset. Onset playout time minus its
+ * capture time is the whole pipeline - input device, encoder, network and
+ * echo server, jitter buffer, decoder, mixer and output device.
+ *
+ * The interval must exceed the latency being measured, and the path must
+ * carry only the probe's own audio (other talkers would trigger detection).
+ *
+ * Thread Safety: inject() and detect() may run on different audio threads;
+ * the marker time is handed over atomically. Both are RT-safe.
+ */
+class LatencyProbe {
+public:
+    struct Config {
+        uint32_t sample_rate = 48000;
+        uint32_t interval_ms = 1000;   // Marker period
+        uint32_t marker_ms = 20;       // Tone burst length
+        float tone_hz = 1000.0f;
+        float amplitude = 0.5f;
+        float threshold = 0.2f;        // Output level that counts as the onset
+    };
+
+    explicit LatencyProbe(const Config& config);
+
+    /**
+     * Overwrite a capture frame with the probe signal
+     * capture_time_us: capture time of pcm[0]
+     */
+    void inject(float* pcm, size_t frame_count, uint64_t capture_time_us) noexcept;
+
+    /**
+     * Look for a marker onset in an output frame
+     * playout_time_us: playout time of pcm[0]
+     * Returns true and sets latency_us when a marker returns
+     */
+    bool detect(const float* pcm, size_t frame_count, uint64_t playout_time_us, uint64_t& latency_us) noexcept;
+
+    [[nodiscard]] uint64_t markers_sent() const noexcept { return markers_sent_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t markers_detected() const noexcept { return markers_detected_.load(std::memory_order_relaxed); }
+
+private:
+    Config config_;
+    size_t marker_samples_;
+    uint64_t interval_us_;
+
+    // Capture side
+    uint64_t next_marker_us_ = 0;  // 0 = start at the first frame
+    size_t marker_pos_;            // Position in the current burst (== marker_samples_ when idle)
+    std::atomic<uint64_t> marker_time_us_{0};
+
+    // Playback side
+    bool armed_ = true;            // Re-armed after a quiet gap
+    size_t quiet_samples_ = 0;
+    uint64_t matched_marker_us_ = 0;
+
+    std::atomic<uint64_t> markers_sent_{0};
+    std::atomic<uint64_t> markers_detected_{0};
+};
+
+} // namespace voip::audio
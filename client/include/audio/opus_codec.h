@@ -38,6 +38,8 @@ public:
     /**
      * Encode PCM audio to Opus
      * Input: PCM float samples (-1.0 to 1.0)
+     * frame_count must be 2.5, 5, 10, 20, 40 or 60ms worth of samples;
+     * the duration is carried in the packet's TOC byte
      * Returns: Encoded packet
      */
     Result<EncodedPacket> encode(const float* pcm, size_t frame_count);
@@ -104,6 +106,24 @@ public:
         size_t max_frame_size
     );
     
+    /**
+     * Number of samples an Opus packet decodes to (read from its TOC byte)
+     * Lets receivers size buffers per packet when senders use different
+     * frame durations
+     */
+    static Result<size_t> packet_frame_size(
+        const uint8_t* opus_data,
+        size_t opus_size,
+        uint32_t sample_rate
+    );
+    
+    /**
+     * Largest frame a single packet can decode to (60ms)
+     */
+    [[nodiscard]] static constexpr size_t max_frame_size(uint32_t sample_rate) noexcept {
+        return frame_size_for_duration_us(sample_rate, MAX_OPUS_FRAME_DURATION_US);
+    }
+    
     /**
      * Packet Loss Concealment - generate audio for missing packet
      * Call when expected packet is missing
@@ -111,10 +131,84 @@ public:
      */
     Result<size_t> decode_plc(float* pcm_out, size_t frame_size);
     
+    /**
+     * Recover a missing packet from the in-band FEC of the packet after it
+     * Call when packet N is missing but N+1 has arrived, before decoding
+     * N+1 itself. Falls back to PLC inside Opus if N+1 carries no FEC.
+     * Returns: Number of samples recovered (frame_size)
+     */
+    Result<size_t> decode_fec(
+        const uint8_t* next_opus_data,
+        size_t next_opus_size,
+        float* pcm_out,
+        size_t frame_size
+    );
+    
+    /**
+     * Forget the previous stream (OPUS_RESET_STATE), e.g. before reusing
+     * the decoder for another speaker
+     */
+    Result<void> reset();
+    
 private:
     explicit OpusDecoder(::OpusDecoder* decoder);
     
     ::OpusDecoder* decoder_;
 };
 
+/**
+ * OpusRepacketizer - Packs consecutive Opus frames into one packet and
+ * splits such packets back into one packet per frame
+ *
+ * Packing saves a datagram (and its headers) per extra frame. Frames share
+ * a packet only if their TOC bytes agree on mode, bandwidth, duration and
+ * channels, and a packet holds at most 120ms.
+ *
+ * Thread Safety: Not thread-safe. Use one instance for packing and another
+ * for splitting.
+ */
+class OpusRepacketizer {
+public:
+    static Result<std::unique_ptr<OpusRepacketizer>> create();
+    
+    ~OpusRepacketizer();
+    
+    // Disable copy
+    OpusRepacketizer(const OpusRepacketizer&) = delete;
+    OpusRepacketizer& operator=(const OpusRepacketizer&) = delete;
+    
+    /**
+     * Append a packet's frames to the pending packet (copies the data)
+     * Fails, leaving the pending packet as it was, if they don't fit in it
+     */
+    Result<void> add(const uint8_t* opus_data, size_t opus_size);
+    
+    /**
+     * Frames in the pending packet
+     */
+    [[nodiscard]] size_t frame_count() const noexcept;
+    
+    /**
+     * The pending frames as one packet; starts a new one
+     */
+    Result<std::vector<uint8_t>> take();
+    
+    /**
+     * One packet per frame of opus_data (a single-frame packet comes back
+     * as is). Discards any pending frames.
+     */
+    Result<std::vector<std::vector<uint8_t>>> split(const uint8_t* opus_data, size_t opus_size);
+    
+private:
+    explicit OpusRepacketizer(::OpusRepacketizer* repacketizer);
+    
+    void reset();
+    
+    ::OpusRepacketizer* repacketizer_;
+    
+    // Libopus keeps pointers into the added packets until take(); moving
+    // the inner vectors on growth leaves their buffers in place
+    std::vector<std::vector<uint8_t>> pending_;
+};
+
 } // namespace voip::audio
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "audio/audio_backend.h"
+#include <portaudio.h>
+
+namespace voip::audio {
+
+/**
+ * PortAudioBackend - Sound card I/O via PortAudio
+ *
+ * Default backend of AudioEngine. Streams run at the device's native rate
+ * when it doesn't support the codec rate.
+ */
+class PortAudioBackend : public AudioBackend {
+public:
+    PortAudioBackend() = default;
+    ~PortAudioBackend() override;
+
+    // Disable copy
+    PortAudioBackend(const PortAudioBackend&) = delete;
+    PortAudioBackend& operator=(const PortAudioBackend&) = delete;
+
+    Result<void> initialize() override;
+    void terminate() override;
+
+    [[nodiscard]] const char* name() const noexcept override { return "PortAudio"; }
+
+    std::vector<AudioDevice> enumerate_input_devices() override;
+    std::vector<AudioDevice> enumerate_output_devices() override;
+    DeviceId default_input_device() override;
+    DeviceId default_output_device() override;
+
+    uint32_t select_sample_rate(DeviceId device, bool is_input, uint32_t preferred) override;
+
+    Result<void> open_capture(const DeviceStreamConfig& config, DeviceCaptureCallback callback) override;
+    Result<void> open_playback(const DeviceStreamConfig& config, DevicePlaybackCallback callback) override;
+    void close_capture() override;
+    void close_playback() override;
+
+private:
+    // PortAudio callback functions (static, forward to the stored callbacks)
+    static int capture_callback_static(
+        const void* input,
+        void* output,
+        unsigned long frame_count,
+        const PaStreamCallbackTimeInfo* time_info,
+        PaStreamCallbackFlags status_flags,
+        void* user_data
+    );
+
+    static int playback_callback_static(
+        const void* input,
+        void* output,
+        unsigned long frame_count,
+        const PaStreamCallbackTimeInfo* time_info,
+        PaStreamCallbackFlags status_flags,
+        void* user_data
+    );
+
+    // Offset of a buffer's ADC/DAC time from the callback time (0 if unknown)
+    static int64_t stream_offset_us(PaTime current_time, PaTime buffer_time) noexcept;
+
+    // Mono float32 parameters for a device (NO_DEVICE = default)
+    PaStreamParameters stream_parameters(DeviceId device, bool is_input);
+
+    Result<void> open_stream(
+        PaStream** stream,
+        const DeviceStreamConfig& config,
+        bool is_input
+    );
+
+    PaStream* capture_stream_ = nullptr;
+    PaStream* playback_stream_ = nullptr;
+
+    DeviceCaptureCallback capture_callback_;
+    DevicePlaybackCallback playback_callback_;
+
+    bool initialized_ = false;
+};
+
+} // namespace voip::audio
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "common/result.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace voip::audio {
+
+/**
+ * Resampler - Polyphase windowed-sinc sample rate converter (mono, float)
+ *
+ * Converts between any two rates with a rational ratio (e.g. 44100 <-> 48000,
+ * 16000 -> 48000). Uses a Kaiser-windowed sinc prototype split into L
+ * polyphase branches, so each output sample costs one short dot product.
+ * The dot product is vectorized (SSE / NEON) where available.
+ *
+ * Streaming: filter history is carried across calls, so a signal can be fed
+ * in arbitrarily sized blocks and the output is identical to a single call.
+ *
+ * Thread Safety: Not thread-safe. Use one resampler per stream/direction.
+ * process() is RT-safe (no allocation, no locks).
+ */
+class Resampler {
+public:
+    /**
+     * Create resampler
+     *
+     * @param input_rate Source sample rate (Hz)
+     * @param output_rate Destination sample rate (Hz)
+     * @param max_input_frames Largest block passed to process()
+     */
+    static Result<std::unique_ptr<Resampler>> create(
+        uint32_t input_rate,
+        uint32_t output_rate,
+        size_t max_input_frames
+    );
+
+    // Disable copy
+    Resampler(const Resampler&) = delete;
+    Resampler& operator=(const Resampler&) = delete;
+
+    /**
+     * Resample a block of input samples
+     *
+     * RT-SAFE: No allocation, no blocking
+     *
+     * @param input Input samples at input_rate
+     * @param input_count Number of input samples (<= max_input_frames)
+     * @param output Output buffer
+     * @param output_capacity Size of output buffer (see max_output_frames())
+     * @return Number of samples written to output
+     */
+    size_t process(const float* input, size_t input_count,
+                   float* output, size_t output_capacity) noexcept;
+
+    /**
+     * Upper bound of samples produced for an input block of given size
+     */
+    [[nodiscard]] size_t max_output_frames(size_t input_count) const noexcept;
+
+    /**
+     * Clear filter history (e.g. when a stream restarts)
+     */
+    void reset() noexcept;
+
+    [[nodiscard]] uint32_t input_rate() const noexcept { return input_rate_; }
+    [[nodiscard]] uint32_t output_rate() const noexcept { return output_rate_; }
+    [[nodiscard]] bool is_passthrough() const noexcept { return up_ == down_; }
+
+    /**
+     * Filter delay in output samples (for latency accounting)
+     */
+    [[nodiscard]] size_t delay_frames() const noexcept;
+
+private:
+    Resampler(uint32_t input_rate, uint32_t output_rate,
+              uint32_t up, uint32_t down, size_t max_input_frames);
+
+    // Build polyphase filter bank
+    void design_filter();
+
+    // Configuration
+    const uint32_t input_rate_;
+    const uint32_t output_rate_;
+    const uint32_t up_;      // Interpolation factor (L)
+    const uint32_t down_;    // Decimation factor (M)
+    const size_t max_input_frames_;
+
+    // Polyphase filter bank: up_ branches of taps_ coefficients each,
+    // stored time-reversed so the inner loop is a forward dot product
+    static constexpr size_t taps_ = 32;
+    std::vector<float> coefficients_;
+
+    // [history (taps_-1) | current input block]
+    std::vector<float> work_;
+
+    // Position of next output sample, in upsampled units relative
+    // to the start of the current input block
+    uint64_t position_ = 0;
+};
+
+} // namespace voip::audio
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "audio/audio_backend.h"
+#include "audio/audio_file.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace voip::audio {
+
+/**
+ * VirtualAudioBackend - Clock-driven file device for headless runs
+ *
+ * Capture plays an audio file (or a preloaded clip) into the engine;
+ * playback is written to a file or discarded. Both streams are serviced by
+ * one virtual clock every period_us, so the full session pipeline runs
+ * without a sound card:
+ * - RealTime clock: an internal thread paced by the wall clock, optionally
+ *   scaled (speed 4.0 = four times real time, 0 = as fast as possible)
+ * - Manual clock: no thread; the caller drives time with advance(), e.g.
+ *   from a shared event loop running many sessions
+ *
+ * Device callbacks run on the clock thread (or the advance() caller) and
+ * must not open or close streams.
+ *
+ * Device timestamps are virtual time offset onto steady_time_us(): a tick
+ * covering [t, t + period) delivers capture samples stamped t and playback
+ * samples that "play" from t + period, like a device with one period of
+ * buffering each way. With a real-time clock at speed 1 they track the
+ * wall clock; otherwise they run at virtual speed, and wall_clock() tells
+ * sessions to run their voice worker off the device callbacks.
+ */
+class VirtualAudioBackend : public AudioBackend {
+public:
+    enum class ClockMode {
+        RealTime,
+        Manual,
+    };
+
+    struct Config {
+        std::string input_path;                       // WAV or raw s16le; empty = silence
+        std::shared_ptr<const AudioClip> input_clip;  // Preloaded input (overrides input_path)
+        uint32_t raw_sample_rate = 48000;             // Rate of raw input files
+        bool loop_input = false;                      // Else silence once the input ends
+
+        std::string output_path;                      // WAV or raw s16le; empty = discard
+        uint32_t output_sample_rate = 0;              // 0 = rate requested by the engine
+
+        uint32_t period_us = 10000;                   // Device callback period
+        ClockMode clock = ClockMode::RealTime;
+        float speed = 1.0f;                           // RealTime clock only
+    };
+
+    /**
+     * Create backend; the input file is loaded up front
+     */
+    static Result<std::unique_ptr<VirtualAudioBackend>> create(const Config& config);
+
+    ~VirtualAudioBackend() override;
+
+    // Disable copy
+    VirtualAudioBackend(const VirtualAudioBackend&) = delete;
+    VirtualAudioBackend& operator=(const VirtualAudioBackend&) = delete;
+
+    Result<void> initialize() override;
+    void terminate() override;
+
+    [[nodiscard]] const char* name() const noexcept override { return "Virtual"; }
+    [[nodiscard]] bool wall_clock() const noexcept override {
+        return config_.clock == ClockMode::RealTime && config_.speed == 1.0f;
+    }
+
+    std::vector<AudioDevice> enumerate_input_devices() override;
+    std::vector<AudioDevice> enumerate_output_devices() override;
+    DeviceId default_input_device() override { return 0; }
+    DeviceId default_output_device() override { return 0; }
+
+    uint32_t select_sample_rate(DeviceId device, bool is_input, uint32_t preferred) override;
+
+    Result<void> open_capture(const DeviceStreamConfig& config, DeviceCaptureCallback callback) override;
+    Result<void> open_playback(const DeviceStreamConfig& config, DevicePlaybackCallback callback) override;
+    void close_capture() override;
+    void close_playback() override;
+
+    /**
+     * Manual clock: run the given number of device periods on this thread
+     */
+    void advance(uint32_t periods = 1);
+
+    /**
+     * True once a non-looping input has been fully captured
+     */
+    [[nodiscard]] bool input_finished() const noexcept { return input_finished_.load(std::memory_order_relaxed); }
+
+    /**
+     * Virtual time since the backend was created (or the clock started)
+     */
+    [[nodiscard]] uint64_t elapsed_us() const noexcept { return elapsed_us_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] uint64_t frames_captured() const noexcept { return frames_captured_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t frames_played() const noexcept { return frames_played_.load(std::memory_order_relaxed); }
+
+private:
+    explicit VirtualAudioBackend(const Config& config);
+
+    // One period of capture and playback (caller holds mutex_)
+    void tick();
+
+    // Frames a stream at this rate covers during [from_us, to_us)
+    static size_t frames_between(uint32_t sample_rate, uint64_t from_us, uint64_t to_us) noexcept;
+
+    void fill_capture(float* pcm, size_t count) noexcept;
+
+    void start_clock();
+    void stop_clock();
+    void clock_loop();
+
+    Config config_;
+    std::shared_ptr<const AudioClip> input_;
+    size_t input_pos_ = 0;
+
+    // Streams (guarded by mutex_, which the clock holds while ticking)
+    std::mutex mutex_;
+    DeviceCaptureCallback capture_callback_;
+    DevicePlaybackCallback playback_callback_;
+    uint32_t capture_rate_ = 0;
+    uint32_t playback_rate_ = 0;
+    std::vector<float> capture_buffer_;
+    std::vector<float> playback_buffer_;
+    std::unique_ptr<AudioFileWriter> output_writer_;
+
+    // Clock
+    std::thread clock_thread_;
+    std::atomic<bool> clock_running_{false};
+    std::atomic<uint64_t> elapsed_us_{0};
+    uint64_t time_base_us_;  // steady_time_us() at virtual time 0
+
+    // Statistics
+    std::atomic<bool> input_finished_{false};
+    std::atomic<uint64_t> frames_captured_{0};
+    std::atomic<uint64_t> frames_played_{0};
+};
+
+} // namespace voip::audio
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "common/result.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace voip::audio {
+
+/**
+ * VoiceActivityDetector - Classifies capture frames as speech or silence
+ *
+ * A frame counts as speech when its energy is well above an adaptive noise
+ * floor and its spectrum is peaky (low spectral flatness), or when it is
+ * loud enough that shape doesn't matter (e.g. fricatives). Steady noise such
+ * as fans is flat and gets absorbed into the floor. A hangover keeps the
+ * detector active briefly after speech so word endings aren't clipped.
+ *
+ * Thread Safety: Not thread-safe. Use one detector per capture stream.
+ * process() is RT-safe (no allocation, no locks).
+ */
+class VoiceActivityDetector {
+public:
+    struct Config {
+        uint32_t sample_rate = 48000;
+        float speech_margin_db = 9.0f;     // Above noise floor (with peaky spectrum)
+        float loud_margin_db = 20.0f;      // Above noise floor (any spectrum)
+        float min_speech_dbfs = -55.0f;    // Never speech below this level
+        float flatness_threshold = 0.3f;   // 0 = pure tone, ~0.56 = white noise
+        uint32_t hangover_ms = 300;
+    };
+
+    /**
+     * Create detector
+     *
+     * @param config Detector settings
+     * @param max_frame_size Largest frame passed to process()
+     */
+    static Result<std::unique_ptr<VoiceActivityDetector>> create(
+        const Config& config,
+        size_t max_frame_size
+    );
+
+    // Disable copy
+    VoiceActivityDetector(const VoiceActivityDetector&) = delete;
+    VoiceActivityDetector& operator=(const VoiceActivityDetector&) = delete;
+
+    /**
+     * Analyze one frame
+     *
+     * RT-SAFE: No allocation, no blocking
+     *
+     * @return true if speech is active (including hangover)
+     */
+    bool process(const float* pcm, size_t count) noexcept;
+
+    /**
+     * Result of the last process() call
+     */
+    [[nodiscard]] bool is_active() const noexcept { return active_; }
+
+    /**
+     * Analysis of the last frame (for meters/debugging)
+     */
+    [[nodiscard]] float energy_db() const noexcept { return energy_db_; }
+    [[nodiscard]] float noise_floor_db() const noexcept { return noise_floor_db_; }
+    [[nodiscard]] float spectral_flatness() const noexcept { return flatness_; }
+
+    /**
+     * Forget the noise floor and hangover (e.g. after a device change)
+     */
+    void reset() noexcept;
+
+private:
+    VoiceActivityDetector(const Config& config, size_t fft_size);
+
+    // Spectral flatness of the speech band (100 Hz - 4 kHz)
+    float measure_flatness(const float* pcm, size_t count) noexcept;
+
+    // In-place radix-2 FFT of fft_re_/fft_im_
+    void fft() noexcept;
+
+    Config config_;
+
+    // FFT over the first fft_size_ samples of each frame
+    const size_t fft_size_;
+    std::vector<float> window_;
+    std::vector<float> fft_re_;
+    std::vector<float> fft_im_;
+    std::vector<float> twiddle_re_;
+    std::vector<float> twiddle_im_;
+    std::vector<uint32_t> bit_reverse_;
+    size_t band_low_;   // First bin of speech band
+    size_t band_high_;  // Last bin of speech band
+
+    // State
+    bool initialized_ = false;
+    bool active_ = false;
+    float noise_floor_db_ = -90.0f;
+    float energy_db_ = -90.0f;
+    float flatness_ = 1.0f;
+    uint64_t hangover_remaining_us_ = 0;
+};
+
+} // namespace voip::audio
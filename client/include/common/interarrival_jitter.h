@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace voip {
+
+/**
+ * InterarrivalJitter - RFC 3550 interarrival jitter for one sender
+ *
+ * Fed with each packet's sender timestamp and local arrival time, both in
+ * microseconds. The clocks need not agree: their offset cancels out in
+ * the transit-time differences. Arrival times should be taken as close to
+ * the wire as possible (kernel receive timestamps), or thread scheduling
+ * on the receive path shows up as jitter.
+ *
+ * Thread Safety: Not thread-safe.
+ */
+class InterarrivalJitter {
+public:
+    /**
+     * Account for one packet; returns the updated estimate in microseconds
+     */
+    float update(uint64_t sender_timestamp_us, uint64_t arrival_us) noexcept {
+        const int64_t transit_us = static_cast<int64_t>(arrival_us) - static_cast<int64_t>(sender_timestamp_us);
+        if (has_transit_) {
+            const auto d = static_cast<float>(std::llabs(transit_us - last_transit_us_));
+            jitter_us_ += (d - jitter_us_) / 16.0f;
+        }
+        last_transit_us_ = transit_us;
+        has_transit_ = true;
+        return jitter_us_;
+    }
+
+    void reset() noexcept {
+        last_transit_us_ = 0;
+        jitter_us_ = 0.0f;
+        has_transit_ = false;
+    }
+
+    [[nodiscard]] float jitter_us() const noexcept { return jitter_us_; }
+
+private:
+    int64_t last_transit_us_ = 0;
+    float jitter_us_ = 0.0f;
+    bool has_transit_ = false;
+};
+
+} // namespace voip
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace voip {
+
+/**
+ * LatencyHistogram - Fixed-size log-linear histogram of microsecond values
+ *
+ * 32 linear sub-buckets per power of two keeps the relative error under
+ * ~3% from 1us to over an hour, in 3.5KB with no allocation, so one can be
+ * kept per stream (or per load-test bot) and merged for reporting.
+ *
+ * Thread Safety: Not thread-safe. record() is RT-safe (no allocation).
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr uint64_t SUB_COUNT = 1u << SUB_BITS;
+    static constexpr size_t BUCKETS = SUB_COUNT + (32 - SUB_BITS) * SUB_COUNT;
+    static constexpr uint64_t MAX_VALUE = (uint64_t{1} << 32) - 1;
+
+    void record(uint64_t value_us) noexcept {
+        counts_[bucket_of(value_us)]++;
+        total_++;
+        if (value_us > max_) {
+            max_ = value_us;
+        }
+    }
+
+    void reset() noexcept {
+        counts_.fill(0);
+        total_ = 0;
+        max_ = 0;
+    }
+
+    void merge(const LatencyHistogram& other) noexcept {
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        if (other.max_ > max_) {
+            max_ = other.max_;
+        }
+    }
+
+    /**
+     * Add counts bucketed elsewhere with bucket_of() (e.g. by a concurrent recorder)
+     */
+    void add_counts(const std::array<uint32_t, BUCKETS>& counts, uint64_t max_value) noexcept {
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            counts_[i] += counts[i];
+            total_ += counts[i];
+        }
+        if (max_value > max_) {
+            max_ = max_value;
+        }
+    }
+
+    /**
+     * Value at the given percentile (0-100), 0 if empty
+     */
+    [[nodiscard]] uint64_t percentile(double p) const noexcept {
+        if (total_ == 0) {
+            return 0;
+        }
+        const uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total_ - 1));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts_[i];
+            if (seen > rank) {
+                const uint64_t value = midpoint_of(i);
+                return value < max_ ? value : max_;
+            }
+        }
+        return max_;
+    }
+
+    [[nodiscard]] uint64_t count() const noexcept { return total_; }
+    [[nodiscard]] uint64_t max() const noexcept { return max_; }
+
+    // Bucket index of a value (values above MAX_VALUE share the last bucket)
+    static size_t bucket_of(uint64_t value) noexcept {
+        if (value > MAX_VALUE) {
+            value = MAX_VALUE;
+        }
+        if (value < SUB_COUNT) {
+            return static_cast<size_t>(value);
+        }
+        const unsigned shift = static_cast<unsigned>(std::bit_width(value)) - 1 - SUB_BITS;
+        return static_cast<size_t>(SUB_COUNT + shift * SUB_COUNT + ((value >> shift) - SUB_COUNT));
+    }
+
+private:
+    static uint64_t midpoint_of(size_t bucket) noexcept {
+        if (bucket < SUB_COUNT) {
+            return bucket;
+        }
+        const uint64_t shift = (bucket - SUB_COUNT) / SUB_COUNT;
+        const uint64_t sub = (bucket - SUB_COUNT) % SUB_COUNT + SUB_COUNT;
+        return (sub << shift) + ((uint64_t{1} << shift) >> 1);
+    }
+
+    std::array<uint32_t, BUCKETS> counts_{};
+    uint64_t total_ = 0;
+    uint64_t max_ = 0;
+};
+
+} // namespace voip
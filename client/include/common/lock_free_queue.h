@@ -1,8 +1,10 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
 #include <cstring>
+#include <utility>
 
 namespace voip {
 
@@ -49,6 +51,24 @@ public:
         return true;
     }
     
+    /**
+     * Push by move (producer side); value is untouched if the queue is full
+     * 
+     * RT-SAFE if moving T doesn't allocate
+     */
+    bool try_push(T&& value) noexcept {
+        const size_t current_tail = tail_.load(std::memory_order_relaxed);
+        const size_t next_tail = next(current_tail);
+        
+        if (next_tail == head_.load(std::memory_order_acquire)) {
+            return false;  // Queue full
+        }
+        
+        buffer_[current_tail] = std::move(value);
+        tail_.store(next_tail, std::memory_order_release);
+        return true;
+    }
+    
     /**
      * Pop element from queue (consumer side)
      * Returns false if queue is empty
@@ -62,7 +82,7 @@ public:
             return false;  // Queue empty
         }
         
-        value = buffer_[current_head];
+        value = std::move(buffer_[current_head]);
         head_.store(next(current_head), std::memory_order_release);
         return true;
     }
@@ -124,7 +144,8 @@ private:
 /**
  * Audio Buffer Queue - Specialized for audio PCM data
  * 
- * Stores fixed-size audio frames for real-time processing
+ * Stores fixed-size audio frames for real-time processing, each with an
+ * optional timestamp (e.g. its capture time)
  */
 class AudioBufferQueue {
 public:
@@ -132,6 +153,7 @@ public:
         : frame_size_(frame_size)
         , capacity_(capacity)
         , data_(std::make_unique<float[]>(capacity * frame_size))
+        , times_(std::make_unique<uint64_t[]>(capacity))
         , head_(0)
         , tail_(0)
     {
@@ -141,7 +163,7 @@ public:
      * Push audio frame (RT-SAFE)
      * Returns false if full
      */
-    bool try_push(const float* frame, size_t count) noexcept {
+    bool try_push(const float* frame, size_t count, uint64_t time_us = 0) noexcept {
         if (count != frame_size_) {
             return false;  // Size mismatch
         }
@@ -156,6 +178,7 @@ public:
         // Copy frame data
         std::memcpy(&data_[current_tail * frame_size_], frame, 
                    frame_size_ * sizeof(float));
+        times_[current_tail] = time_us;
         
         tail_.store(next_tail, std::memory_order_release);
         return true;
@@ -165,7 +188,7 @@ public:
      * Pop audio frame (RT-SAFE)
      * Returns false if empty
      */
-    bool try_pop(float* frame, size_t count) noexcept {
+    bool try_pop(float* frame, size_t count, uint64_t* time_us = nullptr) noexcept {
         if (count != frame_size_) {
             return false;  // Size mismatch
         }
@@ -179,6 +202,9 @@ public:
         // Copy frame data
         std::memcpy(frame, &data_[current_head * frame_size_], 
                    frame_size_ * sizeof(float));
+        if (time_us) {
+            *time_us = times_[current_head];
+        }
         
         head_.store((current_head + 1) % capacity_, std::memory_order_release);
         return true;
@@ -204,6 +230,7 @@ private:
     const size_t frame_size_;
     const size_t capacity_;
     std::unique_ptr<float[]> data_;
+    std::unique_ptr<uint64_t[]> times_;
     
     alignas(64) std::atomic<size_t> head_;
     alignas(64) std::atomic<size_t> tail_;
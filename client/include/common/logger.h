@@ -0,0 +1,222 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace voip {
+
+/**
+ * Logging
+ *
+ * VOIP_LOG_INFO("Joined channel " << channel_id);
+ *
+ * A log statement formats into a fixed-size record on the caller's stack
+ * and pushes it onto a lock-free ring owned by the calling thread; a
+ * background thread writes the records out. Nothing on the calling side
+ * locks, allocates or touches the console, so the macros are safe in
+ * audio and network callbacks (the first statement on a new thread claims
+ * a ring and registers its release, once).
+ *
+ * Each call site allows a burst of messages per second; the rest are
+ * counted and reported with the next message that gets through. Levels
+ * below VOIP_LOG_COMPILED_LEVEL (Debug in debug builds, Info with NDEBUG)
+ * compile to nothing.
+ */
+
+enum class LogLevel : uint8_t {
+    Debug = 0,
+    Info = 1,
+    Warn = 2,
+    Error = 3,
+    Off = 4
+};
+
+const char* to_string(LogLevel level) noexcept;
+
+/**
+ * Per call site rate limiter (lives in a function-local static)
+ */
+class LogSite {
+public:
+    static constexpr uint32_t BURST_PER_SECOND = 10;
+
+    constexpr LogSite() = default;
+
+    /**
+     * Whether this call may log now
+     * RT-SAFE
+     */
+    bool admit() noexcept;
+
+    /**
+     * Messages dropped since the last admitted one (resets the count)
+     */
+    uint32_t take_suppressed() noexcept { return suppressed_.exchange(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> window_start_us_{0};
+    std::atomic<uint32_t> window_count_{0};
+    std::atomic<uint32_t> suppressed_{0};
+};
+
+/**
+ * One formatted message; streaming into it truncates instead of growing
+ */
+class LogLine {
+public:
+    static constexpr size_t MAX_TEXT = 232;
+
+    LogLine(LogLevel level, LogSite& site) noexcept;
+    ~LogLine();  // Submits the record
+
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    LogLine& operator<<(std::string_view text) noexcept;
+    LogLine& operator<<(const char* text) noexcept { return *this << std::string_view(text ? text : "(null)"); }
+    LogLine& operator<<(const std::string& text) noexcept { return *this << std::string_view(text); }
+    LogLine& operator<<(char c) noexcept { return *this << std::string_view(&c, 1); }
+    LogLine& operator<<(bool value) noexcept { return *this << (value ? "true" : "false"); }
+    LogLine& operator<<(double value) noexcept;
+    LogLine& operator<<(float value) noexcept { return *this << static_cast<double>(value); }
+
+    template<typename T>
+        requires std::is_integral_v<T>
+    LogLine& operator<<(T value) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            return append_signed(static_cast<int64_t>(value));
+        } else {
+            return append_unsigned(static_cast<uint64_t>(value));
+        }
+    }
+
+private:
+    LogLine& append_signed(int64_t value) noexcept;
+    LogLine& append_unsigned(uint64_t value) noexcept;
+
+    LogLevel level_;
+    LogSite& site_;
+    size_t length_ = 0;
+    char text_[MAX_TEXT];
+};
+
+/**
+ * Space-separated container elements: line << log_join(channels)
+ */
+template<typename Container>
+struct LogJoin {
+    const Container& items;
+};
+
+template<typename Container>
+LogJoin<Container> log_join(const Container& items) noexcept {
+    return LogJoin<Container>{items};
+}
+
+template<typename Container>
+LogLine& operator<<(LogLine& line, const LogJoin<Container>& join) noexcept {
+    bool first = true;
+    for (const auto& item : join.items) {
+        if (!first) {
+            line << ' ';
+        }
+        line << item;
+        first = false;
+    }
+    return line;
+}
+
+/**
+ * Logger - Process-wide log output
+ *
+ * Thread Safety: All functions are thread-safe.
+ */
+class Logger {
+public:
+    using Sink = std::function<void(LogLevel level, std::string_view text)>;
+
+    /**
+     * Runtime level filter (default Info)
+     * RT-SAFE
+     */
+    static bool enabled(LogLevel level) noexcept {
+        return level >= min_level_.load(std::memory_order_relaxed);
+    }
+    static void set_level(LogLevel level) noexcept { min_level_.store(level, std::memory_order_relaxed); }
+
+    /**
+     * Start the writer thread. Call once at startup, before any audio or
+     * network thread logs; a static initializer in the library calls it
+     * too, so the first log statement never spawns the thread.
+     */
+    static void start();
+
+    /**
+     * Replace the output (default: Warn/Error to stderr, rest to stdout).
+     * Called from the writer thread; an empty sink restores the default.
+     */
+    static void set_sink(Sink sink);
+
+    /**
+     * Write out everything logged so far (blocks; not for RT threads)
+     */
+    static void flush();
+
+    /**
+     * Messages lost because a ring was full or none was free
+     */
+    static uint64_t dropped() noexcept;
+
+    /**
+     * Queue a record for the writer thread
+     * RT-SAFE
+     */
+    static void submit(LogLevel level, const char* text, size_t length, uint32_t suppressed) noexcept;
+
+private:
+    static inline std::atomic<LogLevel> min_level_{LogLevel::Info};
+};
+
+} // namespace voip
+
+#ifndef VOIP_LOG_COMPILED_LEVEL
+#ifdef NDEBUG
+#define VOIP_LOG_COMPILED_LEVEL 1
+#else
+#define VOIP_LOG_COMPILED_LEVEL 0
+#endif
+#endif
+
+#define VOIP_LOG_AT(level, message) \
+    do { \
+        static ::voip::LogSite voip_log_site_; \
+        if (::voip::Logger::enabled(level) && voip_log_site_.admit()) { \
+            ::voip::LogLine voip_log_line_(level, voip_log_site_); \
+            voip_log_line_ << message; \
+        } \
+    } while (0)
+
+#if VOIP_LOG_COMPILED_LEVEL <= 0
+#define VOIP_LOG_DEBUG(message) VOIP_LOG_AT(::voip::LogLevel::Debug, message)
+#else
+#define VOIP_LOG_DEBUG(message) do {} while (0)
+#endif
+
+#if VOIP_LOG_COMPILED_LEVEL <= 1
+#define VOIP_LOG_INFO(message) VOIP_LOG_AT(::voip::LogLevel::Info, message)
+#else
+#define VOIP_LOG_INFO(message) do {} while (0)
+#endif
+
+#if VOIP_LOG_COMPILED_LEVEL <= 2
+#define VOIP_LOG_WARN(message) VOIP_LOG_AT(::voip::LogLevel::Warn, message)
+#else
+#define VOIP_LOG_WARN(message) do {} while (0)
+#endif
+
+#define VOIP_LOG_ERROR(message) VOIP_LOG_AT(::voip::LogLevel::Error, message)
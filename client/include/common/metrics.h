@@ -0,0 +1,228 @@
+#pragma once
+
+#include "common/latency_histogram.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace voip {
+
+/**
+ * Hot-path metrics
+ *
+ * Counters and histograms are sharded: each thread writes its own
+ * cache-line-aligned slot with relaxed atomic adds, so recording never
+ * locks, allocates or contends with other writers. Reads walk all shards
+ * and aggregate, which is cheap at the rate anyone looks at metrics.
+ *
+ * Metrics are registered once (not on the hot path) and the returned
+ * reference is kept; registering a name again returns the same metric, so
+ * every session/engine in a process feeds the same totals. Gauges hold one
+ * writer's state rather than a total, so a gauge can also be registered
+ * with labels: each label set is its own series (one per session).
+ */
+
+// Threads beyond this share slots (still correct, just contended)
+constexpr size_t METRIC_SHARDS = 8;
+
+namespace detail {
+
+// Slot of the calling thread, assigned round-robin on first use
+inline size_t metrics_shard() noexcept {
+    static std::atomic<size_t> next_shard{0};
+    thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % METRIC_SHARDS;
+    return shard;
+}
+
+} // namespace detail
+
+/**
+ * Counter - Monotonic event count
+ */
+class Counter {
+public:
+    Counter(std::string name, std::string help);
+
+    // RT-SAFE
+    void add(uint64_t count = 1) noexcept {
+        shards_[detail::metrics_shard()].value.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint64_t value() const noexcept;
+    void reset() noexcept;
+
+    [[nodiscard]] const std::string& name() const noexcept { return name_; }
+    [[nodiscard]] const std::string& help() const noexcept { return help_; }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+
+    std::string name_;
+    std::string help_;
+    std::array<Shard, METRIC_SHARDS> shards_;
+};
+
+/**
+ * Gauge - Last written value (one writer expected per label set)
+ */
+class Gauge {
+public:
+    Gauge(std::string name, std::string help, std::string labels = {});
+
+    // RT-SAFE
+    void set(int64_t value) noexcept { value_.store(value, std::memory_order_relaxed); }
+
+    [[nodiscard]] int64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] const std::string& name() const noexcept { return name_; }
+    [[nodiscard]] const std::string& help() const noexcept { return help_; }
+    [[nodiscard]] const std::string& labels() const noexcept { return labels_; }
+
+private:
+    std::string name_;
+    std::string help_;
+    std::string labels_;  // Prometheus label set without braces, e.g. server="host:9001"
+    std::atomic<int64_t> value_{0};
+};
+
+/**
+ * Histogram - Log-linear distribution of values (LatencyHistogram layout)
+ *
+ * Units are part of the name: *_us for durations, plain counts otherwise.
+ */
+class Histogram {
+public:
+    Histogram(std::string name, std::string help);
+
+    // RT-SAFE
+    void record(uint64_t value) noexcept {
+        Shard& shard = shards_[detail::metrics_shard()];
+        shard.counts[LatencyHistogram::bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(value, std::memory_order_relaxed);
+        // Slots are practically single-writer, so this rarely loops
+        uint64_t max = shard.max.load(std::memory_order_relaxed);
+        while (value > max && !shard.max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * Aggregate all shards (sum is returned separately; the histogram
+     * itself only keeps bucket counts)
+     */
+    [[nodiscard]] LatencyHistogram aggregate(uint64_t* sum = nullptr) const;
+    void reset() noexcept;
+
+    [[nodiscard]] const std::string& name() const noexcept { return name_; }
+    [[nodiscard]] const std::string& help() const noexcept { return help_; }
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint32_t>, LatencyHistogram::BUCKETS> counts{};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> max{0};
+    };
+
+    std::string name_;
+    std::string help_;
+    std::array<Shard, METRIC_SHARDS> shards_;  // ~30KB: allocate, don't put on the stack
+};
+
+/**
+ * Point-in-time copy of every registered metric
+ */
+struct MetricsSnapshot {
+    struct CounterValue {
+        std::string name;
+        std::string help;
+        uint64_t value = 0;
+    };
+
+    struct GaugeValue {
+        std::string name;
+        std::string help;
+        std::string labels;
+        int64_t value = 0;
+    };
+
+    struct HistogramValue {
+        std::string name;
+        std::string help;
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+        uint64_t p50 = 0;
+        uint64_t p90 = 0;
+        uint64_t p99 = 0;
+        uint64_t p999 = 0;
+    };
+
+    uint64_t timestamp_us = 0;  // steady_time_us() when taken
+    std::vector<CounterValue> counters;
+    std::vector<GaugeValue> gauges;
+    std::vector<HistogramValue> histograms;
+
+    // Lookup by name (nullptr if not registered)
+    [[nodiscard]] const CounterValue* counter(std::string_view name) const noexcept;
+    [[nodiscard]] const GaugeValue* gauge(std::string_view name, std::string_view labels = {}) const noexcept;
+    [[nodiscard]] const HistogramValue* histogram(std::string_view name) const noexcept;
+
+    /**
+     * Prometheus text exposition format (histograms as summaries)
+     */
+    [[nodiscard]] std::string to_prometheus() const;
+
+    /**
+     * Single JSON object keyed by metric name (name{labels} for labelled gauges)
+     */
+    [[nodiscard]] std::string to_json() const;
+};
+
+/**
+ * MetricsRegistry - Owns all metrics of a process
+ *
+ * Thread Safety: Registration and snapshot() take a lock; recording
+ * through the returned references is lock-free and RT-safe.
+ */
+class MetricsRegistry {
+public:
+    MetricsRegistry() = default;
+
+    // Disable copy
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /**
+     * Process-wide registry used by the voice pipeline
+     */
+    static MetricsRegistry& global();
+
+    /**
+     * Get or create a metric (names should be unique across kinds)
+     */
+    Counter& counter(std::string_view name, std::string_view help);
+    Gauge& gauge(std::string_view name, std::string_view help, std::string_view labels = {});
+    Histogram& histogram(std::string_view name, std::string_view help);
+
+    [[nodiscard]] MetricsSnapshot snapshot() const;
+
+    /**
+     * Zero all counters and histograms (registrations are kept)
+     */
+    void reset();
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Counter>> counters_;
+    std::vector<std::unique_ptr<Gauge>> gauges_;
+    std::vector<std::unique_ptr<Histogram>> histograms_;
+};
+
+} // namespace voip
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "common/result.h"
+#include "common/metrics.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace voip {
+
+/**
+ * RtThread - Periodic worker thread with real-time priority
+ *
+ * Calls a tick function on a fixed cadence. Deadlines are absolute
+ * (start + n * period), so time spent in the tick never accumulates as
+ * drift; a tick that wakes more than a whole period late skips the missed
+ * deadlines instead of running them back to back.
+ *
+ * Priority is raised where the OS permits: SCHED_FIFO through
+ * pthread_setschedparam on Linux (needs CAP_SYS_NICE or an rtprio limit),
+ * MMCSS "Pro Audio" on Windows, the time-constraint policy on macOS.
+ * When refused, the thread runs at normal priority and Stats::realtime
+ * says so. The thread can also be pinned to one core.
+ *
+ * Scheduling lateness (wake-up minus deadline) of every tick goes to the
+ * voip_worker_lateness_us histogram and to get_stats().
+ *
+ * Thread Safety: start()/stop() from one control thread; get_stats() from any.
+ */
+class RtThread {
+public:
+    struct Config {
+        const char* name = "voice worker";  // Thread name (string literal)
+        uint32_t period_us = 20000;
+        bool realtime = true;  // Request real-time priority
+        int cpu = -1;          // Pin to this core (-1 = let the OS choose)
+    };
+
+    struct Stats {
+        uint64_t ticks = 0;
+        uint64_t missed_ticks = 0;     // Deadlines skipped after a late wake-up
+        uint32_t lateness_p50_us = 0;  // Last ~1s window
+        uint32_t lateness_p99_us = 0;
+        uint32_t lateness_max_us = 0;
+        bool realtime = false;         // Real-time priority granted
+        bool pinned = false;           // Pinned to Config::cpu
+    };
+
+    using Tick = std::function<void()>;
+
+    RtThread();
+    ~RtThread();
+
+    // Disable copy
+    RtThread(const RtThread&) = delete;
+    RtThread& operator=(const RtThread&) = delete;
+
+    /**
+     * Start calling tick every period (first call one period from now)
+     */
+    Result<void> start(const Config& config, Tick tick);
+
+    /**
+     * Stop and join (waits for a running tick to finish)
+     */
+    void stop();
+
+    [[nodiscard]] bool running() const noexcept { return thread_.joinable(); }
+
+    [[nodiscard]] Stats get_stats() const;
+
+private:
+    void run();
+
+    // Raise priority / pin the calling thread; results go to realtime_/pinned_
+    void apply_scheduling();
+
+    Config config_;
+    Tick tick_;
+    std::thread thread_;
+
+    std::mutex mutex_;  // Guards stopping_ (wake-up for stop())
+    std::condition_variable wake_;
+    bool stopping_ = false;
+
+    std::atomic<uint64_t> ticks_{0};
+    std::atomic<uint64_t> missed_ticks_{0};
+    std::atomic<uint32_t> lateness_p50_us_{0};
+    std::atomic<uint32_t> lateness_p99_us_{0};
+    std::atomic<uint32_t> lateness_max_us_{0};
+    std::atomic<bool> realtime_{false};
+    std::atomic<bool> pinned_{false};
+    void* mmcss_task_ = nullptr;  // Windows MMCSS registration, reverted on exit
+
+    // Process-wide metrics (shared by every worker)
+    Histogram& lateness_metric_;
+    Counter& missed_ticks_metric_;
+};
+
+} // namespace voip
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace voip {
+
+/**
+ * Callback stage tracing
+ *
+ * VOIP_TRACE_SCOPE("encode");
+ *
+ * When enabled, every scope records its start and duration into a
+ * flight-recorder ring owned by the calling thread (the oldest events are
+ * overwritten). Audio xruns and deadline misses are marked with
+ * Tracer::mark_xrun(); a background thread then writes the events around
+ * the xrun as Chrome trace-event JSON (chrome://tracing, Perfetto), so the
+ * stage that blew the deadline is visible.
+ *
+ * Disabled, a scope costs one relaxed atomic load. Enabled, recording is
+ * RT-safe: no locks and no allocation (the first scope on a new thread
+ * claims a ring from a pool allocated by enable()).
+ */
+class Tracer {
+public:
+    struct Config {
+        std::string output_dir = ".";     // Where xrun-<n>.json files go
+        uint32_t window_before_ms = 250;  // Trace kept before an xrun
+        uint32_t window_after_ms = 50;    // ... and after it
+        uint32_t max_dumps = 20;          // Stop dumping after this many attempts
+    };
+
+    /**
+     * Start recording (allocates the rings once, starts the dump thread)
+     */
+    static void enable(const Config& config);
+
+    /**
+     * Stop recording and dumping (recorded events are kept)
+     */
+    static void disable();
+
+    // RT-SAFE
+    static bool enabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * Record a completed stage (stage must be a string literal)
+     * RT-SAFE
+     */
+    static void record(const char* stage, uint64_t start_us, uint64_t end_us) noexcept;
+
+    /**
+     * Mark an xrun or deadline miss now and schedule a dump around it
+     * RT-SAFE
+     */
+    static void mark_xrun(const char* reason) noexcept;
+
+    /**
+     * Label the calling thread in dumps (string literal)
+     * RT-SAFE
+     */
+    static void set_thread_name(const char* name) noexcept;
+
+    /**
+     * Chrome trace-event JSON of everything recorded in [from_us, to_us]
+     * (steady_time_us() clock)
+     */
+    static std::string to_chrome_json(uint64_t from_us, uint64_t to_us);
+
+    /**
+     * Xrun dump files written since enable()
+     */
+    static uint32_t dumps_written() noexcept;
+
+    /**
+     * Xrun dumps that could not be written since enable()
+     */
+    static uint32_t dump_failures() noexcept;
+
+private:
+    static inline std::atomic<bool> enabled_{false};
+};
+
+/**
+ * RAII stage timer used by VOIP_TRACE_SCOPE
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* stage) noexcept;
+    ~TraceScope() noexcept { end(); }
+
+    /**
+     * Record the stage now instead of at scope exit
+     */
+    void end() noexcept;
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* stage_;
+    uint64_t start_us_;
+};
+
+} // namespace voip
+
+#define VOIP_TRACE_CONCAT_INNER(a, b) a##b
+#define VOIP_TRACE_CONCAT(a, b) VOIP_TRACE_CONCAT_INNER(a, b)
+#define VOIP_TRACE_SCOPE(stage) ::voip::TraceScope VOIP_TRACE_CONCAT(voip_trace_scope_, __LINE__)(stage)
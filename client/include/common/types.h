@@ -15,19 +15,74 @@ using SequenceNumber = uint64_t;
 using Timestamp = std::chrono::microseconds;
 using DeviceId = int32_t;
 
+constexpr DeviceId NO_DEVICE = -1;  // Backend default device
+
 // Audio configuration
 struct AudioConfig {
     uint32_t sample_rate = 48000;      // Hz
-    uint32_t frame_size = 960;         // samples (20ms @ 48kHz)
+    uint32_t frame_size = 960;         // samples (20ms @ 48kHz; 2.5-60ms allowed)
     uint32_t buffer_frames = 3;        // Total buffering (60ms)
+    uint32_t device_buffer_frames = 0; // Device callback size (0 = device native)
     float input_volume = 1.0f;         // 0.0-2.0
     float output_volume = 0.8f;        // 0.0-2.0
     
     [[nodiscard]] constexpr uint32_t frame_duration_ms() const noexcept {
         return (frame_size * 1000) / sample_rate;
     }
+    
+    [[nodiscard]] constexpr uint32_t frame_duration_us() const noexcept {
+        return static_cast<uint32_t>((static_cast<uint64_t>(frame_size) * 1000000) / sample_rate);
+    }
 };
 
+// Opus frame durations: 2.5, 5, 10, 20, 40 or 60 ms
+constexpr uint32_t MIN_OPUS_FRAME_DURATION_US = 2500;
+constexpr uint32_t MAX_OPUS_FRAME_DURATION_US = 60000;
+
+// Longest Opus packet (several frames combined by the repacketizer)
+constexpr uint32_t MAX_OPUS_PACKET_DURATION_US = 120000;
+
+/**
+ * Check that frame_size samples at sample_rate is a duration Opus can encode
+ */
+[[nodiscard]] constexpr bool is_valid_opus_frame_size(uint32_t sample_rate, uint32_t frame_size) noexcept {
+    if (sample_rate == 0 || (static_cast<uint64_t>(frame_size) * 400) % sample_rate != 0) {
+        return false;
+    }
+    // Duration in units of 2.5ms
+    switch ((static_cast<uint64_t>(frame_size) * 400) / sample_rate) {
+        case 1: case 2: case 4: case 8: case 16: case 24:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Samples per frame for a frame duration (e.g. 10000us @ 48kHz = 480)
+ */
+[[nodiscard]] constexpr uint32_t frame_size_for_duration_us(uint32_t sample_rate, uint32_t duration_us) noexcept {
+    return static_cast<uint32_t>((static_cast<uint64_t>(sample_rate) * duration_us) / 1000000);
+}
+
+/**
+ * Frame duration in microseconds (e.g. 960 samples @ 48kHz = 20000us)
+ */
+[[nodiscard]] constexpr uint32_t frame_duration_us(uint32_t sample_rate, uint32_t frame_size) noexcept {
+    return sample_rate == 0 ? 0 :
+        static_cast<uint32_t>((static_cast<uint64_t>(frame_size) * 1000000) / sample_rate);
+}
+
+/**
+ * Steady-clock time in microseconds
+ * Clock of VoicePacketHeader::timestamp and of device capture/playout times
+ */
+[[nodiscard]] inline uint64_t steady_time_us() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count());
+}
+
 // Audio device information
 struct AudioDevice {
     DeviceId id;
@@ -46,7 +101,11 @@ struct AudioStats {
     uint64_t queue_empty_errors = 0;
     float current_input_level = 0.0f;
     float current_output_level = 0.0f;
-    uint32_t estimated_latency_ms = 0;
+    uint32_t estimated_latency_ms = 0;  // Device latencies + engine buffering
+    uint32_t input_latency_us = 0;      // ADC to capture callback (measured)
+    uint32_t output_latency_us = 0;     // Playback callback to DAC (measured)
+    uint32_t capture_sample_rate = 0;  // Device rate (codec rate if no resampling)
+    uint32_t playback_sample_rate = 0;
 };
 
 // Opus codec configuration
@@ -60,13 +119,26 @@ struct OpusConfig {
     uint32_t expected_packet_loss = 5; // Percentage
 };
 
+// Voice socket options. Requested values in configs; the effective values
+// read back from the socket in stats (-1 = unsupported or refused).
+struct SocketOptions {
+    int dscp = 46;                       // Traffic class (46 = EF), -1 = leave unmarked
+    int priority = 6;                    // SO_PRIORITY, Linux (6 = interactive), -1 = leave
+    int receive_buffer_bytes = 65536;    // SO_RCVBUF, 0 = system default
+    int send_buffer_bytes = 32768;       // SO_SNDBUF, 0 = system default (small: no queueing)
+    int busy_poll_us = 0;                // SO_BUSY_POLL, Linux, 0 = off (raising needs CAP_NET_ADMIN)
+    bool udp_gro = false;                // UDP_GRO, Linux: coalesced receives, split on read
+    bool receive_timestamps = true;      // SO_TIMESTAMPNS, Linux: kernel arrival times for jitter
+};
+
 // Network configuration
 struct NetworkConfig {
     std::string server_address;
     uint16_t control_port = 9000;
     uint16_t voice_port = 9001;
     uint32_t connect_timeout_ms = 5000;
-    uint32_t keepalive_interval_ms = 30000;
+    uint32_t keepalive_interval_ms = 1000;  // UDP keepalive / RTT probe period
+    SocketOptions voice_socket;             // QoS marking and buffer sizes
 };
 
 // Voice packet header - MUST match server's packed layout exactly!
@@ -83,6 +155,12 @@ struct VoicePacketHeader {
 
 constexpr uint32_t VOICE_PACKET_MAGIC = 0x564F4950; // 'VOIP'
 constexpr size_t VOICE_PACKET_HEADER_SIZE = 28;
+
+// Voice-plane keepalive: magic, sequence (u32), send time (u64 us), user ID
+// (u32), big-endian. The server returns it unchanged apart from the magic.
+constexpr uint32_t KEEPALIVE_MAGIC = 0x56504B41;      // 'VPKA'
+constexpr uint32_t KEEPALIVE_ECHO_MAGIC = 0x56504B45; // 'VPKE'
+constexpr size_t KEEPALIVE_PACKET_SIZE = 20;
 constexpr size_t AES_GCM_NONCE_SIZE = 12;
 constexpr size_t AES_GCM_TAG_SIZE = 16;
 
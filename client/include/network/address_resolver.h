@@ -0,0 +1,56 @@
+#pragma once
+
+#include "common/result.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
+
+namespace voip::network {
+
+/**
+ * A resolved server address (IPv4 or IPv6)
+ */
+struct Endpoint {
+    sockaddr_storage address{};
+    socklen_t length = 0;
+
+    [[nodiscard]] int family() const noexcept { return address.ss_family; }
+    [[nodiscard]] const sockaddr* sockaddr_ptr() const noexcept {
+        return reinterpret_cast<const sockaddr*>(&address);
+    }
+
+    // "1.2.3.4:9001" or "[2001:db8::1]:9001"
+    [[nodiscard]] std::string to_string() const;
+};
+
+/**
+ * Parse an IPv4 or IPv6 literal ("10.0.0.1", "::1", "[::1]") without
+ * touching DNS. Fails for hostnames.
+ */
+Result<Endpoint> parse_numeric_endpoint(const std::string& host, uint16_t port);
+
+/**
+ * Resolve a hostname to all of its UDP endpoints (getaddrinfo)
+ *
+ * Blocks for as long as the system resolver takes - call it off the UI
+ * thread. Results come back in Happy Eyeballs order (RFC 8305): the
+ * resolver's first family leads and families alternate after it, so the
+ * first few candidates cover both IPv6 and IPv4.
+ */
+Result<std::vector<Endpoint>> resolve_endpoints(const std::string& host, uint16_t port);
+
+/**
+ * Reorder endpoints so address families alternate, keeping the order
+ * within each family and starting with the family of the first endpoint
+ */
+std::vector<Endpoint> interleave_families(const std::vector<Endpoint>& endpoints);
+
+} // namespace voip::network
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "common/result.h"
+#include "network/network_impairment.h"
+#include "network/udp_socket.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace voip::network {
+
+/**
+ * ImpairmentRelay - Local UDP relay that impairs voice traffic
+ *
+ * Clients point their voice port at the relay instead of the server; the
+ * relay forwards each datagram through an impaired path per direction.
+ * Works with unmodified clients and servers. The relay serves one client:
+ * replies go to whoever sent the last upstream datagram.
+ *
+ * Thread Safety: get_stats() from any thread.
+ */
+class ImpairmentRelay {
+public:
+    struct Config {
+        uint16_t listen_port = 0;                 // 0 = any free port (see port())
+        std::string server_address = "127.0.0.1";
+        uint16_t server_port = 9001;
+        ImpairmentConfig upstream;                // Client -> server
+        ImpairmentConfig downstream;              // Server -> client
+    };
+
+    struct Stats {
+        ImpairmentStats upstream;
+        ImpairmentStats downstream;
+    };
+
+    /**
+     * Bind the listening port and start relaying
+     */
+    static Result<std::unique_ptr<ImpairmentRelay>> start(const Config& config);
+
+    ~ImpairmentRelay();
+
+    // Disable copy
+    ImpairmentRelay(const ImpairmentRelay&) = delete;
+    ImpairmentRelay& operator=(const ImpairmentRelay&) = delete;
+
+    /**
+     * Stop relaying and close the sockets
+     */
+    void stop();
+
+    /**
+     * Port clients should send to
+     */
+    [[nodiscard]] uint16_t port() const noexcept { return port_; }
+
+    [[nodiscard]] Stats get_stats() const;
+
+private:
+    ImpairmentRelay() = default;
+
+    // Receive loops, one per socket
+    void client_loop();
+    void server_loop();
+
+    SocketType client_socket_ = INVALID_SOCKET;  // Bound to the listening port
+    SocketType server_socket_ = INVALID_SOCKET;  // Ephemeral port facing the server
+    sockaddr_in server_addr_{};
+    uint16_t port_ = 0;
+
+    std::mutex client_mutex_;  // Guards client_addr_
+    sockaddr_in client_addr_{};
+    bool have_client_ = false;
+
+    std::unique_ptr<ImpairedLink> upstream_;
+    std::unique_ptr<ImpairedLink> downstream_;
+
+    std::atomic<bool> running_{false};
+    std::thread client_thread_;
+    std::thread server_thread_;
+};
+
+} // namespace voip::network
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace voip::network {
+
+/**
+ * LinkMonitor - Keepalive probe scheduling and round-trip measurement
+ *
+ * Decides when the next voice-plane keepalive is due and matches the
+ * server's echoes against outstanding probes:
+ * - RTT: smoothed and variance per RFC 6298, plus minimum and last sample
+ * - Loss: probes without an echo within the timeout, over the last
+ *   LOSS_WINDOW probes (round trip: upstream and downstream combined)
+ *
+ * Probes go out every interval whether or not voice is flowing, which also
+ * keeps NAT bindings open through long silences. Pure computation on
+ * caller-supplied timestamps.
+ *
+ * Thread Safety: Not thread-safe.
+ */
+class LinkMonitor {
+public:
+    struct Config {
+        uint32_t interval_ms = 1000;  // Probe period
+        uint32_t timeout_ms = 2000;   // No echo after this = lost
+    };
+
+    struct Stats {
+        uint64_t probes_sent = 0;
+        uint64_t echoes_received = 0;
+        uint64_t probes_lost = 0;
+        uint64_t stray_echoes = 0;    // Duplicate, unknown or after being counted lost
+        float rtt_ms = 0.0f;          // Smoothed (0 = no sample yet)
+        float rtt_var_ms = 0.0f;
+        float min_rtt_ms = 0.0f;
+        float last_rtt_ms = 0.0f;
+        float loss_fraction = 0.0f;   // Round trip, last LOSS_WINDOW probes
+    };
+
+    static constexpr size_t LOSS_WINDOW = 32;
+
+    explicit LinkMonitor(const Config& config);
+
+    /**
+     * Expire overdue probes and, if one is due, register it as sent at
+     * `now_us` and return its sequence number
+     */
+    std::optional<uint32_t> poll(uint64_t now_us);
+
+    /**
+     * Record an echo received at `now_us`
+     * Returns false for echoes that match no outstanding probe
+     */
+    bool on_echo(uint32_t sequence, uint64_t now_us);
+
+    /**
+     * Upstream loss estimate, assuming both directions lose alike
+     */
+    [[nodiscard]] float one_way_loss() const noexcept;
+
+    [[nodiscard]] const Stats& stats() const noexcept { return stats_; }
+
+private:
+    struct Probe {
+        uint32_t sequence = 0;
+        uint64_t sent_at_us = 0;
+        bool outstanding = false;
+    };
+
+    // Outstanding probes by sequence (more than enough for timeout / interval)
+    static constexpr size_t MAX_OUTSTANDING = 64;
+
+    void record_outcome(bool lost);
+    void record_rtt(float rtt_ms);
+
+    Config config_;
+    std::array<Probe, MAX_OUTSTANDING> probes_{};
+    std::array<bool, LOSS_WINDOW> outcomes_{};  // true = lost
+    size_t outcome_count_ = 0;
+    size_t outcome_pos_ = 0;
+    uint32_t next_sequence_ = 0;
+    std::optional<uint64_t> next_probe_at_us_;
+    Stats stats_;
+};
+
+} // namespace voip::network
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "common/types.h"
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace voip::network {
+
+/**
+ * Packet loss model
+ */
+enum class LossModel : uint8_t {
+    None,
+    Bernoulli,       // Independent loss with probability loss_rate
+    GilbertElliott   // Two-state Markov chain: bursty loss
+};
+
+/**
+ * Distribution of the random delay added on top of the base delay
+ */
+enum class DelayDistribution : uint8_t {
+    Uniform,  // U[0, 2 * jitter_ms]
+    Normal,   // |N(0, jitter_ms)|
+    Pareto    // Heavy tail (alpha 2.5) with mean jitter_ms: rare long stalls
+};
+
+/**
+ * ImpairmentConfig - What a simulated network path does to datagrams
+ *
+ * Stages run in the order a real path applies them: the bottleneck queue
+ * (bandwidth cap, tail drop), random loss, propagation delay and jitter,
+ * reordering, duplication. Every random choice derives from `seed`, so a
+ * configuration replays identically, and each stage has its own stream:
+ * the same seed loses the same packets whatever the delay settings.
+ */
+struct ImpairmentConfig {
+    uint64_t seed = 1;
+
+    // Loss
+    LossModel loss_model = LossModel::None;
+    float loss_rate = 0.0f;        // Bernoulli loss probability
+    float p_good_to_bad = 0.0f;    // Gilbert-Elliott transition probabilities (per packet)
+    float p_bad_to_good = 1.0f;
+    float loss_good = 0.0f;        // Loss probability in each state
+    float loss_bad = 1.0f;
+
+    // Delay
+    uint32_t delay_ms = 0;         // Fixed one-way delay
+    uint32_t jitter_ms = 0;        // Scale of the random extra delay
+    DelayDistribution jitter_distribution = DelayDistribution::Uniform;
+    bool preserve_order = true;    // Jitter never lets a packet overtake its predecessor (FIFO link)
+
+    // Reordering: hold a packet back so the ones behind it overtake
+    float reorder_rate = 0.0f;
+    uint32_t reorder_delay_ms = 30;
+
+    float duplicate_rate = 0.0f;
+
+    // Bottleneck: serialization at bandwidth_kbps, tail drop beyond queue_limit_ms of backlog
+    uint32_t bandwidth_kbps = 0;   // 0 = unlimited
+    uint32_t queue_limit_ms = 200;
+
+    /**
+     * Gilbert-Elliott chain with the given average loss and mean burst
+     * length (in packets); every packet in the bad state is lost
+     */
+    static ImpairmentConfig gilbert_elliott(float loss_rate, float mean_burst, uint64_t seed = 1);
+
+    /**
+     * True if the configuration changes anything
+     */
+    [[nodiscard]] bool active() const noexcept;
+};
+
+/**
+ * Impairment statistics
+ */
+struct ImpairmentStats {
+    uint64_t packets = 0;          // Datagrams offered
+    uint64_t delivered = 0;        // Copies scheduled for delivery (duplicates included)
+    uint64_t lost = 0;             // Dropped by the loss model
+    uint64_t queue_drops = 0;      // Tail-dropped at the bandwidth bottleneck
+    uint64_t reordered = 0;        // Held back for reordering
+    uint64_t duplicated = 0;
+    uint64_t bytes = 0;
+};
+
+/**
+ * ImpairmentModel - Deterministic per-packet impairment decisions
+ *
+ * Pure computation on caller-supplied timestamps, so tests can run it in
+ * virtual time; ImpairedLink drives it from the wall clock.
+ *
+ * Thread Safety: Not thread-safe.
+ */
+class ImpairmentModel {
+public:
+    /**
+     * Delivery times for one offered datagram (0, 1 or 2 copies)
+     */
+    struct Verdict {
+        uint32_t copies = 0;
+        std::array<uint64_t, 2> deliver_at_us{};
+    };
+
+    explicit ImpairmentModel(const ImpairmentConfig& config);
+
+    /**
+     * Decide the fate of a datagram of `bytes` offered at `now_us`
+     * Offer times must not go backwards
+     */
+    Verdict process(size_t bytes, uint64_t now_us);
+
+    /**
+     * Restart the random sequence and link state from the configured seed
+     */
+    void reset();
+
+    [[nodiscard]] const ImpairmentConfig& config() const noexcept { return config_; }
+    [[nodiscard]] const ImpairmentStats& stats() const noexcept { return stats_; }
+
+private:
+    bool lose_packet();
+    uint64_t jitter_us();
+
+    ImpairmentConfig config_;
+    std::mt19937_64 loss_rng_;
+    std::mt19937_64 delay_rng_;
+    std::mt19937_64 reorder_rng_;
+    std::mt19937_64 duplicate_rng_;
+    std::uniform_real_distribution<double> unit_{0.0, 1.0};
+
+    bool bad_state_ = false;        // Gilbert-Elliott state
+    uint64_t link_free_at_us_ = 0;  // Bottleneck busy until
+    uint64_t last_delivery_us_ = 0; // For preserve_order
+
+    ImpairmentStats stats_;
+};
+
+/**
+ * ImpairedLink - Applies an ImpairmentModel to live traffic
+ *
+ * send() decides each datagram's fate immediately; surviving copies wait
+ * on a delay line and are handed to the delivery callback at their
+ * scheduled time, from the link's own thread.
+ *
+ * Thread Safety: send() and get_stats() from any thread.
+ */
+class ImpairedLink {
+public:
+    using Deliver = std::function<void(const uint8_t* data, size_t size)>;
+
+    ImpairedLink(const ImpairmentConfig& config, Deliver deliver);
+    ~ImpairedLink();
+
+    // Disable copy
+    ImpairedLink(const ImpairedLink&) = delete;
+    ImpairedLink& operator=(const ImpairedLink&) = delete;
+
+    /**
+     * Offer a datagram to the link
+     */
+    void send(const uint8_t* data, size_t size);
+
+    /**
+     * Stop the delay line; datagrams still in flight are discarded
+     */
+    void stop();
+
+    [[nodiscard]] ImpairmentStats get_stats() const;
+
+private:
+    struct InFlight {
+        uint64_t deliver_at_us;
+        uint64_t order;  // Tie-break: equal times leave in offer order
+        std::vector<uint8_t> data;
+
+        bool operator>(const InFlight& other) const {
+            return deliver_at_us != other.deliver_at_us ? deliver_at_us > other.deliver_at_us
+                                                        : order > other.order;
+        }
+    };
+
+    void run();
+
+    Deliver deliver_;
+
+    mutable std::mutex mutex_;  // Guards everything below
+    std::condition_variable wake_;
+    ImpairmentModel model_;
+    std::priority_queue<InFlight, std::vector<InFlight>, std::greater<InFlight>> in_flight_;
+    uint64_t next_order_ = 0;
+    bool stopping_ = false;
+
+    std::thread thread_;
+};
+
+} // namespace voip::network
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "common/types.h"
+#include "common/metrics.h"
+#include "common/latency_histogram.h"
+#include "common/lock_free_queue.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+namespace voip::network {
+
+/**
+ * Traffic class of an outgoing datagram
+ */
+enum class SendPriority : uint8_t {
+    Voice,    // Audio frames: sent before anything else
+    Control   // Presence, keepalives: paced, only when no voice is waiting
+};
+
+struct SendSchedulerConfig {
+    // Queue limits in datagrams; a full queue drops its oldest entry
+    size_t voice_queue_limit = 256;
+    size_t control_queue_limit = 32;
+
+    // Under congestion (the socket not keeping up) voice that has waited
+    // this long is dropped, oldest first: late audio is worth less than
+    // the frames behind it
+    uint32_t voice_max_age_us = 200000;
+
+    // Control datagrams leave at most once per interval, so a burst of them
+    // occupies the socket for one send at a time
+    uint32_t control_interval_us = 2000;
+};
+
+/**
+ * Counters and queueing delay (time from enqueue() to the send)
+ */
+struct SendSchedulerStats {
+    uint64_t voice_sent = 0;
+    uint64_t control_sent = 0;
+    uint64_t voice_dropped = 0;
+    uint64_t control_dropped = 0;
+    uint32_t voice_delay_p50_us = 0;
+    uint32_t voice_delay_p99_us = 0;
+    uint32_t voice_delay_max_us = 0;
+    uint32_t control_delay_p50_us = 0;
+    uint32_t control_delay_p99_us = 0;
+    uint32_t control_delay_max_us = 0;
+};
+
+/**
+ * SendScheduler - Puts outgoing datagrams on the wire from its own thread
+ *
+ * Callers only queue, so a slow or blocking send never stalls the voice
+ * worker. Voice is strict priority: the thread takes control traffic only
+ * when no voice is waiting, so a control burst delays a voice frame by at
+ * most the one send already in progress.
+ *
+ * enqueue() hands datagrams over through a lock-free inbox per traffic
+ * class and never takes the mutex the send thread shares with
+ * get_stats(), so the voice worker neither blocks behind a stats reader
+ * nor allocates. The send thread moves the inboxes into its own queues,
+ * where the limits and the age rule apply.
+ *
+ * Thread Safety: voice enqueue() from one thread at a time (the voice
+ * worker); control enqueue(), stop() and get_stats() from any thread.
+ */
+class SendScheduler {
+public:
+    using Transmit = std::function<void(const uint8_t* data, size_t size)>;
+
+    SendScheduler(const SendSchedulerConfig& config, Transmit transmit);
+    ~SendScheduler();
+
+    // Disable copy
+    SendScheduler(const SendScheduler&) = delete;
+    SendScheduler& operator=(const SendScheduler&) = delete;
+
+    /**
+     * Queue a datagram; returns false once stopped
+     *
+     * RT-SAFE for voice: no lock, no allocation. Control enqueues from
+     * several threads are serialized among themselves only.
+     */
+    bool enqueue(SendPriority priority, std::vector<uint8_t> data);
+
+    /**
+     * Stop the thread; queued datagrams are discarded
+     */
+    void stop();
+
+    [[nodiscard]] SendSchedulerStats get_stats() const;
+
+private:
+    struct Queued {
+        std::vector<uint8_t> data;
+        uint64_t enqueued_us = 0;
+    };
+
+    void run();
+
+    // Send thread: move what producers handed over into the queues
+    // (caller holds mutex_)
+    void drain_inboxes();
+
+    // Wake the send thread / sleep until woken or the timeout passes
+    void wake() noexcept;
+    void wait_for_work(std::optional<uint64_t> timeout_us);
+
+    SendSchedulerConfig config_;
+    Transmit transmit_;
+
+    // Producer side. Inboxes hold twice a queue's limit, so the drop-oldest
+    // rule applies unless the send thread is stuck in one send for that
+    // long; past that, new datagrams are refused and counted as drops.
+    LockFreeQueue<Queued> voice_inbox_;
+    LockFreeQueue<Queued> control_inbox_;
+    std::mutex control_producers_mutex_;  // Control comes from several threads; never taken by the send thread
+    std::atomic<uint64_t> voice_refused_{0};
+    std::atomic<uint64_t> control_refused_{0};
+    std::atomic<bool> stopping_{false};
+    std::binary_semaphore wake_{0};
+    std::atomic<bool> wake_pending_{false};  // wake_ released and not yet taken
+
+    // Send thread side
+    mutable std::mutex mutex_;  // Guards everything below (send thread and get_stats())
+    std::deque<Queued> voice_;
+    std::deque<Queued> control_;
+    uint64_t next_control_us_ = 0;  // Pacing: earliest next control send
+
+    SendSchedulerStats stats_;
+    LatencyHistogram voice_delay_;
+    LatencyHistogram control_delay_;
+
+    // Process-wide metrics (shared by every scheduler)
+    Histogram& voice_delay_metric_;
+    Histogram& control_delay_metric_;
+    Counter& drop_metric_;
+
+    std::thread thread_;
+};
+
+} // namespace voip::network
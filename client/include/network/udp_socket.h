@@ -2,11 +2,17 @@
 
 #include "common/types.h"
 #include "common/result.h"
+#include "common/metrics.h"
+#include "network/network_impairment.h"
+#include "network/address_resolver.h"
+#include "network/send_scheduler.h"
 #include <string>
 #include <functional>
 #include <atomic>
 #include <thread>
 #include <memory>
+#include <optional>
+#include <vector>
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -28,18 +34,37 @@ namespace voip::network {
 // Forward declaration
 struct VoicePacket;
 
+struct KeepalivePacket;
+
+// Header format negotiation (network/voice_header.h)
+class VoiceHeaderCodec;
+struct VoiceAliases;
+
 /**
  * Callback for received voice packets
  * Called from network thread - must be thread-safe!
  */
 using PacketReceivedCallback = std::function<void(const VoicePacket& packet)>;
 
+/**
+ * Callback for keepalive echoes from the server
+ * Called from network thread - must be thread-safe!
+ */
+using KeepaliveEchoCallback = std::function<void(const KeepalivePacket& echo)>;
+
+/**
+ * Callback for the outcome of connect()
+ * Called from the connecting thread for hostnames, inline for IP literals
+ */
+using ConnectCallback = std::function<void(const Result<void>& result)>;
+
 /**
  * Voice packet structure for network transmission
  */
 struct VoicePacket {
     VoicePacketHeader header;
     std::vector<uint8_t> encrypted_payload;
+    uint64_t received_at_us = 0;  // Local arrival on the steady_time_us() clock (not on the wire)
     
     // Serialize to bytes for network transmission
     std::vector<uint8_t> serialize() const;
@@ -48,6 +73,22 @@ struct VoicePacket {
     static Result<VoicePacket> deserialize(const uint8_t* data, size_t length);
 };
 
+/**
+ * Voice-plane keepalive probe (client -> server) or its echo (server -> client)
+ * Keeps the NAT binding and the server's address mapping fresh and measures
+ * the UDP round trip; see network::LinkMonitor.
+ */
+struct KeepalivePacket {
+    uint32_t sequence = 0;
+    uint64_t sent_at_us = 0;  // Client clock, returned as is
+    UserId user_id = 0;
+    bool echo = false;
+    uint64_t received_at_us = 0;  // Local arrival, as VoicePacket::received_at_us
+    
+    std::vector<uint8_t> serialize() const;
+    static Result<KeepalivePacket> deserialize(const uint8_t* data, size_t length);
+};
+
 /**
  * UdpVoiceSocket - Handles UDP voice packet transmission
  * 
@@ -70,11 +111,23 @@ public:
     
     /**
      * Connect to server
-     * @param server_address Server IP or hostname
+     * @param server_address Server IP (v4 or v6) or hostname
      * @param port UDP port (typically 9001)
+     *
+     * IP literals connect immediately. Hostnames return at once and finish
+     * on a background thread: resolve, then race one keepalive probe per
+     * candidate address (IPv6 and IPv4 interleaved) and keep the path whose
+     * echo came back fastest. Until then is_connected() is false and sends
+     * fail; the connect callback reports the outcome.
      */
     Result<void> connect(const std::string& server_address, uint16_t port);
     
+    /**
+     * Connect to whichever of the given server addresses answers fastest
+     * Returns at once; finishes in the background like a hostname connect().
+     */
+    Result<void> connect(const std::vector<Endpoint>& candidates);
+    
     /**
      * Disconnect from server
      */
@@ -82,9 +135,16 @@ public:
     
     /**
      * Send voice packet to server
-     * Non-blocking, queues packet for transmission
+     * Non-blocking, queues packet for transmission on the send thread.
+     * Presence packets go as SendPriority::Control so they never hold up
+     * voice. Send errors show up in get_stats(), not here.
      */
-    Result<void> send_packet(const VoicePacket& packet);
+    Result<void> send_packet(const VoicePacket& packet, SendPriority priority = SendPriority::Voice);
+    
+    /**
+     * Send a keepalive probe to the server (queued as control traffic)
+     */
+    Result<void> send_keepalive(const KeepalivePacket& probe);
     
     /**
      * Set callback for received packets
@@ -92,11 +152,54 @@ public:
      */
     void set_receive_callback(PacketReceivedCallback callback);
     
+    /**
+     * Set callback for the connect() outcome (set before connect())
+     */
+    void set_connect_callback(ConnectCallback callback);
+    
+    /**
+     * Set callback for keepalive echoes
+     * Called from network thread - must be thread-safe!
+     */
+    void set_keepalive_callback(KeepaliveEchoCallback callback);
+    
+    /**
+     * Set QoS marking and buffer sizes for the voice socket
+     * Must be called before connect(); see SocketOptions for defaults
+     */
+    void set_socket_options(const SocketOptions& options);
+    
+    /**
+     * Install the server's voice aliases: packets whose user and channel
+     * have one go out with the compact header (see voice_header.h).
+     * Both formats are always accepted on receive.
+     */
+    void set_voice_aliases(const VoiceAliases& aliases);
+    
+    /**
+     * Route traffic through simulated network paths (testing)
+     * Must be called before connect(); inactive configs leave that
+     * direction untouched. Impaired packets are received on the link's
+     * delay-line thread instead of the receive thread.
+     */
+    void set_impairment(const ImpairmentConfig& outgoing, const ImpairmentConfig& incoming);
+    
+    /**
+     * Statistics of the simulated paths (zero when not impaired)
+     */
+    [[nodiscard]] ImpairmentStats outgoing_impairment_stats() const;
+    [[nodiscard]] ImpairmentStats incoming_impairment_stats() const;
+    
     /**
      * Check if connected
      */
     [[nodiscard]] bool is_connected() const noexcept;
     
+    /**
+     * Server address in use (empty until connected)
+     */
+    [[nodiscard]] std::string server_endpoint() const;
+    
     /**
      * Get statistics
      */
@@ -107,6 +210,8 @@ public:
         uint64_t receive_errors = 0;
         uint64_t bytes_sent = 0;
         uint64_t bytes_received = 0;
+        std::optional<SocketOptions> effective_options;  // Read back from the socket once connected
+        SendSchedulerStats send_queue;                   // Priority queue in front of the socket
     };
     
     [[nodiscard]] Stats get_stats() const;
@@ -116,22 +221,75 @@ private:
     static bool initialize_winsock();
     static void cleanup_winsock();
     
+    // UDP socket for an address family with a short receive timeout and
+    // the configured options applied (INVALID_SOCKET on failure)
+    SocketType open_socket(int family) const;
+    static void close_socket(SocketType socket);
+    
+    // Resolve (runs in connect thread), then race the results
+    void connect_hostname(const std::string& host, uint16_t port);
+    void connect_fastest(std::vector<Endpoint> candidates);
+    
+    // Probe every candidate at once; returns the index of the fastest echo
+    // (the first open socket when none answers)
+    size_t race_paths(const std::vector<Endpoint>& candidates, const std::vector<SocketType>& sockets);
+    
+    // Adopt a socket and server address, then start receiving
+    void attach(SocketType socket, const Endpoint& server);
+    
+    // Report the connect() outcome
+    void notify_connect(const Result<void>& result);
+    
     // Receive loop (runs in background thread)
     void receive_loop();
     
+    // Hand a received datagram on (through the simulated path if any)
+    void deliver(const uint8_t* data, size_t size, uint64_t arrival_us);
+    
+    // Hand a serialized packet to the send thread
+    Result<void> enqueue(SendPriority priority, std::vector<uint8_t> data);
+    
+    // Put a serialized packet on the wire
+    Result<void> transmit(const uint8_t* data, size_t size);
+    
+    // Parse a received datagram and hand it to the callback
+    void handle_datagram(const uint8_t* data, size_t size, uint64_t arrival_us);
+    
     // Socket handle
     SocketType socket_ = INVALID_SOCKET;
     
     // Server address
-    sockaddr_in server_addr_{};
-    bool connected_ = false;
+    Endpoint server_endpoint_;
+    std::atomic<bool> connected_{false};
+    
+    // Socket options: requested, and read back after connecting
+    SocketOptions socket_options_;
+    SocketOptions effective_options_;
+    
+    // Hostname resolution and path race (see connect())
+    std::unique_ptr<std::thread> connect_thread_;
+    std::atomic<bool> connecting_{false};
+    ConnectCallback connect_callback_;
     
     // Receive thread
     std::unique_ptr<std::thread> receive_thread_;
     std::atomic<bool> running_{false};
     
+    // Send thread: voice first, control traffic paced (created in attach())
+    std::unique_ptr<SendScheduler> send_scheduler_;
+    
+    // Legacy or compact header, per packet
+    std::unique_ptr<VoiceHeaderCodec> header_codec_;
+    
     // Callback for received packets
     PacketReceivedCallback receive_callback_;
+    KeepaliveEchoCallback keepalive_callback_;
+    
+    // Optional simulated network paths (created in connect())
+    ImpairmentConfig outgoing_impairment_;
+    ImpairmentConfig incoming_impairment_;
+    std::unique_ptr<ImpairedLink> outgoing_link_;
+    std::unique_ptr<ImpairedLink> incoming_link_;
     
     // Statistics (atomic for thread safety)
     mutable std::atomic<uint64_t> packets_sent_{0};
@@ -140,6 +298,14 @@ private:
     mutable std::atomic<uint64_t> receive_errors_{0};
     mutable std::atomic<uint64_t> bytes_sent_{0};
     mutable std::atomic<uint64_t> bytes_received_{0};
+    
+    // Process-wide metrics (shared by every socket)
+    Counter& packets_sent_metric_;
+    Counter& packets_received_metric_;
+    Counter& bytes_sent_metric_;
+    Counter& bytes_received_metric_;
+    Counter& send_error_metric_;
+    Counter& receive_error_metric_;
 };
 
 } // namespace voip::network
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "common/types.h"
+#include "common/result.h"
+#include "network/udp_socket.h"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace voip::network {
+
+/**
+ * Compact voice header (negotiated as "compact_v1")
+ *
+ * Replaces the 28-byte legacy header with, typically, 9 bytes:
+ *
+ *   version 0xC1 | user alias (varint) | channel alias (varint) |
+ *   sequence low 16 bits (BE) | timestamp low 32 bits (BE, microseconds)
+ *
+ * Aliases are short IDs the server hands out over the control plane.
+ * Sequence and timestamp carry only their low bits; the receiver restores
+ * the rest from the last value seen on the same stream, so losing packets
+ * never desynchronizes it. Parsed byte by byte - no unaligned loads.
+ * Legacy packets start with 'V' (0x56), so the first byte tells them apart.
+ */
+constexpr uint8_t COMPACT_HEADER_VERSION = 0xC1;
+constexpr size_t COMPACT_HEADER_MAX_SIZE = 1 + 3 + 3 + 2 + 4;
+
+struct CompactHeader {
+    uint16_t user_alias = 0;
+    uint16_t channel_alias = 0;
+    uint16_t sequence_lsb = 0;
+    uint32_t timestamp_lsb = 0;
+    size_t size = 0;  // Encoded size, set by parse()
+
+    // Append the encoded header to `out`
+    void write(std::vector<uint8_t>& out) const;
+
+    static Result<CompactHeader> parse(const uint8_t* data, size_t length);
+};
+
+/**
+ * The value ending in `lsb` (its low `bits` bits) closest to `reference`
+ */
+uint64_t extend_lsb(uint64_t reference, uint64_t lsb, unsigned bits) noexcept;
+
+/**
+ * Alias assignments from the server's voice_aliases message
+ */
+struct VoiceAliases {
+    std::vector<std::pair<UserId, uint16_t>> users;
+    std::vector<std::pair<ChannelId, uint16_t>> channels;
+};
+
+/**
+ * VoiceHeaderCodec - Serializes voice packets in the negotiated header format
+ *
+ * Sends the legacy header until aliases are installed, and for any packet
+ * whose user or channel has no alias yet. Receives both formats.
+ *
+ * Thread Safety: All methods are thread-safe
+ */
+class VoiceHeaderCodec {
+public:
+    /**
+     * Install the server's alias table; enables compact sending
+     */
+    void set_aliases(const VoiceAliases& aliases);
+
+    /**
+     * Drop the aliases and go back to the legacy header
+     */
+    void clear_aliases();
+
+    [[nodiscard]] bool compact_enabled() const;
+
+    std::vector<uint8_t> serialize(const VoicePacket& packet) const;
+
+    Result<VoicePacket> deserialize(const uint8_t* data, size_t length);
+
+    /**
+     * Same, at `now_us` on the steady_time_us() clock (tests drive time)
+     */
+    Result<VoicePacket> deserialize(const uint8_t* data, size_t length, uint64_t now_us);
+
+    /**
+     * Compact streams being restored (at most MAX_STREAMS)
+     */
+    [[nodiscard]] size_t stream_count() const;
+
+    // A stream silent this long has its timestamp re-anchored on our clock:
+    // past 2^31 us its low bits no longer say which wrap it is on
+    static constexpr uint64_t STREAM_IDLE_US = 5000000;
+
+    // Streams tracked at once; idle ones, then the longest silent, make room
+    static constexpr size_t MAX_STREAMS = 1024;
+
+private:
+    struct Stream {
+        uint64_t sequence = 0;
+        uint64_t timestamp = 0;
+        uint64_t last_seen_us = 0;
+    };
+
+    Result<VoicePacket> deserialize_compact(const uint8_t* data, size_t length, uint64_t now_us);
+
+    // Make room for one more stream (caller holds mutex_)
+    void evict_streams(uint64_t now_us);
+
+    mutable std::mutex mutex_;
+    bool compact_ = false;
+    std::unordered_map<UserId, uint16_t> user_aliases_;
+    std::unordered_map<uint16_t, UserId> users_by_alias_;
+    std::unordered_map<ChannelId, uint16_t> channel_aliases_;
+    std::unordered_map<uint16_t, ChannelId> channels_by_alias_;
+
+    // Newest restored values per (sender, channel) stream
+    std::map<std::pair<UserId, ChannelId>, Stream> streams_;
+};
+
+} // namespace voip::network
@@ -8,11 +8,14 @@
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <random>
+#include <set>
 
 // Forward declarations for Qt WebSocket
 class QWebSocket;
 class QString;
 class QUrl;
+class QTimer;
 
 namespace voip::network {
 
@@ -29,6 +32,9 @@ using UserLeftCallback = std::function<void(const protocol::UserLeftNotification
 using ErrorCallback = std::function<void(const protocol::ErrorMessage&)>;
 using KeyExchangeInitCallback = std::function<void(const protocol::KeyExchangeInit&)>;
 using AllChannelRostersCallback = std::function<void(const protocol::AllChannelRostersResponse&)>;
+using ReconnectingCallback = std::function<void(uint32_t attempt, uint32_t delay_ms)>;
+using ResumedCallback = std::function<void(const protocol::ResumeResponse&)>;
+using VoiceAliasesCallback = std::function<void(const protocol::VoiceAliasesResponse&)>;
 
 /**
  * WebSocketClient - Handles WebSocket control channel
@@ -39,6 +45,17 @@ using AllChannelRostersCallback = std::function<void(const protocol::AllChannelR
  * - Join/leave channels
  * - Send/receive control messages
  * - Handle notifications
+ * - Reconnect after unexpected drops and resume the session
+ * 
+ * Reconnect: when the connection drops without disconnect() being called,
+ * the client retries with jittered exponential backoff. Once connected it
+ * sends a single resume message carrying the session token, the channels
+ * it was in and its roster version; the server restores the session
+ * (keeping SRTP keys if it is still within its grace period) and only
+ * resends rosters that changed. The voice session is never touched, so a
+ * brief drop costs one round trip instead of login, key exchange, joins
+ * and roster requests. If the server cannot resume, the connected callback
+ * fires as for a fresh connection.
  * 
  * Thread Safety: Public methods are thread-safe
  */
@@ -63,6 +80,7 @@ public:
     
     /**
      * Disconnect from server
+     * Explicit disconnects are final: no reconnect, session state cleared
      */
     void disconnect();
     
@@ -112,6 +130,12 @@ public:
      */
     Result<void> request_all_channel_rosters();
 
+    /**
+     * Offer the compact voice packet header to the server
+     * The server answers (and later updates) with voice_aliases
+     */
+    Result<void> request_compact_voice_header();
+
     /**
      * Send key exchange response to server
      * @param public_key Client's X25519 public key (32 bytes)
@@ -156,6 +180,9 @@ public:
     void set_error_callback(ErrorCallback callback);
     void set_key_exchange_init_callback(KeyExchangeInitCallback callback);
     void set_all_channel_rosters_callback(AllChannelRostersCallback callback);
+    void set_reconnecting_callback(ReconnectingCallback callback);
+    void set_resumed_callback(ResumedCallback callback);
+    void set_voice_aliases_callback(VoiceAliasesCallback callback);
     
     /**
      * Get statistics
@@ -185,12 +212,33 @@ private:
     void handle_error(const std::string& json);
     void handle_key_exchange_init(const std::string& json);
     void handle_all_channel_rosters(const std::string& json);
+    void handle_resumed(const std::string& json);
+    void handle_resume_failed(const std::string& json);
+    void handle_voice_aliases(const std::string& json);
+    
+    // Reconnect
+    void schedule_reconnect();
+    void send_resume();
     
     // Send message helpers
     Result<void> send_message(protocol::MessageType type, const std::string& json);
     
     // WebSocket connection
     std::unique_ptr<QWebSocket> websocket_;
+    std::string url_;
+    
+    // Reconnect state
+    static constexpr uint32_t RECONNECT_BASE_DELAY_MS = 250;
+    static constexpr uint32_t RECONNECT_MAX_DELAY_MS = 10000;
+    std::unique_ptr<QTimer> reconnect_timer_;
+    uint32_t backoff_attempt_ = 0;      // Attempts since the last successful session
+    bool reconnecting_ = false;         // Current connection is a reconnect
+    std::atomic<bool> closing_{false};  // disconnect() called: don't reconnect
+    std::mt19937 jitter_rng_{std::random_device{}()};
+    
+    // Resume state
+    std::string resume_token_;          // Single-use, rotated by the server on every (re)connect
+    uint64_t roster_version_ = 0;       // 0 = no rosters cached
     
     // Authentication state
     std::string auth_token_;
@@ -200,6 +248,7 @@ private:
     
     // Available channels
     std::vector<protocol::ChannelInfo> channels_;
+    std::set<ChannelId> joined_channels_;  // Replayed on resume
     mutable std::mutex channels_mutex_;
     
     // Connection state
@@ -217,6 +266,9 @@ private:
     ErrorCallback on_error_cb_;
     KeyExchangeInitCallback on_key_exchange_init_cb_;
     AllChannelRostersCallback on_all_channel_rosters_cb_;
+    ReconnectingCallback on_reconnecting_cb_;
+    ResumedCallback on_resumed_cb_;
+    VoiceAliasesCallback on_voice_aliases_cb_;
 
     mutable std::mutex callbacks_mutex_;
     
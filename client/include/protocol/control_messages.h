@@ -5,6 +5,7 @@
 #include <vector>
 #include <array>
 #include <cstdint>
+#include <utility>
 
 namespace voip::protocol {
 
@@ -195,6 +196,34 @@ struct ChannelRosterInfo {
  */
 struct AllChannelRostersResponse {
     std::vector<ChannelRosterInfo> channels;
+    uint64_t roster_version = 0;    // Changes whenever any channel membership changes
+};
+
+/**
+ * Resume Response: Server → Client
+ * Reply to a resume request after the control connection dropped.
+ * A warm resume keeps the SRTP keys; a cold one (grace period over)
+ * rejoins the channels and starts a new key exchange.
+ */
+struct ResumeResponse {
+    UserId user_id = 0;
+    OrgId org_id = 0;
+    uint32_t permissions = 0;
+    std::vector<ChannelId> channels;   // Channels the session is in after resuming
+    bool rosters_included = false;     // False if the cached rosters are current
+    bool key_exchange_required = false;
+};
+
+/**
+ * Voice Aliases: Server → Client
+ * Answer to a voice_format request, re-sent whenever an alias changes.
+ * When the server agreed to the compact format, voice packets in both
+ * directions may carry these short IDs instead of user/channel IDs.
+ */
+struct VoiceAliasesResponse {
+    bool compact = false;  // Server will use "compact_v1"
+    std::vector<std::pair<UserId, uint16_t>> users;
+    std::vector<std::pair<ChannelId, uint16_t>> channels;
 };
 
 } // namespace voip::protocol
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+
+namespace voip::session {
+
+/**
+ * Network feedback for one controller interval (~1 second)
+ */
+struct QualityFeedback {
+    float loss_fraction = 0.0f;  // 0.0-1.0 packets lost over the interval
+    float jitter_ms = 0.0f;      // Interarrival jitter
+    float rtt_ms = 0.0f;         // Round-trip time (0 = unknown)
+};
+
+/**
+ * Encoder settings chosen by the controller
+ */
+struct QualityDecision {
+    uint32_t bitrate = 32000;
+    int complexity = 10;
+    bool enable_fec = true;
+    int packet_loss_perc = 5;
+    uint32_t frames_per_packet = 1;  // Opus frames packed into each datagram
+};
+
+/**
+ * QualityController - Adapts Opus encoder settings to network conditions
+ *
+ * Fed once per interval with receiver-side loss, jitter and RTT:
+ * - Bitrate: multiplicative decrease on congestion, additive increase
+ *   after several consecutive clean intervals (AIMD)
+ * - FEC: switched on above one loss threshold, off only below a lower one
+ * - Expected loss %: tracks smoothed loss, changed only on a clear shift
+ * - Complexity: full at low bitrates, where it buys the most quality
+ * - Frames per packet: raised when congestion persists at the bitrate
+ *   floor (fewer datagrams, less header overhead); lowered again before
+ *   any bitrate increase
+ *
+ * Thread Safety: Not thread-safe. Owned and driven by the capture thread.
+ */
+class QualityController {
+public:
+    struct Config {
+        uint32_t min_bitrate = 12000;            // bps
+        uint32_t max_bitrate = 32000;            // bps (also the start bitrate)
+        int complexity = 10;                     // Complexity at low bitrates
+        uint32_t relaxed_complexity_bitrate = 28000;  // At/above: complexity - 2
+
+        // Congestion: any of these triggers a bitrate decrease
+        float loss_high = 0.05f;
+        float jitter_high_ms = 40.0f;
+        float rtt_high_ms = 400.0f;
+
+        // Clean: all of these (for increase_after intervals) allow an increase
+        float loss_low = 0.01f;
+
+        float decrease_factor = 0.85f;
+        uint32_t increase_step = 2000;           // bps
+        uint32_t increase_after = 5;             // Clean intervals before increasing
+
+        // FEC hysteresis (smoothed loss)
+        float fec_on_loss = 0.01f;
+        float fec_off_loss = 0.005f;
+
+        // Don't retune expected loss for changes smaller than this (percent)
+        int loss_perc_deadband = 2;
+        int max_loss_perc = 30;
+
+        // Aggregation: frames per datagram go up by one after this many
+        // congested intervals with the bitrate already at min_bitrate
+        uint32_t max_frames_per_packet = 1;      // 1 = never aggregate
+        uint32_t aggregate_after = 3;
+    };
+
+    explicit QualityController(const Config& config);
+
+    /**
+     * Feed one interval of feedback
+     * Returns true if the decision changed and should be applied
+     */
+    bool update(const QualityFeedback& feedback);
+
+    /**
+     * Current encoder settings
+     */
+    [[nodiscard]] const QualityDecision& decision() const noexcept { return decision_; }
+
+    /**
+     * Smoothed loss estimate (0.0-1.0)
+     */
+    [[nodiscard]] float smoothed_loss() const noexcept { return smoothed_loss_; }
+
+    /**
+     * Number of updates that changed the decision
+     */
+    [[nodiscard]] uint64_t adjustments() const noexcept { return adjustments_; }
+
+private:
+    [[nodiscard]] int complexity_for(uint32_t bitrate) const noexcept;
+
+    Config config_;
+    QualityDecision decision_;
+
+    float smoothed_loss_ = 0.0f;
+    float smoothed_jitter_ms_ = 0.0f;
+    uint32_t clean_intervals_ = 0;
+    uint32_t floor_intervals_ = 0;  // Consecutive congested intervals at min_bitrate
+    uint64_t adjustments_ = 0;
+    bool first_update_ = true;
+};
+
+} // namespace voip::session
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "audio/jitter_buffer.h"
+#include "audio/opus_codec.h"
+#include "common/types.h"
+#include <atomic>
+#include <compare>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace voip::session {
+
+/**
+ * Identifies one run of a remote sender's numbering. The wire header has
+ * no SSRC, so the receiver opens a new epoch whenever a sender's sequence
+ * numbers restart (client restart, rejoin) or jump past the jitter buffer.
+ */
+struct StreamKey {
+    ChannelId channel_id = 0;
+    UserId user_id = 0;
+    uint32_t epoch = 0;
+
+    auto operator<=>(const StreamKey&) const = default;
+};
+
+/**
+ * Receive state of one remote speaker: reordering, decoding and the
+ * decoded samples not yet played
+ */
+struct SpeakerStream {
+    StreamKey key;
+    std::unique_ptr<audio::JitterBuffer> jitter_buffer;
+    std::unique_ptr<audio::OpusDecoder> decoder;  // Created by the owner on first use; kept when pooled
+    std::vector<float> samples;                   // Decoded, from read_pos on still to play
+    size_t read_pos = 0;
+
+    // Newest frame of this epoch, and when the epoch began (sender clock)
+    SequenceNumber highest_sequence = 0;
+    uint64_t highest_timestamp = 0;
+    uint64_t first_timestamp = 0;
+    uint64_t last_heard_us = 0;  // Local arrival of the latest packet
+};
+
+/**
+ * SpeakerStreams - Per-speaker receive state, created on a speaker's first
+ * packet and reclaimed after a silence
+ *
+ * Channels with hundreds of occasional talkers only hold state for the
+ * ones heard lately: a stream idle for idle_timeout_us goes back to a
+ * small pool (its jitter buffer and decoder are reset and reused), and the
+ * table never holds more than max_streams (the least recently heard is
+ * evicted first).
+ *
+ * Sequence numbers restarting behind the stream (the packet is newer by
+ * its timestamp, or far behind) or jumping further ahead than the jitter
+ * buffer reaches open a new epoch with fresh state instead of being
+ * dropped as duplicates or late packets. The previous epoch stays until
+ * it drains, so its late packets still find it.
+ *
+ * Thread Safety: not thread-safe (voice worker only), except stats().
+ */
+class SpeakerStreams {
+public:
+    struct Config {
+        uint32_t sample_rate = 48000;
+        uint32_t frame_size = 960;           // Jitter buffer default frame
+        uint32_t jitter_buffer_frames = 5;
+        uint64_t idle_timeout_us = 5000000;  // Reclaim after this much silence
+        size_t max_streams = 64;
+        size_t pool_size = 8;                // Reclaimed streams kept for reuse
+        SequenceNumber reset_gap = 1000;     // This far behind is always a restart
+    };
+
+    struct Stats {
+        uint32_t active = 0;        // Streams in the table
+        uint32_t pooled = 0;
+        uint64_t opened = 0;        // Streams started (new speakers and epochs)
+        uint64_t epoch_resets = 0;  // Of those, restarted sender numbering
+        uint64_t reclaimed = 0;     // Idle or left-channel streams released
+        uint64_t evicted = 0;       // Released early for a new speaker (table full)
+        uint64_t dropped = 0;       // Late packets of an epoch already released
+        float jitter_ms = 0.0f;     // Worst stream, as of the last reclaim()
+    };
+
+    explicit SpeakerStreams(const Config& config);
+
+    // Disable copy
+    SpeakerStreams(const SpeakerStreams&) = delete;
+    SpeakerStreams& operator=(const SpeakerStreams&) = delete;
+
+    /**
+     * Stream for a packet whose first frame is `sequence` and last frame
+     * `sequence + frames - 1`; opens one as needed and records the
+     * arrival. nullptr when the packet belongs to an epoch already released.
+     */
+    SpeakerStream* route(ChannelId channel_id, UserId user_id, SequenceNumber sequence,
+                         uint64_t timestamp, size_t frames, uint64_t now_us);
+
+    /**
+     * Release idle streams and those whose channel `keep` rejects
+     */
+    void reclaim(uint64_t now_us, const std::function<bool(ChannelId)>& keep);
+
+    /**
+     * Release every stream
+     */
+    void clear();
+
+    /**
+     * Call fn(SpeakerStream&) for each stream, by channel, user and epoch
+     */
+    template <typename Fn>
+    void for_each(Fn&& fn) {
+        for (auto& [key, stream] : streams_) {
+            fn(*stream);
+        }
+    }
+
+    [[nodiscard]] Stats stats() const;
+
+private:
+    // Newest epoch of a speaker (nullptr when none)
+    SpeakerStream* current(ChannelId channel_id, UserId user_id);
+
+    // Start epoch `epoch`, releasing older epochs than the one before it
+    SpeakerStream* open(ChannelId channel_id, UserId user_id, uint32_t epoch,
+                        SequenceNumber sequence, uint64_t timestamp);
+
+    // Back to the pool (or freed when the pool is full)
+    void release(std::unique_ptr<SpeakerStream> stream);
+
+    Config config_;
+    std::map<StreamKey, std::unique_ptr<SpeakerStream>> streams_;
+    std::vector<std::unique_ptr<SpeakerStream>> pool_;
+
+    // Published for stats() (other threads)
+    std::atomic<uint32_t> active_{0};
+    std::atomic<uint32_t> pooled_{0};
+    std::atomic<uint64_t> opened_{0};
+    std::atomic<uint64_t> epoch_resets_{0};
+    std::atomic<uint64_t> reclaimed_{0};
+    std::atomic<uint64_t> evicted_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<float> jitter_ms_{0.0f};
+};
+
+} // namespace voip::session
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "audio/audio_engine.h"
+#include "common/types.h"
+#include "common/result.h"
+#include "common/metrics.h"
+#include "common/rt_thread.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace voip::session {
+
+/**
+ * VoiceHub - One audio device and voice worker shared by several sessions
+ *
+ * Lets a client stay connected to several servers at once: each
+ * VoiceSession keeps its own socket, SRTP keys, channels and codec state,
+ * while the hub opens the devices once, hands every captured frame to all
+ * started sessions and sums their mixed frames into one playback stream.
+ * A single RtThread runs every session's frame of work in turn, so two
+ * servers cost one worker wake-up per frame period, not two. On a device
+ * off the wall clock (AudioBackend::wall_clock() false) there is no
+ * worker thread: the playback callback ticks every member once per codec
+ * frame, so the pipeline runs at the device's pace.
+ *
+ * Devices and the worker start with the first started session and stop
+ * with the last. Sessions must use the hub's sample rate and frame size,
+ * and the hub must outlive them.
+ *
+ * The callbacks and the worker read the session list from a published
+ * snapshot (two slots, swapped atomically, each with a reader count), so
+ * they never take a lock; attach()/detach() fill the idle slot, swap it
+ * in and wait until nobody reads the old one.
+ *
+ * Thread Safety: public methods from the control thread; the device
+ * callbacks and worker are lock-free.
+ */
+class VoiceHub {
+public:
+    struct Config {
+        uint32_t sample_rate = 48000;
+        uint32_t frame_size = 960;    // 20ms at 48kHz; every session uses this
+        bool worker_realtime = true;  // Ask for real-time priority
+        int worker_cpu = -1;          // Pin to this core (-1 = any)
+    };
+
+    /**
+     * What the hub drives: one session's device callbacks and frame of
+     * worker work (implemented by VoiceSession)
+     */
+    class Member {
+    public:
+        virtual ~Member() = default;
+
+        // Audio thread: a captured frame / the next frame to play
+        virtual void hub_capture(const float* pcm, size_t frames, uint64_t capture_time_us) = 0;
+        virtual void hub_playback(float* pcm, size_t frames, uint64_t playout_time_us) = 0;
+
+        // Worker thread: one frame period of work
+        virtual void hub_tick() = 0;
+    };
+
+    // Members a hub carries at once
+    static constexpr size_t MAX_MEMBERS = 8;
+
+    VoiceHub();
+    ~VoiceHub();
+
+    // Disable copy
+    VoiceHub(const VoiceHub&) = delete;
+    VoiceHub& operator=(const VoiceHub&) = delete;
+
+    /**
+     * Open the shared audio engine (default backend when none is given)
+     */
+    Result<void> initialize(const Config& config, std::unique_ptr<audio::AudioBackend> audio_backend = nullptr);
+
+    /**
+     * Stop devices and the worker; sessions must be stopped first
+     */
+    void shutdown();
+
+    /**
+     * Add a started member; the first one starts devices and worker
+     */
+    Result<void> attach(Member* member);
+
+    /**
+     * Remove a member; returns once no callback or tick is still in it.
+     * The last one stops devices and worker.
+     */
+    void detach(Member* member);
+
+    /**
+     * Shared audio engine for device configuration (nullptr before initialize())
+     */
+    [[nodiscard]] audio::AudioEngine* get_audio_engine() noexcept;
+    [[nodiscard]] const audio::AudioEngine* get_audio_engine() const noexcept;
+
+    [[nodiscard]] const Config& config() const noexcept { return config_; }
+
+    /**
+     * Members currently attached
+     */
+    [[nodiscard]] size_t session_count() const;
+
+    /**
+     * Scheduling figures of the shared voice worker
+     */
+    [[nodiscard]] RtThread::Stats worker_stats() const;
+
+    /**
+     * Device frames not handed to the members (odd-sized callbacks)
+     */
+    [[nodiscard]] uint64_t dropped_frames() const noexcept { return dropped_frames_.load(std::memory_order_relaxed); }
+
+private:
+    struct Snapshot {
+        std::array<Member*, MAX_MEMBERS> members{};
+        size_t count = 0;
+    };
+
+    // Pin the published snapshot for reading (never blocks); release with
+    // the returned slot
+    const Snapshot& acquire(int& slot) noexcept;
+    void release(int slot) noexcept;
+
+    // Publish members_ (caller holds lifecycle_mutex_); returns once no
+    // reader is left on the previous snapshot
+    void publish();
+
+    // Device callbacks (audio thread) and worker tick
+    void on_audio_captured(const float* pcm, size_t frames, uint64_t capture_time_us);
+    void on_audio_playback_needed(float* pcm, size_t frames, uint64_t playout_time_us);
+    void worker_tick();
+
+    Config config_;
+    std::unique_ptr<audio::AudioEngine> audio_engine_;
+    RtThread worker_;
+
+    mutable std::mutex lifecycle_mutex_;  // Serializes attach/detach/shutdown; guards members_
+    std::vector<Member*> members_;
+
+    // What the callbacks and worker see
+    std::array<Snapshot, 2> snapshots_;
+    std::atomic<int> published_{0};
+    std::array<std::atomic<uint32_t>, 2> readers_{};
+
+    // Playback callback: one member's frame before it is summed
+    std::vector<float> mix_buffer_;
+
+    std::atomic<bool> device_paced_{false};  // Members ticked from playback, no worker
+
+    std::atomic<uint64_t> dropped_frames_{0};
+    Counter& dropped_frames_metric_;
+};
+
+} // namespace voip::session
@@ -3,13 +3,26 @@
 #include "audio/audio_engine.h"
 #include "audio/opus_codec.h"
 #include "audio/jitter_buffer.h"
+#include "audio/voice_activity_detector.h"
+#include "audio/cpu_budget_monitor.h"
+#include "audio/latency_probe.h"
+#include "session/quality_controller.h"
+#include "session/speaker_streams.h"
+#include "session/voice_hub.h"
 #include "network/udp_socket.h"
+#include "network/link_monitor.h"
+#include "network/voice_header.h"
 #include "crypto/srtp_session.h"
 #include "common/types.h"
 #include "common/result.h"
+#include "common/latency_histogram.h"
+#include "common/interarrival_jitter.h"
+#include "common/lock_free_queue.h"
+#include "common/rt_thread.h"
 #include <atomic>
 #include <memory>
 #include <map>
+#include <optional>
 #include <set>
 #include <mutex>
 
@@ -27,23 +40,62 @@ namespace voip::session {
  * - Timestamp generation
  * - Packet loss detection
  * - Audio synchronization
+ * 
+ * Threads: the device callbacks only move PCM through lock-free FIFOs.
+ * Encoding, encryption, sending, decoding and mixing run on a dedicated
+ * voice worker (RtThread) once per frame period, at real-time priority
+ * where the OS allows. The network thread only timestamps and queues
+ * incoming packets. On a device off the wall clock (a scaled, unthrottled
+ * or manual VirtualAudioBackend) the worker tick runs from the playback
+ * callback instead, once per codec frame.
+ *
+ * Sessions initialized on a VoiceHub share its audio devices and worker
+ * instead (one connection per server, one mixer).
  */
-class VoiceSession {
+class VoiceSession : private VoiceHub::Member {
 public:
     struct Config {
         // Audio config
         uint32_t sample_rate = 48000;
         uint32_t channels = 1;
+        // Opus frame: 2.5, 5, 10, 20, 40 or 60ms (120/240/480/960/1920/2880
+        // samples at 48kHz). 10ms for low-latency local links, 40/60ms to
+        // save header overhead on constrained links. Receivers follow each
+        // sender's duration from the Opus TOC byte.
         uint32_t frame_size = 960;  // 20ms at 48kHz
         
+        // Frames packed into each datagram (Opus repacketizer): fewer
+        // packets and headers for (N-1) frames of extra delay. Fixed without
+        // adaptive quality; with it, the controller raises it up to
+        // max_frames_per_packet when the bitrate floor isn't enough.
+        // Capped at 120ms per packet.
+        uint32_t frames_per_packet = 1;
+        uint32_t max_frames_per_packet = 3;
+        
         // Opus config
-        uint32_t bitrate = 32000;
+        uint32_t bitrate = 32000;  // Starting (and maximum adaptive) bitrate
+        int complexity = 10;
         bool enable_fec = true;
-        bool enable_dtx = false;
+        bool enable_dtx = true;
+        
+        // Voice activity gate (hot mic): silent frames are not encoded or sent,
+        // apart from a periodic comfort-noise frame
+        bool enable_vad = true;
+        uint32_t vad_hangover_ms = 300;
+        
+        // Adapt bitrate/complexity/FEC to measured loss, jitter and RTT
+        bool adaptive_quality = true;
+        uint32_t min_bitrate = 12000;
+        
+        // Cap complexity so encoding stays within this share of the frame period
+        bool adaptive_complexity = true;
+        float encode_budget_fraction = 0.25f;
         
         // Network config
         std::string server_address = "127.0.0.1";
         uint16_t server_port = 9001;
+        uint32_t keepalive_interval_ms = 1000;  // UDP keepalive + RTT probe (0 = off)
+        SocketOptions socket_options;           // DSCP EF marking, priority, buffer sizes
         
         // Session config (DEPRECATED: use multi-channel methods)
         ChannelId channel_id = 1;  // Legacy: single channel mode
@@ -53,7 +105,22 @@ public:
         bool multi_channel_mode = true;  // Enable multi-channel support
         
         // Jitter buffer config
-        uint32_t jitter_buffer_frames = 5;  // ~100ms at 20ms/frame
+        uint32_t jitter_buffer_frames = 5;  // Packets (~100ms at 20ms/frame)
+        
+        // Receive state per remote speaker: reclaimed after this much
+        // silence, and kept for at most this many (least recently heard
+        // goes first)
+        uint32_t speaker_idle_timeout_ms = 5000;
+        uint32_t max_speaker_streams = 64;
+        
+        // Loopback test mode: replace the microphone with a periodic marker
+        // tone and time its return (needs a server that echoes our voice)
+        bool latency_probe = false;
+        
+        // Voice worker thread (VoiceHub::Config instead on a hub)
+        bool worker_realtime = true;         // Ask for real-time priority
+        int worker_cpu = -1;                 // Pin to this core (-1 = any)
+        uint32_t playback_queue_frames = 2;  // Mixed frames kept ahead of the device
     };
     
     VoiceSession();
@@ -68,6 +135,19 @@ public:
      */
     Result<void> initialize(const Config& config);
     
+    /**
+     * Initialize session with a specific audio backend
+     * (e.g. audio::VirtualAudioBackend for headless runs)
+     */
+    Result<void> initialize(const Config& config, std::unique_ptr<audio::AudioBackend> audio_backend);
+    
+    /**
+     * Initialize session on a shared hub: capture and playback go through
+     * the hub's devices and mixer, the socket and crypto stay per session.
+     * sample_rate and frame_size must match the hub's.
+     */
+    Result<void> initialize(const Config& config, VoiceHub& hub);
+    
     /**
      * Shutdown session
      */
@@ -113,6 +193,12 @@ public:
     [[nodiscard]] bool is_muted() const noexcept;
     [[nodiscard]] bool is_deafened() const noexcept;
     
+    /**
+     * Check if local voice is currently being transmitted
+     * (not muted, has a target, and voice activity detected)
+     */
+    [[nodiscard]] bool is_speaking() const noexcept;
+    
     /**
      * Set user ID for voice packets
      * Should be called with authenticated user ID from server
@@ -181,7 +267,7 @@ public:
     [[nodiscard]] std::set<ChannelId> get_active_ptt_channels() const;
     
     /**
-     * Get audio engine for device configuration
+     * Get audio engine for device configuration (the hub's when shared)
      * Returns nullptr if not initialized
      */
     [[nodiscard]] audio::AudioEngine* get_audio_engine() noexcept;
@@ -192,6 +278,22 @@ public:
      */
     void set_srtp_session(std::unique_ptr<crypto::SrtpSession> srtp_session);
     
+    /**
+     * Install the server's voice aliases (voice_aliases control message)
+     * Switches sending to the compact packet header; kept across initialize()
+     */
+    void set_voice_aliases(const network::VoiceAliases& aliases);
+    
+    /**
+     * Latency distribution since start (milliseconds)
+     */
+    struct LatencyPercentiles {
+        float p50_ms = 0.0f;
+        float p95_ms = 0.0f;
+        float p99_ms = 0.0f;
+        uint64_t samples = 0;
+    };
+    
     /**
      * Get current statistics
      */
@@ -199,15 +301,23 @@ public:
         // Audio stats
         uint64_t frames_captured = 0;
         uint64_t frames_played = 0;
+        float frame_duration_ms = 0.0f;  // Local capture/encode frame
         
         // Encoding stats
         uint64_t frames_encoded = 0;
         uint64_t encode_errors = 0;
         
+        // Voice activity gate
+        uint64_t vad_gated_frames = 0;     // Silent frames not encoded/sent
+        uint64_t comfort_noise_frames = 0; // Periodic frames sent during silence
+        bool speaking = false;
+        
         // Network stats
         uint64_t packets_sent = 0;
         uint64_t packets_received = 0;
         uint64_t network_errors = 0;
+        std::optional<SocketOptions> socket_options;  // Effective, once connected
+        network::SendSchedulerStats send_queue;       // Queueing delay ahead of the socket
         
         // Decoding stats
         uint64_t frames_decoded = 0;
@@ -216,41 +326,213 @@ public:
         
         // Jitter buffer stats
         uint64_t jitter_buffer_underruns = 0;
-        float jitter_ms = 0.0f;
+        float jitter_ms = 0.0f;  // RFC 3550 interarrival jitter, worst sender
+        
+        // Per-speaker receive streams
+        uint32_t speaker_streams = 0;       // Remote speakers with state held
+        uint64_t speaker_stream_resets = 0; // Sender numbering restarted (new epoch)
+        uint64_t speaker_streams_reclaimed = 0;
         
-        // Latency estimate (ms)
+        // Latency (ms): mouth-to-ear when measured, else the local share
+        // (capture device + frame + receive-to-ear; network transit excluded)
         float estimated_latency_ms = 0.0f;
+        
+        // Measured latency, published about once a second
+        LatencyPercentiles mouth_to_ear;   // Own voice echoed back: capture ADC to playback DAC
+        LatencyPercentiles playout_delay;  // Any sender: packet arrival to playback DAC
+        LatencyPercentiles probe;          // Marker tone round trip (latency_probe mode)
+        uint64_t probe_markers_sent = 0;
+        uint64_t probe_markers_detected = 0;
+        
+        // Adaptive quality (encoder settings currently in use)
+        uint32_t target_bitrate = 0;
+        int encoder_complexity = 0;
+        bool fec_enabled = false;
+        uint32_t expected_loss_perc = 0;
+        uint32_t frames_per_packet = 1;
+        float measured_loss_percent = 0.0f;  // Receive side, last interval
+        
+        // Voice-plane keepalive: UDP round trip to the server
+        float rtt_ms = 0.0f;               // Smoothed (0 = no echo yet)
+        float rtt_min_ms = 0.0f;
+        float rtt_var_ms = 0.0f;
+        float path_loss_percent = 0.0f;    // Round-trip probe loss, last 32 probes
+        uint64_t keepalives_sent = 0;
+        uint64_t keepalives_lost = 0;
+        uint64_t quality_adjustments = 0;
+        
+        // Encoder CPU (last ~1s window)
+        uint32_t encode_time_p50_us = 0;
+        uint32_t encode_time_p95_us = 0;
+        uint32_t encode_time_p99_us = 0;
+        int complexity_cap = 0;  // From CPU budget
+        
+        // Voice worker scheduling
+        bool worker_realtime = false;        // Real-time priority granted
+        uint64_t worker_missed_ticks = 0;    // Frame periods skipped after a late wake-up
+        uint32_t worker_lateness_p50_us = 0; // Wake-up past deadline, last ~1s
+        uint32_t worker_lateness_p99_us = 0;
+        uint32_t worker_lateness_max_us = 0;
+        uint64_t worker_queue_drops = 0;     // Captured frames/received packets the worker fell behind on
+        uint64_t playback_underruns = 0;     // Device asked before the worker had mixed a frame
     };
     
     [[nodiscard]] Stats get_stats() const;
     
 private:
-    // Audio capture callback (from audio thread)
-    void on_audio_captured(const float* pcm, size_t frames);
+    // VoiceHub::Member: what a hub drives on sessions started on it
+    void hub_capture(const float* pcm, size_t frames, uint64_t capture_time_us) override;
+    void hub_playback(float* pcm, size_t frames, uint64_t playout_time_us) override;
+    void hub_tick() override;
+    
+    // Everything but the hub check (engine created unless on a hub)
+    Result<void> initialize_session(const Config& config, std::unique_ptr<audio::AudioBackend> audio_backend);
+    
+    // Own engine, or the hub's (nullptr before initialize())
+    [[nodiscard]] audio::AudioEngine* engine() const noexcept;
+    
+    // Audio capture callback (from audio thread): queue the frame for the worker
+    void on_audio_captured(const float* pcm, size_t frames, uint64_t capture_time_us);
     
-    // Network receive callback (from network thread)
+    // Network receive callback (from network thread): queue the packet for the worker
     void on_packet_received(const network::VoicePacket& packet);
     
-    // Audio playback callback (from audio thread)
-    void on_audio_playback_needed(float* pcm, size_t frames);
+    // Audio playback callback (from audio thread): hand over a mixed frame
+    void on_audio_playback_needed(float* pcm, size_t frames, uint64_t playout_time_us);
+    
+    // One frame period of voice work (worker thread)
+    void worker_tick();
+    
+    // Encode, encrypt and send one captured frame (worker thread)
+    void process_capture(const float* pcm, size_t frames, uint64_t capture_time_us);
+    
+    // Encrypt and send an Opus packet of `frames` frames to each target
+    // (worker thread)
+    void send_encoded(const std::vector<uint8_t>& opus_data, size_t frames,
+                      const std::set<ChannelId>& targets, uint64_t capture_time_us);
+    
+    // Send the frames held for a multi-frame packet, if any (worker thread)
+    void flush_aggregate();
+    
+    // Decrypt, decode and buffer one received packet, frame by frame (worker thread)
+    void process_packet(const network::VoicePacket& packet, uint64_t arrival_us);
+    
+    // Mix the next output frame into the playback FIFO (worker thread)
+    void render_playback_frame();
     
-    // Multi-channel audio mixing
-    void mix_channels(float* output, size_t frames);
+    // Multi-channel audio mixing (playout_time_us 0 = not known yet)
+    void mix_channels(float* output, size_t frames, uint64_t playout_time_us);
+    
+    // Publish latency percentiles about once a second (worker thread)
+    void publish_latency(size_t frames);
+    
+    // Track loss/jitter of an incoming stream (worker thread)
+    void track_reception(const network::VoicePacket& packet, uint64_t arrival_us, size_t frames);
+    
+    // Collect and reset this interval's reception figures
+    QualityFeedback sample_feedback();
+    
+    // Run the quality controller about once per second (capture thread)
+    void update_quality();
+    
+    // Send a keepalive probe when one is due (worker thread)
+    void service_keepalive();
+    
+    // Match a keepalive echo against its probe (network thread)
+    void on_keepalive_echo(const network::KeepalivePacket& echo);
+    
+    // Push current decision to the encoder and stats
+    void apply_quality_decision(const QualityDecision& decision);
+    
+    // Set encoder complexity to the lower of the quality decision and CPU cap
+    void apply_complexity();
     
     // Components
-    std::unique_ptr<audio::AudioEngine> audio_engine_;
+    std::unique_ptr<audio::AudioEngine> audio_engine_;  // Unset on a hub
+    VoiceHub* hub_ = nullptr;                           // Shared devices and worker, if any
     std::unique_ptr<audio::OpusEncoder> encoder_;
-    std::unique_ptr<audio::OpusDecoder> decoder_;  // Shared decoder for all channels
+    std::unique_ptr<audio::VoiceActivityDetector> vad_;
+    std::unique_ptr<audio::OpusRepacketizer> packer_;    // Outgoing multi-frame packets
+    std::unique_ptr<audio::OpusRepacketizer> unpacker_;  // Incoming ones, split per frame
     std::unique_ptr<audio::JitterBuffer> jitter_buffer_;  // Legacy: single channel
     std::unique_ptr<network::UdpVoiceSocket> network_;
     
-    // Multi-channel components
-    std::map<ChannelId, std::unique_ptr<audio::JitterBuffer>> channel_buffers_;
+    // Receive state per remote speaker (worker thread), created on the
+    // first packet and reclaimed when the speaker goes quiet. Remote
+    // senders may use a different frame duration than the local playback frame.
+    std::unique_ptr<SpeakerStreams> speaker_streams_;
     mutable std::mutex channels_mutex_;  // Protects channel state
 
+    // Adaptive quality
+    std::unique_ptr<QualityController> quality_controller_;
+    uint64_t quality_interval_us_ = 0;  // Capture time since last update
+    int requested_complexity_ = 10;     // From quality decision, before CPU cap
+    
+    // Frame aggregation (worker thread): frames held in packer_ go to
+    // aggregate_targets_ with the first frame's capture time
+    std::atomic<uint32_t> frames_per_packet_{1};
+    uint32_t max_frames_per_packet_ = 1;  // What fits in one Opus packet
+    std::set<ChannelId> aggregate_targets_;
+    uint64_t aggregate_capture_time_us_ = 0;
+    
+    // Encoder CPU budget
+    std::unique_ptr<audio::CpuBudgetMonitor> cpu_monitor_;
+    
+    // Voice worker (unused on a hub) and the FIFOs that feed it. Mixed frames are numbered;
+    // the playback callback publishes the playout time of frame 0 so the
+    // worker knows when each frame it mixes will be heard.
+    struct ReceivedPacket {
+        network::VoicePacket packet;
+        uint64_t arrival_us = 0;
+    };
+    static constexpr int64_t NO_PLAYOUT_ORIGIN = INT64_MIN;
+    RtThread worker_;
+    std::unique_ptr<AudioBufferQueue> capture_fifo_;     // Capture callback -> worker
+    std::unique_ptr<AudioBufferQueue> playback_fifo_;    // Worker -> playback callback
+    std::unique_ptr<LockFreeQueue<ReceivedPacket>> receive_fifo_;  // Network thread -> worker
+    uint64_t frames_mixed_ = 0;   // Worker
+    uint64_t frames_popped_ = 0;  // Playback callback
+    std::atomic<int64_t> playout_origin_us_{NO_PLAYOUT_ORIGIN};
+    std::atomic<uint64_t> worker_queue_drops_{0};
+    std::atomic<uint64_t> playback_underruns_{0};
+    
+    // Latency measurement: histograms belong to the worker thread, which
+    // publishes percentiles under latency_mutex_ (try_lock only, RT-safe)
+    std::unique_ptr<audio::LatencyProbe> latency_probe_;
+    LatencyHistogram mouth_to_ear_;
+    LatencyHistogram playout_delay_;
+    LatencyHistogram probe_latency_;
+    uint64_t latency_publish_us_ = 0;
+    LatencyPercentiles published_mouth_to_ear_;
+    LatencyPercentiles published_playout_delay_;
+    LatencyPercentiles published_probe_;
+    mutable std::mutex latency_mutex_;
+    
+    // Reception of each remote sender, sampled as controller feedback
+    struct SenderReception {
+        SequenceNumber highest_sequence = 0;
+        uint64_t received = 0;      // Frames, this interval
+        uint64_t expected = 0;      // Frames, this interval
+        InterarrivalJitter jitter;  // From kernel arrival times where available
+    };
+    std::map<std::pair<ChannelId, UserId>, SenderReception> senders_;
+    std::mutex senders_mutex_;
+    
+    // Voice-plane keepalive. The worker only try_locks link_mutex_; the
+    // figures the quality controller needs are mirrored in atomics.
+    std::unique_ptr<network::LinkMonitor> link_monitor_;
+    mutable std::mutex link_mutex_;
+    std::atomic<float> link_rtt_ms_{0.0f};
+    std::atomic<float> link_one_way_loss_{0.0f};
+
     // SRTP encryption
     std::unique_ptr<crypto::SrtpSession> srtp_session_;
     mutable std::mutex srtp_mutex_;  // Protects SRTP session
+    uint32_t next_srtp_index_ = 1;   // Per datagram, unique under the key (guarded by srtp_mutex_)
+    
+    // Compact header aliases from the control plane
+    std::optional<network::VoiceAliases> voice_aliases_;
+    std::mutex voice_aliases_mutex_;
 
     // Configuration
     Config config_;
@@ -260,6 +542,16 @@ private:
     std::atomic<bool> is_muted_{false};
     std::atomic<bool> is_deafened_{false};
     std::atomic<SequenceNumber> next_sequence_{0};
+    std::atomic<bool> speaking_{false};
+    uint64_t silence_us_ = 0;  // Capture time since last comfort-noise frame
+    
+    // Debug log throttling, per session (capture path on the worker;
+    // recv_log_count_ on the network thread)
+    uint64_t capture_log_count_ = 0;
+    uint64_t mute_log_count_ = 0;
+    uint64_t targets_log_count_ = 0;
+    std::set<ChannelId> last_targets_;
+    uint64_t recv_log_count_ = 0;
     
     // Multi-channel state
     std::set<ChannelId> listening_channels_;        // Channels we're listening to
@@ -277,11 +569,37 @@ private:
     mutable std::atomic<uint64_t> decode_errors_{0};
     mutable std::atomic<uint64_t> plc_frames_{0};
     mutable std::atomic<uint64_t> jitter_underruns_{0};
+    mutable std::atomic<uint64_t> vad_gated_frames_{0};
+    mutable std::atomic<uint64_t> comfort_noise_frames_{0};
+    std::atomic<uint32_t> target_bitrate_{0};
+    std::atomic<int> encoder_complexity_{0};
+    std::atomic<bool> fec_enabled_{false};
+    std::atomic<uint32_t> expected_loss_perc_{0};
+    std::atomic<float> measured_loss_percent_{0.0f};
+    std::atomic<uint64_t> quality_adjustments_{0};
+    std::atomic<uint32_t> encode_time_p50_us_{0};
+    std::atomic<uint32_t> encode_time_p95_us_{0};
+    std::atomic<uint32_t> encode_time_p99_us_{0};
+    std::atomic<int> complexity_cap_{0};
+    
+    // Process-wide metrics (shared by every session)
+    Histogram& encode_time_metric_;
+    Histogram& decode_time_metric_;
+    Histogram& mouth_to_ear_metric_;
+    Counter& plc_frames_metric_;
+    Counter& codec_errors_metric_;
+    Histogram& udp_rtt_metric_;
+    
+    // This session's encoder state, labelled with its server (set in initialize())
+    Gauge* bitrate_metric_ = nullptr;
+    Gauge* complexity_metric_ = nullptr;
+    Gauge* frames_per_packet_metric_ = nullptr;
     
     // Temporary buffers for audio processing
     std::vector<float> capture_buffer_;
     std::vector<float> playback_buffer_;
     std::vector<uint8_t> encode_buffer_;
+    size_t max_decode_frame_size_ = 0;  // 60ms at sample_rate
 };
 
 } // namespace voip::session
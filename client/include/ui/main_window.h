@@ -9,6 +9,7 @@
 #include <QKeyEvent>
 #include <memory>
 #include <map>
+#include <set>
 #include "network/websocket_client.h"
 #include "session/voice_session.h"
 #include "protocol/control_messages.h"
@@ -36,6 +37,7 @@ public:
 
 signals:
     void disconnectRequested();
+    void addServerRequested();  // Connect to another server too (shares the audio devices)
     void channelJoinRequested(uint32_t channelId);
 
 private slots:
@@ -46,10 +48,13 @@ private slots:
     void onDisconnectClicked();
     void onSettingsClicked();
     void onVoiceStatsUpdate();
+    void onSpeakingUpdate();
     
     // WebSocket callbacks
     void onWsConnected();
     void onWsDisconnected();
+    void onWsReconnecting(uint32_t attempt, uint32_t delayMs);
+    void onWsResumed(bool keysRetained);
     void onWsError(const std::string& error);
     void onWsChannelJoined(uint32_t channelId, const std::string& channelName);
     void onWsUserJoined(ChannelId channelId, uint32_t userId, const std::string& username);
@@ -132,8 +137,12 @@ private:
     bool isAdmin_ = false;
     Qt::Key pttKey_ = Qt::Key_Control;
     
+    // Channels showing us as speaking (driven by voice activity)
+    std::set<ChannelId> speakingChannels_;
+    
     // Stats timer
     QTimer* statsTimer_ = nullptr;
+    QTimer* speakingTimer_ = nullptr;
 };
 
 } // namespace voip::ui
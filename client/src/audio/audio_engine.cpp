@@ -1,10 +1,31 @@
 #include "audio/audio_engine.h"
+#include "audio/portaudio_backend.h"
+#include "common/trace.h"
 #include <cmath>
 #include <algorithm>
+#include <cstring>
 
 namespace voip::audio {
 
-AudioEngine::AudioEngine() = default;
+AudioEngine::AudioEngine()
+    : AudioEngine(std::make_unique<PortAudioBackend>())
+{
+}
+
+AudioEngine::AudioEngine(std::unique_ptr<AudioBackend> backend)
+    : backend_(std::move(backend))
+    , capture_callback_metric_(MetricsRegistry::global().histogram(
+          "voip_audio_capture_callback_us", "Capture device callback duration (resample and FIFO transfer)"))
+    , playback_callback_metric_(MetricsRegistry::global().histogram(
+          "voip_audio_playback_callback_us", "Playback device callback duration (resample and FIFO transfer)"))
+    , input_overflow_metric_(MetricsRegistry::global().counter(
+          "voip_audio_input_overflows_total", "Capture device buffer overflows"))
+    , output_underflow_metric_(MetricsRegistry::global().counter(
+          "voip_audio_output_underflows_total", "Playback device buffer underflows"))
+    , deadline_miss_metric_(MetricsRegistry::global().counter(
+          "voip_audio_deadline_misses_total", "Audio callbacks that ran longer than their buffer period"))
+{
+}
 
 AudioEngine::~AudioEngine() {
     shutdown();
@@ -17,19 +38,17 @@ Result<void> AudioEngine::initialize(const AudioConfig& config) {
     
     config_ = config;
     
-    // Initialize PortAudio
-    PaError err = Pa_Initialize();
-    if (err != paNoError) {
-        return Err<void>(ErrorCode::AudioInitFailed, 
-                        std::string("PortAudio init failed: ") + Pa_GetErrorText(err));
+    auto backend_result = backend_->initialize();
+    if (!backend_result.is_ok()) {
+        return backend_result;
     }
     
     // Get default devices if not set
-    if (input_device_id_ == paNoDevice) {
-        input_device_id_ = Pa_GetDefaultInputDevice();
+    if (input_device_id_ == NO_DEVICE) {
+        input_device_id_ = backend_->default_input_device();
     }
-    if (output_device_id_ == paNoDevice) {
-        output_device_id_ = Pa_GetDefaultOutputDevice();
+    if (output_device_id_ == NO_DEVICE) {
+        output_device_id_ = backend_->default_output_device();
     }
     
     initialized_.store(true);
@@ -44,59 +63,23 @@ void AudioEngine::shutdown() {
     stop_capture();
     stop_playback();
     
-    Pa_Terminate();
+    backend_->terminate();
     initialized_.store(false);
 }
 
 std::vector<AudioDevice> AudioEngine::enumerate_input_devices() {
-    std::vector<AudioDevice> devices;
-    
-    const PaDeviceIndex device_count = Pa_GetDeviceCount();
-    const PaDeviceIndex default_input = Pa_GetDefaultInputDevice();
-    
-    for (PaDeviceIndex i = 0; i < device_count; ++i) {
-        const PaDeviceInfo* info = Pa_GetDeviceInfo(i);
-        if (info && info->maxInputChannels > 0) {
-            devices.push_back({
-                .id = i,
-                .name = info->name,
-                .max_input_channels = info->maxInputChannels,
-                .max_output_channels = 0,
-                .default_sample_rate = info->defaultSampleRate,
-                .is_default = (i == default_input)
-            });
-        }
-    }
-    
-    return devices;
+    return backend_->enumerate_input_devices();
 }
 
 std::vector<AudioDevice> AudioEngine::enumerate_output_devices() {
-    std::vector<AudioDevice> devices;
-    
-    const PaDeviceIndex device_count = Pa_GetDeviceCount();
-    const PaDeviceIndex default_output = Pa_GetDefaultOutputDevice();
-    
-    for (PaDeviceIndex i = 0; i < device_count; ++i) {
-        const PaDeviceInfo* info = Pa_GetDeviceInfo(i);
-        if (info && info->maxOutputChannels > 0) {
-            devices.push_back({
-                .id = i,
-                .name = info->name,
-                .max_input_channels = 0,
-                .max_output_channels = info->maxOutputChannels,
-                .default_sample_rate = info->defaultSampleRate,
-                .is_default = (i == default_output)
-            });
-        }
-    }
-    
-    return devices;
+    return backend_->enumerate_output_devices();
 }
 
 Result<void> AudioEngine::set_input_device(DeviceId id) {
-    const PaDeviceInfo* info = Pa_GetDeviceInfo(id);
-    if (!info || info->maxInputChannels == 0) {
+    const auto devices = backend_->enumerate_input_devices();
+    const bool found = std::any_of(devices.begin(), devices.end(),
+                                   [id](const AudioDevice& device) { return device.id == id; });
+    if (!found) {
         return Err<void>(ErrorCode::AudioDeviceNotFound, "Invalid input device");
     }
     
@@ -105,8 +88,10 @@ Result<void> AudioEngine::set_input_device(DeviceId id) {
 }
 
 Result<void> AudioEngine::set_output_device(DeviceId id) {
-    const PaDeviceInfo* info = Pa_GetDeviceInfo(id);
-    if (!info || info->maxOutputChannels == 0) {
+    const auto devices = backend_->enumerate_output_devices();
+    const bool found = std::any_of(devices.begin(), devices.end(),
+                                   [id](const AudioDevice& device) { return device.id == id; });
+    if (!found) {
         return Err<void>(ErrorCode::AudioDeviceNotFound, "Invalid output device");
     }
     
@@ -123,35 +108,34 @@ Result<void> AudioEngine::start_capture() {
         return Ok();  // Already running
     }
     
-    PaStreamParameters input_params;
-    input_params.device = input_device_id_;
-    input_params.channelCount = 1;  // Mono
-    input_params.sampleFormat = paFloat32;
-    input_params.suggestedLatency = Pa_GetDeviceInfo(input_device_id_)->defaultLowInputLatency;
-    input_params.hostApiSpecificStreamInfo = nullptr;
-    
-    PaError err = Pa_OpenStream(
-        &capture_stream_,
-        &input_params,
-        nullptr,  // No output
-        config_.sample_rate,
-        config_.frame_size,
-        paNoFlag,
-        &AudioEngine::capture_callback_static,
-        this
-    );
-    
-    if (err != paNoError) {
+    // Run the device at its own rate/buffer size; the FIFO adapts to the codec
+    const uint32_t device_rate = backend_->select_sample_rate(input_device_id_, true, config_.sample_rate);
+    auto resampler_result = Resampler::create(device_rate, config_.sample_rate, MAX_RESAMPLER_BLOCK);
+    if (!resampler_result.is_ok()) {
         return Err<void>(ErrorCode::AudioStreamFailed,
-                        std::string("Failed to open capture stream: ") + Pa_GetErrorText(err));
+                        "Capture resampler: " + resampler_result.error().message());
     }
-    
-    err = Pa_StartStream(capture_stream_);
-    if (err != paNoError) {
-        Pa_CloseStream(capture_stream_);
-        capture_stream_ = nullptr;
-        return Err<void>(ErrorCode::AudioStreamFailed,
-                        std::string("Failed to start capture stream: ") + Pa_GetErrorText(err));
+    capture_resampler_ = std::move(resampler_result.value());
+    capture_resampled_.assign(capture_resampler_->max_output_frames(MAX_RESAMPLER_BLOCK), 0.0f);
+    capture_frame_.assign(config_.frame_size, 0.0f);
+    capture_frame_fill_ = 0;
+    capture_deliver_.assign(config_.frame_size, 0.0f);
+    capture_queue_ = std::make_unique<AudioBufferQueue>(config_.buffer_frames + 1, config_.frame_size);
+    capture_times_.assign(config_.buffer_frames + 1, 0);
+    capture_times_count_ = 0;
+    capture_device_rate_.store(device_rate);
+    
+    DeviceStreamConfig stream_config;
+    stream_config.device = input_device_id_;
+    stream_config.sample_rate = device_rate;
+    stream_config.buffer_frames = config_.device_buffer_frames;
+    
+    auto open_result = backend_->open_capture(stream_config,
+        [this](const float* pcm, size_t frame_count, uint64_t time_us, bool overflow) {
+            handle_capture(pcm, frame_count, time_us, overflow);
+        });
+    if (!open_result.is_ok()) {
+        return open_result;
     }
     
     capture_running_.store(true);
@@ -163,11 +147,7 @@ Result<void> AudioEngine::stop_capture() {
         return Ok();
     }
     
-    if (capture_stream_) {
-        Pa_StopStream(capture_stream_);
-        Pa_CloseStream(capture_stream_);
-        capture_stream_ = nullptr;
-    }
+    backend_->close_capture();
     
     capture_running_.store(false);
     return Ok();
@@ -182,35 +162,32 @@ Result<void> AudioEngine::start_playback() {
         return Ok();  // Already running
     }
     
-    PaStreamParameters output_params;
-    output_params.device = output_device_id_;
-    output_params.channelCount = 1;  // Mono
-    output_params.sampleFormat = paFloat32;
-    output_params.suggestedLatency = Pa_GetDeviceInfo(output_device_id_)->defaultLowOutputLatency;
-    output_params.hostApiSpecificStreamInfo = nullptr;
-    
-    PaError err = Pa_OpenStream(
-        &playback_stream_,
-        nullptr,  // No input
-        &output_params,
-        config_.sample_rate,
-        config_.frame_size,
-        paNoFlag,
-        &AudioEngine::playback_callback_static,
-        this
-    );
-    
-    if (err != paNoError) {
+    // Run the device at its own rate/buffer size; the FIFO adapts to the codec
+    const uint32_t device_rate = backend_->select_sample_rate(output_device_id_, false, config_.sample_rate);
+    auto resampler_result = Resampler::create(config_.sample_rate, device_rate, MAX_RESAMPLER_BLOCK);
+    if (!resampler_result.is_ok()) {
         return Err<void>(ErrorCode::AudioStreamFailed,
-                        std::string("Failed to open playback stream: ") + Pa_GetErrorText(err));
+                        "Playback resampler: " + resampler_result.error().message());
     }
-    
-    err = Pa_StartStream(playback_stream_);
-    if (err != paNoError) {
-        Pa_CloseStream(playback_stream_);
-        playback_stream_ = nullptr;
-        return Err<void>(ErrorCode::AudioStreamFailed,
-                        std::string("Failed to start playback stream: ") + Pa_GetErrorText(err));
+    playback_resampler_ = std::move(resampler_result.value());
+    playback_frame_.assign(config_.frame_size, 0.0f);
+    const size_t chunks = (config_.frame_size + MAX_RESAMPLER_BLOCK - 1) / MAX_RESAMPLER_BLOCK;
+    playback_fifo_.assign(chunks * playback_resampler_->max_output_frames(MAX_RESAMPLER_BLOCK), 0.0f);
+    playback_fifo_read_ = 0;
+    playback_fifo_fill_ = 0;
+    playback_device_rate_.store(device_rate);
+    
+    DeviceStreamConfig stream_config;
+    stream_config.device = output_device_id_;
+    stream_config.sample_rate = device_rate;
+    stream_config.buffer_frames = config_.device_buffer_frames;
+    
+    auto open_result = backend_->open_playback(stream_config,
+        [this](float* pcm, size_t frame_count, uint64_t time_us, bool underflow) {
+            handle_playback(pcm, frame_count, time_us, underflow);
+        });
+    if (!open_result.is_ok()) {
+        return open_result;
     }
     
     playback_running_.store(true);
@@ -222,11 +199,7 @@ Result<void> AudioEngine::stop_playback() {
         return Ok();
     }
     
-    if (playback_stream_) {
-        Pa_StopStream(playback_stream_);
-        Pa_CloseStream(playback_stream_);
-        playback_stream_ = nullptr;
-    }
+    backend_->close_playback();
     
     playback_running_.store(false);
     return Ok();
@@ -249,14 +222,24 @@ float AudioEngine::get_output_level() const noexcept {
 }
 
 AudioStats AudioEngine::get_stats() const {
+    const uint32_t input_latency_us = input_latency_us_.load(std::memory_order_relaxed);
+    const uint32_t output_latency_us = output_latency_us_.load(std::memory_order_relaxed);
+    
+    // Measured device latency plus up to one codec frame waiting in each FIFO
+    const uint32_t engine_latency_us = input_latency_us + output_latency_us + 2 * config_.frame_duration_us();
+    
     return AudioStats{
         .input_overflows = input_overflows_.load(std::memory_order_relaxed),
         .output_underflows = output_underflows_.load(std::memory_order_relaxed),
-        .queue_full_errors = 0,
-        .queue_empty_errors = 0,
+        .queue_full_errors = queue_full_errors_.load(std::memory_order_relaxed),
+        .queue_empty_errors = queue_empty_errors_.load(std::memory_order_relaxed),
         .current_input_level = current_input_level_.load(std::memory_order_relaxed),
         .current_output_level = current_output_level_.load(std::memory_order_relaxed),
-        .estimated_latency_ms = config_.frame_size * config_.buffer_frames * 1000 / config_.sample_rate
+        .estimated_latency_ms = engine_latency_us / 1000,
+        .input_latency_us = input_latency_us,
+        .output_latency_us = output_latency_us,
+        .capture_sample_rate = capture_device_rate_.load(std::memory_order_relaxed),
+        .playback_sample_rate = playback_device_rate_.load(std::memory_order_relaxed)
     };
 }
 
@@ -268,102 +251,194 @@ void AudioEngine::set_output_volume(float volume) noexcept {
     output_volume_.store(std::clamp(volume, 0.0f, 2.0f), std::memory_order_relaxed);
 }
 
-// Static callback wrappers
-int AudioEngine::capture_callback_static(
-    const void* input,
-    void* output,
-    unsigned long frame_count,
-    const PaStreamCallbackTimeInfo* time_info,
-    PaStreamCallbackFlags status_flags,
-    void* user_data
-) {
-    auto* engine = static_cast<AudioEngine*>(user_data);
-    return engine->handle_capture(
-        static_cast<const float*>(input),
-        frame_count,
-        status_flags
-    );
-}
-
-int AudioEngine::playback_callback_static(
-    const void* input,
-    void* output,
-    unsigned long frame_count,
-    const PaStreamCallbackTimeInfo* time_info,
-    PaStreamCallbackFlags status_flags,
-    void* user_data
-) {
-    auto* engine = static_cast<AudioEngine*>(user_data);
-    return engine->handle_playback(
-        static_cast<float*>(output),
-        frame_count,
-        status_flags
-    );
-}
-
 // Member callback handlers
-int AudioEngine::handle_capture(
-    const float* input,
-    unsigned long frame_count,
-    PaStreamCallbackFlags status_flags
-) {
+void AudioEngine::handle_capture(const float* input, size_t frame_count, uint64_t adc_time_us, bool overflow) {
+    Tracer::set_thread_name("audio capture");
+    VOIP_TRACE_SCOPE("capture callback");
+    
     // Check for buffer overflow
-    if (status_flags & paInputOverflow) {
+    if (overflow) {
         input_overflows_.fetch_add(1, std::memory_order_relaxed);
+        input_overflow_metric_.add();
+        Tracer::mark_xrun("input overflow");
+    }
+    
+    if (!input || frame_count == 0) {
+        return;
     }
     
-    // Apply input volume
+    const uint64_t callback_start_us = steady_time_us();
+    
     const float volume = input_volume_.load(std::memory_order_relaxed);
     
     // Calculate input level (RMS)
-    const float level = calculate_rms(input, frame_count);
-    current_input_level_.store(level, std::memory_order_relaxed);
+    {
+        VOIP_TRACE_SCOPE("rms");
+        const float level = calculate_rms(input, frame_count);
+        current_input_level_.store(level, std::memory_order_relaxed);
+    }
     
-    // Call user callback if set
-    if (capture_callback_) {
-        // Note: If volume != 1.0, we'd need to apply it here
-        // For now, pass through directly for performance
-        capture_callback_(input, frame_count);
+    // Device latency: how long the newest sample waited for this callback
+    const uint32_t device_rate = capture_device_rate_.load(std::memory_order_relaxed);
+    const uint64_t block_end_us = adc_time_us + samples_to_us(frame_count, device_rate);
+    const uint64_t waited_us = callback_start_us > block_end_us ? callback_start_us - block_end_us : 0;
+    input_latency_us_.store(static_cast<uint32_t>(std::min<uint64_t>(waited_us, 1000000)), std::memory_order_relaxed);
+    
+    // Resampler output lags its input by the filter delay
+    const uint64_t resampler_delay_us = samples_to_us(capture_resampler_->delay_frames(), config_.sample_rate);
+    
+    // Resample to the codec rate and re-block into codec frames
+    TraceScope resample_trace("resample");
+    for (size_t offset = 0; offset < frame_count; offset += MAX_RESAMPLER_BLOCK) {
+        const size_t count = std::min<size_t>(MAX_RESAMPLER_BLOCK, frame_count - offset);
+        const size_t produced = capture_resampler_->process(
+            input + offset, count, capture_resampled_.data(), capture_resampled_.size());
+        // Clamped: backends may report no (zero) ADC time
+        const uint64_t chunk_adc_end_us = adc_time_us + samples_to_us(offset + count, device_rate);
+        const uint64_t chunk_end_us = chunk_adc_end_us > resampler_delay_us ? chunk_adc_end_us - resampler_delay_us : 0;
+        append_capture_samples(capture_resampled_.data(), produced, volume, chunk_end_us);
+    }
+    resample_trace.end();
+    
+    // Deliver every complete frame to the user callback
+    size_t delivered = 0;
+    while (capture_queue_->try_pop(capture_deliver_.data(), config_.frame_size)) {
+        const uint64_t capture_time_us = delivered < capture_times_count_ ? capture_times_[delivered] : block_end_us;
+        delivered++;
+        if (capture_callback_) {
+            capture_callback_(capture_deliver_.data(), config_.frame_size, capture_time_us);
+        }
     }
+    capture_times_count_ = 0;
     
-    return paContinue;
+    finish_callback(capture_callback_metric_, callback_start_us, frame_count, device_rate, "capture deadline miss");
 }
 
-int AudioEngine::handle_playback(
-    float* output,
-    unsigned long frame_count,
-    PaStreamCallbackFlags status_flags
-) {
+void AudioEngine::handle_playback(float* output, size_t frame_count, uint64_t dac_time_us, bool underflow) {
+    Tracer::set_thread_name("audio playback");
+    VOIP_TRACE_SCOPE("playback callback");
+    
     // Check for buffer underflow
-    if (status_flags & paOutputUnderflow) {
+    if (underflow) {
         output_underflows_.fetch_add(1, std::memory_order_relaxed);
+        output_underflow_metric_.add();
+        Tracer::mark_xrun("output underflow");
     }
     
-    // Call user callback if set
-    if (playback_callback_) {
-        playback_callback_(output, frame_count);
-        
-        // Apply output volume
-        const float volume = output_volume_.load(std::memory_order_relaxed);
-        if (volume != 1.0f) {
-            for (unsigned long i = 0; i < frame_count; ++i) {
-                output[i] *= volume;
+    if (!playback_callback_) {
+        // No callback - output silence
+        std::fill(output, output + frame_count, 0.0f);
+        current_output_level_.store(0.0f, std::memory_order_relaxed);
+        return;
+    }
+    
+    // Device latency: how long until the first sample is heard
+    const uint64_t callback_start_us = steady_time_us();
+    const uint64_t ahead_us = dac_time_us > callback_start_us ? dac_time_us - callback_start_us : 0;
+    output_latency_us_.store(static_cast<uint32_t>(std::min<uint64_t>(ahead_us, 1000000)), std::memory_order_relaxed);
+    
+    // Serve the device from the FIFO, pulling codec frames as needed
+    const uint32_t device_rate = playback_device_rate_.load(std::memory_order_relaxed);
+    const uint64_t resampler_delay_us = samples_to_us(playback_resampler_->delay_frames(), device_rate);
+    size_t written = 0;
+    while (written < frame_count) {
+        if (playback_fifo_read_ == playback_fifo_fill_) {
+            VOIP_TRACE_SCOPE("render frame");
+            render_playback_frame(dac_time_us + samples_to_us(written, device_rate) + resampler_delay_us);
+            if (playback_fifo_fill_ == 0) {
+                queue_empty_errors_.fetch_add(1, std::memory_order_relaxed);
+                std::fill(output + written, output + frame_count, 0.0f);
+                break;
             }
         }
         
-        // Calculate output level (RMS)
+        const size_t take = std::min(frame_count - written, playback_fifo_fill_ - playback_fifo_read_);
+        std::memcpy(output + written, &playback_fifo_[playback_fifo_read_], take * sizeof(float));
+        playback_fifo_read_ += take;
+        written += take;
+    }
+    
+    // Apply output volume
+    const float volume = output_volume_.load(std::memory_order_relaxed);
+    if (volume != 1.0f) {
+        for (size_t i = 0; i < frame_count; ++i) {
+            output[i] *= volume;
+        }
+    }
+    
+    // Calculate output level (RMS)
+    {
+        VOIP_TRACE_SCOPE("rms");
         const float level = calculate_rms(output, frame_count);
         current_output_level_.store(level, std::memory_order_relaxed);
-    } else {
-        // No callback - output silence
-        std::fill(output, output + frame_count, 0.0f);
-        current_output_level_.store(0.0f, std::memory_order_relaxed);
     }
     
-    return paContinue;
+    finish_callback(playback_callback_metric_, callback_start_us, frame_count, device_rate, "playback deadline miss");
+}
+
+void AudioEngine::finish_callback(Histogram& duration_metric, uint64_t start_us, size_t frame_count,
+                                  uint32_t device_rate, const char* deadline_reason) noexcept {
+    const uint64_t duration_us = steady_time_us() - start_us;
+    duration_metric.record(duration_us);
+    
+    // A callback that outlasts its own buffer period will glitch the device
+    if (device_rate != 0 && duration_us > samples_to_us(frame_count, device_rate)) {
+        deadline_miss_metric_.add();
+        Tracer::mark_xrun(deadline_reason);
+    }
+}
+
+void AudioEngine::append_capture_samples(const float* pcm, size_t count, float volume, uint64_t end_time_us) noexcept {
+    const size_t frame_size = config_.frame_size;
+    
+    size_t consumed = 0;
+    while (consumed < count) {
+        const size_t take = std::min(count - consumed, frame_size - capture_frame_fill_);
+        float* dst = &capture_frame_[capture_frame_fill_];
+        if (volume != 1.0f) {
+            for (size_t i = 0; i < take; ++i) {
+                dst[i] = pcm[consumed + i] * volume;
+            }
+        } else {
+            std::memcpy(dst, pcm + consumed, take * sizeof(float));
+        }
+        capture_frame_fill_ += take;
+        consumed += take;
+        
+        if (capture_frame_fill_ == frame_size) {
+            if (!capture_queue_->try_push(capture_frame_.data(), frame_size)) {
+                queue_full_errors_.fetch_add(1, std::memory_order_relaxed);
+            } else if (capture_times_count_ < capture_times_.size()) {
+                // Frame ends (count - consumed) samples before the end of pcm
+                const uint64_t frame_end_us = end_time_us - samples_to_us(count - consumed, config_.sample_rate);
+                capture_times_[capture_times_count_++] = frame_end_us - samples_to_us(frame_size, config_.sample_rate);
+            }
+            capture_frame_fill_ = 0;
+        }
+    }
+}
+
+void AudioEngine::render_playback_frame(uint64_t playout_time_us) noexcept {
+    const size_t frame_size = config_.frame_size;
+    playback_callback_(playback_frame_.data(), frame_size, playout_time_us);
+    
+    size_t produced = 0;
+    for (size_t offset = 0; offset < frame_size; offset += MAX_RESAMPLER_BLOCK) {
+        const size_t count = std::min(MAX_RESAMPLER_BLOCK, frame_size - offset);
+        produced += playback_resampler_->process(
+            &playback_frame_[offset], count,
+            &playback_fifo_[produced], playback_fifo_.size() - produced);
+    }
+    
+    playback_fifo_read_ = 0;
+    playback_fifo_fill_ = produced;
 }
 
 float AudioEngine::calculate_rms(const float* pcm, size_t count) const noexcept {
+    if (count == 0) {
+        return 0.0f;
+    }
+    
     float sum_squares = 0.0f;
     for (size_t i = 0; i < count; ++i) {
         sum_squares += pcm[i] * pcm[i];
@@ -0,0 +1,244 @@
+#include "audio/audio_file.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+namespace voip::audio {
+
+namespace {
+
+constexpr uint16_t WAV_FORMAT_PCM = 1;
+constexpr uint16_t WAV_FORMAT_FLOAT = 3;
+constexpr uint16_t WAV_FORMAT_EXTENSIBLE = 0xFFFE;
+constexpr size_t WAV_HEADER_SIZE = 44;
+
+bool has_wav_extension(const std::string& path) {
+    if (path.size() < 4) {
+        return false;
+    }
+    std::string ext = path.substr(path.size() - 4);
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext == ".wav";
+}
+
+uint16_t read_u16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t read_u32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void put_u32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+float pcm16_to_float(const uint8_t* p) {
+    return static_cast<float>(static_cast<int16_t>(read_u16(p))) / 32768.0f;
+}
+
+float float32_le(const uint8_t* p) {
+    const uint32_t bits = read_u32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+Result<AudioClip> parse_wav(const std::vector<uint8_t>& data) {
+    if (data.size() < 12 || std::memcmp(data.data(), "RIFF", 4) != 0 ||
+        std::memcmp(data.data() + 8, "WAVE", 4) != 0) {
+        return Err<AudioClip>(ErrorCode::AudioStreamFailed, "Not a RIFF/WAVE file");
+    }
+
+    uint16_t format = 0;
+    uint16_t channels = 0;
+    uint32_t sample_rate = 0;
+    uint16_t bits = 0;
+    const uint8_t* samples = nullptr;
+    size_t samples_size = 0;
+
+    // Walk the chunks; only "fmt " and "data" matter
+    size_t pos = 12;
+    while (pos + 8 <= data.size()) {
+        const uint8_t* chunk = data.data() + pos;
+        const size_t size = read_u32(chunk + 4);
+        const size_t available = std::min(size, data.size() - pos - 8);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && available >= 16) {
+            format = read_u16(chunk + 8);
+            channels = read_u16(chunk + 10);
+            sample_rate = read_u32(chunk + 12);
+            bits = read_u16(chunk + 22);
+            if (format == WAV_FORMAT_EXTENSIBLE && available >= 26) {
+                format = read_u16(chunk + 32);  // First two bytes of the sub-format GUID
+            }
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            samples = chunk + 8;
+            samples_size = available;
+        }
+
+        pos += 8 + size + (size & 1);  // Chunks are word aligned
+    }
+
+    const bool pcm16 = format == WAV_FORMAT_PCM && bits == 16;
+    const bool float32 = format == WAV_FORMAT_FLOAT && bits == 32;
+    if (!pcm16 && !float32) {
+        return Err<AudioClip>(ErrorCode::AudioStreamFailed,
+                             "Unsupported WAV format (need 16-bit PCM or 32-bit float)");
+    }
+    if (channels == 0 || sample_rate == 0 || !samples) {
+        return Err<AudioClip>(ErrorCode::AudioStreamFailed, "Malformed WAV file");
+    }
+
+    const size_t bytes_per_sample = bits / 8;
+    const size_t frame_bytes = bytes_per_sample * channels;
+    const size_t frames = samples_size / frame_bytes;
+
+    AudioClip clip;
+    clip.sample_rate = sample_rate;
+    clip.samples.resize(frames);
+
+    // Downmix to mono
+    for (size_t i = 0; i < frames; ++i) {
+        const uint8_t* frame = samples + i * frame_bytes;
+        float sum = 0.0f;
+        for (size_t ch = 0; ch < channels; ++ch) {
+            const uint8_t* sample = frame + ch * bytes_per_sample;
+            sum += pcm16 ? pcm16_to_float(sample) : float32_le(sample);
+        }
+        clip.samples[i] = sum / static_cast<float>(channels);
+    }
+
+    return Ok(std::move(clip));
+}
+
+} // namespace
+
+Result<AudioClip> read_audio_file(const std::string& path, uint32_t raw_sample_rate) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return Err<AudioClip>(ErrorCode::AudioDeviceNotFound, "Cannot open audio file: " + path);
+    }
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
+                              std::istreambuf_iterator<char>());
+
+    if (has_wav_extension(path)) {
+        auto result = parse_wav(data);
+        if (!result.is_ok()) {
+            return Err<AudioClip>(result.error().code(), path + ": " + result.error().message());
+        }
+        return result;
+    }
+
+    // Raw 16-bit little-endian mono
+    AudioClip clip;
+    clip.sample_rate = raw_sample_rate;
+    clip.samples.resize(data.size() / 2);
+    for (size_t i = 0; i < clip.samples.size(); ++i) {
+        clip.samples[i] = pcm16_to_float(&data[i * 2]);
+    }
+    return Ok(std::move(clip));
+}
+
+// AudioFileWriter
+
+Result<std::unique_ptr<AudioFileWriter>> AudioFileWriter::create(
+    const std::string& path,
+    uint32_t sample_rate
+) {
+    if (sample_rate == 0) {
+        return Err<std::unique_ptr<AudioFileWriter>>(
+            ErrorCode::AudioInitFailed, "Invalid sample rate");
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return Err<std::unique_ptr<AudioFileWriter>>(
+            ErrorCode::AudioDeviceNotFound, "Cannot create audio file: " + path);
+    }
+
+    auto writer = std::unique_ptr<AudioFileWriter>(
+        new AudioFileWriter(std::move(file), sample_rate, has_wav_extension(path)));
+    if (writer->is_wav_) {
+        writer->write_wav_header();  // Placeholder sizes until close()
+    }
+    return Ok(std::move(writer));
+}
+
+AudioFileWriter::AudioFileWriter(std::ofstream file, uint32_t sample_rate, bool is_wav)
+    : file_(std::move(file))
+    , sample_rate_(sample_rate)
+    , is_wav_(is_wav)
+{
+}
+
+AudioFileWriter::~AudioFileWriter() {
+    close();
+}
+
+void AudioFileWriter::write(const float* pcm, size_t count) {
+    if (!file_.is_open() || count == 0) {
+        return;
+    }
+
+    scratch_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const float clamped = std::clamp(pcm[i], -1.0f, 1.0f);
+        const auto value = static_cast<int16_t>(std::lround(clamped * 32767.0f));
+        // Store little-endian regardless of host order
+        uint8_t* bytes = reinterpret_cast<uint8_t*>(&scratch_[i]);
+        put_u16(bytes, static_cast<uint16_t>(value));
+    }
+
+    file_.write(reinterpret_cast<const char*>(scratch_.data()),
+                static_cast<std::streamsize>(count * sizeof(int16_t)));
+    samples_written_ += count;
+}
+
+void AudioFileWriter::close() {
+    if (!file_.is_open()) {
+        return;
+    }
+
+    if (is_wav_) {
+        file_.seekp(0);
+        write_wav_header();
+    }
+    file_.close();
+}
+
+void AudioFileWriter::write_wav_header() {
+    const uint32_t data_bytes = static_cast<uint32_t>(
+        std::min<uint64_t>(samples_written_ * 2, UINT32_MAX - WAV_HEADER_SIZE));
+
+    uint8_t header[WAV_HEADER_SIZE];
+    std::memcpy(header, "RIFF", 4);
+    put_u32(header + 4, static_cast<uint32_t>(WAV_HEADER_SIZE - 8) + data_bytes);
+    std::memcpy(header + 8, "WAVE", 4);
+    std::memcpy(header + 12, "fmt ", 4);
+    put_u32(header + 16, 16);
+    put_u16(header + 20, WAV_FORMAT_PCM);
+    put_u16(header + 22, 1);                  // Mono
+    put_u32(header + 24, sample_rate_);
+    put_u32(header + 28, sample_rate_ * 2);   // Byte rate
+    put_u16(header + 32, 2);                  // Block align
+    put_u16(header + 34, 16);                 // Bits per sample
+    std::memcpy(header + 36, "data", 4);
+    put_u32(header + 40, data_bytes);
+
+    file_.write(reinterpret_cast<const char*>(header), sizeof(header));
+}
+
+} // namespace voip::audio
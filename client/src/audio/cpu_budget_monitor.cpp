@@ -0,0 +1,55 @@
+#include "audio/cpu_budget_monitor.h"
+#include <algorithm>
+
+namespace voip::audio {
+
+CpuBudgetMonitor::CpuBudgetMonitor(const Config& config)
+    : config_(config)
+    , budget_us_(static_cast<uint32_t>(static_cast<float>(config.frame_duration_us) * config.budget_fraction))
+    , complexity_cap_(config.max_complexity)
+{
+    config_.window_frames = std::clamp<uint32_t>(config_.window_frames, 1, MAX_WINDOW);
+}
+
+bool CpuBudgetMonitor::record(uint32_t encode_us) noexcept {
+    samples_[sample_count_++] = encode_us;
+    if (sample_count_ < config_.window_frames) {
+        return false;
+    }
+
+    const int previous_cap = complexity_cap_;
+    evaluate();
+    sample_count_ = 0;
+    return complexity_cap_ != previous_cap;
+}
+
+void CpuBudgetMonitor::evaluate() noexcept {
+    // Sorting in place is fine: the window is discarded afterwards
+    auto begin = samples_.begin();
+    auto end = samples_.begin() + static_cast<std::ptrdiff_t>(sample_count_);
+    std::sort(begin, end);
+
+    auto at = [&](size_t percent) {
+        const size_t index = std::min(sample_count_ - 1, (sample_count_ * percent) / 100);
+        return samples_[index];
+    };
+    percentiles_.p50_us = at(50);
+    percentiles_.p95_us = at(95);
+    percentiles_.p99_us = at(99);
+
+    if (percentiles_.p95_us > budget_us_) {
+        // Over budget: back off straight away
+        complexity_cap_ = std::max(config_.min_complexity, complexity_cap_ - 1);
+        headroom_windows_ = 0;
+    } else if (static_cast<float>(percentiles_.p95_us) < static_cast<float>(budget_us_) * config_.raise_fraction) {
+        // Plenty of headroom: step back up only once it has lasted a while
+        if (++headroom_windows_ >= config_.raise_after_windows) {
+            complexity_cap_ = std::min(config_.max_complexity, complexity_cap_ + 1);
+            headroom_windows_ = 0;
+        }
+    } else {
+        headroom_windows_ = 0;
+    }
+}
+
+} // namespace voip::audio
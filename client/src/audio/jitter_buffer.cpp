@@ -4,13 +4,19 @@
 
 namespace voip::audio {
 
-JitterBuffer::JitterBuffer(uint32_t buffer_frames, uint32_t frame_size)
+JitterBuffer::JitterBuffer(uint32_t buffer_frames, uint32_t frame_size, uint32_t sample_rate)
     : max_packets_(buffer_frames * 2)  // Allow some headroom
     , frame_size_(frame_size)
+    , sample_rate_(sample_rate)
     , target_buffer_size_(buffer_frames)
+    , last_frame_size_(frame_size)
+    , depth_metric_(MetricsRegistry::global().histogram(
+          "voip_jitter_buffer_depth", "Packets buffered when a packet is played out"))
+    , queue_wait_metric_(MetricsRegistry::global().histogram(
+          "voip_jitter_queue_wait_us", "Time a packet waited in the jitter buffer"))
+    , underrun_metric_(MetricsRegistry::global().counter(
+          "voip_jitter_buffer_underruns_total", "Playout found the jitter buffer empty"))
 {
-    // deque doesn't have reserve()
-    recent_jitter_.reserve(100);  // Track last 100 samples for jitter calculation
 }
 
 bool JitterBuffer::push(AudioPacket packet) {
@@ -18,6 +24,17 @@ bool JitterBuffer::push(AudioPacket packet) {
     
     stats_.packets_received++;
     
+    // Jitter is a property of the network, so measure it on arrival
+    if (packet.arrival_us != 0) {
+        const float jitter_us = sender_jitter_[packet.sender].update(
+            static_cast<uint64_t>(packet.timestamp.count()), packet.arrival_us);
+        float worst_us = jitter_us;
+        for (const auto& [sender, jitter] : sender_jitter_) {
+            worst_us = std::max(worst_us, jitter.jitter_us());
+        }
+        stats_.jitter_ms = worst_us / 1000.0f;
+    }
+    
     // First packet initializes sequence tracking
     if (!initialized_) {
         next_sequence_ = packet.sequence;
@@ -30,16 +47,32 @@ bool JitterBuffer::push(AudioPacket packet) {
         return false;
     }
     
-    // Check for extremely late packet (more than buffer capacity behind)
+    // Further ahead than the buffer spans (a long loss burst, or playout
+    // stalled): skip to it, or nothing would ever be accepted again
     if (packet.sequence > next_sequence_ + max_packets_) {
-        stats_.packets_late++;
-        return false;
+        const SequenceNumber resume = packet.sequence - max_packets_;
+        SequenceNumber skipped = resume - next_sequence_;
+        while (!buffer_.empty() && buffer_.front().sequence < resume) {
+            stats_.packets_dropped++;
+            skipped--;
+            buffer_.pop_front();
+        }
+        stats_.packets_late += skipped;
+        next_sequence_ = resume;
     }
     
-    // Buffer is full, drop oldest if necessary
+    // Buffer is full: drop the oldest, and the missing ones ahead of it, so
+    // playout catches up
     if (buffer_.size() >= max_packets_) {
-        stats_.packets_dropped++;
+        const SequenceNumber dropped = buffer_.front().sequence;
         buffer_.pop_front();
+        stats_.packets_dropped++;
+        stats_.packets_late += dropped - next_sequence_;
+        next_sequence_ = dropped + 1;
+        if (packet.sequence < next_sequence_) {
+            stats_.packets_late++;
+            return false;
+        }
     }
     
     // Find insertion point to maintain sorted order
@@ -52,11 +85,17 @@ bool JitterBuffer::push(AudioPacket packet) {
         return false;
     }
     
-    // Insert packet
+    // Insert packet (frame duration is per packet; senders may change it)
+    const size_t frame_size = packet.frame_size != 0 ? packet.frame_size : frame_size_;
+    last_frame_size_ = frame_size;
+    
     BufferEntry entry{
         .sequence = packet.sequence,
         .timestamp = packet.timestamp,
-        .samples = std::move(packet.samples)
+        .samples = std::move(packet.samples),
+        .frame_size = frame_size,
+        .sender = packet.sender,
+        .arrival_us = packet.arrival_us
     };
     
     buffer_.insert(buffer_.begin() + insert_pos, std::move(entry));
@@ -71,16 +110,26 @@ bool JitterBuffer::push(AudioPacket packet) {
 std::optional<AudioPacket> JitterBuffer::pop() {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    // Wait until we have at least target_buffer_size packets (initial buffering)
-    if (buffer_.size() < target_buffer_size_) {
-        return std::nullopt;
+    // Fill to target_buffer_size packets before playout starts (again)
+    if (!playing_) {
+        if (buffer_.empty() || buffer_.size() < target_buffer_size_) {
+            return std::nullopt;
+        }
+        playing_ = true;
+        
+        // Slots of packets missing before the oldest were already stalled
+        // through; resume with what is held instead of concealing them late
+        if (buffer_.front().sequence > next_sequence_) {
+            stats_.packets_late += buffer_.front().sequence - next_sequence_;
+            next_sequence_ = buffer_.front().sequence;
+        }
     }
     
-    // Check if we have the next expected packet
+    // Ran dry: count it and build the cushion up again
     if (buffer_.empty()) {
-        if (initialized_) {
-            stats_.underruns++;
-        }
+        stats_.underruns++;
+        underrun_metric_.add();
+        playing_ = false;
         return std::nullopt;
     }
     
@@ -89,40 +138,25 @@ std::optional<AudioPacket> JitterBuffer::pop() {
     
     // Check if we have the next expected packet
     if (front.sequence == next_sequence_) {
+        depth_metric_.record(buffer_.size());
+        if (front.arrival_us != 0) {
+            const uint64_t now_us = steady_time_us();
+            queue_wait_metric_.record(now_us > front.arrival_us ? now_us - front.arrival_us : 0);
+        }
+        
         // Perfect - we have the next packet
         AudioPacket result{
             .sequence = front.sequence,
             .timestamp = front.timestamp,
             .samples = std::move(front.samples),
-            .frame_size = frame_size_
+            .frame_size = front.frame_size,
+            .sender = front.sender,
+            .arrival_us = front.arrival_us
         };
         
         buffer_.pop_front();
         next_sequence_++;
         
-        // Update timing for jitter calculation
-        auto now = Timestamp(std::chrono::duration_cast<std::chrono::microseconds>(
-            std::chrono::high_resolution_clock::now().time_since_epoch()
-        ).count());
-        
-        if (last_pop_time_.has_value()) {
-            auto delta = now.count() - last_pop_time_.value().count();
-            
-            float jitter = std::abs(static_cast<float>(delta) - 20000.0f);  // 20ms expected
-            recent_jitter_.push_back(jitter);
-            if (recent_jitter_.size() > 100) {
-                recent_jitter_.erase(recent_jitter_.begin());
-            }
-            
-            // Calculate average jitter
-            float sum = 0.0f;
-            for (float j : recent_jitter_) {
-                sum += j;
-            }
-            stats_.jitter_ms = sum / (recent_jitter_.size() * 1000.0f);
-        }
-        last_pop_time_ = now;
-        
         return result;
     }
     
@@ -133,7 +167,7 @@ std::optional<AudioPacket> JitterBuffer::pop() {
             .sequence = next_sequence_,
             .timestamp = Timestamp(0),  // Unknown timestamp
             .samples = {},  // Empty indicates loss
-            .frame_size = frame_size_
+            .frame_size = last_frame_size_
         };
         
         next_sequence_++;
@@ -161,14 +195,16 @@ void JitterBuffer::reset() {
     buffer_.clear();
     next_sequence_ = 0;
     initialized_ = false;
-    last_pop_time_.reset();
-    recent_jitter_.clear();
+    playing_ = false;
+    last_frame_size_ = frame_size_;
+    sender_jitter_.clear();
     stats_ = JitterStats{};
 }
 
 JitterStats JitterBuffer::get_stats() const {
     std::lock_guard<std::mutex> lock(mutex_);
     stats_.current_buffer_size = static_cast<uint32_t>(buffer_.size());
+    stats_.frame_duration_us = frame_duration_us(sample_rate_, static_cast<uint32_t>(last_frame_size_));
     return stats_;
 }
 
@@ -0,0 +1,72 @@
+#include "audio/latency_probe.h"
+#include <cmath>
+
+namespace voip::audio {
+
+LatencyProbe::LatencyProbe(const Config& config)
+    : config_(config)
+    , marker_samples_(static_cast<size_t>(config.sample_rate) * config.marker_ms / 1000)
+    , interval_us_(static_cast<uint64_t>(config.interval_ms) * 1000)
+    , marker_pos_(marker_samples_)
+{
+}
+
+void LatencyProbe::inject(float* pcm, size_t frame_count, uint64_t capture_time_us) noexcept {
+    constexpr double two_pi = 6.283185307179586;
+
+    // Markers start on a frame boundary so the frame's capture time is exact
+    if (marker_pos_ >= marker_samples_ && capture_time_us >= next_marker_us_) {
+        marker_pos_ = 0;
+        next_marker_us_ = capture_time_us + interval_us_;
+        marker_time_us_.store(capture_time_us, std::memory_order_release);
+        markers_sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    for (size_t i = 0; i < frame_count; ++i) {
+        if (marker_pos_ < marker_samples_) {
+            // Hard onset: a clear edge survives the codec
+            pcm[i] = config_.amplitude * static_cast<float>(
+                std::sin(two_pi * config_.tone_hz * static_cast<double>(marker_pos_) / config_.sample_rate));
+            marker_pos_++;
+        } else {
+            pcm[i] = 0.0f;
+        }
+    }
+}
+
+bool LatencyProbe::detect(const float* pcm, size_t frame_count, uint64_t playout_time_us, uint64_t& latency_us) noexcept {
+    bool found = false;
+
+    for (size_t i = 0; i < frame_count; ++i) {
+        if (std::fabs(pcm[i]) < config_.threshold) {
+            // A burst dips below threshold at every zero crossing; only a
+            // gap as long as the burst itself re-arms the detector
+            if (!armed_ && ++quiet_samples_ >= marker_samples_) {
+                armed_ = true;
+            }
+            continue;
+        }
+
+        quiet_samples_ = 0;
+        if (!armed_) {
+            continue;
+        }
+        armed_ = false;
+
+        const uint64_t marker_us = marker_time_us_.load(std::memory_order_acquire);
+        const uint64_t onset_us = playout_time_us + static_cast<uint64_t>(i) * 1000000 / config_.sample_rate;
+        if (marker_us == 0 || marker_us == matched_marker_us_ || onset_us < marker_us ||
+            onset_us - marker_us >= interval_us_) {
+            continue;  // Not the latest marker (stray audio or a lost marker)
+        }
+
+        matched_marker_us_ = marker_us;
+        latency_us = onset_us - marker_us;
+        markers_detected_.fetch_add(1, std::memory_order_relaxed);
+        found = true;
+    }
+
+    return found;
+}
+
+} // namespace voip::audio
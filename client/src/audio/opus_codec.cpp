@@ -49,6 +49,13 @@ OpusEncoder::~OpusEncoder() {
 }
 
 Result<EncodedPacket> OpusEncoder::encode(const float* pcm, size_t frame_count) {
+    if (!is_valid_opus_frame_size(config_.sample_rate, static_cast<uint32_t>(frame_count))) {
+        return Err<EncodedPacket>(
+            ErrorCode::OpusEncodeFailed,
+            "Invalid Opus frame size: " + std::to_string(frame_count) + " samples"
+        );
+    }
+    
     const int encoded_bytes = opus_encode_float(
         encoder_,
         pcm,
@@ -186,6 +193,27 @@ Result<size_t> OpusDecoder::decode(
     return Ok(static_cast<size_t>(decoded_samples));
 }
 
+Result<size_t> OpusDecoder::packet_frame_size(
+    const uint8_t* opus_data,
+    size_t opus_size,
+    uint32_t sample_rate
+) {
+    const int samples = opus_packet_get_nb_samples(
+        opus_data,
+        static_cast<opus_int32>(opus_size),
+        static_cast<opus_int32>(sample_rate)
+    );
+    
+    if (samples < 0) {
+        return Err<size_t>(
+            ErrorCode::OpusDecodeFailed,
+            std::string("opus_packet_get_nb_samples failed: ") + opus_strerror(samples)
+        );
+    }
+    
+    return Ok(static_cast<size_t>(samples));
+}
+
 Result<size_t> OpusDecoder::decode_plc(float* pcm_out, size_t frame_size) {
     // Call opus_decode with NULL packet for PLC
     const int decoded_samples = opus_decode_float(
@@ -207,4 +235,165 @@ Result<size_t> OpusDecoder::decode_plc(float* pcm_out, size_t frame_size) {
     return Ok(static_cast<size_t>(decoded_samples));
 }
 
+Result<size_t> OpusDecoder::decode_fec(
+    const uint8_t* next_opus_data,
+    size_t next_opus_size,
+    float* pcm_out,
+    size_t frame_size
+) {
+    // decode_fec=1 decodes the redundant copy of the previous frame;
+    // frame_size must be exactly the missing frame's duration
+    const int decoded_samples = opus_decode_float(
+        decoder_,
+        next_opus_data,
+        static_cast<int>(next_opus_size),
+        pcm_out,
+        static_cast<int>(frame_size),
+        1
+    );
+    
+    if (decoded_samples < 0) {
+        return Err<size_t>(
+            ErrorCode::OpusDecodeFailed,
+            std::string("opus_decode_float (FEC) failed: ") + opus_strerror(decoded_samples)
+        );
+    }
+    
+    return Ok(static_cast<size_t>(decoded_samples));
+}
+
+Result<void> OpusDecoder::reset() {
+    const int result = opus_decoder_ctl(decoder_, OPUS_RESET_STATE);
+    if (result != OPUS_OK) {
+        return Err<void>(ErrorCode::OpusDecodeFailed,
+                        std::string("OPUS_RESET_STATE failed: ") + opus_strerror(result));
+    }
+    return Ok();
+}
+
+// OpusRepacketizer implementation
+
+Result<std::unique_ptr<OpusRepacketizer>> OpusRepacketizer::create() {
+    ::OpusRepacketizer* repacketizer = opus_repacketizer_create();
+    if (!repacketizer) {
+        return Err<std::unique_ptr<OpusRepacketizer>>(
+            ErrorCode::AudioInitFailed,
+            "opus_repacketizer_create failed"
+        );
+    }
+    
+    return Ok(std::unique_ptr<OpusRepacketizer>(new OpusRepacketizer(repacketizer)));
+}
+
+OpusRepacketizer::OpusRepacketizer(::OpusRepacketizer* repacketizer)
+    : repacketizer_(repacketizer)
+{
+}
+
+OpusRepacketizer::~OpusRepacketizer() {
+    if (repacketizer_) {
+        opus_repacketizer_destroy(repacketizer_);
+    }
+}
+
+void OpusRepacketizer::reset() {
+    opus_repacketizer_init(repacketizer_);
+    pending_.clear();
+}
+
+Result<void> OpusRepacketizer::add(const uint8_t* opus_data, size_t opus_size) {
+    std::vector<uint8_t> packet(opus_data, opus_data + opus_size);
+    const int result = opus_repacketizer_cat(
+        repacketizer_,
+        packet.data(),
+        static_cast<opus_int32>(packet.size())
+    );
+    
+    if (result != OPUS_OK) {
+        return Err<void>(
+            ErrorCode::OpusEncodeFailed,
+            std::string("opus_repacketizer_cat failed: ") + opus_strerror(result)
+        );
+    }
+    
+    pending_.push_back(std::move(packet));
+    return Ok();
+}
+
+size_t OpusRepacketizer::frame_count() const noexcept {
+    const int frames = opus_repacketizer_get_nb_frames(repacketizer_);
+    return frames > 0 ? static_cast<size_t>(frames) : 0;
+}
+
+Result<std::vector<uint8_t>> OpusRepacketizer::take() {
+    // Room for every frame plus a code 3 header with two-byte frame lengths
+    size_t capacity = 2;
+    for (const auto& packet : pending_) {
+        capacity += packet.size() + 2;
+    }
+    
+    std::vector<uint8_t> out(capacity);
+    const opus_int32 size = opus_repacketizer_out(
+        repacketizer_,
+        out.data(),
+        static_cast<opus_int32>(out.size())
+    );
+    reset();
+    
+    if (size < 0) {
+        return Err<std::vector<uint8_t>>(
+            ErrorCode::OpusEncodeFailed,
+            std::string("opus_repacketizer_out failed: ") + opus_strerror(size)
+        );
+    }
+    
+    out.resize(static_cast<size_t>(size));
+    return Ok(std::move(out));
+}
+
+Result<std::vector<std::vector<uint8_t>>> OpusRepacketizer::split(const uint8_t* opus_data, size_t opus_size) {
+    using Frames = std::vector<std::vector<uint8_t>>;
+    
+    const int frames = opus_packet_get_nb_frames(opus_data, static_cast<opus_int32>(opus_size));
+    if (frames < 0) {
+        return Err<Frames>(
+            ErrorCode::OpusDecodeFailed,
+            std::string("opus_packet_get_nb_frames failed: ") + opus_strerror(frames)
+        );
+    }
+    if (frames <= 1) {
+        return Ok(Frames{std::vector<uint8_t>(opus_data, opus_data + opus_size)});
+    }
+    
+    reset();
+    const int result = opus_repacketizer_cat(repacketizer_, opus_data, static_cast<opus_int32>(opus_size));
+    if (result != OPUS_OK) {
+        return Err<Frames>(
+            ErrorCode::OpusDecodeFailed,
+            std::string("opus_repacketizer_cat failed: ") + opus_strerror(result)
+        );
+    }
+    
+    Frames out;
+    out.reserve(static_cast<size_t>(frames));
+    for (int i = 0; i < frames; ++i) {
+        // A frame on its own never needs more than the packet it came from
+        std::vector<uint8_t> frame(opus_size);
+        const opus_int32 size = opus_repacketizer_out_range(
+            repacketizer_, i, i + 1, frame.data(), static_cast<opus_int32>(frame.size()));
+        if (size < 0) {
+            reset();
+            return Err<Frames>(
+                ErrorCode::OpusDecodeFailed,
+                std::string("opus_repacketizer_out_range failed: ") + opus_strerror(size)
+            );
+        }
+        frame.resize(static_cast<size_t>(size));
+        out.push_back(std::move(frame));
+    }
+    
+    reset();
+    return Ok(std::move(out));
+}
+
 } // namespace voip::audio
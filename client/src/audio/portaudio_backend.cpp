@@ -0,0 +1,259 @@
+#include "audio/portaudio_backend.h"
+#include <algorithm>
+
+namespace voip::audio {
+
+PortAudioBackend::~PortAudioBackend() {
+    terminate();
+}
+
+Result<void> PortAudioBackend::initialize() {
+    if (initialized_) {
+        return Ok();
+    }
+
+    PaError err = Pa_Initialize();
+    if (err != paNoError) {
+        return Err<void>(ErrorCode::AudioInitFailed,
+                        std::string("PortAudio init failed: ") + Pa_GetErrorText(err));
+    }
+
+    initialized_ = true;
+    return Ok();
+}
+
+void PortAudioBackend::terminate() {
+    if (!initialized_) {
+        return;
+    }
+
+    close_capture();
+    close_playback();
+
+    Pa_Terminate();
+    initialized_ = false;
+}
+
+std::vector<AudioDevice> PortAudioBackend::enumerate_input_devices() {
+    std::vector<AudioDevice> devices;
+
+    const PaDeviceIndex device_count = Pa_GetDeviceCount();
+    const PaDeviceIndex default_input = Pa_GetDefaultInputDevice();
+
+    for (PaDeviceIndex i = 0; i < device_count; ++i) {
+        const PaDeviceInfo* info = Pa_GetDeviceInfo(i);
+        if (info && info->maxInputChannels > 0) {
+            devices.push_back({
+                .id = i,
+                .name = info->name,
+                .max_input_channels = info->maxInputChannels,
+                .max_output_channels = 0,
+                .default_sample_rate = info->defaultSampleRate,
+                .is_default = (i == default_input)
+            });
+        }
+    }
+
+    return devices;
+}
+
+std::vector<AudioDevice> PortAudioBackend::enumerate_output_devices() {
+    std::vector<AudioDevice> devices;
+
+    const PaDeviceIndex device_count = Pa_GetDeviceCount();
+    const PaDeviceIndex default_output = Pa_GetDefaultOutputDevice();
+
+    for (PaDeviceIndex i = 0; i < device_count; ++i) {
+        const PaDeviceInfo* info = Pa_GetDeviceInfo(i);
+        if (info && info->maxOutputChannels > 0) {
+            devices.push_back({
+                .id = i,
+                .name = info->name,
+                .max_input_channels = 0,
+                .max_output_channels = info->maxOutputChannels,
+                .default_sample_rate = info->defaultSampleRate,
+                .is_default = (i == default_output)
+            });
+        }
+    }
+
+    return devices;
+}
+
+DeviceId PortAudioBackend::default_input_device() {
+    return Pa_GetDefaultInputDevice();
+}
+
+DeviceId PortAudioBackend::default_output_device() {
+    return Pa_GetDefaultOutputDevice();
+}
+
+PaStreamParameters PortAudioBackend::stream_parameters(DeviceId device, bool is_input) {
+    if (device == NO_DEVICE) {
+        device = is_input ? Pa_GetDefaultInputDevice() : Pa_GetDefaultOutputDevice();
+    }
+
+    PaStreamParameters params;
+    params.device = device;
+    params.channelCount = 1;  // Mono
+    params.sampleFormat = paFloat32;
+    params.suggestedLatency = 0.0;
+    params.hostApiSpecificStreamInfo = nullptr;
+
+    if (const PaDeviceInfo* info = Pa_GetDeviceInfo(device)) {
+        params.suggestedLatency = is_input ? info->defaultLowInputLatency
+                                           : info->defaultLowOutputLatency;
+    }
+    return params;
+}
+
+uint32_t PortAudioBackend::select_sample_rate(DeviceId device, bool is_input, uint32_t preferred) {
+    const PaStreamParameters params = stream_parameters(device, is_input);
+    const PaError supported = Pa_IsFormatSupported(
+        is_input ? &params : nullptr,
+        is_input ? nullptr : &params,
+        preferred
+    );
+    if (supported == paFormatIsSupported) {
+        return preferred;
+    }
+
+    const PaDeviceInfo* info = Pa_GetDeviceInfo(params.device);
+    if (!info || info->defaultSampleRate <= 0.0) {
+        return preferred;
+    }
+    return static_cast<uint32_t>(info->defaultSampleRate);
+}
+
+Result<void> PortAudioBackend::open_stream(
+    PaStream** stream,
+    const DeviceStreamConfig& config,
+    bool is_input
+) {
+    const PaStreamParameters params = stream_parameters(config.device, is_input);
+    if (!Pa_GetDeviceInfo(params.device)) {
+        return Err<void>(ErrorCode::AudioDeviceNotFound,
+                        is_input ? "No input device" : "No output device");
+    }
+
+    const char* direction = is_input ? "capture" : "playback";
+    PaError err = Pa_OpenStream(
+        stream,
+        is_input ? &params : nullptr,
+        is_input ? nullptr : &params,
+        config.sample_rate,
+        config.buffer_frames != 0 ? config.buffer_frames : paFramesPerBufferUnspecified,
+        paNoFlag,
+        is_input ? &PortAudioBackend::capture_callback_static
+                 : &PortAudioBackend::playback_callback_static,
+        this
+    );
+
+    if (err != paNoError) {
+        *stream = nullptr;
+        return Err<void>(ErrorCode::AudioStreamFailed,
+                        std::string("Failed to open ") + direction + " stream: " + Pa_GetErrorText(err));
+    }
+
+    err = Pa_StartStream(*stream);
+    if (err != paNoError) {
+        Pa_CloseStream(*stream);
+        *stream = nullptr;
+        return Err<void>(ErrorCode::AudioStreamFailed,
+                        std::string("Failed to start ") + direction + " stream: " + Pa_GetErrorText(err));
+    }
+
+    return Ok();
+}
+
+Result<void> PortAudioBackend::open_capture(const DeviceStreamConfig& config, DeviceCaptureCallback callback) {
+    if (capture_stream_) {
+        return Err<void>(ErrorCode::InvalidState, "Capture stream already open");
+    }
+
+    capture_callback_ = std::move(callback);
+    return open_stream(&capture_stream_, config, true);
+}
+
+Result<void> PortAudioBackend::open_playback(const DeviceStreamConfig& config, DevicePlaybackCallback callback) {
+    if (playback_stream_) {
+        return Err<void>(ErrorCode::InvalidState, "Playback stream already open");
+    }
+
+    playback_callback_ = std::move(callback);
+    return open_stream(&playback_stream_, config, false);
+}
+
+void PortAudioBackend::close_capture() {
+    if (capture_stream_) {
+        Pa_StopStream(capture_stream_);
+        Pa_CloseStream(capture_stream_);
+        capture_stream_ = nullptr;
+    }
+}
+
+void PortAudioBackend::close_playback() {
+    if (playback_stream_) {
+        Pa_StopStream(playback_stream_);
+        Pa_CloseStream(playback_stream_);
+        playback_stream_ = nullptr;
+    }
+}
+
+int64_t PortAudioBackend::stream_offset_us(PaTime current_time, PaTime buffer_time) noexcept {
+    // Stream clock is unrelated to steady_clock; only the offset from
+    // currentTime carries over. Some host APIs leave the fields zero.
+    if (current_time <= 0.0 || buffer_time <= 0.0) {
+        return 0;
+    }
+    const double offset_us = (buffer_time - current_time) * 1e6;
+    if (offset_us < -1e6 || offset_us > 1e6) {
+        return 0;  // Implausible (> 1s): ignore rather than skew latency stats
+    }
+    return static_cast<int64_t>(offset_us);
+}
+
+// Static callback wrappers
+int PortAudioBackend::capture_callback_static(
+    const void* input,
+    void* /*output*/,
+    unsigned long frame_count,
+    const PaStreamCallbackTimeInfo* time_info,
+    PaStreamCallbackFlags status_flags,
+    void* user_data
+) {
+    auto* backend = static_cast<PortAudioBackend*>(user_data);
+    const int64_t offset_us = time_info
+        ? std::min<int64_t>(0, stream_offset_us(time_info->currentTime, time_info->inputBufferAdcTime))
+        : 0;
+    backend->capture_callback_(
+        static_cast<const float*>(input),
+        frame_count,
+        static_cast<uint64_t>(static_cast<int64_t>(steady_time_us()) + offset_us),
+        (status_flags & paInputOverflow) != 0
+    );
+    return paContinue;
+}
+
+int PortAudioBackend::playback_callback_static(
+    const void* /*input*/,
+    void* output,
+    unsigned long frame_count,
+    const PaStreamCallbackTimeInfo* time_info,
+    PaStreamCallbackFlags status_flags,
+    void* user_data
+) {
+    auto* backend = static_cast<PortAudioBackend*>(user_data);
+    const int64_t offset_us = time_info
+        ? std::max<int64_t>(0, stream_offset_us(time_info->currentTime, time_info->outputBufferDacTime))
+        : 0;
+    backend->playback_callback_(
+        static_cast<float*>(output),
+        frame_count,
+        static_cast<uint64_t>(static_cast<int64_t>(steady_time_us()) + offset_us),
+        (status_flags & paOutputUnderflow) != 0
+    );
+    return paContinue;
+}
+
+} // namespace voip::audio
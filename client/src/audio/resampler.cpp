@@ -0,0 +1,201 @@
+#include "audio/resampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define VOIP_RESAMPLER_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define VOIP_RESAMPLER_NEON 1
+#endif
+
+namespace voip::audio {
+
+namespace {
+
+// Largest interpolation factor we accept (filter bank = taps * L floats)
+constexpr uint32_t MAX_UP_FACTOR = 1024;
+
+constexpr double PI = 3.14159265358979323846;
+
+// Kaiser window shape (~80 dB stopband attenuation)
+constexpr double KAISER_BETA = 8.0;
+
+// Passband edge relative to the lower Nyquist frequency
+constexpr double CUTOFF_RATIO = 0.92;
+
+// Zeroth-order modified Bessel function (for Kaiser window)
+double bessel_i0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    const double half_x = x / 2.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= half_x / k;
+        sum += term * term;
+        if (term * term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+// Dot product of two float arrays (count must be a multiple of 4)
+inline float dot_product(const float* a, const float* b, size_t count) noexcept {
+#if defined(VOIP_RESAMPLER_SSE)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    for (; i < count; i += 4) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    acc0 = _mm_add_ps(acc0, acc1);
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, acc0);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(VOIP_RESAMPLER_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (size_t i = 0; i < count; i += 4) {
+        acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+    float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    return vget_lane_f32(vpadd_f32(sum, sum), 0);
+#else
+    float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (size_t i = 0; i < count; i += 4) {
+        acc[0] += a[i] * b[i];
+        acc[1] += a[i + 1] * b[i + 1];
+        acc[2] += a[i + 2] * b[i + 2];
+        acc[3] += a[i + 3] * b[i + 3];
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+}
+
+} // namespace
+
+Result<std::unique_ptr<Resampler>> Resampler::create(
+    uint32_t input_rate,
+    uint32_t output_rate,
+    size_t max_input_frames
+) {
+    if (input_rate == 0 || output_rate == 0 || max_input_frames == 0) {
+        return Err<std::unique_ptr<Resampler>>(
+            ErrorCode::AudioInitFailed, "Invalid resampler parameters");
+    }
+
+    const uint32_t g = std::gcd(input_rate, output_rate);
+    const uint32_t up = output_rate / g;
+    const uint32_t down = input_rate / g;
+
+    if (up > MAX_UP_FACTOR) {
+        return Err<std::unique_ptr<Resampler>>(
+            ErrorCode::AudioInitFailed,
+            "Unsupported resampling ratio " + std::to_string(input_rate) +
+            " -> " + std::to_string(output_rate) + " Hz");
+    }
+
+    auto resampler = std::unique_ptr<Resampler>(
+        new Resampler(input_rate, output_rate, up, down, max_input_frames));
+    return Ok(std::move(resampler));
+}
+
+Resampler::Resampler(uint32_t input_rate, uint32_t output_rate,
+                     uint32_t up, uint32_t down, size_t max_input_frames)
+    : input_rate_(input_rate)
+    , output_rate_(output_rate)
+    , up_(up)
+    , down_(down)
+    , max_input_frames_(max_input_frames)
+    , work_(taps_ - 1 + max_input_frames, 0.0f)
+{
+    if (!is_passthrough()) {
+        design_filter();
+    }
+}
+
+void Resampler::design_filter() {
+    const size_t length = taps_ * up_;
+    const double center = static_cast<double>(length - 1) / 2.0;
+
+    // Cutoff in cycles per upsampled sample: below both Nyquist limits
+    const double cutoff = CUTOFF_RATIO * 0.5 / static_cast<double>(std::max(up_, down_));
+    const double window_norm = bessel_i0(KAISER_BETA);
+
+    std::vector<double> prototype(length);
+    for (size_t n = 0; n < length; ++n) {
+        const double t = static_cast<double>(n) - center;
+        const double x = 2.0 * cutoff * t;
+        const double sinc = (std::abs(x) < 1e-12) ? 1.0 : std::sin(PI * x) / (PI * x);
+        const double r = t / center;
+        const double window = bessel_i0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - r * r))) / window_norm;
+        // Gain of L compensates for the zero-stuffing of the upsampler
+        prototype[n] = 2.0 * cutoff * sinc * window * static_cast<double>(up_);
+    }
+
+    // Split into polyphase branches, time-reversed:
+    // branch p tap k = h[(taps-1-k) * L + p]
+    coefficients_.assign(taps_ * up_, 0.0f);
+    for (uint32_t p = 0; p < up_; ++p) {
+        float* branch = &coefficients_[p * taps_];
+        for (size_t k = 0; k < taps_; ++k) {
+            branch[k] = static_cast<float>(prototype[(taps_ - 1 - k) * up_ + p]);
+        }
+    }
+}
+
+size_t Resampler::process(const float* input, size_t input_count,
+                          float* output, size_t output_capacity) noexcept {
+    input_count = std::min(input_count, max_input_frames_);
+
+    if (is_passthrough()) {
+        const size_t count = std::min(input_count, output_capacity);
+        std::memcpy(output, input, count * sizeof(float));
+        return count;
+    }
+
+    // Append new block after the retained history
+    constexpr size_t history = taps_ - 1;
+    std::memcpy(&work_[history], input, input_count * sizeof(float));
+
+    size_t produced = 0;
+    const uint64_t block_end = static_cast<uint64_t>(input_count) * up_;
+
+    while (position_ < block_end && produced < output_capacity) {
+        const size_t index = static_cast<size_t>(position_ / up_);
+        const size_t phase = static_cast<size_t>(position_ % up_);
+        output[produced++] = dot_product(&work_[index], &coefficients_[phase * taps_], taps_);
+        position_ += down_;
+    }
+
+    // Rebase position and keep the tail as history for the next block
+    position_ = (position_ >= block_end) ? position_ - block_end : 0;
+    std::memmove(work_.data(), &work_[input_count], history * sizeof(float));
+
+    return produced;
+}
+
+size_t Resampler::max_output_frames(size_t input_count) const noexcept {
+    return (input_count * up_ + down_ - 1) / down_ + 1;
+}
+
+void Resampler::reset() noexcept {
+    std::fill(work_.begin(), work_.end(), 0.0f);
+    position_ = 0;
+}
+
+size_t Resampler::delay_frames() const noexcept {
+    if (is_passthrough()) {
+        return 0;
+    }
+    // Half the prototype length, expressed at the output rate
+    return (taps_ * up_ / 2) / down_;
+}
+
+} // namespace voip::audio
@@ -0,0 +1,253 @@
+#include "audio/virtual_audio_backend.h"
+#include <algorithm>
+#include <chrono>
+
+namespace voip::audio {
+
+Result<std::unique_ptr<VirtualAudioBackend>> VirtualAudioBackend::create(const Config& config) {
+    if (config.period_us == 0) {
+        return Err<std::unique_ptr<VirtualAudioBackend>>(
+            ErrorCode::AudioInitFailed, "Clock period must be non-zero");
+    }
+
+    auto backend = std::unique_ptr<VirtualAudioBackend>(new VirtualAudioBackend(config));
+
+    if (config.input_clip) {
+        backend->input_ = config.input_clip;
+    } else if (!config.input_path.empty()) {
+        auto clip_result = read_audio_file(config.input_path, config.raw_sample_rate);
+        if (!clip_result.is_ok()) {
+            return Err<std::unique_ptr<VirtualAudioBackend>>(
+                clip_result.error().code(), clip_result.error().message());
+        }
+        backend->input_ = std::make_shared<const AudioClip>(std::move(clip_result.value()));
+    }
+
+    if (backend->input_ && backend->input_->sample_rate == 0) {
+        return Err<std::unique_ptr<VirtualAudioBackend>>(
+            ErrorCode::AudioInitFailed, "Input clip has no sample rate");
+    }
+
+    return Ok(std::move(backend));
+}
+
+VirtualAudioBackend::VirtualAudioBackend(const Config& config)
+    : config_(config)
+    , time_base_us_(steady_time_us())
+{
+}
+
+VirtualAudioBackend::~VirtualAudioBackend() {
+    terminate();
+}
+
+Result<void> VirtualAudioBackend::initialize() {
+    return Ok();
+}
+
+void VirtualAudioBackend::terminate() {
+    close_capture();
+    close_playback();
+}
+
+std::vector<AudioDevice> VirtualAudioBackend::enumerate_input_devices() {
+    return {{
+        .id = 0,
+        .name = config_.input_path.empty() ? "Virtual input" : "Virtual input (" + config_.input_path + ")",
+        .max_input_channels = 1,
+        .max_output_channels = 0,
+        .default_sample_rate = input_ ? static_cast<double>(input_->sample_rate) : 48000.0,
+        .is_default = true
+    }};
+}
+
+std::vector<AudioDevice> VirtualAudioBackend::enumerate_output_devices() {
+    return {{
+        .id = 0,
+        .name = config_.output_path.empty() ? "Virtual output" : "Virtual output (" + config_.output_path + ")",
+        .max_input_channels = 0,
+        .max_output_channels = 1,
+        .default_sample_rate = config_.output_sample_rate != 0
+            ? static_cast<double>(config_.output_sample_rate) : 48000.0,
+        .is_default = true
+    }};
+}
+
+uint32_t VirtualAudioBackend::select_sample_rate(DeviceId /*device*/, bool is_input, uint32_t preferred) {
+    // The files set the device rate, so the engine's resampler gets exercised
+    if (is_input) {
+        return input_ ? input_->sample_rate : preferred;
+    }
+    return config_.output_sample_rate != 0 ? config_.output_sample_rate : preferred;
+}
+
+Result<void> VirtualAudioBackend::open_capture(const DeviceStreamConfig& config, DeviceCaptureCallback callback) {
+    if (config.sample_rate == 0) {
+        return Err<void>(ErrorCode::AudioStreamFailed, "Invalid capture sample rate");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (capture_callback_) {
+            return Err<void>(ErrorCode::InvalidState, "Capture stream already open");
+        }
+        capture_rate_ = config.sample_rate;
+        capture_buffer_.assign(frames_between(capture_rate_, 0, config_.period_us) + 1, 0.0f);
+        capture_callback_ = std::move(callback);
+    }
+
+    start_clock();
+    return Ok();
+}
+
+Result<void> VirtualAudioBackend::open_playback(const DeviceStreamConfig& config, DevicePlaybackCallback callback) {
+    if (config.sample_rate == 0) {
+        return Err<void>(ErrorCode::AudioStreamFailed, "Invalid playback sample rate");
+    }
+
+    std::unique_ptr<AudioFileWriter> writer;
+    if (!config_.output_path.empty()) {
+        auto writer_result = AudioFileWriter::create(config_.output_path, config.sample_rate);
+        if (!writer_result.is_ok()) {
+            return Err<void>(writer_result.error().code(), writer_result.error().message());
+        }
+        writer = std::move(writer_result.value());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (playback_callback_) {
+            return Err<void>(ErrorCode::InvalidState, "Playback stream already open");
+        }
+        playback_rate_ = config.sample_rate;
+        playback_buffer_.assign(frames_between(playback_rate_, 0, config_.period_us) + 1, 0.0f);
+        output_writer_ = std::move(writer);
+        playback_callback_ = std::move(callback);
+    }
+
+    start_clock();
+    return Ok();
+}
+
+void VirtualAudioBackend::close_capture() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capture_callback_ = nullptr;
+        if (playback_callback_) {
+            return;
+        }
+    }
+    stop_clock();
+}
+
+void VirtualAudioBackend::close_playback() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        playback_callback_ = nullptr;
+        output_writer_.reset();  // Finalizes the file
+        if (capture_callback_) {
+            return;
+        }
+    }
+    stop_clock();
+}
+
+void VirtualAudioBackend::advance(uint32_t periods) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (uint32_t i = 0; i < periods; ++i) {
+        tick();
+    }
+}
+
+size_t VirtualAudioBackend::frames_between(uint32_t sample_rate, uint64_t from_us, uint64_t to_us) noexcept {
+    // Computed from absolute time so fractional frames never drift
+    return static_cast<size_t>((to_us * sample_rate) / 1000000 - (from_us * sample_rate) / 1000000);
+}
+
+void VirtualAudioBackend::tick() {
+    const uint64_t from_us = elapsed_us_.load(std::memory_order_relaxed);
+    const uint64_t to_us = from_us + config_.period_us;
+
+    if (capture_callback_) {
+        const size_t count = frames_between(capture_rate_, from_us, to_us);
+        fill_capture(capture_buffer_.data(), count);
+        capture_callback_(capture_buffer_.data(), count, time_base_us_ + from_us, false);
+        frames_captured_.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    if (playback_callback_) {
+        const size_t count = frames_between(playback_rate_, from_us, to_us);
+        playback_callback_(playback_buffer_.data(), count, time_base_us_ + to_us, false);
+        if (output_writer_) {
+            output_writer_->write(playback_buffer_.data(), count);
+        }
+        frames_played_.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    elapsed_us_.store(to_us, std::memory_order_relaxed);
+}
+
+void VirtualAudioBackend::fill_capture(float* pcm, size_t count) noexcept {
+    const size_t total = input_ ? input_->samples.size() : 0;
+
+    size_t written = 0;
+    while (written < count) {
+        if (input_pos_ >= total) {
+            if (config_.loop_input && total > 0) {
+                input_pos_ = 0;
+            } else {
+                std::fill(pcm + written, pcm + count, 0.0f);
+                input_finished_.store(true, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        const size_t take = std::min(count - written, total - input_pos_);
+        std::copy_n(input_->samples.data() + input_pos_, take, pcm + written);
+        input_pos_ += take;
+        written += take;
+    }
+}
+
+void VirtualAudioBackend::start_clock() {
+    if (config_.clock != ClockMode::RealTime || clock_running_.exchange(true)) {
+        return;
+    }
+    // Line virtual time up with the wall clock from the first tick
+    time_base_us_ = steady_time_us() - elapsed_us_.load(std::memory_order_relaxed);
+    clock_thread_ = std::thread(&VirtualAudioBackend::clock_loop, this);
+}
+
+void VirtualAudioBackend::stop_clock() {
+    if (!clock_running_.exchange(false)) {
+        return;
+    }
+    if (clock_thread_.joinable()) {
+        clock_thread_.join();
+    }
+}
+
+void VirtualAudioBackend::clock_loop() {
+    using clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double, std::micro>(
+            config_.speed > 0.0f ? config_.period_us / config_.speed : 0.0));
+
+    auto next_tick = clock::now();
+    while (clock_running_.load(std::memory_order_acquire)) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tick();
+        }
+
+        if (period.count() > 0) {
+            // Absolute deadlines: a late tick is caught up, not lost
+            next_tick += period;
+            std::this_thread::sleep_until(next_tick);
+        } else {
+            std::this_thread::yield();  // Let close_*() take the lock
+        }
+    }
+}
+
+} // namespace voip::audio
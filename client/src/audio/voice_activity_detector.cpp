@@ -0,0 +1,190 @@
+#include "audio/voice_activity_detector.h"
+#include <algorithm>
+#include <cmath>
+
+namespace voip::audio {
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// FFT length bounds (samples)
+constexpr size_t MIN_FFT_SIZE = 16;
+constexpr size_t MAX_FFT_SIZE = 512;
+
+// Speech band used for spectral flatness
+constexpr float BAND_LOW_HZ = 100.0f;
+constexpr float BAND_HIGH_HZ = 4000.0f;
+
+// Noise floor time constants: quick to follow a quieter room, slow to
+// accept a louder one, and slower still while someone is talking
+constexpr float FLOOR_FALL_US = 100000.0f;
+constexpr float FLOOR_RISE_US = 2000000.0f;
+constexpr float FLOOR_RISE_SPEECH_US = 20000000.0f;
+
+constexpr float SILENCE_DB = -90.0f;
+
+float to_db(float mean_square) noexcept {
+    return std::max(SILENCE_DB, 10.0f * std::log10(mean_square + 1e-12f));
+}
+
+} // namespace
+
+Result<std::unique_ptr<VoiceActivityDetector>> VoiceActivityDetector::create(
+    const Config& config,
+    size_t max_frame_size
+) {
+    if (config.sample_rate == 0 || max_frame_size < MIN_FFT_SIZE) {
+        return Err<std::unique_ptr<VoiceActivityDetector>>(
+            ErrorCode::AudioInitFailed, "Invalid voice activity detector parameters");
+    }
+
+    size_t fft_size = MIN_FFT_SIZE;
+    while (fft_size * 2 <= std::min(max_frame_size, MAX_FFT_SIZE)) {
+        fft_size *= 2;
+    }
+
+    return Ok(std::unique_ptr<VoiceActivityDetector>(new VoiceActivityDetector(config, fft_size)));
+}
+
+VoiceActivityDetector::VoiceActivityDetector(const Config& config, size_t fft_size)
+    : config_(config)
+    , fft_size_(fft_size)
+    , window_(fft_size)
+    , fft_re_(fft_size)
+    , fft_im_(fft_size)
+    , twiddle_re_(fft_size / 2)
+    , twiddle_im_(fft_size / 2)
+    , bit_reverse_(fft_size)
+{
+    for (size_t i = 0; i < fft_size_; ++i) {
+        window_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * PI * static_cast<double>(i) /
+                                                             static_cast<double>(fft_size_ - 1)));
+    }
+
+    for (size_t k = 0; k < fft_size_ / 2; ++k) {
+        const double angle = -2.0 * PI * static_cast<double>(k) / static_cast<double>(fft_size_);
+        twiddle_re_[k] = static_cast<float>(std::cos(angle));
+        twiddle_im_[k] = static_cast<float>(std::sin(angle));
+    }
+
+    size_t bits = 0;
+    while ((size_t{1} << bits) < fft_size_) {
+        bits++;
+    }
+    for (size_t i = 0; i < fft_size_; ++i) {
+        uint32_t reversed = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            reversed |= static_cast<uint32_t>(((i >> b) & 1) << (bits - 1 - b));
+        }
+        bit_reverse_[i] = reversed;
+    }
+
+    // Speech band bins (at least one bin, never DC or beyond Nyquist)
+    const float bin_hz = static_cast<float>(config_.sample_rate) / static_cast<float>(fft_size_);
+    band_low_ = std::max<size_t>(1, static_cast<size_t>(std::ceil(BAND_LOW_HZ / bin_hz)));
+    band_high_ = std::min(fft_size_ / 2, static_cast<size_t>(BAND_HIGH_HZ / bin_hz));
+    band_high_ = std::max(band_high_, band_low_);
+}
+
+bool VoiceActivityDetector::process(const float* pcm, size_t count) noexcept {
+    if (count == 0) {
+        return active_;
+    }
+
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        sum += pcm[i] * pcm[i];
+    }
+    energy_db_ = to_db(sum / static_cast<float>(count));
+    flatness_ = measure_flatness(pcm, count);
+
+    if (!initialized_) {
+        noise_floor_db_ = energy_db_;
+        initialized_ = true;
+    }
+
+    const float above_floor = energy_db_ - noise_floor_db_;
+    const bool speech = energy_db_ > config_.min_speech_dbfs &&
+                        (above_floor > config_.loud_margin_db ||
+                         (above_floor > config_.speech_margin_db && flatness_ < config_.flatness_threshold));
+
+    // Track the noise floor. Loud but noise-like frames still raise it at
+    // the normal rate, so a fan switching on is only "speech" for a moment.
+    const float frame_us = static_cast<float>(count) * 1e6f / static_cast<float>(config_.sample_rate);
+    float tau_us = FLOOR_RISE_US;
+    if (energy_db_ < noise_floor_db_) {
+        tau_us = FLOOR_FALL_US;
+    } else if (speech && flatness_ < config_.flatness_threshold) {
+        tau_us = FLOOR_RISE_SPEECH_US;
+    }
+    noise_floor_db_ += (1.0f - std::exp(-frame_us / tau_us)) * (energy_db_ - noise_floor_db_);
+
+    // Hangover
+    if (speech) {
+        hangover_remaining_us_ = static_cast<uint64_t>(config_.hangover_ms) * 1000;
+        active_ = true;
+    } else if (hangover_remaining_us_ > 0) {
+        const auto elapsed = static_cast<uint64_t>(frame_us);
+        hangover_remaining_us_ = hangover_remaining_us_ > elapsed ? hangover_remaining_us_ - elapsed : 0;
+        active_ = true;
+    } else {
+        active_ = false;
+    }
+
+    return active_;
+}
+
+void VoiceActivityDetector::reset() noexcept {
+    initialized_ = false;
+    active_ = false;
+    noise_floor_db_ = SILENCE_DB;
+    energy_db_ = SILENCE_DB;
+    flatness_ = 1.0f;
+    hangover_remaining_us_ = 0;
+}
+
+float VoiceActivityDetector::measure_flatness(const float* pcm, size_t count) noexcept {
+    const size_t n = std::min(count, fft_size_);
+    for (size_t i = 0; i < fft_size_; ++i) {
+        fft_re_[bit_reverse_[i]] = (i < n) ? pcm[i] * window_[i] : 0.0f;
+        fft_im_[bit_reverse_[i]] = 0.0f;
+    }
+    fft();
+
+    // Geometric / arithmetic mean of the power spectrum
+    constexpr float EPSILON = 1e-10f;
+    float log_sum = 0.0f;
+    float power_sum = 0.0f;
+    for (size_t k = band_low_; k <= band_high_; ++k) {
+        const float power = fft_re_[k] * fft_re_[k] + fft_im_[k] * fft_im_[k] + EPSILON;
+        log_sum += std::log(power);
+        power_sum += power;
+    }
+    const auto bins = static_cast<float>(band_high_ - band_low_ + 1);
+    return std::exp(log_sum / bins) / (power_sum / bins);
+}
+
+void VoiceActivityDetector::fft() noexcept {
+    // Iterative Cooley-Tukey on bit-reversed input
+    for (size_t length = 2; length <= fft_size_; length *= 2) {
+        const size_t half = length / 2;
+        const size_t stride = fft_size_ / length;
+        for (size_t start = 0; start < fft_size_; start += length) {
+            for (size_t k = 0; k < half; ++k) {
+                const float wr = twiddle_re_[k * stride];
+                const float wi = twiddle_im_[k * stride];
+                const size_t a = start + k;
+                const size_t b = a + half;
+                const float tr = fft_re_[b] * wr - fft_im_[b] * wi;
+                const float ti = fft_re_[b] * wi + fft_im_[b] * wr;
+                fft_re_[b] = fft_re_[a] - tr;
+                fft_im_[b] = fft_im_[a] - ti;
+                fft_re_[a] += tr;
+                fft_im_[a] += ti;
+            }
+        }
+    }
+}
+
+} // namespace voip::audio
@@ -0,0 +1,244 @@
+#include "common/logger.h"
+#include "common/lock_free_queue.h"
+#include "common/types.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace voip {
+
+namespace {
+
+constexpr size_t RING_COUNT = 32;        // Threads that can log at once
+constexpr size_t RING_CAPACITY = 64;     // Records per thread between writer passes
+constexpr auto WRITER_PERIOD = std::chrono::milliseconds(10);
+
+struct LogRecord {
+    uint64_t time_us = 0;
+    LogLevel level = LogLevel::Info;
+    uint32_t suppressed = 0;
+    uint16_t length = 0;
+    char text[LogLine::MAX_TEXT];
+};
+
+struct LogRing {
+    LockFreeQueue<LogRecord> queue{RING_CAPACITY};
+    std::atomic<bool> in_use{false};
+};
+
+/**
+ * Owns the rings and the writer thread. Never destroyed: other threads may
+ * still log while static destructors run; an atexit hook flushes instead.
+ */
+class LogWriter {
+public:
+    static LogWriter& instance() {
+        static LogWriter* writer = new LogWriter();
+        return *writer;
+    }
+
+    LogRing* claim() noexcept {
+        for (auto& ring : rings_) {
+            bool expected = false;
+            if (ring->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return ring.get();
+            }
+        }
+        return nullptr;
+    }
+
+    void count_dropped() noexcept { dropped_.fetch_add(1, std::memory_order_relaxed); }
+    uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+    void set_sink(Logger::Sink sink) {
+        std::lock_guard<std::mutex> lock(drain_mutex_);
+        sink_ = std::move(sink);
+    }
+
+    // Drain every ring and write the records in time order
+    void drain() {
+        std::lock_guard<std::mutex> lock(drain_mutex_);
+
+        batch_.clear();
+        LogRecord record;
+        for (auto& ring : rings_) {
+            while (ring->queue.try_pop(record)) {
+                batch_.push_back(record);
+            }
+        }
+        if (batch_.empty()) {
+            return;
+        }
+
+        std::stable_sort(batch_.begin(), batch_.end(),
+                         [](const LogRecord& a, const LogRecord& b) { return a.time_us < b.time_us; });
+
+        std::string text;
+        for (const auto& entry : batch_) {
+            text.assign(entry.text, entry.length);
+            if (entry.suppressed > 0) {
+                text += " (+" + std::to_string(entry.suppressed) + " suppressed)";
+            }
+            if (sink_) {
+                sink_(entry.level, text);
+            } else {
+                (entry.level >= LogLevel::Warn ? std::cerr : std::cout) << text << '\n';
+            }
+        }
+        if (!sink_) {
+            std::cout.flush();
+            std::cerr.flush();
+        }
+    }
+
+private:
+    LogWriter() {
+        for (auto& ring : rings_) {
+            ring = std::make_unique<LogRing>();
+        }
+        batch_.reserve(RING_COUNT * RING_CAPACITY);
+        std::atexit([] { LogWriter::instance().drain(); });
+
+        std::thread([this] {
+            for (;;) {
+                std::this_thread::sleep_for(WRITER_PERIOD);
+                drain();
+            }
+        }).detach();
+    }
+
+    std::array<std::unique_ptr<LogRing>, RING_COUNT> rings_;
+    std::mutex drain_mutex_;  // One consumer at a time; guards sink_ and batch_
+    Logger::Sink sink_;
+    std::vector<LogRecord> batch_;
+    std::atomic<uint64_t> dropped_{0};
+};
+
+// Returns the ring to the pool when its thread exits
+struct RingLease {
+    LogRing* ring = nullptr;
+
+    ~RingLease() {
+        if (ring) {
+            ring->in_use.store(false, std::memory_order_release);
+        }
+    }
+};
+
+thread_local RingLease ring_lease;
+
+// Writer up before main(), whatever the binary (tests call nothing)
+[[maybe_unused]] const bool writer_started = (Logger::start(), true);
+
+} // namespace
+
+const char* to_string(LogLevel level) noexcept {
+    switch (level) {
+        case LogLevel::Debug: return "debug";
+        case LogLevel::Info: return "info";
+        case LogLevel::Warn: return "warn";
+        case LogLevel::Error: return "error";
+        case LogLevel::Off: return "off";
+    }
+    return "unknown";
+}
+
+bool LogSite::admit() noexcept {
+    constexpr uint64_t WINDOW_US = 1000000;
+
+    const uint64_t now_us = steady_time_us();
+    uint64_t start_us = window_start_us_.load(std::memory_order_relaxed);
+    if (now_us - start_us >= WINDOW_US &&
+        window_start_us_.compare_exchange_strong(start_us, now_us, std::memory_order_relaxed)) {
+        window_count_.store(0, std::memory_order_relaxed);
+    }
+
+    if (window_count_.fetch_add(1, std::memory_order_relaxed) < BURST_PER_SECOND) {
+        return true;
+    }
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+LogLine::LogLine(LogLevel level, LogSite& site) noexcept
+    : level_(level)
+    , site_(site)
+{
+}
+
+LogLine::~LogLine() {
+    Logger::submit(level_, text_, length_, site_.take_suppressed());
+}
+
+LogLine& LogLine::operator<<(std::string_view text) noexcept {
+    const size_t count = std::min(text.size(), MAX_TEXT - length_);
+    std::memcpy(text_ + length_, text.data(), count);
+    length_ += count;
+    return *this;
+}
+
+LogLine& LogLine::operator<<(double value) noexcept {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 6);
+    return *this << std::string_view(buffer, static_cast<size_t>(result.ptr - buffer));
+}
+
+LogLine& LogLine::append_signed(int64_t value) noexcept {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return *this << std::string_view(buffer, static_cast<size_t>(result.ptr - buffer));
+}
+
+LogLine& LogLine::append_unsigned(uint64_t value) noexcept {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return *this << std::string_view(buffer, static_cast<size_t>(result.ptr - buffer));
+}
+
+void Logger::start() {
+    LogWriter::instance();
+}
+
+void Logger::set_sink(Sink sink) {
+    LogWriter::instance().set_sink(std::move(sink));
+}
+
+void Logger::flush() {
+    LogWriter::instance().drain();
+}
+
+uint64_t Logger::dropped() noexcept {
+    return LogWriter::instance().dropped();
+}
+
+void Logger::submit(LogLevel level, const char* text, size_t length, uint32_t suppressed) noexcept {
+    LogWriter& writer = LogWriter::instance();
+    if (!ring_lease.ring) {
+        ring_lease.ring = writer.claim();
+        if (!ring_lease.ring) {
+            writer.count_dropped();
+            return;
+        }
+    }
+
+    LogRecord record;
+    record.time_us = steady_time_us();
+    record.level = level;
+    record.suppressed = suppressed;
+    record.length = static_cast<uint16_t>(std::min(length, LogLine::MAX_TEXT));
+    std::memcpy(record.text, text, record.length);
+
+    if (!ring_lease.ring->queue.try_push(record)) {
+        writer.count_dropped();
+    }
+}
+
+} // namespace voip
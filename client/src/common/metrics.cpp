@@ -0,0 +1,261 @@
+#include "common/metrics.h"
+#include "common/types.h"
+#include <algorithm>
+#include <sstream>
+
+namespace voip {
+
+Counter::Counter(std::string name, std::string help)
+    : name_(std::move(name))
+    , help_(std::move(help))
+{
+}
+
+uint64_t Counter::value() const noexcept {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Counter::reset() noexcept {
+    for (auto& shard : shards_) {
+        shard.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+Gauge::Gauge(std::string name, std::string help, std::string labels)
+    : name_(std::move(name))
+    , help_(std::move(help))
+    , labels_(std::move(labels))
+{
+}
+
+Histogram::Histogram(std::string name, std::string help)
+    : name_(std::move(name))
+    , help_(std::move(help))
+{
+}
+
+LatencyHistogram Histogram::aggregate(uint64_t* sum) const {
+    LatencyHistogram result;
+    std::array<uint32_t, LatencyHistogram::BUCKETS> counts;
+    uint64_t total = 0;
+
+    for (const auto& shard : shards_) {
+        for (size_t i = 0; i < counts.size(); ++i) {
+            counts[i] = shard.counts[i].load(std::memory_order_relaxed);
+        }
+        result.add_counts(counts, shard.max.load(std::memory_order_relaxed));
+        total += shard.sum.load(std::memory_order_relaxed);
+    }
+
+    if (sum) {
+        *sum = total;
+    }
+    return result;
+}
+
+void Histogram::reset() noexcept {
+    for (auto& shard : shards_) {
+        for (auto& count : shard.counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        shard.sum.store(0, std::memory_order_relaxed);
+        shard.max.store(0, std::memory_order_relaxed);
+    }
+}
+
+namespace {
+
+template<typename T>
+const T* find_by_name(const std::vector<T>& values, std::string_view name) noexcept {
+    auto it = std::find_if(values.begin(), values.end(),
+                           [name](const T& value) { return value.name == name; });
+    return it != values.end() ? &*it : nullptr;
+}
+
+template<typename T>
+T& get_or_create(std::vector<std::unique_ptr<T>>& metrics, std::string_view name, std::string_view help) {
+    for (auto& metric : metrics) {
+        if (metric->name() == name) {
+            return *metric;
+        }
+    }
+    metrics.push_back(std::make_unique<T>(std::string(name), std::string(help)));
+    return *metrics.back();
+}
+
+// Series name as exposed: name, or name{labels}
+std::string series_name(const MetricsSnapshot::GaugeValue& gauge) {
+    return gauge.labels.empty() ? gauge.name : gauge.name + '{' + gauge.labels + '}';
+}
+
+void write_header(std::ostringstream& out, const std::string& name, const std::string& help, const char* type) {
+    out << "# HELP " << name << ' ' << help << '\n';
+    out << "# TYPE " << name << ' ' << type << '\n';
+}
+
+} // namespace
+
+const MetricsSnapshot::CounterValue* MetricsSnapshot::counter(std::string_view name) const noexcept {
+    return find_by_name(counters, name);
+}
+
+const MetricsSnapshot::GaugeValue* MetricsSnapshot::gauge(std::string_view name, std::string_view labels) const noexcept {
+    auto it = std::find_if(gauges.begin(), gauges.end(), [&](const GaugeValue& gauge) {
+        return gauge.name == name && gauge.labels == labels;
+    });
+    return it != gauges.end() ? &*it : nullptr;
+}
+
+const MetricsSnapshot::HistogramValue* MetricsSnapshot::histogram(std::string_view name) const noexcept {
+    return find_by_name(histograms, name);
+}
+
+std::string MetricsSnapshot::to_prometheus() const {
+    std::ostringstream out;
+
+    for (const auto& counter : counters) {
+        write_header(out, counter.name, counter.help, "counter");
+        out << counter.name << ' ' << counter.value << '\n';
+    }
+
+    // One header per name, followed by every series of that name
+    for (size_t i = 0; i < gauges.size(); ++i) {
+        const auto first = std::find_if(gauges.begin(), gauges.end(),
+                                        [&](const GaugeValue& gauge) { return gauge.name == gauges[i].name; });
+        if (first != gauges.begin() + static_cast<std::ptrdiff_t>(i)) {
+            continue;
+        }
+        write_header(out, gauges[i].name, gauges[i].help, "gauge");
+        for (size_t j = i; j < gauges.size(); ++j) {
+            if (gauges[j].name == gauges[i].name) {
+                out << series_name(gauges[j]) << ' ' << gauges[j].value << '\n';
+            }
+        }
+    }
+
+    for (const auto& histogram : histograms) {
+        write_header(out, histogram.name, histogram.help, "summary");
+        out << histogram.name << "{quantile=\"0.5\"} " << histogram.p50 << '\n';
+        out << histogram.name << "{quantile=\"0.9\"} " << histogram.p90 << '\n';
+        out << histogram.name << "{quantile=\"0.99\"} " << histogram.p99 << '\n';
+        out << histogram.name << "{quantile=\"0.999\"} " << histogram.p999 << '\n';
+        out << histogram.name << "_sum " << histogram.sum << '\n';
+        out << histogram.name << "_count " << histogram.count << '\n';
+    }
+
+    return out.str();
+}
+
+std::string MetricsSnapshot::to_json() const {
+    // Metric names are identifiers; only label values need their quotes escaped
+    std::ostringstream out;
+    out << "{\"timestamp_us\":" << timestamp_us;
+
+    out << ",\"counters\":{";
+    for (size_t i = 0; i < counters.size(); ++i) {
+        out << (i ? "," : "") << '"' << counters[i].name << "\":" << counters[i].value;
+    }
+
+    out << "},\"gauges\":{";
+    for (size_t i = 0; i < gauges.size(); ++i) {
+        out << (i ? "," : "") << '"';
+        for (char c : series_name(gauges[i])) {
+            if (c == '"' || c == '\\') {
+                out << '\\';
+            }
+            out << c;
+        }
+        out << "\":" << gauges[i].value;
+    }
+
+    out << "},\"histograms\":{";
+    for (size_t i = 0; i < histograms.size(); ++i) {
+        const auto& histogram = histograms[i];
+        out << (i ? "," : "") << '"' << histogram.name << "\":{"
+            << "\"count\":" << histogram.count
+            << ",\"sum\":" << histogram.sum
+            << ",\"max\":" << histogram.max
+            << ",\"p50\":" << histogram.p50
+            << ",\"p90\":" << histogram.p90
+            << ",\"p99\":" << histogram.p99
+            << ",\"p999\":" << histogram.p999 << '}';
+    }
+
+    out << "}}";
+    return out.str();
+}
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+Counter& MetricsRegistry::counter(std::string_view name, std::string_view help) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return get_or_create(counters_, name, help);
+}
+
+Gauge& MetricsRegistry::gauge(std::string_view name, std::string_view help, std::string_view labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& gauge : gauges_) {
+        if (gauge->name() == name && gauge->labels() == labels) {
+            return *gauge;
+        }
+    }
+    gauges_.push_back(std::make_unique<Gauge>(std::string(name), std::string(help), std::string(labels)));
+    return *gauges_.back();
+}
+
+Histogram& MetricsRegistry::histogram(std::string_view name, std::string_view help) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return get_or_create(histograms_, name, help);
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    MetricsSnapshot snapshot;
+    snapshot.timestamp_us = steady_time_us();
+
+    for (const auto& counter : counters_) {
+        snapshot.counters.push_back({counter->name(), counter->help(), counter->value()});
+    }
+
+    for (const auto& gauge : gauges_) {
+        snapshot.gauges.push_back({gauge->name(), gauge->help(), gauge->labels(), gauge->value()});
+    }
+
+    for (const auto& histogram : histograms_) {
+        uint64_t sum = 0;
+        const LatencyHistogram aggregated = histogram->aggregate(&sum);
+        snapshot.histograms.push_back({
+            .name = histogram->name(),
+            .help = histogram->help(),
+            .count = aggregated.count(),
+            .sum = sum,
+            .max = aggregated.max(),
+            .p50 = aggregated.percentile(50),
+            .p90 = aggregated.percentile(90),
+            .p99 = aggregated.percentile(99),
+            .p999 = aggregated.percentile(99.9)
+        });
+    }
+
+    return snapshot;
+}
+
+void MetricsRegistry::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& counter : counters_) {
+        counter->reset();
+    }
+    for (auto& histogram : histograms_) {
+        histogram->reset();
+    }
+}
+
+} // namespace voip
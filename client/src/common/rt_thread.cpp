@@ -0,0 +1,210 @@
+#include "common/rt_thread.h"
+#include "common/latency_histogram.h"
+#include "common/logger.h"
+#include "common/trace.h"
+#include "common/types.h"
+#include <algorithm>
+#include <chrono>
+#include <system_error>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <avrt.h>
+#pragma comment(lib, "avrt.lib")
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <mach/thread_policy.h>
+#endif
+
+namespace voip {
+
+namespace {
+
+constexpr uint64_t LATENCY_WINDOW_US = 1000000;
+
+} // namespace
+
+RtThread::RtThread()
+    : lateness_metric_(MetricsRegistry::global().histogram(
+          "voip_worker_lateness_us", "Voice worker wake-up time past its deadline"))
+    , missed_ticks_metric_(MetricsRegistry::global().counter(
+          "voip_worker_missed_ticks_total", "Voice worker deadlines skipped after a late wake-up"))
+{
+}
+
+RtThread::~RtThread() {
+    stop();
+}
+
+Result<void> RtThread::start(const Config& config, Tick tick) {
+    if (running()) {
+        return Err<void>(ErrorCode::InvalidState, "Worker thread already running");
+    }
+    if (config.period_us == 0 || !tick) {
+        return Err<void>(ErrorCode::InvalidState, "Worker thread needs a period and a tick function");
+    }
+
+    config_ = config;
+    tick_ = std::move(tick);
+    stopping_ = false;
+    ticks_ = 0;
+    missed_ticks_ = 0;
+    realtime_ = false;
+    pinned_ = false;
+
+    try {
+        thread_ = std::thread(&RtThread::run, this);
+    } catch (const std::system_error& e) {
+        return Err<void>(ErrorCode::Unknown, std::string("Failed to start worker thread: ") + e.what());
+    }
+    return Ok();
+}
+
+void RtThread::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+RtThread::Stats RtThread::get_stats() const {
+    Stats stats;
+    stats.ticks = ticks_.load(std::memory_order_relaxed);
+    stats.missed_ticks = missed_ticks_.load(std::memory_order_relaxed);
+    stats.lateness_p50_us = lateness_p50_us_.load(std::memory_order_relaxed);
+    stats.lateness_p99_us = lateness_p99_us_.load(std::memory_order_relaxed);
+    stats.lateness_max_us = lateness_max_us_.load(std::memory_order_relaxed);
+    stats.realtime = realtime_.load(std::memory_order_relaxed);
+    stats.pinned = pinned_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void RtThread::run() {
+    Tracer::set_thread_name(config_.name);
+    apply_scheduling();
+
+    const auto period = std::chrono::microseconds(config_.period_us);
+    const uint64_t window_ticks = std::max<uint64_t>(1, LATENCY_WINDOW_US / config_.period_us);
+    LatencyHistogram lateness;
+    auto deadline = std::chrono::steady_clock::now() + period;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!wake_.wait_until(lock, deadline, [this] { return stopping_; })) {
+        lock.unlock();
+
+        const auto now = std::chrono::steady_clock::now();
+        const auto late_us = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - deadline).count());
+        lateness.record(late_us);
+        lateness_metric_.record(late_us);
+
+        tick_();
+        ticks_.fetch_add(1, std::memory_order_relaxed);
+
+        // Skip deadlines we slept (or worked) through rather than bursting
+        deadline += period;
+        const auto after = std::chrono::steady_clock::now();
+        if (after > deadline) {
+            const auto behind = (after - deadline) / period + 1;
+            deadline += behind * period;
+            missed_ticks_.fetch_add(static_cast<uint64_t>(behind), std::memory_order_relaxed);
+            missed_ticks_metric_.add(static_cast<uint64_t>(behind));
+            // Let the xrun dump show which stages of the tick blew the period
+            Tracer::mark_xrun("worker deadline");
+        }
+
+        if (lateness.count() >= window_ticks) {
+            lateness_p50_us_.store(static_cast<uint32_t>(lateness.percentile(50)), std::memory_order_relaxed);
+            lateness_p99_us_.store(static_cast<uint32_t>(lateness.percentile(99)), std::memory_order_relaxed);
+            lateness_max_us_.store(static_cast<uint32_t>(lateness.max()), std::memory_order_relaxed);
+            lateness.reset();
+        }
+
+        lock.lock();
+    }
+    lock.unlock();
+
+#ifdef _WIN32
+    if (mmcss_task_) {
+        AvRevertMmThreadCharacteristics(mmcss_task_);
+        mmcss_task_ = nullptr;
+    }
+#endif
+}
+
+void RtThread::apply_scheduling() {
+    bool realtime = false;
+    bool pinned = false;
+
+#ifdef _WIN32
+    if (config_.realtime) {
+        DWORD task_index = 0;
+        mmcss_task_ = AvSetMmThreadCharacteristicsW(L"Pro Audio", &task_index);
+        if (mmcss_task_) {
+            realtime = AvSetMmThreadPriority(mmcss_task_, AVRT_PRIORITY_HIGH) != FALSE;
+        } else {
+            realtime = SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != FALSE;
+        }
+    }
+    if (config_.cpu >= 0 && config_.cpu < 64) {
+        pinned = SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << config_.cpu) != 0;
+    }
+#elif defined(__APPLE__)
+    pthread_setname_np(config_.name);
+    if (config_.realtime) {
+        // Expect to need a quarter of each period, finished within half of it
+        mach_timebase_info_data_t timebase;
+        mach_timebase_info(&timebase);
+        auto to_ticks = [&timebase](uint64_t us) {
+            return static_cast<uint32_t>(us * 1000 * timebase.denom / timebase.numer);
+        };
+        thread_time_constraint_policy_data_t policy;
+        policy.period = to_ticks(config_.period_us);
+        policy.computation = to_ticks(config_.period_us / 4);
+        policy.constraint = to_ticks(config_.period_us / 2);
+        policy.preemptible = 1;
+        realtime = thread_policy_set(pthread_mach_thread_np(pthread_self()), THREAD_TIME_CONSTRAINT_POLICY,
+                                     reinterpret_cast<thread_policy_t>(&policy),
+                                     THREAD_TIME_CONSTRAINT_POLICY_COUNT) == KERN_SUCCESS;
+    }
+    // macOS has no hard affinity; config_.cpu is ignored
+#else
+    pthread_setname_np(pthread_self(), config_.name);  // Truncated to 15 characters by the kernel
+    if (config_.realtime) {
+        // Just below the audio device threads, which usually sit at the top
+        sched_param param{};
+        param.sched_priority = (std::max)(sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO) - 10);
+        realtime = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+    }
+    if (config_.cpu >= 0 && config_.cpu < CPU_SETSIZE) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(config_.cpu, &cpus);
+        pinned = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+    }
+#endif
+
+    realtime_.store(realtime, std::memory_order_relaxed);
+    pinned_.store(pinned, std::memory_order_relaxed);
+
+    if (config_.realtime && !realtime) {
+        VOIP_LOG_WARN("⚠️ " << config_.name << ": real-time priority not permitted, running at normal priority");
+    }
+    if (config_.cpu >= 0 && !pinned) {
+        VOIP_LOG_WARN("⚠️ " << config_.name << ": could not pin to CPU " << config_.cpu);
+    }
+    VOIP_LOG_INFO("⚙️ " << config_.name << " running every " << config_.period_us << "us"
+                  << (realtime ? " (real-time)" : "") << (pinned ? ", pinned" : ""));
+}
+
+} // namespace voip
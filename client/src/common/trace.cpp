@@ -0,0 +1,345 @@
+#include "common/trace.h"
+#include "common/logger.h"
+#include "common/types.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace voip {
+
+namespace {
+
+constexpr size_t RING_COUNT = 16;       // Threads that can trace at once
+constexpr size_t RING_CAPACITY = 4096;  // Events kept per thread
+constexpr uint64_t XRUN_MARK = std::numeric_limits<uint64_t>::max();  // Duration of an xrun marker
+constexpr uint64_t DUMP_COOLDOWN_US = 1000000;  // Xruns this soon after a dump are not dumped again
+constexpr auto DUMP_POLL_PERIOD = std::chrono::milliseconds(20);
+
+// Fields are relaxed atomics so a dump can read a ring while its owner writes
+struct TraceSlot {
+    std::atomic<const char*> stage{nullptr};
+    std::atomic<uint64_t> start_us{0};
+    std::atomic<uint64_t> duration_us{0};
+};
+
+struct TraceRing {
+    explicit TraceRing(uint32_t ring_id) : id(ring_id) {}
+
+    const uint32_t id;
+    std::unique_ptr<TraceSlot[]> slots = std::make_unique<TraceSlot[]>(RING_CAPACITY);
+    std::atomic<uint64_t> head{0};  // Events ever written
+    std::atomic<bool> in_use{false};
+    std::atomic<const char*> thread_name{nullptr};
+};
+
+struct TraceEvent {
+    const char* stage;
+    uint64_t start_us;
+    uint64_t duration_us;
+    uint32_t thread;
+};
+
+/**
+ * Rings and dump thread. Never destroyed: audio threads may still trace
+ * while static destructors run.
+ */
+class TraceState {
+public:
+    static TraceState& instance() {
+        static TraceState* state = new TraceState();
+        return *state;
+    }
+
+    TraceRing* claim() noexcept {
+        for (auto& ring : rings_) {
+            bool expected = false;
+            if (ring->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                ring->head.store(0, std::memory_order_relaxed);
+                return ring.get();
+            }
+        }
+        return nullptr;
+    }
+
+    void start(const Tracer::Config& config) {
+        stop();
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_ = config;
+        dumps_written_.store(0, std::memory_order_relaxed);
+        dump_failures_.store(0, std::memory_order_relaxed);
+        pending_xrun_us_.store(0, std::memory_order_relaxed);
+        stopping_ = false;
+        thread_ = std::thread([this] { dump_loop(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    void request_dump(uint64_t xrun_us) noexcept {
+        uint64_t expected = 0;
+        pending_xrun_us_.compare_exchange_strong(expected, xrun_us, std::memory_order_release);
+    }
+
+    uint32_t dumps_written() const noexcept { return dumps_written_.load(std::memory_order_relaxed); }
+    uint32_t dump_failures() const noexcept { return dump_failures_.load(std::memory_order_relaxed); }
+
+    // Consistent copy of every event in [from_us, to_us], sorted by start
+    std::vector<TraceEvent> collect(uint64_t from_us, uint64_t to_us) const {
+        std::vector<TraceEvent> events;
+        for (const auto& ring : rings_) {
+            const uint64_t head = ring->head.load(std::memory_order_acquire);
+            const uint64_t first = head > RING_CAPACITY ? head - RING_CAPACITY : 0;
+            const size_t before = events.size();
+            std::vector<uint64_t> indices;
+
+            for (uint64_t i = first; i < head; ++i) {
+                const TraceSlot& slot = ring->slots[i % RING_CAPACITY];
+                TraceEvent event{
+                    slot.stage.load(std::memory_order_relaxed),
+                    slot.start_us.load(std::memory_order_relaxed),
+                    slot.duration_us.load(std::memory_order_relaxed),
+                    ring->id
+                };
+                if (event.stage && event.start_us >= from_us && event.start_us <= to_us) {
+                    events.push_back(event);
+                    indices.push_back(i);
+                }
+            }
+
+            // Drop slots the owner overwrote while we were copying
+            const uint64_t head_after = ring->head.load(std::memory_order_acquire);
+            const uint64_t valid_from = head_after > RING_CAPACITY ? head_after - RING_CAPACITY : 0;
+            size_t kept = before;
+            for (size_t k = 0; k < indices.size(); ++k) {
+                if (indices[k] >= valid_from) {
+                    events[kept++] = events[before + k];
+                }
+            }
+            events.resize(kept);
+        }
+
+        std::sort(events.begin(), events.end(),
+                  [](const TraceEvent& a, const TraceEvent& b) { return a.start_us < b.start_us; });
+        return events;
+    }
+
+    std::string to_json(uint64_t from_us, uint64_t to_us) const {
+        const auto events = collect(from_us, to_us);
+
+        std::ostringstream out;
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        auto separator = [&out, &first] {
+            out << (first ? "" : ",\n");
+            first = false;
+        };
+
+        for (const auto& ring : rings_) {
+            const char* name = ring->thread_name.load(std::memory_order_relaxed);
+            if (name) {
+                separator();
+                out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->id
+                    << ",\"args\":{\"name\":\"" << name << "\"}}";
+            }
+        }
+
+        // Stage names are string literals in our code, so no escaping is needed
+        for (const auto& event : events) {
+            separator();
+            const uint64_t ts = event.start_us - from_us;
+            if (event.duration_us == XRUN_MARK) {
+                out << "{\"name\":\"" << event.stage << "\",\"cat\":\"xrun\",\"ph\":\"i\",\"s\":\"g\""
+                    << ",\"ts\":" << ts << ",\"pid\":1,\"tid\":" << event.thread << "}";
+            } else {
+                out << "{\"name\":\"" << event.stage << "\",\"cat\":\"audio\",\"ph\":\"X\""
+                    << ",\"ts\":" << ts << ",\"dur\":" << event.duration_us
+                    << ",\"pid\":1,\"tid\":" << event.thread << "}";
+            }
+        }
+
+        out << "]}\n";
+        return out.str();
+    }
+
+private:
+    TraceState() {
+        for (size_t i = 0; i < rings_.size(); ++i) {
+            rings_[i] = std::make_unique<TraceRing>(static_cast<uint32_t>(i + 1));
+        }
+    }
+
+    void dump_loop() {
+        uint64_t cooldown_until_us = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            wake_.wait_for(lock, DUMP_POLL_PERIOD, [this] { return stopping_; });
+
+            const uint64_t xrun_us = pending_xrun_us_.load(std::memory_order_acquire);
+            if (xrun_us == 0) {
+                continue;
+            }
+            const uint64_t after_us = static_cast<uint64_t>(config_.window_after_ms) * 1000;
+            const uint64_t before_us = static_cast<uint64_t>(config_.window_before_ms) * 1000;
+            if (steady_time_us() < xrun_us + after_us) {
+                continue;  // Let the aftermath be recorded
+            }
+            pending_xrun_us_.store(0, std::memory_order_relaxed);
+
+            // Failed attempts count against the limit too, so an unwritable
+            // directory doesn't get retried on every xrun
+            const uint32_t attempts = dumps_written_.load() + dump_failures_.load();
+            if (xrun_us < cooldown_until_us || attempts >= config_.max_dumps) {
+                continue;
+            }
+            cooldown_until_us = xrun_us + DUMP_COOLDOWN_US;
+
+            // Only this thread writes dumps; count one once its file is closed
+            const uint32_t index = attempts + 1;
+            const std::string path = config_.output_dir + "/xrun-" + std::to_string(index) + ".json";
+            const uint64_t from_us = xrun_us > before_us ? xrun_us - before_us : 0;
+            bool written = false;
+            {
+                std::ofstream file(path);
+                file << to_json(from_us, xrun_us + after_us);
+                file.close();
+                written = !file.fail();
+            }
+            if (written) {
+                dumps_written_.fetch_add(1);
+                VOIP_LOG_INFO("📝 Wrote xrun trace " << path);
+            } else {
+                dump_failures_.fetch_add(1);
+                VOIP_LOG_WARN("⚠️ Failed to write xrun trace " << path);
+            }
+        }
+    }
+
+    std::array<std::unique_ptr<TraceRing>, RING_COUNT> rings_;
+
+    std::mutex mutex_;  // Guards config_ and stopping_
+    std::condition_variable wake_;
+    Tracer::Config config_;
+    bool stopping_ = false;
+    std::thread thread_;
+
+    std::atomic<uint64_t> pending_xrun_us_{0};
+    std::atomic<uint32_t> dumps_written_{0};
+    std::atomic<uint32_t> dump_failures_{0};
+};
+
+// Returns the ring to the pool when its thread exits
+struct RingLease {
+    TraceRing* ring = nullptr;
+    bool exhausted = false;
+    const char* thread_name = nullptr;
+
+    ~RingLease() {
+        if (ring) {
+            ring->in_use.store(false, std::memory_order_release);
+        }
+    }
+};
+
+thread_local RingLease ring_lease;
+
+TraceRing* thread_ring() noexcept {
+    if (!ring_lease.ring && !ring_lease.exhausted) {
+        ring_lease.ring = TraceState::instance().claim();
+        ring_lease.exhausted = ring_lease.ring == nullptr;
+        if (ring_lease.ring) {
+            ring_lease.ring->thread_name.store(ring_lease.thread_name, std::memory_order_relaxed);
+        }
+    }
+    return ring_lease.ring;
+}
+
+void push_event(const char* stage, uint64_t start_us, uint64_t duration_us) noexcept {
+    TraceRing* ring = thread_ring();
+    if (!ring) {
+        return;
+    }
+    const uint64_t index = ring->head.load(std::memory_order_relaxed);
+    TraceSlot& slot = ring->slots[index % RING_CAPACITY];
+    slot.stage.store(stage, std::memory_order_relaxed);
+    slot.start_us.store(start_us, std::memory_order_relaxed);
+    slot.duration_us.store(duration_us, std::memory_order_relaxed);
+    ring->head.store(index + 1, std::memory_order_release);
+}
+
+} // namespace
+
+void Tracer::enable(const Config& config) {
+    TraceState::instance().start(config);
+    enabled_.store(true, std::memory_order_release);
+}
+
+void Tracer::disable() {
+    enabled_.store(false, std::memory_order_release);
+    TraceState::instance().stop();
+}
+
+void Tracer::record(const char* stage, uint64_t start_us, uint64_t end_us) noexcept {
+    if (!enabled()) {
+        return;
+    }
+    push_event(stage, start_us, end_us > start_us ? end_us - start_us : 0);
+}
+
+void Tracer::mark_xrun(const char* reason) noexcept {
+    if (!enabled()) {
+        return;
+    }
+    const uint64_t now_us = steady_time_us();
+    push_event(reason, now_us, XRUN_MARK);
+    TraceState::instance().request_dump(now_us);
+}
+
+void Tracer::set_thread_name(const char* name) noexcept {
+    ring_lease.thread_name = name;
+    if (ring_lease.ring) {
+        ring_lease.ring->thread_name.store(name, std::memory_order_relaxed);
+    }
+}
+
+std::string Tracer::to_chrome_json(uint64_t from_us, uint64_t to_us) {
+    return TraceState::instance().to_json(from_us, to_us);
+}
+
+uint32_t Tracer::dumps_written() noexcept {
+    return TraceState::instance().dumps_written();
+}
+
+uint32_t Tracer::dump_failures() noexcept {
+    return TraceState::instance().dump_failures();
+}
+
+TraceScope::TraceScope(const char* stage) noexcept
+    : stage_(Tracer::enabled() ? stage : nullptr)
+    , start_us_(stage_ ? steady_time_us() : 0)
+{
+}
+
+void TraceScope::end() noexcept {
+    if (stage_) {
+        Tracer::record(stage_, start_us_, steady_time_us());
+        stage_ = nullptr;
+    }
+}
+
+} // namespace voip
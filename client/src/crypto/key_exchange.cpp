@@ -1,10 +1,10 @@
 #include "crypto/key_exchange.h"
+#include "common/logger.h"
 #include <openssl/evp.h>
 #include <openssl/kdf.h>
 #include <openssl/core_names.h>
 #include <stdexcept>
 #include <cstring>
-#include <iostream>
 
 namespace voip::crypto {
 
@@ -40,7 +40,7 @@ public:
 };
 
 KeyExchange::KeyExchange() : pImpl_(std::make_unique<Impl>()) {
-    std::cout << "🔑 Generated X25519 keypair for SRTP" << std::endl;
+    VOIP_LOG_DEBUG("🔑 Generated X25519 keypair for SRTP");
 }
 
 KeyExchange::~KeyExchange() = default;
@@ -176,7 +176,7 @@ KeyMaterial KeyExchange::derive_keys(const std::array<uint8_t, 32>& peer_public_
 
     EVP_PKEY_CTX_free(kctx);
 
-    std::cout << "🔐 SRTP key material derived successfully" << std::endl;
+    VOIP_LOG_DEBUG("🔐 SRTP key material derived successfully");
 
     return km;
 }
@@ -1,7 +1,7 @@
 #include "crypto/srtp_session.h"
+#include "common/logger.h"
 #include <openssl/evp.h>
 #include <stdexcept>
-#include <iostream>
 #include <cstring>
 
 // Portable endianness conversion
@@ -104,7 +104,7 @@ public:
 SrtpSession::SrtpSession(const std::array<uint8_t, 16>& master_key,
                          const std::array<uint8_t, 14>& salt)
     : pImpl_(std::make_unique<Impl>(master_key, salt)) {
-    std::cout << "🔒 SRTP session created" << std::endl;
+    VOIP_LOG_DEBUG("🔒 SRTP session created");
 }
 
 SrtpSession::~SrtpSession() = default;
@@ -116,7 +116,7 @@ std::vector<uint8_t> SrtpSession::encrypt(const std::vector<uint8_t>& plaintext,
     // Initialize encryption
     if (EVP_EncryptInit_ex(pImpl_->enc_ctx, EVP_aes_128_gcm(), nullptr,
                            pImpl_->master_key.data(), nonce.data()) != 1) {
-        std::cerr << "❌ Failed to init AES-GCM encryption" << std::endl;
+        VOIP_LOG_ERROR("❌ Failed to init AES-GCM encryption");
         return {};
     }
 
@@ -125,21 +125,21 @@ std::vector<uint8_t> SrtpSession::encrypt(const std::vector<uint8_t>& plaintext,
     int len = 0;
     if (EVP_EncryptUpdate(pImpl_->enc_ctx, ciphertext.data(), &len,
                           plaintext.data(), plaintext.size()) != 1) {
-        std::cerr << "❌ Failed to encrypt data" << std::endl;
+        VOIP_LOG_ERROR("❌ Failed to encrypt data");
         return {};
     }
 
     // Finalize encryption
     int final_len = 0;
     if (EVP_EncryptFinal_ex(pImpl_->enc_ctx, ciphertext.data() + len, &final_len) != 1) {
-        std::cerr << "❌ Failed to finalize encryption" << std::endl;
+        VOIP_LOG_ERROR("❌ Failed to finalize encryption");
         return {};
     }
 
     // Get authentication tag
     std::array<uint8_t, 16> tag{};
     if (EVP_CIPHER_CTX_ctrl(pImpl_->enc_ctx, EVP_CTRL_GCM_GET_TAG, 16, tag.data()) != 1) {
-        std::cerr << "❌ Failed to get GCM tag" << std::endl;
+        VOIP_LOG_ERROR("❌ Failed to get GCM tag");
         return {};
     }
 
@@ -164,7 +164,7 @@ std::vector<uint8_t> SrtpSession::encrypt(const std::vector<uint8_t>& plaintext,
 std::vector<uint8_t> SrtpSession::decrypt(const std::vector<uint8_t>& encrypted) {
     // Minimum size check: seq(4) + tag(16)
     if (encrypted.size() < 20) {
-        std::cerr << "❌ SRTP packet too short: " << encrypted.size() << " bytes" << std::endl;
+        VOIP_LOG_WARN("⚠️ SRTP packet too short: " << encrypted.size() << " bytes");
         return {};
     }
 
@@ -175,7 +175,7 @@ std::vector<uint8_t> SrtpSession::decrypt(const std::vector<uint8_t>& encrypted)
 
     // Check replay
     if (!pImpl_->check_replay(sequence)) {
-        std::cerr << "❌ SRTP replay attack detected: seq=" << sequence << std::endl;
+        VOIP_LOG_WARN("⚠️ SRTP replay attack detected: seq=" << sequence);
         return {};
     }
 
@@ -192,7 +192,7 @@ std::vector<uint8_t> SrtpSession::decrypt(const std::vector<uint8_t>& encrypted)
     // Initialize decryption
     if (EVP_DecryptInit_ex(pImpl_->dec_ctx, EVP_aes_128_gcm(), nullptr,
                            pImpl_->master_key.data(), nonce.data()) != 1) {
-        std::cerr << "❌ Failed to init AES-GCM decryption" << std::endl;
+        VOIP_LOG_ERROR("❌ Failed to init AES-GCM decryption");
         return {};
     }
 
@@ -201,21 +201,21 @@ std::vector<uint8_t> SrtpSession::decrypt(const std::vector<uint8_t>& encrypted)
     int len = 0;
     if (EVP_DecryptUpdate(pImpl_->dec_ctx, plaintext.data(), &len,
                           ciphertext_ptr, ciphertext_len) != 1) {
-        std::cerr << "❌ Failed to decrypt data" << std::endl;
+        VOIP_LOG_ERROR("❌ Failed to decrypt data");
         return {};
     }
 
     // Set expected tag
     if (EVP_CIPHER_CTX_ctrl(pImpl_->dec_ctx, EVP_CTRL_GCM_SET_TAG, 16,
                             const_cast<uint8_t*>(tag_ptr)) != 1) {
-        std::cerr << "❌ Failed to set GCM tag" << std::endl;
+        VOIP_LOG_ERROR("❌ Failed to set GCM tag");
         return {};
     }
 
     // Finalize decryption (verifies tag)
     int final_len = 0;
     if (EVP_DecryptFinal_ex(pImpl_->dec_ctx, plaintext.data() + len, &final_len) != 1) {
-        std::cerr << "❌ SRTP authentication failed (invalid tag)" << std::endl;
+        VOIP_LOG_WARN("⚠️ SRTP authentication failed (invalid tag)");
         return {};
     }
 
@@ -0,0 +1,109 @@
+#include "network/address_resolver.h"
+#include <algorithm>
+#include <cstring>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netdb.h>
+#endif
+
+namespace voip::network {
+
+namespace {
+
+// "[::1]" -> "::1"; other hosts pass through
+std::string strip_brackets(const std::string& host) {
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+        return host.substr(1, host.size() - 2);
+    }
+    return host;
+}
+
+Result<std::vector<Endpoint>> lookup(const std::string& host, uint16_t port, int flags) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_protocol = IPPROTO_UDP;
+    hints.ai_flags = flags;
+
+    const std::string service = std::to_string(port);
+    addrinfo* results = nullptr;
+    const int status = getaddrinfo(strip_brackets(host).c_str(), service.c_str(), &hints, &results);
+    if (status != 0 || results == nullptr) {
+        return Err<std::vector<Endpoint>>(ErrorCode::NetworkConnectionFailed,
+            "Cannot resolve " + host + ": " + gai_strerror(status));
+    }
+
+    std::vector<Endpoint> endpoints;
+    for (const addrinfo* entry = results; entry != nullptr; entry = entry->ai_next) {
+        if ((entry->ai_family != AF_INET && entry->ai_family != AF_INET6) ||
+            entry->ai_addrlen > sizeof(sockaddr_storage)) {
+            continue;
+        }
+        Endpoint endpoint;
+        std::memcpy(&endpoint.address, entry->ai_addr, entry->ai_addrlen);
+        endpoint.length = static_cast<socklen_t>(entry->ai_addrlen);
+        endpoints.push_back(endpoint);
+    }
+    freeaddrinfo(results);
+
+    if (endpoints.empty()) {
+        return Err<std::vector<Endpoint>>(ErrorCode::NetworkConnectionFailed,
+            "No IPv4 or IPv6 address for " + host);
+    }
+    return Ok(std::move(endpoints));
+}
+
+} // namespace
+
+std::string Endpoint::to_string() const {
+    char text[INET6_ADDRSTRLEN] = {};
+    if (family() == AF_INET6) {
+        const auto* v6 = reinterpret_cast<const sockaddr_in6*>(&address);
+        inet_ntop(AF_INET6, &v6->sin6_addr, text, sizeof(text));
+        return "[" + std::string(text) + "]:" + std::to_string(ntohs(v6->sin6_port));
+    }
+    const auto* v4 = reinterpret_cast<const sockaddr_in*>(&address);
+    inet_ntop(AF_INET, &v4->sin_addr, text, sizeof(text));
+    return std::string(text) + ":" + std::to_string(ntohs(v4->sin_port));
+}
+
+Result<Endpoint> parse_numeric_endpoint(const std::string& host, uint16_t port) {
+    auto result = lookup(host, port, AI_NUMERICHOST);
+    if (!result.is_ok()) {
+        return Err<Endpoint>(ErrorCode::NetworkConnectionFailed, "Not an IP address: " + host);
+    }
+    return Ok(result.value().front());
+}
+
+Result<std::vector<Endpoint>> resolve_endpoints(const std::string& host, uint16_t port) {
+    // AI_ADDRCONFIG: skip IPv6 answers on hosts without IPv6 (and vice versa)
+    auto result = lookup(host, port, AI_ADDRCONFIG);
+    if (!result.is_ok()) {
+        return result;
+    }
+    return Ok(interleave_families(result.value()));
+}
+
+std::vector<Endpoint> interleave_families(const std::vector<Endpoint>& endpoints) {
+    if (endpoints.empty()) {
+        return {};
+    }
+
+    const int first_family = endpoints.front().family();
+    std::vector<Endpoint> preferred;
+    std::vector<Endpoint> other;
+    for (const auto& endpoint : endpoints) {
+        (endpoint.family() == first_family ? preferred : other).push_back(endpoint);
+    }
+
+    std::vector<Endpoint> ordered;
+    ordered.reserve(endpoints.size());
+    for (size_t i = 0; i < std::max(preferred.size(), other.size()); ++i) {
+        if (i < preferred.size()) ordered.push_back(preferred[i]);
+        if (i < other.size()) ordered.push_back(other[i]);
+    }
+    return ordered;
+}
+
+} // namespace voip::network
@@ -0,0 +1,186 @@
+#include "network/impairment_relay.h"
+#include "common/logger.h"
+#include "common/trace.h"
+#include <cstring>
+#include <vector>
+
+namespace voip::network {
+
+namespace {
+
+constexpr size_t MAX_DATAGRAM_SIZE = 2048;
+
+void close_socket(SocketType& socket) {
+    if (socket == INVALID_SOCKET) {
+        return;
+    }
+#ifdef _WIN32
+    closesocket(socket);
+#else
+    close(socket);
+#endif
+    socket = INVALID_SOCKET;
+}
+
+// Blocking UDP socket bound to INADDR_ANY:port, with a 100ms receive
+// timeout so the loops notice stop()
+SocketType open_bound_socket(uint16_t port) {
+    SocketType sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock == INVALID_SOCKET) {
+        return INVALID_SOCKET;
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(sock, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == SOCKET_ERROR) {
+        close_socket(sock);
+        return INVALID_SOCKET;
+    }
+
+#ifdef _WIN32
+    DWORD timeout = 100;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+#else
+    struct timeval tv;
+    tv.tv_sec = 0;
+    tv.tv_usec = 100000;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+#endif
+    return sock;
+}
+
+} // namespace
+
+Result<std::unique_ptr<ImpairmentRelay>> ImpairmentRelay::start(const Config& config) {
+#ifdef _WIN32
+    WSADATA wsa_data;
+    WSAStartup(MAKEWORD(2, 2), &wsa_data);
+#endif
+
+    auto relay = std::unique_ptr<ImpairmentRelay>(new ImpairmentRelay());
+
+    relay->server_addr_.sin_family = AF_INET;
+    relay->server_addr_.sin_port = htons(config.server_port);
+    if (inet_pton(AF_INET, config.server_address.c_str(), &relay->server_addr_.sin_addr) <= 0) {
+        return Err<std::unique_ptr<ImpairmentRelay>>(
+            ErrorCode::NetworkConnectionFailed, "Invalid server address: " + config.server_address);
+    }
+
+    relay->client_socket_ = open_bound_socket(config.listen_port);
+    relay->server_socket_ = open_bound_socket(0);
+    if (relay->client_socket_ == INVALID_SOCKET || relay->server_socket_ == INVALID_SOCKET) {
+        return Err<std::unique_ptr<ImpairmentRelay>>(
+            ErrorCode::NetworkConnectionFailed,
+            "Failed to bind relay port " + std::to_string(config.listen_port));
+    }
+
+    sockaddr_in bound{};
+#ifdef _WIN32
+    int bound_len = sizeof(bound);
+#else
+    socklen_t bound_len = sizeof(bound);
+#endif
+    getsockname(relay->client_socket_, reinterpret_cast<sockaddr*>(&bound), &bound_len);
+    relay->port_ = ntohs(bound.sin_port);
+
+    ImpairmentRelay* self = relay.get();
+    relay->upstream_ = std::make_unique<ImpairedLink>(config.upstream, [self](const uint8_t* data, size_t size) {
+        sendto(self->server_socket_, reinterpret_cast<const char*>(data), static_cast<int>(size), 0,
+               reinterpret_cast<const sockaddr*>(&self->server_addr_), sizeof(self->server_addr_));
+    });
+    relay->downstream_ = std::make_unique<ImpairedLink>(config.downstream, [self](const uint8_t* data, size_t size) {
+        sockaddr_in client{};
+        {
+            std::lock_guard<std::mutex> lock(self->client_mutex_);
+            if (!self->have_client_) {
+                return;
+            }
+            client = self->client_addr_;
+        }
+        sendto(self->client_socket_, reinterpret_cast<const char*>(data), static_cast<int>(size), 0,
+               reinterpret_cast<const sockaddr*>(&client), sizeof(client));
+    });
+
+    relay->running_ = true;
+    relay->client_thread_ = std::thread(&ImpairmentRelay::client_loop, self);
+    relay->server_thread_ = std::thread(&ImpairmentRelay::server_loop, self);
+
+    VOIP_LOG_INFO("🌩️ Impairment relay on port " << relay->port_ << " -> "
+                  << config.server_address << ":" << config.server_port);
+    return Ok(std::move(relay));
+}
+
+ImpairmentRelay::~ImpairmentRelay() {
+    stop();
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void ImpairmentRelay::stop() {
+    running_ = false;
+    if (client_thread_.joinable()) {
+        client_thread_.join();
+    }
+    if (server_thread_.joinable()) {
+        server_thread_.join();
+    }
+
+    // Links deliver through the sockets, so they go first
+    upstream_.reset();
+    downstream_.reset();
+    close_socket(client_socket_);
+    close_socket(server_socket_);
+}
+
+ImpairmentRelay::Stats ImpairmentRelay::get_stats() const {
+    return Stats{
+        .upstream = upstream_ ? upstream_->get_stats() : ImpairmentStats{},
+        .downstream = downstream_ ? downstream_->get_stats() : ImpairmentStats{}
+    };
+}
+
+void ImpairmentRelay::client_loop() {
+    Tracer::set_thread_name("relay upstream");
+    std::vector<uint8_t> buffer(MAX_DATAGRAM_SIZE);
+
+    while (running_) {
+        sockaddr_in from{};
+#ifdef _WIN32
+        int from_len = sizeof(from);
+#else
+        socklen_t from_len = sizeof(from);
+#endif
+        const int received = recvfrom(client_socket_, reinterpret_cast<char*>(buffer.data()),
+                                      static_cast<int>(buffer.size()), 0,
+                                      reinterpret_cast<sockaddr*>(&from), &from_len);
+        if (received <= 0) {
+            continue;  // Timeout (or a reset from a departed client)
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(client_mutex_);
+            client_addr_ = from;
+            have_client_ = true;
+        }
+        upstream_->send(buffer.data(), static_cast<size_t>(received));
+    }
+}
+
+void ImpairmentRelay::server_loop() {
+    Tracer::set_thread_name("relay downstream");
+    std::vector<uint8_t> buffer(MAX_DATAGRAM_SIZE);
+
+    while (running_) {
+        const int received = recv(server_socket_, reinterpret_cast<char*>(buffer.data()),
+                                  static_cast<int>(buffer.size()), 0);
+        if (received <= 0) {
+            continue;
+        }
+        downstream_->send(buffer.data(), static_cast<size_t>(received));
+    }
+}
+
+} // namespace voip::network
@@ -0,0 +1,82 @@
+#include "network/link_monitor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace voip::network {
+
+LinkMonitor::LinkMonitor(const Config& config)
+    : config_(config)
+{
+}
+
+std::optional<uint32_t> LinkMonitor::poll(uint64_t now_us) {
+    const uint64_t timeout_us = static_cast<uint64_t>(config_.timeout_ms) * 1000;
+    for (auto& probe : probes_) {
+        if (probe.outstanding && now_us - probe.sent_at_us >= timeout_us) {
+            probe.outstanding = false;
+            stats_.probes_lost++;
+            record_outcome(true);
+        }
+    }
+
+    if (next_probe_at_us_ && now_us < *next_probe_at_us_) {
+        return std::nullopt;
+    }
+    next_probe_at_us_ = now_us + static_cast<uint64_t>(config_.interval_ms) * 1000;
+
+    const uint32_t sequence = next_sequence_++;
+    Probe& slot = probes_[sequence % MAX_OUTSTANDING];
+    if (slot.outstanding) {
+        // Timeout longer than MAX_OUTSTANDING intervals: treat the old one as lost
+        stats_.probes_lost++;
+        record_outcome(true);
+    }
+    slot = Probe{sequence, now_us, true};
+    stats_.probes_sent++;
+    return sequence;
+}
+
+bool LinkMonitor::on_echo(uint32_t sequence, uint64_t now_us) {
+    Probe& slot = probes_[sequence % MAX_OUTSTANDING];
+    if (!slot.outstanding || slot.sequence != sequence || now_us < slot.sent_at_us) {
+        stats_.stray_echoes++;
+        return false;
+    }
+
+    slot.outstanding = false;
+    stats_.echoes_received++;
+    record_outcome(false);
+    record_rtt(static_cast<float>(now_us - slot.sent_at_us) / 1000.0f);
+    return true;
+}
+
+float LinkMonitor::one_way_loss() const noexcept {
+    // Round trip survives with (1 - p)^2
+    return 1.0f - std::sqrt(1.0f - std::clamp(stats_.loss_fraction, 0.0f, 1.0f));
+}
+
+void LinkMonitor::record_outcome(bool lost) {
+    outcomes_[outcome_pos_] = lost;
+    outcome_pos_ = (outcome_pos_ + 1) % LOSS_WINDOW;
+    outcome_count_ = std::min(outcome_count_ + 1, LOSS_WINDOW);
+
+    const auto lost_count = std::count(outcomes_.begin(), outcomes_.begin() + outcome_count_, true);
+    stats_.loss_fraction = static_cast<float>(lost_count) / static_cast<float>(outcome_count_);
+}
+
+void LinkMonitor::record_rtt(float rtt_ms) {
+    stats_.last_rtt_ms = rtt_ms;
+    if (stats_.echoes_received == 1) {
+        stats_.rtt_ms = rtt_ms;
+        stats_.rtt_var_ms = rtt_ms / 2.0f;
+        stats_.min_rtt_ms = rtt_ms;
+        return;
+    }
+
+    // RFC 6298: alpha 1/8, beta 1/4
+    stats_.rtt_var_ms += (std::fabs(stats_.rtt_ms - rtt_ms) - stats_.rtt_var_ms) / 4.0f;
+    stats_.rtt_ms += (rtt_ms - stats_.rtt_ms) / 8.0f;
+    stats_.min_rtt_ms = std::min(stats_.min_rtt_ms, rtt_ms);
+}
+
+} // namespace voip::network
@@ -0,0 +1,222 @@
+#include "network/network_impairment.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace voip::network {
+
+namespace {
+
+constexpr double PARETO_ALPHA = 2.5;
+
+// Each stage draws from its own stream, so enabling jitter does not change
+// which packets a given seed loses
+constexpr uint64_t LOSS_STREAM = 0x6c6f7373;
+constexpr uint64_t DELAY_STREAM = 0x64656c61;
+constexpr uint64_t REORDER_STREAM = 0x72656f72;
+constexpr uint64_t DUPLICATE_STREAM = 0x64757065;
+
+} // namespace
+
+// ImpairmentConfig
+
+ImpairmentConfig ImpairmentConfig::gilbert_elliott(float loss_rate, float mean_burst, uint64_t seed) {
+    ImpairmentConfig config;
+    config.seed = seed;
+    config.loss_model = LossModel::GilbertElliott;
+    config.loss_good = 0.0f;
+    config.loss_bad = 1.0f;
+
+    // Bursts last 1/r packets on average; the chain spends p/(p+r) of the time in the bad state
+    const float loss = std::clamp(loss_rate, 0.0f, 0.99f);
+    config.p_bad_to_good = 1.0f / std::max(1.0f, mean_burst);
+    config.p_good_to_bad = std::min(1.0f, loss * config.p_bad_to_good / (1.0f - loss));
+    return config;
+}
+
+bool ImpairmentConfig::active() const noexcept {
+    const bool loses = (loss_model == LossModel::Bernoulli && loss_rate > 0.0f) ||
+                       (loss_model == LossModel::GilbertElliott && (p_good_to_bad > 0.0f || loss_good > 0.0f));
+    return loses || delay_ms > 0 || jitter_ms > 0 || reorder_rate > 0.0f ||
+           duplicate_rate > 0.0f || bandwidth_kbps > 0;
+}
+
+// ImpairmentModel
+
+ImpairmentModel::ImpairmentModel(const ImpairmentConfig& config)
+    : config_(config)
+{
+    reset();
+}
+
+void ImpairmentModel::reset() {
+    loss_rng_.seed(config_.seed ^ LOSS_STREAM);
+    delay_rng_.seed(config_.seed ^ DELAY_STREAM);
+    reorder_rng_.seed(config_.seed ^ REORDER_STREAM);
+    duplicate_rng_.seed(config_.seed ^ DUPLICATE_STREAM);
+    bad_state_ = false;
+    link_free_at_us_ = 0;
+    last_delivery_us_ = 0;
+    stats_ = ImpairmentStats{};
+}
+
+ImpairmentModel::Verdict ImpairmentModel::process(size_t bytes, uint64_t now_us) {
+    stats_.packets++;
+    stats_.bytes += bytes;
+
+    // Bottleneck queue: wait for the link, then serialize
+    uint64_t depart_us = now_us;
+    if (config_.bandwidth_kbps > 0) {
+        const uint64_t start_us = std::max(now_us, link_free_at_us_);
+        if (start_us - now_us > static_cast<uint64_t>(config_.queue_limit_ms) * 1000) {
+            stats_.queue_drops++;
+            return Verdict{};
+        }
+        link_free_at_us_ = start_us + bytes * 8 * 1000 / config_.bandwidth_kbps;
+        depart_us = link_free_at_us_;
+    }
+
+    if (lose_packet()) {
+        stats_.lost++;
+        return Verdict{};
+    }
+
+    uint64_t deliver_us = depart_us + static_cast<uint64_t>(config_.delay_ms) * 1000 + jitter_us();
+    if (config_.preserve_order) {
+        deliver_us = std::max(deliver_us, last_delivery_us_);
+    }
+    last_delivery_us_ = std::max(last_delivery_us_, deliver_us);
+
+    if (config_.reorder_rate > 0.0f && unit_(reorder_rng_) < config_.reorder_rate) {
+        deliver_us += static_cast<uint64_t>(config_.reorder_delay_ms) * 1000;
+        stats_.reordered++;
+    }
+
+    Verdict verdict;
+    verdict.copies = 1;
+    verdict.deliver_at_us[0] = deliver_us;
+    if (config_.duplicate_rate > 0.0f && unit_(duplicate_rng_) < config_.duplicate_rate) {
+        verdict.copies = 2;
+        verdict.deliver_at_us[1] = deliver_us;
+        stats_.duplicated++;
+    }
+    stats_.delivered += verdict.copies;
+    return verdict;
+}
+
+bool ImpairmentModel::lose_packet() {
+    switch (config_.loss_model) {
+        case LossModel::None:
+            return false;
+        case LossModel::Bernoulli:
+            return unit_(loss_rng_) < config_.loss_rate;
+        case LossModel::GilbertElliott: {
+            const float transition = bad_state_ ? config_.p_bad_to_good : config_.p_good_to_bad;
+            if (unit_(loss_rng_) < transition) {
+                bad_state_ = !bad_state_;
+            }
+            return unit_(loss_rng_) < (bad_state_ ? config_.loss_bad : config_.loss_good);
+        }
+    }
+    return false;
+}
+
+uint64_t ImpairmentModel::jitter_us() {
+    if (config_.jitter_ms == 0) {
+        return 0;
+    }
+
+    const double scale_us = config_.jitter_ms * 1000.0;
+    double extra_us = 0.0;
+    switch (config_.jitter_distribution) {
+        case DelayDistribution::Uniform:
+            extra_us = unit_(delay_rng_) * 2.0 * scale_us;
+            break;
+        case DelayDistribution::Normal:
+            extra_us = std::abs(std::normal_distribution<double>(0.0, scale_us)(delay_rng_));
+            break;
+        case DelayDistribution::Pareto: {
+            // Shifted Pareto: x_m / U^(1/alpha) - x_m has mean x_m / (alpha - 1)
+            const double x_m = scale_us * (PARETO_ALPHA - 1.0);
+            const double u = 1.0 - unit_(delay_rng_);  // (0, 1]
+            extra_us = std::min(x_m / std::pow(u, 1.0 / PARETO_ALPHA) - x_m, 100.0 * scale_us);
+            break;
+        }
+    }
+    return static_cast<uint64_t>(extra_us);
+}
+
+// ImpairedLink
+
+ImpairedLink::ImpairedLink(const ImpairmentConfig& config, Deliver deliver)
+    : deliver_(std::move(deliver))
+    , model_(config)
+    , thread_(&ImpairedLink::run, this)
+{
+}
+
+ImpairedLink::~ImpairedLink() {
+    stop();
+}
+
+void ImpairedLink::send(const uint8_t* data, size_t size) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        const auto verdict = model_.process(size, steady_time_us());
+        for (uint32_t i = 0; i < verdict.copies; ++i) {
+            in_flight_.push(InFlight{
+                .deliver_at_us = verdict.deliver_at_us[i],
+                .order = next_order_++,
+                .data = std::vector<uint8_t>(data, data + size)
+            });
+        }
+    }
+    wake_.notify_one();
+}
+
+void ImpairedLink::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        in_flight_ = {};
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+ImpairmentStats ImpairedLink::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return model_.stats();
+}
+
+void ImpairedLink::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (in_flight_.empty()) {
+            wake_.wait(lock);
+            continue;
+        }
+
+        const uint64_t due_us = in_flight_.top().deliver_at_us;
+        const uint64_t now_us = steady_time_us();
+        if (due_us > now_us) {
+            wake_.wait_for(lock, std::chrono::microseconds(due_us - now_us));
+            continue;
+        }
+
+        // top() is const only to protect the heap order, which pop() discards anyway
+        std::vector<uint8_t> data = std::move(const_cast<InFlight&>(in_flight_.top()).data);
+        in_flight_.pop();
+
+        lock.unlock();
+        deliver_(data.data(), data.size());
+        lock.lock();
+    }
+}
+
+} // namespace voip::network
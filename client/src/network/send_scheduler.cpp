@@ -0,0 +1,170 @@
+#include "network/send_scheduler.h"
+#include <algorithm>
+#include <chrono>
+
+namespace voip::network {
+
+SendScheduler::SendScheduler(const SendSchedulerConfig& config, Transmit transmit)
+    : config_(config)
+    , transmit_(std::move(transmit))
+    , voice_inbox_(2 * std::max<size_t>(config.voice_queue_limit, 1))
+    , control_inbox_(2 * std::max<size_t>(config.control_queue_limit, 1))
+    , voice_delay_metric_(MetricsRegistry::global().histogram(
+          "voip_send_queue_voice_us", "Voice datagram wait in the send queue"))
+    , control_delay_metric_(MetricsRegistry::global().histogram(
+          "voip_send_queue_control_us", "Control datagram wait in the send queue"))
+    , drop_metric_(MetricsRegistry::global().counter(
+          "voip_send_queue_drops_total", "Datagrams dropped from a full send queue"))
+{
+    config_.voice_queue_limit = std::max<size_t>(config_.voice_queue_limit, 1);
+    config_.control_queue_limit = std::max<size_t>(config_.control_queue_limit, 1);
+    thread_ = std::thread(&SendScheduler::run, this);
+}
+
+SendScheduler::~SendScheduler() {
+    stop();
+}
+
+bool SendScheduler::enqueue(SendPriority priority, std::vector<uint8_t> data) {
+    if (stopping_.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    const bool voice = priority == SendPriority::Voice;
+    Queued queued{std::move(data), steady_time_us()};
+    bool accepted = false;
+    if (voice) {
+        accepted = voice_inbox_.try_push(std::move(queued));
+    } else {
+        std::lock_guard<std::mutex> producers(control_producers_mutex_);
+        accepted = control_inbox_.try_push(std::move(queued));
+    }
+    if (!accepted) {
+        (voice ? voice_refused_ : control_refused_).fetch_add(1, std::memory_order_relaxed);
+        drop_metric_.add();
+    }
+    wake();
+    return true;
+}
+
+void SendScheduler::stop() {
+    stopping_.store(true, std::memory_order_release);
+    wake();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    // The send thread is gone: this one is the inboxes' consumer now
+    std::lock_guard<std::mutex> lock(mutex_);
+    Queued discarded;
+    while (voice_inbox_.try_pop(discarded)) {
+    }
+    while (control_inbox_.try_pop(discarded)) {
+    }
+    voice_.clear();
+    control_.clear();
+}
+
+SendSchedulerStats SendScheduler::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SendSchedulerStats stats = stats_;
+    stats.voice_dropped += voice_refused_.load(std::memory_order_relaxed);
+    stats.control_dropped += control_refused_.load(std::memory_order_relaxed);
+    stats.voice_delay_p50_us = static_cast<uint32_t>(voice_delay_.percentile(50.0));
+    stats.voice_delay_p99_us = static_cast<uint32_t>(voice_delay_.percentile(99.0));
+    stats.voice_delay_max_us = static_cast<uint32_t>(voice_delay_.max());
+    stats.control_delay_p50_us = static_cast<uint32_t>(control_delay_.percentile(50.0));
+    stats.control_delay_p99_us = static_cast<uint32_t>(control_delay_.percentile(99.0));
+    stats.control_delay_max_us = static_cast<uint32_t>(control_delay_.max());
+    return stats;
+}
+
+void SendScheduler::wake() noexcept {
+    // At most one release outstanding; the send thread clears the flag
+    // when it takes it, before looking at the inboxes again
+    if (!wake_pending_.exchange(true, std::memory_order_acq_rel)) {
+        wake_.release();
+    }
+}
+
+void SendScheduler::wait_for_work(std::optional<uint64_t> timeout_us) {
+    bool woken = true;
+    if (timeout_us) {
+        woken = wake_.try_acquire_for(std::chrono::microseconds(*timeout_us));
+    } else {
+        wake_.acquire();
+    }
+    if (woken) {
+        wake_pending_.store(false, std::memory_order_release);
+    }
+}
+
+void SendScheduler::drain_inboxes() {
+    auto admit = [this](std::deque<Queued>& queue, size_t limit, uint64_t& dropped, Queued&& queued) {
+        if (queue.size() >= limit) {
+            queue.pop_front();
+            dropped++;
+            drop_metric_.add();
+        }
+        queue.push_back(std::move(queued));
+    };
+
+    Queued queued;
+    while (voice_inbox_.try_pop(queued)) {
+        admit(voice_, config_.voice_queue_limit, stats_.voice_dropped, std::move(queued));
+    }
+    while (control_inbox_.try_pop(queued)) {
+        admit(control_, config_.control_queue_limit, stats_.control_dropped, std::move(queued));
+    }
+}
+
+void SendScheduler::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_.load(std::memory_order_acquire)) {
+        drain_inboxes();
+
+        const uint64_t now_us = steady_time_us();
+        Queued next;
+
+        while (!voice_.empty() && now_us > voice_.front().enqueued_us + config_.voice_max_age_us) {
+            voice_.pop_front();
+            stats_.voice_dropped++;
+            drop_metric_.add();
+        }
+
+        if (!voice_.empty()) {
+            next = std::move(voice_.front());
+            voice_.pop_front();
+            const uint64_t waited_us = now_us - std::min(now_us, next.enqueued_us);
+            voice_delay_.record(waited_us);
+            voice_delay_metric_.record(waited_us);
+            stats_.voice_sent++;
+        } else if (!control_.empty()) {
+            // Paced; a voice enqueue wakes us early and goes first
+            if (now_us < next_control_us_) {
+                lock.unlock();
+                wait_for_work(next_control_us_ - now_us);
+                lock.lock();
+                continue;
+            }
+            next = std::move(control_.front());
+            control_.pop_front();
+            next_control_us_ = now_us + config_.control_interval_us;
+            const uint64_t waited_us = now_us - std::min(now_us, next.enqueued_us);
+            control_delay_.record(waited_us);
+            control_delay_metric_.record(waited_us);
+            stats_.control_sent++;
+        } else {
+            lock.unlock();
+            wait_for_work(std::nullopt);
+            lock.lock();
+            continue;
+        }
+
+        lock.unlock();
+        transmit_(next.data.data(), next.data.size());
+        lock.lock();
+    }
+}
+
+} // namespace voip::network
@@ -1,9 +1,144 @@
 #include "network/udp_socket.h"
+#include "network/voice_header.h"
 #include <cstring>
-#include <iostream>
+#include "common/logger.h"
+#include "common/trace.h"
+#include <algorithm>
+#include <chrono>
+#include <optional>
+
+#ifndef _WIN32
+#include <endian.h>
+#include <sys/select.h>
+#endif
+#ifdef __linux__
+#include <netinet/udp.h>
+#endif
 
 namespace voip::network {
 
+// Helper functions for 64-bit byte order conversion
+#ifdef _WIN32
+static inline uint64_t htonll(uint64_t value) {
+    // Convert 64-bit value to network byte order (big-endian)
+    // Upper 32 bits go to upper position, lower 32 bits go to lower position
+    return ((uint64_t)htonl((uint32_t)(value >> 32)) << 32) | htonl((uint32_t)(value & 0xFFFFFFFF));
+}
+
+static inline uint64_t ntohll(uint64_t value) {
+    // Convert 64-bit value from network byte order (big-endian)
+    return ((uint64_t)ntohl((uint32_t)(value >> 32)) << 32) | ntohl((uint32_t)(value & 0xFFFFFFFF));
+}
+#else
+// Linux usually has these
+#ifndef htonll
+#define htonll(x) htobe64(x)
+#endif
+#ifndef ntohll
+#define ntohll(x) be64toh(x)
+#endif
+#endif
+
+namespace {
+
+// Hostname connects race at most this many addresses (both families
+// interleaved), waiting up to the timeout for echoes and a little longer
+// after the first one in case a faster path's probe left later
+constexpr size_t MAX_PATH_CANDIDATES = 4;
+constexpr uint64_t PATH_RACE_TIMEOUT_US = 1000 * 1000;
+constexpr uint64_t PATH_RACE_GRACE_US = 20 * 1000;
+
+// Largest coalesced read with UDP_GRO (one IP datagram)
+constexpr size_t GRO_BUFFER_SIZE = 65536;
+constexpr size_t RECEIVE_BUFFER_SIZE = 2048;
+
+int read_int_option(SocketType socket, int level, int name) {
+    int value = 0;
+    socklen_t length = sizeof(value);
+    if (getsockopt(socket, level, name, reinterpret_cast<char*>(&value), &length) != 0) {
+        return -1;
+    }
+    return value;
+}
+
+void set_int_option(SocketType socket, int level, int name, int value) {
+    // Failures show up in read_socket_options()
+    setsockopt(socket, level, name, reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void apply_socket_options(SocketType socket, int family, const SocketOptions& options) {
+    if (options.dscp >= 0) {
+        // DSCP is the upper six bits of the TOS / traffic class byte
+        const int traffic_class = (options.dscp & 0x3F) << 2;
+        if (family == AF_INET6) {
+            set_int_option(socket, IPPROTO_IPV6, IPV6_TCLASS, traffic_class);
+        } else {
+            set_int_option(socket, IPPROTO_IP, IP_TOS, traffic_class);
+        }
+    }
+    if (options.receive_buffer_bytes > 0) {
+        set_int_option(socket, SOL_SOCKET, SO_RCVBUF, options.receive_buffer_bytes);
+    }
+    if (options.send_buffer_bytes > 0) {
+        set_int_option(socket, SOL_SOCKET, SO_SNDBUF, options.send_buffer_bytes);
+    }
+#ifdef __linux__
+    if (options.priority >= 0) {
+        set_int_option(socket, SOL_SOCKET, SO_PRIORITY, options.priority);
+    }
+    if (options.busy_poll_us > 0) {
+        set_int_option(socket, SOL_SOCKET, SO_BUSY_POLL, options.busy_poll_us);
+    }
+    if (options.udp_gro) {
+        set_int_option(socket, SOL_UDP, UDP_GRO, 1);
+    }
+    if (options.receive_timestamps) {
+        set_int_option(socket, SOL_SOCKET, SO_TIMESTAMPNS, 1);
+    }
+#endif
+}
+
+SocketOptions read_socket_options(SocketType socket, int family) {
+    SocketOptions effective;
+    const int traffic_class = family == AF_INET6
+        ? read_int_option(socket, IPPROTO_IPV6, IPV6_TCLASS)
+        : read_int_option(socket, IPPROTO_IP, IP_TOS);
+    effective.dscp = traffic_class < 0 ? -1 : traffic_class >> 2;
+    // Linux reports twice the requested buffer sizes (bookkeeping overhead)
+    effective.receive_buffer_bytes = read_int_option(socket, SOL_SOCKET, SO_RCVBUF);
+    effective.send_buffer_bytes = read_int_option(socket, SOL_SOCKET, SO_SNDBUF);
+#ifdef __linux__
+    effective.priority = read_int_option(socket, SOL_SOCKET, SO_PRIORITY);
+    effective.busy_poll_us = read_int_option(socket, SOL_SOCKET, SO_BUSY_POLL);
+    effective.udp_gro = read_int_option(socket, SOL_UDP, UDP_GRO) > 0;
+    effective.receive_timestamps = read_int_option(socket, SOL_SOCKET, SO_TIMESTAMPNS) > 0;
+#else
+    effective.priority = -1;
+    effective.busy_poll_us = -1;
+    effective.udp_gro = false;
+    effective.receive_timestamps = false;
+#endif
+    return effective;
+}
+
+#ifdef __linux__
+// Kernel timestamps are CLOCK_REALTIME; move one onto the steady clock by
+// its age. Implausible ages (wall clock stepped) fall back to "now".
+uint64_t steady_arrival_us(const timespec& kernel_time) {
+    const uint64_t now_us = steady_time_us();
+    timespec wall_now{};
+    clock_gettime(CLOCK_REALTIME, &wall_now);
+    const int64_t age_us = (static_cast<int64_t>(wall_now.tv_sec) - kernel_time.tv_sec) * 1000000 +
+                           (wall_now.tv_nsec - kernel_time.tv_nsec) / 1000;
+    if (age_us < 0 || age_us > 1000000 || static_cast<uint64_t>(age_us) > now_us) {
+        return now_us;
+    }
+    return now_us - static_cast<uint64_t>(age_us);
+}
+#endif
+
+} // namespace
+
 // VoicePacket serialization
 std::vector<uint8_t> VoicePacket::serialize() const {
     std::vector<uint8_t> data;
@@ -60,9 +195,66 @@ Result<VoicePacket> VoicePacket::deserialize(const uint8_t* data, size_t length)
     return Ok(std::move(packet));
 }
 
+// KeepalivePacket serialization
+std::vector<uint8_t> KeepalivePacket::serialize() const {
+    std::vector<uint8_t> data(KEEPALIVE_PACKET_SIZE);
+    
+    const uint32_t magic = htonl(echo ? KEEPALIVE_ECHO_MAGIC : KEEPALIVE_MAGIC);
+    const uint32_t net_sequence = htonl(sequence);
+    const uint64_t net_sent_at = htonll(sent_at_us);
+    const uint32_t net_user_id = htonl(user_id);
+    std::memcpy(data.data(), &magic, 4);
+    std::memcpy(data.data() + 4, &net_sequence, 4);
+    std::memcpy(data.data() + 8, &net_sent_at, 8);
+    std::memcpy(data.data() + 16, &net_user_id, 4);
+    
+    return data;
+}
+
+Result<KeepalivePacket> KeepalivePacket::deserialize(const uint8_t* data, size_t length) {
+    if (length != KEEPALIVE_PACKET_SIZE) {
+        return Err<KeepalivePacket>(ErrorCode::InvalidPacket, "Bad keepalive size");
+    }
+    
+    uint32_t magic = 0;
+    uint32_t net_sequence = 0;
+    uint64_t net_sent_at = 0;
+    uint32_t net_user_id = 0;
+    std::memcpy(&magic, data, 4);
+    std::memcpy(&net_sequence, data + 4, 4);
+    std::memcpy(&net_sent_at, data + 8, 8);
+    std::memcpy(&net_user_id, data + 16, 4);
+    
+    magic = ntohl(magic);
+    if (magic != KEEPALIVE_MAGIC && magic != KEEPALIVE_ECHO_MAGIC) {
+        return Err<KeepalivePacket>(ErrorCode::InvalidPacket, "Invalid magic number");
+    }
+    
+    KeepalivePacket packet;
+    packet.sequence = ntohl(net_sequence);
+    packet.sent_at_us = ntohll(net_sent_at);
+    packet.user_id = ntohl(net_user_id);
+    packet.echo = magic == KEEPALIVE_ECHO_MAGIC;
+    return Ok(packet);
+}
+
 // UdpVoiceSocket implementation
 
-UdpVoiceSocket::UdpVoiceSocket() {
+UdpVoiceSocket::UdpVoiceSocket()
+    : packets_sent_metric_(MetricsRegistry::global().counter(
+          "voip_udp_packets_sent_total", "Voice packets sent"))
+    , packets_received_metric_(MetricsRegistry::global().counter(
+          "voip_udp_packets_received_total", "Voice packets received"))
+    , bytes_sent_metric_(MetricsRegistry::global().counter(
+          "voip_udp_bytes_sent_total", "Voice bytes sent, headers included"))
+    , bytes_received_metric_(MetricsRegistry::global().counter(
+          "voip_udp_bytes_received_total", "Voice bytes received, headers included"))
+    , send_error_metric_(MetricsRegistry::global().counter(
+          "voip_udp_send_errors_total", "Failed voice packet sends"))
+    , receive_error_metric_(MetricsRegistry::global().counter(
+          "voip_udp_receive_errors_total", "Failed or malformed voice packet receives"))
+{
+    header_codec_ = std::make_unique<VoiceHeaderCodec>();
 #ifdef _WIN32
     initialize_winsock();
 #endif
@@ -92,65 +284,292 @@ void UdpVoiceSocket::cleanup_winsock() {
 }
 
 Result<void> UdpVoiceSocket::connect(const std::string& server_address, uint16_t port) {
-    if (connected_) {
+    if (connected_ || connecting_) {
         return Err<void>(ErrorCode::NetworkConnectionFailed, "Already connected");
     }
     
-    // Create UDP socket
-    socket_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    if (socket_ == INVALID_SOCKET) {
-        return Err<void>(ErrorCode::NetworkConnectionFailed, "Failed to create socket");
+    // IP literal: nothing to resolve or race
+    auto numeric = parse_numeric_endpoint(server_address, port);
+    if (numeric.is_ok()) {
+        SocketType socket = open_socket(numeric.value().family());
+        if (socket == INVALID_SOCKET) {
+            return Err<void>(ErrorCode::NetworkConnectionFailed, "Failed to create socket");
+        }
+        attach(socket, numeric.value());
+        notify_connect(Ok());
+        return Ok();
     }
     
-    // Set non-blocking mode
-#ifdef _WIN32
-    u_long mode = 1;
-    ioctlsocket(socket_, FIONBIO, &mode);
-#else
-    int flags = fcntl(socket_, F_GETFL, 0);
-    fcntl(socket_, F_SETFL, flags | O_NONBLOCK);
-#endif
+    // Hostname: DNS can take seconds, so resolve and pick a path off the
+    // caller's (usually the UI) thread
+    if (connect_thread_ && connect_thread_->joinable()) {
+        connect_thread_->join();  // Earlier attempt that failed
+    }
+    connecting_ = true;
+    connect_thread_ = std::make_unique<std::thread>(&UdpVoiceSocket::connect_hostname, this, server_address, port);
+    return Ok();
+}
+
+Result<void> UdpVoiceSocket::connect(const std::vector<Endpoint>& candidates) {
+    if (connected_ || connecting_) {
+        return Err<void>(ErrorCode::NetworkConnectionFailed, "Already connected");
+    }
+    if (candidates.empty()) {
+        return Err<void>(ErrorCode::NetworkConnectionFailed, "No server address");
+    }
+    
+    if (connect_thread_ && connect_thread_->joinable()) {
+        connect_thread_->join();
+    }
+    connecting_ = true;
+    connect_thread_ = std::make_unique<std::thread>([this, candidates] {
+        Tracer::set_thread_name("network connect");
+        connect_fastest(candidates);
+    });
+    return Ok();
+}
+
+void UdpVoiceSocket::connect_hostname(const std::string& host, uint16_t port) {
+    Tracer::set_thread_name("network connect");
+    
+    auto resolved = resolve_endpoints(host, port);
+    if (!resolved.is_ok()) {
+        VOIP_LOG_ERROR("❌ " << resolved.error().message());
+        connecting_ = false;
+        notify_connect(Err<void>(resolved.error().code(), resolved.error().message()));
+        return;
+    }
+    
+    connect_fastest(resolved.value());
+}
+
+void UdpVoiceSocket::connect_fastest(std::vector<Endpoint> candidates) {
+    if (candidates.size() > MAX_PATH_CANDIDATES) {
+        candidates.resize(MAX_PATH_CANDIDATES);
+    }
+    
+    // A family may be unusable here (e.g. no IPv6 stack); its sockets stay invalid
+    std::vector<SocketType> sockets;
+    bool any_open = false;
+    for (const auto& candidate : candidates) {
+        sockets.push_back(open_socket(candidate.family()));
+        any_open = any_open || sockets.back() != INVALID_SOCKET;
+    }
+    if (!any_open) {
+        connecting_ = false;
+        notify_connect(Err<void>(ErrorCode::NetworkConnectionFailed, "Failed to create socket"));
+        return;
+    }
+    
+    const size_t winner = candidates.size() == 1 ? 0 : race_paths(candidates, sockets);
+    for (size_t i = 0; i < sockets.size(); ++i) {
+        if (i != winner || !connecting_) {
+            close_socket(sockets[i]);
+        }
+    }
+    if (!connecting_) {
+        return;  // disconnect() gave up on us
+    }
+    
+    attach(sockets[winner], candidates[winner]);
+    connecting_ = false;
+    notify_connect(Ok());
+}
+
+size_t UdpVoiceSocket::race_paths(const std::vector<Endpoint>& candidates, const std::vector<SocketType>& sockets) {
+    // One probe per path, all sent together. Sequence = candidate index;
+    // user 0 tells the server not to map the address to anyone yet.
+    std::vector<uint64_t> sent_at_us(candidates.size(), 0);
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (sockets[i] == INVALID_SOCKET) {
+            continue;
+        }
+        KeepalivePacket probe;
+        probe.sequence = static_cast<uint32_t>(i);
+        probe.sent_at_us = steady_time_us();
+        const auto data = probe.serialize();
+        sendto(sockets[i], reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size()), 0,
+               candidates[i].sockaddr_ptr(), candidates[i].length);
+        sent_at_us[i] = probe.sent_at_us;
+    }
+    
+    std::optional<size_t> fastest;
+    uint64_t fastest_rtt_us = 0;
+    uint64_t deadline_us = steady_time_us() + PATH_RACE_TIMEOUT_US;
+    uint8_t buffer[64];
+    
+    while (connecting_) {
+        const uint64_t start_us = steady_time_us();
+        if (start_us >= deadline_us) {
+            break;
+        }
+        
+        // Wake on any echo; wake up regularly to notice disconnect()
+        fd_set readable;
+        FD_ZERO(&readable);
+        SocketType highest = 0;
+        for (SocketType socket : sockets) {
+            if (socket != INVALID_SOCKET) {
+                FD_SET(socket, &readable);
+                highest = std::max(highest, socket);
+            }
+        }
+        const uint64_t wait_us = std::min<uint64_t>(deadline_us - start_us, 50 * 1000);
+        timeval timeout{0, static_cast<decltype(timeval::tv_usec)>(wait_us)};
+        if (select(static_cast<int>(highest + 1), &readable, nullptr, nullptr, &timeout) <= 0) {
+            continue;
+        }
+        
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            if (sockets[i] == INVALID_SOCKET || !FD_ISSET(sockets[i], &readable)) {
+                continue;
+            }
+            const int received = recv(sockets[i], reinterpret_cast<char*>(buffer), sizeof(buffer), 0);
+            const uint64_t now_us = steady_time_us();
+            if (received != static_cast<int>(KEEPALIVE_PACKET_SIZE)) {
+                continue;  // Nothing yet, ICMP unreachable, or not an echo
+            }
+            auto echo = KeepalivePacket::deserialize(buffer, KEEPALIVE_PACKET_SIZE);
+            if (!echo.is_ok() || !echo.value().echo || echo.value().sequence != i) {
+                continue;
+            }
+            
+            const uint64_t rtt_us = now_us - sent_at_us[i];
+            VOIP_LOG_DEBUG("🏁 Path " << candidates[i].to_string() << ": " << rtt_us / 1000.0 << "ms");
+            if (!fastest) {
+                // Probes leave a few microseconds apart, so give the others a moment
+                deadline_us = std::min(deadline_us, now_us + PATH_RACE_GRACE_US);
+            }
+            if (!fastest || rtt_us < fastest_rtt_us) {
+                fastest = i;
+                fastest_rtt_us = rtt_us;
+            }
+        }
+    }
     
-    // Set up server address
-    std::memset(&server_addr_, 0, sizeof(server_addr_));
-    server_addr_.sin_family = AF_INET;
-    server_addr_.sin_port = htons(port);
+    if (fastest) {
+        VOIP_LOG_INFO("🏁 Voice path " << candidates[*fastest].to_string() << " ("
+                      << fastest_rtt_us / 1000.0 << "ms RTT) won against "
+                      << candidates.size() - 1 << " other(s)");
+        return *fastest;
+    }
     
-    // Resolve server address
-    if (inet_pton(AF_INET, server_address.c_str(), &server_addr_.sin_addr) <= 0) {
-        // Try hostname resolution
-        // For now, just fail - full DNS resolution would go here
-        disconnect();
-        return Err<void>(ErrorCode::NetworkConnectionFailed, 
-                        "Invalid server address: " + server_address);
+    // Server doesn't echo (or UDP is blocked everywhere): take the preferred address
+    for (size_t i = 0; i < sockets.size(); ++i) {
+        if (sockets[i] != INVALID_SOCKET) {
+            VOIP_LOG_WARN("⚠️ No keepalive echo from any voice path, using " << candidates[i].to_string());
+            return i;
+        }
     }
+    return 0;
+}
+
+void UdpVoiceSocket::attach(SocketType socket, const Endpoint& server) {
+    socket_ = socket;
+    server_endpoint_ = server;
+    effective_options_ = read_socket_options(socket, server.family());
+    
+    if (effective_options_.dscp != socket_options_.dscp && socket_options_.dscp >= 0) {
+        VOIP_LOG_WARN("⚠️ Voice socket DSCP " << socket_options_.dscp << " not applied (got "
+                      << effective_options_.dscp << "); voice is not prioritised on the wire");
+    }
+    if (socket_options_.busy_poll_us > 0 && effective_options_.busy_poll_us != socket_options_.busy_poll_us) {
+        VOIP_LOG_WARN("⚠️ SO_BUSY_POLL " << socket_options_.busy_poll_us << "us refused (needs CAP_NET_ADMIN)");
+    }
+    VOIP_LOG_DEBUG("🚦 Voice socket: DSCP " << effective_options_.dscp
+                   << ", priority " << effective_options_.priority
+                   << ", rcvbuf " << effective_options_.receive_buffer_bytes
+                   << ", sndbuf " << effective_options_.send_buffer_bytes
+                   << ", busy poll " << effective_options_.busy_poll_us << "us"
+                   << (effective_options_.udp_gro ? ", GRO" : ""));
+    
+    if (outgoing_impairment_.active()) {
+        outgoing_link_ = std::make_unique<ImpairedLink>(outgoing_impairment_, [this](const uint8_t* data, size_t size) {
+            (void)transmit(data, size);
+        });
+    }
+    if (incoming_impairment_.active()) {
+        // The simulated path ends here, so that is when the packet "arrives"
+        incoming_link_ = std::make_unique<ImpairedLink>(incoming_impairment_, [this](const uint8_t* data, size_t size) {
+            handle_datagram(data, size, steady_time_us());
+        });
+    }
+    if (outgoing_link_ || incoming_link_) {
+        VOIP_LOG_WARN("⚠️ UDP socket running over a simulated impaired network");
+    }
+    
+    // Everything outgoing leaves from the send thread, voice first
+    send_scheduler_ = std::make_unique<SendScheduler>(SendSchedulerConfig{}, [this](const uint8_t* data, size_t size) {
+        if (outgoing_link_) {
+            outgoing_link_->send(data, size);
+        } else {
+            (void)transmit(data, size);
+        }
+    });
+    
+    // Start receive thread
+    running_ = true;
+    receive_thread_ = std::make_unique<std::thread>(&UdpVoiceSocket::receive_loop, this);
     
     connected_ = true;
+    VOIP_LOG_INFO("📡 UDP voice socket connected to " << server.to_string());
+}
+
+void UdpVoiceSocket::notify_connect(const Result<void>& result) {
+    if (connect_callback_) {
+        connect_callback_(result);
+    }
+}
+
+SocketType UdpVoiceSocket::open_socket(int family) const {
+    SocketType socket = ::socket(family, SOCK_DGRAM, IPPROTO_UDP);
+    if (socket == INVALID_SOCKET) {
+        return INVALID_SOCKET;
+    }
     
+    apply_socket_options(socket, family, socket_options_);
+    
+    // Blocking receives with a timeout: the receive thread sleeps in the
+    // kernel until a packet arrives and still notices shutdown
     // Set socket timeout to allow graceful shutdown
 #ifdef _WIN32
     DWORD timeout = 100;  // 100ms timeout
-    setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+    setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
 #else
     struct timeval tv;
     tv.tv_sec = 0;
     tv.tv_usec = 100000;  // 100ms
-    setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
 #endif
     
-    // Start receive thread
-    running_ = true;
-    receive_thread_ = std::make_unique<std::thread>(&UdpVoiceSocket::receive_loop, this);
-    
-    return Ok();
+    return socket;
+}
+
+void UdpVoiceSocket::close_socket(SocketType socket) {
+    if (socket == INVALID_SOCKET) {
+        return;
+    }
+#ifdef _WIN32
+    closesocket(socket);
+#else
+    close(socket);
+#endif
 }
 
 void UdpVoiceSocket::disconnect() {
+    // Abandon a path race in progress (a DNS lookup can't be interrupted,
+    // so this may wait for the resolver)
+    connecting_ = false;
+    if (connect_thread_ && connect_thread_->joinable()) {
+        connect_thread_->join();
+    }
+    connect_thread_.reset();
+    
     if (!connected_) {
         return;
     }
     
-    std::cout << "🔌 Disconnecting UDP socket..." << std::endl;
+    VOIP_LOG_INFO("🔌 Disconnecting UDP socket...");
     
     // Signal receive thread to stop
     running_ = false;
@@ -168,49 +587,73 @@ void UdpVoiceSocket::disconnect() {
     if (receive_thread_ && receive_thread_->joinable()) {
         // Thread should exit within 100ms due to socket timeout
         receive_thread_->join();
-        std::cout << "✅ UDP receive thread stopped" << std::endl;
+        VOIP_LOG_DEBUG("✅ UDP receive thread stopped");
     }
     receive_thread_.reset();
     
+    // Drop queued and in-flight packets before the socket goes away
+    if (send_scheduler_) {
+        send_scheduler_->stop();
+    }
+    outgoing_link_.reset();
+    incoming_link_.reset();
+    
     // Close socket
     if (socket_ != INVALID_SOCKET) {
-#ifdef _WIN32
-        closesocket(socket_);
-#else
-        close(socket_);
-#endif
-        std::cout << "✅ UDP socket closed" << std::endl;
+        close_socket(socket_);
+        VOIP_LOG_DEBUG("✅ UDP socket closed");
         socket_ = INVALID_SOCKET;
     }
     
     connected_ = false;
 }
 
-Result<void> UdpVoiceSocket::send_packet(const VoicePacket& packet) {
+Result<void> UdpVoiceSocket::send_packet(const VoicePacket& packet, SendPriority priority) {
     if (!connected_) {
         return Err<void>(ErrorCode::NetworkSendFailed, "Not connected");
     }
     
-    // Serialize packet
-    auto data = packet.serialize();
+    // Serialize packet in the negotiated header format
+    return enqueue(priority, header_codec_->serialize(packet));
+}
+
+Result<void> UdpVoiceSocket::send_keepalive(const KeepalivePacket& probe) {
+    if (!connected_) {
+        return Err<void>(ErrorCode::NetworkSendFailed, "Not connected");
+    }
     
+    // Takes the same path as voice so it measures (and keeps open) the same route
+    return enqueue(SendPriority::Control, probe.serialize());
+}
+
+Result<void> UdpVoiceSocket::enqueue(SendPriority priority, std::vector<uint8_t> data) {
+    if (!send_scheduler_ || !send_scheduler_->enqueue(priority, std::move(data))) {
+        return Err<void>(ErrorCode::NetworkSendFailed, "Send queue stopped");
+    }
+    return Ok();
+}
+
+Result<void> UdpVoiceSocket::transmit(const uint8_t* data, size_t size) {
     // Send to server
     int sent = sendto(
         socket_,
-        reinterpret_cast<const char*>(data.data()),
-        static_cast<int>(data.size()),
+        reinterpret_cast<const char*>(data),
+        static_cast<int>(size),
         0,
-        reinterpret_cast<const sockaddr*>(&server_addr_),
-        sizeof(server_addr_)
+        server_endpoint_.sockaddr_ptr(),
+        server_endpoint_.length
     );
     
     if (sent == SOCKET_ERROR) {
         send_errors_++;
+        send_error_metric_.add();
         return Err<void>(ErrorCode::NetworkSendFailed, "sendto failed");
     }
     
     packets_sent_++;
     bytes_sent_ += sent;
+    packets_sent_metric_.add();
+    bytes_sent_metric_.add(static_cast<uint64_t>(sent));
     
     return Ok();
 }
@@ -219,10 +662,43 @@ void UdpVoiceSocket::set_receive_callback(PacketReceivedCallback callback) {
     receive_callback_ = std::move(callback);
 }
 
+void UdpVoiceSocket::set_connect_callback(ConnectCallback callback) {
+    connect_callback_ = std::move(callback);
+}
+
+void UdpVoiceSocket::set_keepalive_callback(KeepaliveEchoCallback callback) {
+    keepalive_callback_ = std::move(callback);
+}
+
+void UdpVoiceSocket::set_socket_options(const SocketOptions& options) {
+    socket_options_ = options;
+}
+
+void UdpVoiceSocket::set_voice_aliases(const VoiceAliases& aliases) {
+    header_codec_->set_aliases(aliases);
+}
+
+void UdpVoiceSocket::set_impairment(const ImpairmentConfig& outgoing, const ImpairmentConfig& incoming) {
+    outgoing_impairment_ = outgoing;
+    incoming_impairment_ = incoming;
+}
+
+ImpairmentStats UdpVoiceSocket::outgoing_impairment_stats() const {
+    return outgoing_link_ ? outgoing_link_->get_stats() : ImpairmentStats{};
+}
+
+ImpairmentStats UdpVoiceSocket::incoming_impairment_stats() const {
+    return incoming_link_ ? incoming_link_->get_stats() : ImpairmentStats{};
+}
+
 bool UdpVoiceSocket::is_connected() const noexcept {
     return connected_;
 }
 
+std::string UdpVoiceSocket::server_endpoint() const {
+    return connected_ ? server_endpoint_.to_string() : std::string();
+}
+
 UdpVoiceSocket::Stats UdpVoiceSocket::get_stats() const {
     return Stats{
         .packets_sent = packets_sent_.load(),
@@ -230,44 +706,60 @@ UdpVoiceSocket::Stats UdpVoiceSocket::get_stats() const {
         .send_errors = send_errors_.load(),
         .receive_errors = receive_errors_.load(),
         .bytes_sent = bytes_sent_.load(),
-        .bytes_received = bytes_received_.load()
+        .bytes_received = bytes_received_.load(),
+        .effective_options = connected_ ? std::optional<SocketOptions>(effective_options_) : std::nullopt,
+        .send_queue = send_scheduler_ ? send_scheduler_->get_stats() : SendSchedulerStats{}
     };
 }
 
 void UdpVoiceSocket::receive_loop() {
-    std::vector<uint8_t> buffer(2048);  // Max UDP packet size
-    sockaddr_in from_addr;
+    Tracer::set_thread_name("network receive");
     
-#ifdef _WIN32
-    int from_len = sizeof(from_addr);
-#else
-    socklen_t from_len = sizeof(from_addr);
-#endif
+    // With GRO the kernel hands over several datagrams from one sender in a
+    // single read, cut into equal segments (the last may be shorter)
+    const bool gro = effective_options_.udp_gro;
+    std::vector<uint8_t> buffer(gro ? GRO_BUFFER_SIZE : RECEIVE_BUFFER_SIZE);
     
     while (running_) {
-        // Receive packet
-        int received = recvfrom(
-            socket_,
-            reinterpret_cast<char*>(buffer.data()),
-            static_cast<int>(buffer.size()),
-            0,
-            reinterpret_cast<sockaddr*>(&from_addr),
-            &from_len
-        );
+        // Blocks until a packet arrives or the receive timeout expires
+        int received = 0;
+        size_t segment_size = 0;
+        uint64_t arrival_us = 0;
+#ifdef __linux__
+        iovec iov{buffer.data(), buffer.size()};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(timespec))];
+        msghdr message{};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
         
+        received = static_cast<int>(recvmsg(socket_, &message, 0));
         if (received > 0) {
-            bytes_received_ += received;
-            packets_received_++;
-            
-            // Parse packet
-            auto result = VoicePacket::deserialize(buffer.data(), received);
-            if (result.is_ok()) {
-                // Call callback if set
-                if (receive_callback_) {
-                    receive_callback_(result.value());
+            for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+                if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                    int gso_size = 0;
+                    std::memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+                    segment_size = static_cast<size_t>(gso_size);
+                } else if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                    timespec kernel_time{};
+                    std::memcpy(&kernel_time, CMSG_DATA(cmsg), sizeof(kernel_time));
+                    arrival_us = steady_arrival_us(kernel_time);
                 }
-            } else {
-                receive_errors_++;
+            }
+        }
+#else
+        received = recv(socket_, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0);
+#endif
+        
+        if (received > 0) {
+            if (arrival_us == 0) {
+                arrival_us = steady_time_us();  // No kernel timestamp
+            }
+            const size_t total = static_cast<size_t>(received);
+            const size_t step = segment_size > 0 ? segment_size : total;
+            for (size_t offset = 0; offset < total; offset += step) {
+                deliver(buffer.data() + offset, std::min(step, total - offset), arrival_us);
             }
         } else if (received == SOCKET_ERROR) {
 #ifdef _WIN32
@@ -275,41 +767,59 @@ void UdpVoiceSocket::receive_loop() {
             // Ignore timeout and connection reset (happens during shutdown)
             if (error != WSAEWOULDBLOCK && error != WSAETIMEDOUT && error != WSAECONNRESET) {
                 receive_errors_++;
+                receive_error_metric_.add();
                 if (!running_) break;  // Exit if shutting down
             }
 #else
-            if (errno != EWOULDBLOCK && errno != EAGAIN) {
+            if (errno != EWOULDBLOCK && errno != EAGAIN && errno != EINTR) {
                 receive_errors_++;
+                receive_error_metric_.add();
                 if (!running_) break;
             }
 #endif
         }
-        
-        // No need for sleep - socket timeout handles this
     }
 }
 
-// Helper functions for 64-bit byte order conversion
-#ifdef _WIN32
-static inline uint64_t htonll(uint64_t value) {
-    // Convert 64-bit value to network byte order (big-endian)
-    // Upper 32 bits go to upper position, lower 32 bits go to lower position
-    return ((uint64_t)htonl((uint32_t)(value >> 32)) << 32) | htonl((uint32_t)(value & 0xFFFFFFFF));
+void UdpVoiceSocket::deliver(const uint8_t* data, size_t size, uint64_t arrival_us) {
+    if (incoming_link_) {
+        incoming_link_->send(data, size);
+    } else {
+        handle_datagram(data, size, arrival_us);
+    }
 }
 
-static inline uint64_t ntohll(uint64_t value) {
-    // Convert 64-bit value from network byte order (big-endian)
-    return ((uint64_t)ntohl((uint32_t)(value >> 32)) << 32) | ntohl((uint32_t)(value & 0xFFFFFFFF));
+void UdpVoiceSocket::handle_datagram(const uint8_t* data, size_t size, uint64_t arrival_us) {
+    bytes_received_ += size;
+    packets_received_++;
+    bytes_received_metric_.add(size);
+    packets_received_metric_.add();
+    
+    // Keepalive echoes are told apart by size and magic
+    if (size == KEEPALIVE_PACKET_SIZE) {
+        auto echo = KeepalivePacket::deserialize(data, size);
+        if (echo.is_ok() && echo.value().echo) {
+            echo.value().received_at_us = arrival_us;
+            if (keepalive_callback_) {
+                keepalive_callback_(echo.value());
+            }
+            return;
+        }
+    }
+    
+    // Parse packet (compact or legacy header)
+    auto result = header_codec_->deserialize(data, size);
+    if (result.is_ok()) {
+        result.value().received_at_us = arrival_us;
+        
+        // Call callback if set
+        if (receive_callback_) {
+            receive_callback_(result.value());
+        }
+    } else {
+        receive_errors_++;
+        receive_error_metric_.add();
+    }
 }
-#else
-#include <arpa/inet.h>
-// Linux usually has these
-#ifndef htonll
-#define htonll(x) htobe64(x)
-#endif
-#ifndef ntohll
-#define ntohll(x) be64toh(x)
-#endif
-#endif
 
 } // namespace voip::network
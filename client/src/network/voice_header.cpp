@@ -0,0 +1,224 @@
+#include "network/voice_header.h"
+#include <algorithm>
+
+namespace voip::network {
+
+namespace {
+
+constexpr unsigned SEQUENCE_BITS = 16;
+constexpr unsigned TIMESTAMP_BITS = 32;
+
+// LEB128: 7 bits per byte, low bits first; aliases under 128 take one byte
+void write_varint(std::vector<uint8_t>& out, uint16_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool read_varint(const uint8_t* data, size_t length, size_t& pos, uint16_t& value) {
+    uint32_t result = 0;
+    for (unsigned shift = 0; shift <= 14; shift += 7) {
+        if (pos >= length) {
+            return false;
+        }
+        const uint8_t byte = data[pos++];
+        result |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            if (result > 0xFFFF) {
+                return false;
+            }
+            value = static_cast<uint16_t>(result);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+void CompactHeader::write(std::vector<uint8_t>& out) const {
+    out.push_back(COMPACT_HEADER_VERSION);
+    write_varint(out, user_alias);
+    write_varint(out, channel_alias);
+    out.push_back(static_cast<uint8_t>(sequence_lsb >> 8));
+    out.push_back(static_cast<uint8_t>(sequence_lsb));
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>(timestamp_lsb >> shift));
+    }
+}
+
+Result<CompactHeader> CompactHeader::parse(const uint8_t* data, size_t length) {
+    if (length == 0 || data[0] != COMPACT_HEADER_VERSION) {
+        return Err<CompactHeader>(ErrorCode::InvalidPacket, "Not a compact header");
+    }
+
+    CompactHeader header;
+    size_t pos = 1;
+    if (!read_varint(data, length, pos, header.user_alias) ||
+        !read_varint(data, length, pos, header.channel_alias) ||
+        length - pos < 6) {
+        return Err<CompactHeader>(ErrorCode::InvalidPacket, "Truncated compact header");
+    }
+
+    header.sequence_lsb = static_cast<uint16_t>((data[pos] << 8) | data[pos + 1]);
+    header.timestamp_lsb = (static_cast<uint32_t>(data[pos + 2]) << 24) |
+                           (static_cast<uint32_t>(data[pos + 3]) << 16) |
+                           (static_cast<uint32_t>(data[pos + 4]) << 8) |
+                           static_cast<uint32_t>(data[pos + 5]);
+    header.size = pos + 6;
+    return Ok(header);
+}
+
+uint64_t extend_lsb(uint64_t reference, uint64_t lsb, unsigned bits) noexcept {
+    const uint64_t range = uint64_t{1} << bits;
+    const uint64_t half = range / 2;
+    const uint64_t candidate = (reference & ~(range - 1)) | lsb;
+    if (candidate < reference && reference - candidate > half) {
+        return candidate + range;
+    }
+    if (candidate > reference && candidate - reference > half && candidate >= range) {
+        return candidate - range;
+    }
+    return candidate;
+}
+
+void VoiceHeaderCodec::set_aliases(const VoiceAliases& aliases) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    user_aliases_.clear();
+    users_by_alias_.clear();
+    channel_aliases_.clear();
+    channels_by_alias_.clear();
+    for (const auto& [user_id, alias] : aliases.users) {
+        user_aliases_[user_id] = alias;
+        users_by_alias_[alias] = user_id;
+    }
+    for (const auto& [channel_id, alias] : aliases.channels) {
+        channel_aliases_[channel_id] = alias;
+        channels_by_alias_[alias] = channel_id;
+    }
+    compact_ = true;
+}
+
+void VoiceHeaderCodec::clear_aliases() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    compact_ = false;
+    user_aliases_.clear();
+    users_by_alias_.clear();
+    channel_aliases_.clear();
+    channels_by_alias_.clear();
+    streams_.clear();
+}
+
+bool VoiceHeaderCodec::compact_enabled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return compact_;
+}
+
+std::vector<uint8_t> VoiceHeaderCodec::serialize(const VoicePacket& packet) const {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto user = user_aliases_.find(packet.header.user_id);
+        const auto channel = channel_aliases_.find(packet.header.channel_id);
+        if (compact_ && user != user_aliases_.end() && channel != channel_aliases_.end()) {
+            CompactHeader header;
+            header.user_alias = user->second;
+            header.channel_alias = channel->second;
+            header.sequence_lsb = static_cast<uint16_t>(packet.header.sequence);
+            header.timestamp_lsb = static_cast<uint32_t>(packet.header.timestamp);
+
+            std::vector<uint8_t> data;
+            data.reserve(COMPACT_HEADER_MAX_SIZE + packet.encrypted_payload.size());
+            header.write(data);
+            data.insert(data.end(), packet.encrypted_payload.begin(), packet.encrypted_payload.end());
+            return data;
+        }
+    }
+
+    // Not negotiated, or the server hasn't announced an alias yet
+    return packet.serialize();
+}
+
+Result<VoicePacket> VoiceHeaderCodec::deserialize(const uint8_t* data, size_t length) {
+    return deserialize(data, length, steady_time_us());
+}
+
+Result<VoicePacket> VoiceHeaderCodec::deserialize(const uint8_t* data, size_t length, uint64_t now_us) {
+    if (length > 0 && data[0] == COMPACT_HEADER_VERSION) {
+        return deserialize_compact(data, length, now_us);
+    }
+    return VoicePacket::deserialize(data, length);
+}
+
+size_t VoiceHeaderCodec::stream_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return streams_.size();
+}
+
+void VoiceHeaderCodec::evict_streams(uint64_t now_us) {
+    std::erase_if(streams_, [now_us](const auto& entry) {
+        return now_us - entry.second.last_seen_us > STREAM_IDLE_US;
+    });
+    if (streams_.size() >= MAX_STREAMS) {
+        const auto oldest = std::min_element(streams_.begin(), streams_.end(), [](const auto& a, const auto& b) {
+            return a.second.last_seen_us < b.second.last_seen_us;
+        });
+        streams_.erase(oldest);
+    }
+}
+
+Result<VoicePacket> VoiceHeaderCodec::deserialize_compact(const uint8_t* data, size_t length, uint64_t now_us) {
+    auto parsed = CompactHeader::parse(data, length);
+    if (!parsed.is_ok()) {
+        return Err<VoicePacket>(parsed.error().code(), parsed.error().message());
+    }
+    const CompactHeader& header = parsed.value();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto user = users_by_alias_.find(header.user_alias);
+    const auto channel = channels_by_alias_.find(header.channel_alias);
+    if (user == users_by_alias_.end() || channel == channels_by_alias_.end()) {
+        return Err<VoicePacket>(ErrorCode::InvalidPacket, "Unknown voice alias");
+    }
+
+    VoicePacket packet;
+    packet.header.magic = VOICE_PACKET_MAGIC;
+    packet.header.user_id = user->second;
+    packet.header.channel_id = channel->second;
+
+    // A new stream's timestamps are restored around our own clock, so a
+    // sender sharing it (our own voice echoed back) comes out exact. Late
+    // packets restore against the newest values without moving them back.
+    // After a pause the timestamp is re-anchored the same way; the sequence
+    // only moves when packets are sent, so it keeps its reference.
+    const uint64_t seq_lsb = header.sequence_lsb;
+    const uint64_t ts_lsb = header.timestamp_lsb;
+    const std::pair<UserId, ChannelId> key{user->second, channel->second};
+    auto stream = streams_.find(key);
+    if (stream == streams_.end()) {
+        if (streams_.size() >= MAX_STREAMS) {
+            evict_streams(now_us);
+        }
+        stream = streams_.emplace(key, Stream{seq_lsb, now_us, now_us}).first;
+    } else if (now_us - stream->second.last_seen_us > STREAM_IDLE_US) {
+        stream->second.timestamp = now_us;
+    }
+    stream->second.last_seen_us = now_us;
+
+    const uint64_t sequence = extend_lsb(stream->second.sequence, seq_lsb, SEQUENCE_BITS);
+    const uint64_t timestamp = extend_lsb(stream->second.timestamp, ts_lsb, TIMESTAMP_BITS);
+    if (sequence >= stream->second.sequence) {
+        stream->second.sequence = sequence;
+        stream->second.timestamp = timestamp;
+    }
+    packet.header.sequence = sequence;
+    packet.header.timestamp = timestamp;
+
+    if (length > header.size) {
+        packet.encrypted_payload.assign(data + header.size, data + length);
+    }
+    return Ok(std::move(packet));
+}
+
+} // namespace voip::network
@@ -4,12 +4,52 @@
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonArray>
+#include <QtCore/QTimer>
+#include <algorithm>
 #include <iostream>
 
 namespace voip::network {
 
+namespace {
+
+// Rosters as sent in all_channel_rosters and resumed
+std::vector<protocol::ChannelRosterInfo> parse_rosters(const QJsonArray& channels_array) {
+    std::vector<protocol::ChannelRosterInfo> rosters;
+    rosters.reserve(channels_array.size());
+
+    for (const QJsonValue& ch_val : channels_array) {
+        QJsonObject ch_obj = ch_val.toObject();
+
+        protocol::ChannelRosterInfo roster;
+        roster.channel_id = ch_obj["channel_id"].toInt();
+        roster.channel_name = ch_obj["channel_name"].toString().toStdString();
+
+        // Parse users array
+        QJsonArray users_array = ch_obj["users"].toArray();
+        roster.users.reserve(users_array.size());
+
+        for (const QJsonValue& user_val : users_array) {
+            QJsonObject user_obj = user_val.toObject();
+
+            protocol::UserInfo user;
+            user.id = user_obj["id"].toInt();
+            user.username = user_obj["name"].toString().toStdString();
+            user.speaking = user_obj["speaking"].toBool();
+            user.muted = false;  // Server doesn't send this yet
+
+            roster.users.push_back(user);
+        }
+
+        rosters.push_back(roster);
+    }
+    return rosters;
+}
+
+} // namespace
+
 WebSocketClient::WebSocketClient()
     : websocket_(std::make_unique<QWebSocket>())
+    , reconnect_timer_(std::make_unique<QTimer>())
 {
     // Connect Qt signals to our handlers
     QObject::connect(websocket_.get(), &QWebSocket::connected,
@@ -36,6 +76,13 @@ WebSocketClient::WebSocketClient()
                          }
                          websocket_->ignoreSslErrors();
                      });
+
+    reconnect_timer_->setSingleShot(true);
+    QObject::connect(reconnect_timer_.get(), &QTimer::timeout, [this]() {
+        std::cout << "🔄 Reconnecting to: " << url_ << "\n";
+        reconnecting_ = true;
+        websocket_->open(QUrl(QString::fromStdString(url_)));
+    });
 }
 
 WebSocketClient::~WebSocketClient() {
@@ -51,17 +98,31 @@ Result<void> WebSocketClient::connect(const std::string& server_address,
     
     // Build WebSocket URL
     std::string protocol = use_tls ? "wss" : "ws";
-    std::string url = protocol + "://" + server_address + ":" + std::to_string(port) + "/control";
+    url_ = protocol + "://" + server_address + ":" + std::to_string(port) + "/control";
+    
+    std::cout << "WebSocket connecting to: " << url_ << "\n";
     
-    std::cout << "WebSocket connecting to: " << url << "\n";
+    closing_ = false;
+    reconnecting_ = false;
+    backoff_attempt_ = 0;
     
     // Open connection
-    websocket_->open(QUrl(QString::fromStdString(url)));
+    websocket_->open(QUrl(QString::fromStdString(url_)));
     
     return Ok();
 }
 
 void WebSocketClient::disconnect() {
+    // Deliberate disconnect: stop retrying and forget the session
+    closing_ = true;
+    reconnect_timer_->stop();
+    resume_token_.clear();
+    roster_version_ = 0;
+    {
+        std::lock_guard<std::mutex> lock(channels_mutex_);
+        joined_channels_.clear();
+    }
+    
     if (!connected_) {
         return;
     }
@@ -165,6 +226,11 @@ Result<void> WebSocketClient::leave_channel(ChannelId channel_id) {
     websocket_->sendTextMessage(message);
     messages_sent_++;
 
+    {
+        std::lock_guard<std::mutex> lock(channels_mutex_);
+        joined_channels_.erase(channel_id);
+    }
+
     return Ok();
 }
 
@@ -186,6 +252,10 @@ Result<void> WebSocketClient::leave_channel() {
     websocket_->sendTextMessage(message);
     messages_sent_++;
 
+    {
+        std::lock_guard<std::mutex> lock(channels_mutex_);
+        joined_channels_.erase(current_channel_);
+    }
     current_channel_ = 0;
 
     return Ok();
@@ -211,6 +281,25 @@ Result<void> WebSocketClient::request_all_channel_rosters() {
     return Ok();
 }
 
+Result<void> WebSocketClient::request_compact_voice_header() {
+    if (!authenticated_) {
+        return Err<void>(ErrorCode::InvalidState, "Not authenticated");
+    }
+
+    // Build JSON message to match Rust server protocol
+    QJsonObject json;
+    json["type"] = "voice_format";  // snake_case to match serde
+    json["formats"] = QJsonArray{"compact_v1", "legacy"};
+
+    QJsonDocument doc(json);
+    QString message = doc.toJson(QJsonDocument::Compact);
+
+    websocket_->sendTextMessage(message);
+    messages_sent_++;
+
+    return Ok();
+}
+
 Result<void> WebSocketClient::send_key_exchange_response(const std::array<uint8_t, 32>& public_key) {
     if (!connected_) {
         return Err<void>(ErrorCode::NetworkConnectionFailed, "Not connected");
@@ -293,6 +382,21 @@ void WebSocketClient::set_all_channel_rosters_callback(AllChannelRostersCallback
     on_all_channel_rosters_cb_ = std::move(callback);
 }
 
+void WebSocketClient::set_reconnecting_callback(ReconnectingCallback callback) {
+    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    on_reconnecting_cb_ = std::move(callback);
+}
+
+void WebSocketClient::set_resumed_callback(ResumedCallback callback) {
+    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    on_resumed_cb_ = std::move(callback);
+}
+
+void WebSocketClient::set_voice_aliases_callback(VoiceAliasesCallback callback) {
+    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    on_voice_aliases_cb_ = std::move(callback);
+}
+
 WebSocketClient::Stats WebSocketClient::get_stats() const {
     return Stats{
         .messages_sent = messages_sent_.load(),
@@ -308,6 +412,12 @@ void WebSocketClient::on_connected() {
     std::cout << "✅ WebSocket connected!\n";
     connected_ = true;
     
+    // After a drop, pick the old session back up instead of logging in again
+    if (reconnecting_ && !auth_token_.empty()) {
+        send_resume();
+        return;
+    }
+    
     std::lock_guard<std::mutex> lock(callbacks_mutex_);
     if (on_connected_cb_) {
         on_connected_cb_();
@@ -319,9 +429,15 @@ void WebSocketClient::on_disconnected() {
     connected_ = false;
     authenticated_ = false;
     
-    std::lock_guard<std::mutex> lock(callbacks_mutex_);
-    if (on_disconnected_cb_) {
-        on_disconnected_cb_();
+    {
+        std::lock_guard<std::mutex> lock(callbacks_mutex_);
+        if (on_disconnected_cb_) {
+            on_disconnected_cb_();
+        }
+    }
+    
+    if (!closing_ && !url_.empty()) {
+        schedule_reconnect();
     }
 }
 
@@ -367,6 +483,12 @@ void WebSocketClient::on_text_message_received(const QString& message) {
     } else if (typeStr == "all_channel_rosters") {  // Channel roster broadcast
         std::cout << "📊 Received all channel rosters" << std::endl;
         handle_all_channel_rosters(json_str);
+    } else if (typeStr == "resumed") {  // Session restored after reconnect
+        handle_resumed(json_str);
+    } else if (typeStr == "resume_failed") {  // Session gone, log in again
+        handle_resume_failed(json_str);
+    } else if (typeStr == "voice_aliases") {  // Compact voice header IDs
+        handle_voice_aliases(json_str);
     } else {
         std::cout << "Unknown message type: " << typeStr.toStdString() << "\n";
     }
@@ -375,6 +497,64 @@ void WebSocketClient::on_text_message_received(const QString& message) {
 void WebSocketClient::on_error(const QString& error) {
     std::cerr << "WebSocket error: " << error.toStdString() << "\n";
     errors_++;
+    
+    // A failed reconnect attempt never reaches connected, so retry from here
+    if (reconnecting_ && !connected_ && !closing_) {
+        schedule_reconnect();
+    }
+}
+
+// Reconnect
+
+void WebSocketClient::schedule_reconnect() {
+    if (reconnect_timer_->isActive()) {
+        return;
+    }
+    
+    // Exponential backoff with jitter, so clients that dropped together
+    // (server restart, access point handoff) don't reconnect in lockstep
+    const uint32_t exponent = std::min<uint32_t>(backoff_attempt_, 6);
+    const uint32_t ceiling = std::min(RECONNECT_MAX_DELAY_MS, RECONNECT_BASE_DELAY_MS << exponent);
+    std::uniform_int_distribution<uint32_t> jitter(ceiling / 2, ceiling);
+    const uint32_t delay_ms = jitter(jitter_rng_);
+    
+    backoff_attempt_++;
+    reconnect_attempts_++;
+    std::cout << "🔄 Reconnecting in " << delay_ms << "ms (attempt " << backoff_attempt_ << ")\n";
+    reconnect_timer_->start(static_cast<int>(delay_ms));
+    
+    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    if (on_reconnecting_cb_) {
+        on_reconnecting_cb_(backoff_attempt_, delay_ms);
+    }
+}
+
+void WebSocketClient::send_resume() {
+    // Build JSON message to match Rust server protocol
+    QJsonObject json;
+    json["type"] = "resume";  // snake_case to match serde
+    json["session_token"] = QString::fromStdString(auth_token_);
+    json["resume_token"] = resume_token_.empty()
+        ? QJsonValue(QJsonValue::Null) : QJsonValue(QString::fromStdString(resume_token_));
+    
+    QJsonArray channels;
+    {
+        std::lock_guard<std::mutex> lock(channels_mutex_);
+        for (ChannelId channel_id : joined_channels_) {
+            channels.append(static_cast<qint64>(channel_id));
+        }
+    }
+    json["channels"] = channels;
+    json["roster_version"] = roster_version_ == 0
+        ? QJsonValue(QJsonValue::Null) : QJsonValue(static_cast<qint64>(roster_version_));
+    
+    QJsonDocument doc(json);
+    QString message = doc.toJson(QJsonDocument::Compact);
+    
+    std::cout << "🔄 Resuming session (" << channels.size() << " channels)\n";
+    
+    websocket_->sendTextMessage(message);
+    messages_sent_++;
 }
 
 // Message handlers
@@ -452,6 +632,15 @@ void WebSocketClient::handle_login_response(const std::string& json_str) {
         user_id_ = response.user_id;
         org_id_ = response.org_id;
         
+        // Fresh session: nothing joined yet, keep the token for a later resume
+        resume_token_ = json["resume_token"].toString().toStdString();
+        reconnecting_ = false;
+        backoff_attempt_ = 0;
+        {
+            std::lock_guard<std::mutex> lock(channels_mutex_);
+            joined_channels_.clear();
+        }
+        
         // Server doesn't send channels list in auth_result
         // Channels will be discovered via other means
         
@@ -490,6 +679,10 @@ void WebSocketClient::handle_channel_joined(const std::string& json_str) {
     }
     
     current_channel_ = response.channel_id;
+    {
+        std::lock_guard<std::mutex> lock(channels_mutex_);
+        joined_channels_.insert(response.channel_id);
+    }
     
     std::cout << "✅ Joined channel " << response.channel_id 
               << " with " << response.users.size() << " users:\n";
@@ -590,43 +783,109 @@ void WebSocketClient::handle_all_channel_rosters(const std::string& json_str) {
     QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromStdString(json_str));
     QJsonObject json = doc.object();
 
-    // Parse channels array
-    QJsonArray channels_array = json["channels"].toArray();
-
     protocol::AllChannelRostersResponse response;
-    response.channels.reserve(channels_array.size());
+    response.channels = parse_rosters(json["channels"].toArray());
+    response.roster_version = static_cast<uint64_t>(json["roster_version"].toInteger());
+    roster_version_ = response.roster_version;
 
-    for (const QJsonValue& ch_val : channels_array) {
-        QJsonObject ch_obj = ch_val.toObject();
+    std::cout << "📊 Parsed rosters for " << response.channels.size() << " channels" << std::endl;
 
-        protocol::ChannelRosterInfo roster;
-        roster.channel_id = ch_obj["channel_id"].toInt();
-        roster.channel_name = ch_obj["channel_name"].toString().toStdString();
+    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    if (on_all_channel_rosters_cb_) {
+        on_all_channel_rosters_cb_(response);
+    }
+}
 
-        // Parse users array
-        QJsonArray users_array = ch_obj["users"].toArray();
-        roster.users.reserve(users_array.size());
+void WebSocketClient::handle_resumed(const std::string& json_str) {
+    QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromStdString(json_str));
+    QJsonObject json = doc.object();
 
-        for (const QJsonValue& user_val : users_array) {
-            QJsonObject user_obj = user_val.toObject();
+    protocol::ResumeResponse response;
+    response.user_id = json["user_id"].toInt();
+    response.org_id = json["org_id"].toInt();
+    response.permissions = static_cast<uint32_t>(json["permissions"].toInteger());
+    response.key_exchange_required = json["key_exchange_required"].toBool();
+    for (const QJsonValue& channel : json["channels"].toArray()) {
+        response.channels.push_back(static_cast<ChannelId>(channel.toInt()));
+    }
 
-            protocol::UserInfo user;
-            user.id = user_obj["id"].toInt();
-            user.username = user_obj["name"].toString().toStdString();
-            user.speaking = user_obj["speaking"].toBool();
-            user.muted = false;  // Server doesn't send this yet
+    authenticated_ = true;
+    reconnecting_ = false;
+    backoff_attempt_ = 0;
+    auth_token_ = json["session_token"].toString().toStdString();
+    resume_token_ = json["resume_token"].toString().toStdString();
+    user_id_ = response.user_id;
+    org_id_ = response.org_id;
+    roster_version_ = static_cast<uint64_t>(json["roster_version"].toInteger());
+    {
+        std::lock_guard<std::mutex> lock(channels_mutex_);
+        joined_channels_ = std::set<ChannelId>(response.channels.begin(), response.channels.end());
+    }
 
-            roster.users.push_back(user);
-        }
+    // Rosters only come back if something changed while we were away
+    protocol::AllChannelRostersResponse rosters;
+    response.rosters_included = json["rosters"].isArray();
+    if (response.rosters_included) {
+        rosters.channels = parse_rosters(json["rosters"].toArray());
+        rosters.roster_version = roster_version_;
+    }
 
-        response.channels.push_back(roster);
+    std::cout << "✅ Session resumed: " << response.channels.size() << " channels"
+              << (response.key_exchange_required ? ", renegotiating keys" : "")
+              << (response.rosters_included ? ", rosters updated" : "") << std::endl;
+
+    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    if (on_resumed_cb_) {
+        on_resumed_cb_(response);
     }
+    if (response.rosters_included && on_all_channel_rosters_cb_) {
+        on_all_channel_rosters_cb_(rosters);
+    }
+}
 
-    std::cout << "📊 Parsed rosters for " << response.channels.size() << " channels" << std::endl;
+void WebSocketClient::handle_voice_aliases(const std::string& json_str) {
+    QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromStdString(json_str));
+    QJsonObject json = doc.object();
+
+    protocol::VoiceAliasesResponse response;
+    response.compact = json["format"].toString() == "compact_v1";
+    for (const QJsonValue& entry : json["users"].toArray()) {
+        const QJsonObject alias = entry.toObject();
+        response.users.emplace_back(static_cast<UserId>(alias["id"].toInteger()),
+                                    static_cast<uint16_t>(alias["alias"].toInt()));
+    }
+    for (const QJsonValue& entry : json["channels"].toArray()) {
+        const QJsonObject alias = entry.toObject();
+        response.channels.emplace_back(static_cast<ChannelId>(alias["id"].toInteger()),
+                                       static_cast<uint16_t>(alias["alias"].toInt()));
+    }
 
     std::lock_guard<std::mutex> lock(callbacks_mutex_);
-    if (on_all_channel_rosters_cb_) {
-        on_all_channel_rosters_cb_(response);
+    if (on_voice_aliases_cb_) {
+        on_voice_aliases_cb_(response);
+    }
+}
+
+void WebSocketClient::handle_resume_failed(const std::string& json_str) {
+    QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromStdString(json_str));
+    QJsonObject json = doc.object();
+
+    std::cout << "⚠️  Session could not be resumed: " << json["message"].toString().toStdString()
+              << " - logging in again" << std::endl;
+
+    // Start over as if this were a fresh connection
+    reconnecting_ = false;
+    auth_token_.clear();
+    resume_token_.clear();
+    roster_version_ = 0;
+    {
+        std::lock_guard<std::mutex> lock(channels_mutex_);
+        joined_channels_.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    if (on_connected_cb_) {
+        on_connected_cb_();
     }
 }
 
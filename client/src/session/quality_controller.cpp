@@ -0,0 +1,121 @@
+#include "session/quality_controller.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace voip::session {
+
+namespace {
+
+// EWMA weight of a new interval
+constexpr float SMOOTHING = 0.3f;
+
+} // namespace
+
+QualityController::QualityController(const Config& config)
+    : config_(config)
+{
+    config_.min_bitrate = std::min(config_.min_bitrate, config_.max_bitrate);
+    config_.max_frames_per_packet = std::max(config_.max_frames_per_packet, 1u);
+
+    decision_.bitrate = config_.max_bitrate;
+    decision_.complexity = complexity_for(decision_.bitrate);
+    decision_.enable_fec = true;
+    decision_.packet_loss_perc = 5;
+}
+
+bool QualityController::update(const QualityFeedback& feedback) {
+    const float loss = std::clamp(feedback.loss_fraction, 0.0f, 1.0f);
+
+    if (first_update_) {
+        smoothed_loss_ = loss;
+        smoothed_jitter_ms_ = feedback.jitter_ms;
+        first_update_ = false;
+    } else {
+        smoothed_loss_ += SMOOTHING * (loss - smoothed_loss_);
+        smoothed_jitter_ms_ += SMOOTHING * (feedback.jitter_ms - smoothed_jitter_ms_);
+    }
+
+    const bool rtt_known = feedback.rtt_ms > 0.0f;
+    QualityDecision next = decision_;
+
+    // Bitrate (AIMD)
+    const bool congested = smoothed_loss_ > config_.loss_high ||
+                           smoothed_jitter_ms_ > config_.jitter_high_ms ||
+                           (rtt_known && feedback.rtt_ms > config_.rtt_high_ms);
+    const bool clean = smoothed_loss_ < config_.loss_low &&
+                       smoothed_jitter_ms_ < config_.jitter_high_ms / 2.0f &&
+                       (!rtt_known || feedback.rtt_ms < config_.rtt_high_ms / 2.0f);
+
+    if (congested) {
+        const auto reduced = static_cast<uint32_t>(static_cast<float>(decision_.bitrate) * config_.decrease_factor);
+        next.bitrate = std::max(config_.min_bitrate, reduced);
+        clean_intervals_ = 0;
+
+        // Nothing left to take off the bitrate: spend fewer bytes on headers
+        if (decision_.bitrate > config_.min_bitrate) {
+            floor_intervals_ = 0;
+        } else if (++floor_intervals_ >= config_.aggregate_after &&
+                   decision_.frames_per_packet < config_.max_frames_per_packet) {
+            next.frames_per_packet = decision_.frames_per_packet + 1;
+            floor_intervals_ = 0;
+        }
+    } else if (clean) {
+        floor_intervals_ = 0;
+        if (++clean_intervals_ >= config_.increase_after) {
+            // Aggregation costs latency, so it is the first thing undone
+            if (decision_.frames_per_packet > 1) {
+                next.frames_per_packet = decision_.frames_per_packet - 1;
+            } else {
+                next.bitrate = std::min(config_.max_bitrate, decision_.bitrate + config_.increase_step);
+            }
+            clean_intervals_ = 0;
+        }
+    } else {
+        clean_intervals_ = 0;  // In between: hold
+        floor_intervals_ = 0;
+    }
+
+    next.complexity = complexity_for(next.bitrate);
+
+    // FEC (separate on/off thresholds so it doesn't flap)
+    if (!decision_.enable_fec && smoothed_loss_ >= config_.fec_on_loss) {
+        next.enable_fec = true;
+    } else if (decision_.enable_fec && smoothed_loss_ < config_.fec_off_loss) {
+        next.enable_fec = false;
+    }
+
+    // Expected loss: Opus only spends bits on FEC when this is non-zero
+    int target_perc = std::min(config_.max_loss_perc,
+                               static_cast<int>(std::ceil(smoothed_loss_ * 100.0f)));
+    if (next.enable_fec) {
+        target_perc = std::max(target_perc, 1);
+    }
+    if (std::abs(target_perc - decision_.packet_loss_perc) >= config_.loss_perc_deadband ||
+        next.enable_fec != decision_.enable_fec) {
+        next.packet_loss_perc = target_perc;
+    }
+
+    const bool changed = next.bitrate != decision_.bitrate ||
+                         next.complexity != decision_.complexity ||
+                         next.enable_fec != decision_.enable_fec ||
+                         next.packet_loss_perc != decision_.packet_loss_perc ||
+                         next.frames_per_packet != decision_.frames_per_packet;
+    if (changed) {
+        decision_ = next;
+        adjustments_++;
+    }
+
+    return changed;
+}
+
+int QualityController::complexity_for(uint32_t bitrate) const noexcept {
+    // Complexity buys the most at low bitrates; with bits to spare,
+    // two steps less is inaudible and saves encoder CPU
+    if (bitrate >= config_.relaxed_complexity_bitrate) {
+        return std::max(0, config_.complexity - 2);
+    }
+    return config_.complexity;
+}
+
+} // namespace voip::session
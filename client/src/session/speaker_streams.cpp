@@ -0,0 +1,173 @@
+#include "session/speaker_streams.h"
+#include "common/logger.h"
+#include <algorithm>
+#include <limits>
+
+namespace voip::session {
+
+SpeakerStreams::SpeakerStreams(const Config& config)
+    : config_(config)
+{
+    config_.max_streams = std::max<size_t>(config_.max_streams, 1);
+    pool_.reserve(config_.pool_size);
+}
+
+SpeakerStream* SpeakerStreams::route(ChannelId channel_id, UserId user_id, SequenceNumber sequence,
+                                     uint64_t timestamp, size_t frames, uint64_t now_us) {
+    SpeakerStream* stream = current(channel_id, user_id);
+    if (!stream) {
+        stream = open(channel_id, user_id, 0, sequence, timestamp);
+    } else {
+        // Sender timestamps only move forward within a run, so a packet
+        // behind the stream but newer than anything on it was numbered
+        // after a restart, while one older than the epoch's start is a
+        // straggler from the run before
+        const SequenceNumber highest = stream->highest_sequence;
+        bool restarted = false;
+        if (sequence + config_.reset_gap < highest) {
+            restarted = true;  // Far behind: a restart whatever the clock says
+        } else if (timestamp < stream->first_timestamp) {
+            const auto previous = stream->key.epoch > 0
+                ? streams_.find(StreamKey{channel_id, user_id, stream->key.epoch - 1})
+                : streams_.end();
+            if (previous == streams_.end() || timestamp < previous->second->first_timestamp) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            stream = previous->second.get();
+        } else if (sequence > highest) {
+            // Past what the jitter buffer accepts: it would drop every packet from here on
+            restarted = sequence - highest > stream->jitter_buffer->capacity();
+        } else {
+            restarted = timestamp > stream->highest_timestamp;
+        }
+
+        if (restarted) {
+            VOIP_LOG_DEBUG("🔁 Sender " << user_id << " on channel " << channel_id
+                           << " restarted numbering (seq " << highest << " -> " << sequence
+                           << "), epoch " << stream->key.epoch + 1);
+            stream = open(channel_id, user_id, stream->key.epoch + 1, sequence, timestamp);
+            epoch_resets_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    stream->highest_sequence = std::max(stream->highest_sequence, sequence + std::max<size_t>(frames, 1) - 1);
+    stream->highest_timestamp = std::max(stream->highest_timestamp, timestamp);
+    stream->last_heard_us = now_us;
+    return stream;
+}
+
+void SpeakerStreams::reclaim(uint64_t now_us, const std::function<bool(ChannelId)>& keep) {
+    float jitter_ms = 0.0f;
+    for (auto it = streams_.begin(); it != streams_.end();) {
+        SpeakerStream& stream = *it->second;
+        const bool idle = now_us > stream.last_heard_us &&
+                          now_us - stream.last_heard_us > config_.idle_timeout_us;
+        if (idle || !keep(stream.key.channel_id)) {
+            release(std::move(it->second));
+            it = streams_.erase(it);
+            reclaimed_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        jitter_ms = std::max(jitter_ms, stream.jitter_buffer->get_stats().jitter_ms);
+        ++it;
+    }
+    active_.store(static_cast<uint32_t>(streams_.size()), std::memory_order_relaxed);
+    jitter_ms_.store(jitter_ms, std::memory_order_relaxed);
+}
+
+void SpeakerStreams::clear() {
+    for (auto& [key, stream] : streams_) {
+        release(std::move(stream));
+    }
+    streams_.clear();
+    active_.store(0, std::memory_order_relaxed);
+    jitter_ms_.store(0.0f, std::memory_order_relaxed);
+}
+
+SpeakerStreams::Stats SpeakerStreams::stats() const {
+    Stats stats;
+    stats.active = active_.load(std::memory_order_relaxed);
+    stats.pooled = pooled_.load(std::memory_order_relaxed);
+    stats.opened = opened_.load(std::memory_order_relaxed);
+    stats.epoch_resets = epoch_resets_.load(std::memory_order_relaxed);
+    stats.reclaimed = reclaimed_.load(std::memory_order_relaxed);
+    stats.evicted = evicted_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.jitter_ms = jitter_ms_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+SpeakerStream* SpeakerStreams::current(ChannelId channel_id, UserId user_id) {
+    // Epochs of a speaker are adjacent in the table, newest last
+    auto it = streams_.upper_bound(StreamKey{channel_id, user_id, std::numeric_limits<uint32_t>::max()});
+    if (it == streams_.begin()) {
+        return nullptr;
+    }
+    --it;
+    if (it->first.channel_id != channel_id || it->first.user_id != user_id) {
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+SpeakerStream* SpeakerStreams::open(ChannelId channel_id, UserId user_id, uint32_t epoch,
+                                    SequenceNumber sequence, uint64_t timestamp) {
+    // Only the epoch before this one may still have audio to play out
+    for (auto it = streams_.lower_bound(StreamKey{channel_id, user_id, 0});
+         it != streams_.end() && it->first.channel_id == channel_id && it->first.user_id == user_id &&
+         it->first.epoch + 1 < epoch;) {
+        release(std::move(it->second));
+        it = streams_.erase(it);
+        reclaimed_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (streams_.size() >= config_.max_streams) {
+        auto quietest = std::min_element(streams_.begin(), streams_.end(), [](const auto& a, const auto& b) {
+            return a.second->last_heard_us < b.second->last_heard_us;
+        });
+        release(std::move(quietest->second));
+        streams_.erase(quietest);
+        evicted_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::unique_ptr<SpeakerStream> stream;
+    if (!pool_.empty()) {
+        stream = std::move(pool_.back());
+        pool_.pop_back();
+        pooled_.store(static_cast<uint32_t>(pool_.size()), std::memory_order_relaxed);
+    } else {
+        stream = std::make_unique<SpeakerStream>();
+        stream->jitter_buffer = std::make_unique<audio::JitterBuffer>(
+            config_.jitter_buffer_frames, config_.frame_size, config_.sample_rate);
+    }
+
+    const StreamKey key{channel_id, user_id, epoch};
+    stream->key = key;
+    stream->highest_sequence = sequence;
+    stream->highest_timestamp = timestamp;
+    stream->first_timestamp = timestamp;
+
+    SpeakerStream* opened = stream.get();
+    streams_[key] = std::move(stream);
+    opened_.fetch_add(1, std::memory_order_relaxed);
+    active_.store(static_cast<uint32_t>(streams_.size()), std::memory_order_relaxed);
+    return opened;
+}
+
+void SpeakerStreams::release(std::unique_ptr<SpeakerStream> stream) {
+    if (pool_.size() >= config_.pool_size) {
+        return;
+    }
+    stream->jitter_buffer->reset();
+    if (stream->decoder) {
+        auto _ = stream->decoder->reset();
+    }
+    stream->samples.clear();
+    stream->read_pos = 0;
+    stream->last_heard_us = 0;
+    pool_.push_back(std::move(stream));
+    pooled_.store(static_cast<uint32_t>(pool_.size()), std::memory_order_relaxed);
+}
+
+} // namespace voip::session
@@ -0,0 +1,269 @@
+#include "session/voice_hub.h"
+#include "common/logger.h"
+#include <algorithm>
+#include <thread>
+
+namespace voip::session {
+
+VoiceHub::VoiceHub()
+    : dropped_frames_metric_(MetricsRegistry::global().counter(
+          "voip_hub_dropped_frames_total", "Device frames the voice hub could not hand to its sessions"))
+{
+}
+
+VoiceHub::~VoiceHub() {
+    shutdown();
+}
+
+Result<void> VoiceHub::initialize(const Config& config, std::unique_ptr<audio::AudioBackend> audio_backend) {
+    if (audio_engine_) {
+        return Err<void>(ErrorCode::AudioInitFailed, "Voice hub already initialized");
+    }
+    if (!is_valid_opus_frame_size(config.sample_rate, config.frame_size)) {
+        return Err<void>(ErrorCode::AudioInitFailed,
+                        "Frame size " + std::to_string(config.frame_size) +
+                        " is not a valid Opus frame duration (2.5-60ms)");
+    }
+
+    config_ = config;
+
+    auto engine = audio_backend ? std::make_unique<audio::AudioEngine>(std::move(audio_backend))
+                                : std::make_unique<audio::AudioEngine>();
+    AudioConfig audio_config;
+    audio_config.sample_rate = config.sample_rate;
+    audio_config.frame_size = config.frame_size;
+
+    auto audio_result = engine->initialize(audio_config);
+    if (!audio_result.is_ok()) {
+        return Err<void>(audio_result.error().code(),
+                        "Failed to initialize audio: " + audio_result.error().message());
+    }
+
+    // Callbacks stay installed; they only run while the streams are open
+    engine->set_capture_callback([this](const float* pcm, size_t frames, uint64_t capture_time_us) {
+        this->on_audio_captured(pcm, frames, capture_time_us);
+    });
+    engine->set_playback_callback([this](float* pcm, size_t frames, uint64_t playout_time_us) {
+        this->on_audio_playback_needed(pcm, frames, playout_time_us);
+    });
+
+    mix_buffer_.assign(config.frame_size, 0.0f);
+    members_.reserve(MAX_MEMBERS);
+    audio_engine_ = std::move(engine);
+
+    VOIP_LOG_INFO("🔀 Voice hub initialized: " << config.sample_rate << " Hz, frame "
+                  << config.frame_size << " samples");
+    return Ok();
+}
+
+void VoiceHub::shutdown() {
+    std::lock_guard<std::mutex> lifecycle(lifecycle_mutex_);
+    if (!audio_engine_) {
+        return;
+    }
+
+    if (!members_.empty()) {
+        VOIP_LOG_WARN("⚠️ Voice hub shut down with " << members_.size() << " session(s) still started");
+        members_.clear();
+        publish();
+    }
+
+    worker_.stop();
+    auto _ = audio_engine_->stop_capture();
+    auto __ = audio_engine_->stop_playback();
+    audio_engine_->shutdown();
+    audio_engine_.reset();
+}
+
+audio::AudioEngine* VoiceHub::get_audio_engine() noexcept {
+    return audio_engine_.get();
+}
+
+const audio::AudioEngine* VoiceHub::get_audio_engine() const noexcept {
+    return audio_engine_.get();
+}
+
+size_t VoiceHub::session_count() const {
+    std::lock_guard<std::mutex> lifecycle(lifecycle_mutex_);
+    return members_.size();
+}
+
+RtThread::Stats VoiceHub::worker_stats() const {
+    return worker_.get_stats();
+}
+
+Result<void> VoiceHub::attach(Member* member) {
+    std::lock_guard<std::mutex> lifecycle(lifecycle_mutex_);
+    if (!audio_engine_) {
+        return Err<void>(ErrorCode::AudioStreamFailed, "Voice hub not initialized");
+    }
+    if (std::find(members_.begin(), members_.end(), member) != members_.end()) {
+        return Err<void>(ErrorCode::AudioStreamFailed, "Session already started on this hub");
+    }
+    if (members_.size() >= MAX_MEMBERS) {
+        return Err<void>(ErrorCode::AudioStreamFailed,
+                        "Voice hub already carries " + std::to_string(MAX_MEMBERS) + " sessions");
+    }
+
+    const bool first = members_.empty();
+    members_.push_back(member);
+    publish();
+    if (!first) {
+        VOIP_LOG_INFO("🔀 Session joined the voice hub (" << members_.size() << " started)");
+        return Ok();
+    }
+
+    // First session: open the devices and start the shared worker
+    auto fail = [this](const Result<void>& result, const char* what) {
+        members_.clear();
+        publish();
+        auto _ = audio_engine_->stop_capture();
+        auto __ = audio_engine_->stop_playback();
+        return Err<void>(result.error().code(), std::string(what) + result.error().message());
+    };
+
+    auto capture_result = audio_engine_->start_capture();
+    if (!capture_result.is_ok()) {
+        return fail(capture_result, "Failed to start capture: ");
+    }
+
+    auto playback_result = audio_engine_->start_playback();
+    if (!playback_result.is_ok()) {
+        return fail(playback_result, "Failed to start playback: ");
+    }
+
+    // A device off the wall clock paces the members from its playback callback
+    device_paced_.store(!audio_engine_->backend()->wall_clock());
+    if (device_paced_.load()) {
+        VOIP_LOG_INFO("🔀 Voice hub started devices (worker runs on device ticks)");
+        return Ok();
+    }
+
+    RtThread::Config worker_config;
+    worker_config.period_us = frame_duration_us(config_.sample_rate, config_.frame_size);
+    worker_config.realtime = config_.worker_realtime;
+    worker_config.cpu = config_.worker_cpu;
+    auto worker_result = worker_.start(worker_config, [this] { worker_tick(); });
+    if (!worker_result.is_ok()) {
+        return fail(worker_result, "Failed to start voice worker: ");
+    }
+
+    VOIP_LOG_INFO("🔀 Voice hub started devices and worker");
+    return Ok();
+}
+
+void VoiceHub::detach(Member* member) {
+    std::lock_guard<std::mutex> lifecycle(lifecycle_mutex_);
+    const auto it = std::find(members_.begin(), members_.end(), member);
+    if (it == members_.end()) {
+        return;
+    }
+    members_.erase(it);
+
+    // Returns once no callback or tick still holds the old list
+    publish();
+
+    if (members_.empty() && audio_engine_) {
+        worker_.stop();
+        auto _ = audio_engine_->stop_capture();
+        auto __ = audio_engine_->stop_playback();
+        VOIP_LOG_INFO("🔀 Voice hub stopped devices and worker");
+    }
+}
+
+const VoiceHub::Snapshot& VoiceHub::acquire(int& slot) noexcept {
+    // Count ourselves in, then make sure the slot was not swapped out
+    // meanwhile; a writer only refills a slot once its count is zero
+    for (;;) {
+        slot = published_.load();
+        readers_[slot].fetch_add(1);
+        if (published_.load() == slot) {
+            return snapshots_[slot];
+        }
+        readers_[slot].fetch_sub(1);
+    }
+}
+
+void VoiceHub::release(int slot) noexcept {
+    readers_[slot].fetch_sub(1);
+}
+
+void VoiceHub::publish() {
+    const int current = published_.load();
+    const int next = 1 - current;
+
+    // Readers on the idle slot only pinned it in passing and back off
+    while (readers_[next].load() != 0) {
+        std::this_thread::yield();
+    }
+    Snapshot& snapshot = snapshots_[next];
+    snapshot.members.fill(nullptr);
+    std::copy(members_.begin(), members_.end(), snapshot.members.begin());
+    snapshot.count = members_.size();
+    published_.store(next);
+
+    // Wait out callbacks and a worker tick still on the previous list
+    while (readers_[current].load() != 0) {
+        std::this_thread::yield();
+    }
+}
+
+// Capture callback (runs in audio thread - must be RT-safe!)
+void VoiceHub::on_audio_captured(const float* pcm, size_t frames, uint64_t capture_time_us) {
+    int slot = 0;
+    const Snapshot& snapshot = acquire(slot);
+    for (size_t i = 0; i < snapshot.count; ++i) {
+        snapshot.members[i]->hub_capture(pcm, frames, capture_time_us);
+    }
+    release(slot);
+}
+
+// Playback callback (runs in audio thread - must be RT-safe!)
+void VoiceHub::on_audio_playback_needed(float* pcm, size_t frames, uint64_t playout_time_us) {
+    std::fill(pcm, pcm + frames, 0.0f);
+
+    int slot = 0;
+    const Snapshot& snapshot = acquire(slot);
+    if (device_paced_.load(std::memory_order_relaxed)) {
+        for (size_t i = 0; i < snapshot.count; ++i) {
+            snapshot.members[i]->hub_tick();
+        }
+    }
+    if (frames > mix_buffer_.size()) {
+        // The engine hands out codec frames; anything longer plays as silence
+        if (snapshot.count > 0) {
+            dropped_frames_.fetch_add(1, std::memory_order_relaxed);
+            dropped_frames_metric_.add(1);
+        }
+        release(slot);
+        return;
+    }
+
+    // Every session mixes its own channels; the servers are summed here
+    float* mixed = mix_buffer_.data();
+    for (size_t m = 0; m < snapshot.count; ++m) {
+        snapshot.members[m]->hub_playback(mixed, frames, playout_time_us);
+        for (size_t i = 0; i < frames; ++i) {
+            pcm[i] += mixed[i];
+        }
+    }
+    if (snapshot.count > 1) {
+        for (size_t i = 0; i < frames; ++i) {
+            pcm[i] = std::clamp(pcm[i], -1.0f, 1.0f);
+        }
+    }
+    release(slot);
+}
+
+// Shared voice worker: one frame period of work for every session.
+// Holding the snapshot for the whole tick is what lets detach() wait it out.
+void VoiceHub::worker_tick() {
+    int slot = 0;
+    const Snapshot& snapshot = acquire(slot);
+    for (size_t i = 0; i < snapshot.count; ++i) {
+        snapshot.members[i]->hub_tick();
+    }
+    release(slot);
+}
+
+} // namespace voip::session
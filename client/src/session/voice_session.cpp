@@ -1,36 +1,97 @@
 #include "session/voice_session.h"
+#include "session/voice_hub.h"
+#include "common/logger.h"
+#include "common/trace.h"
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <cstring>
-#include <iostream>
 #include <thread>
 
 namespace voip::session {
 
-VoiceSession::VoiceSession() = default;
+VoiceSession::VoiceSession()
+    : encode_time_metric_(MetricsRegistry::global().histogram(
+          "voip_encode_time_us", "Opus encode duration per frame"))
+    , decode_time_metric_(MetricsRegistry::global().histogram(
+          "voip_decode_time_us", "Opus decode duration per frame"))
+    , mouth_to_ear_metric_(MetricsRegistry::global().histogram(
+          "voip_mouth_to_ear_us", "Own voice echoed back: capture ADC to playback DAC"))
+    , plc_frames_metric_(MetricsRegistry::global().counter(
+          "voip_plc_frames_total", "Lost frames concealed at playout"))
+    , codec_errors_metric_(MetricsRegistry::global().counter(
+          "voip_codec_errors_total", "Failed Opus encodes and decodes"))
+    , udp_rtt_metric_(MetricsRegistry::global().histogram(
+          "voip_udp_rtt_us", "Voice-plane keepalive round trip"))
+{
+}
 
 VoiceSession::~VoiceSession() {
     shutdown();
 }
 
 Result<void> VoiceSession::initialize(const Config& config) {
-    config_ = config;
+    return initialize(config, nullptr);
+}
+
+Result<void> VoiceSession::initialize(const Config& config, std::unique_ptr<audio::AudioBackend> audio_backend) {
+    hub_ = nullptr;
+    return initialize_session(config, std::move(audio_backend));
+}
+
+Result<void> VoiceSession::initialize(const Config& config, VoiceHub& hub) {
+    if (!hub.get_audio_engine()) {
+        return Err<void>(ErrorCode::AudioInitFailed, "Voice hub not initialized");
+    }
+    if (config.sample_rate != hub.config().sample_rate || config.frame_size != hub.config().frame_size) {
+        return Err<void>(ErrorCode::AudioInitFailed,
+                        "Session format " + std::to_string(config.sample_rate) + " Hz/" +
+                        std::to_string(config.frame_size) + " doesn't match the voice hub's " +
+                        std::to_string(hub.config().sample_rate) + " Hz/" +
+                        std::to_string(hub.config().frame_size));
+    }
+    hub_ = &hub;
+    return initialize_session(config, nullptr);
+}
+
+Result<void> VoiceSession::initialize_session(const Config& config, std::unique_ptr<audio::AudioBackend> audio_backend) {
+    if (!is_valid_opus_frame_size(config.sample_rate, config.frame_size)) {
+        return Err<void>(ErrorCode::AudioInitFailed,
+                        "Frame size " + std::to_string(config.frame_size) +
+                        " is not a valid Opus frame duration (2.5-60ms)");
+    }
     
-    // Initialize audio engine
-    audio_engine_ = std::make_unique<audio::AudioEngine>();
-    AudioConfig audio_config;
-    audio_config.sample_rate = config.sample_rate;
-    audio_config.frame_size = config.frame_size;
+    config_ = config;
     
-    auto audio_result = audio_engine_->initialize(audio_config);
-    if (!audio_result.is_ok()) {
-        return Err<void>(audio_result.error().code(), 
-                        "Failed to initialize audio: " + audio_result.error().message());
+    // Encoder state is this session's: one gauge series per server
+    const std::string server_label = "server=\"" + config.server_address + ":" +
+                                     std::to_string(config.server_port) + "\"";
+    auto& metrics = MetricsRegistry::global();
+    bitrate_metric_ = &metrics.gauge("voip_encoder_bitrate_bps", "Encoder target bitrate", server_label);
+    complexity_metric_ = &metrics.gauge("voip_encoder_complexity", "Encoder complexity in use", server_label);
+    frames_per_packet_metric_ = &metrics.gauge("voip_frames_per_packet", "Opus frames sent per voice datagram",
+                                               server_label);
+    
+    // Initialize audio engine (a hub has its own, already running)
+    if (!hub_) {
+        audio_engine_ = audio_backend ? std::make_unique<audio::AudioEngine>(std::move(audio_backend))
+                                      : std::make_unique<audio::AudioEngine>();
+        AudioConfig audio_config;
+        audio_config.sample_rate = config.sample_rate;
+        audio_config.frame_size = config.frame_size;
+        
+        auto audio_result = audio_engine_->initialize(audio_config);
+        if (!audio_result.is_ok()) {
+            return Err<void>(audio_result.error().code(), 
+                            "Failed to initialize audio: " + audio_result.error().message());
+        }
     }
     
     // Create Opus encoder
     OpusConfig opus_config;
     opus_config.sample_rate = config.sample_rate;
     opus_config.bitrate = config.bitrate;
+    opus_config.complexity = config.complexity;
     opus_config.enable_fec = config.enable_fec;
     opus_config.enable_dtx = config.enable_dtx;
     
@@ -40,21 +101,97 @@ Result<void> VoiceSession::initialize(const Config& config) {
                         "Failed to create encoder: " + encoder_result.error().message());
     }
     encoder_ = std::move(encoder_result.value());
+    encoder_complexity_ = config.complexity;
+    complexity_metric_->set(config.complexity);
+    bitrate_metric_->set(config.bitrate);
+    
+    // Multi-frame packets: as many frames as one Opus packet holds
+    auto packer_result = audio::OpusRepacketizer::create();
+    if (!packer_result.is_ok()) {
+        return Err<void>(packer_result.error().code(),
+                        "Failed to create repacketizer: " + packer_result.error().message());
+    }
+    packer_ = std::move(packer_result.value());
+    max_frames_per_packet_ = std::max<uint32_t>(
+        1, MAX_OPUS_PACKET_DURATION_US / frame_duration_us(config.sample_rate, config.frame_size));
+    
+    if (config.adaptive_complexity) {
+        audio::CpuBudgetMonitor::Config cpu_config;
+        cpu_config.frame_duration_us = frame_duration_us(config.sample_rate, config.frame_size);
+        cpu_config.budget_fraction = config.encode_budget_fraction;
+        cpu_config.max_complexity = config.complexity;
+        cpu_config.window_frames = std::max<uint32_t>(1, 1000000 / cpu_config.frame_duration_us);  // ~1s
+        cpu_monitor_ = std::make_unique<audio::CpuBudgetMonitor>(cpu_config);
+    }
+    complexity_cap_ = config.complexity;
     
-    // Create Opus decoder
-    auto decoder_result = audio::OpusDecoder::create(config.sample_rate, 1);
-    if (!decoder_result.is_ok()) {
-        return Err<void>(decoder_result.error().code(),
-                        "Failed to create decoder: " + decoder_result.error().message());
+    if (config.enable_vad) {
+        audio::VoiceActivityDetector::Config vad_config;
+        vad_config.sample_rate = config.sample_rate;
+        vad_config.hangover_ms = config.vad_hangover_ms;
+        
+        auto vad_result = audio::VoiceActivityDetector::create(vad_config, config.frame_size);
+        if (!vad_result.is_ok()) {
+            return Err<void>(vad_result.error().code(),
+                            "Failed to create voice activity detector: " + vad_result.error().message());
+        }
+        vad_ = std::move(vad_result.value());
+    }
+    
+    if (config.latency_probe) {
+        audio::LatencyProbe::Config probe_config;
+        probe_config.sample_rate = config.sample_rate;
+        latency_probe_ = std::make_unique<audio::LatencyProbe>(probe_config);
+    }
+    
+    if (config.adaptive_quality) {
+        QualityController::Config quality_config;
+        quality_config.min_bitrate = config.min_bitrate;
+        quality_config.max_bitrate = config.bitrate;
+        quality_config.complexity = config.complexity;
+        quality_config.max_frames_per_packet = config.max_frames_per_packet;
+        quality_controller_ = std::make_unique<QualityController>(quality_config);
+        apply_quality_decision(quality_controller_->decision());
+    } else {
+        apply_quality_decision(QualityDecision{
+            .bitrate = config.bitrate,
+            .complexity = config.complexity,
+            .enable_fec = config.enable_fec,
+            .packet_loss_perc = static_cast<int>(opus_config.expected_packet_loss),
+            .frames_per_packet = config.frames_per_packet
+        });
+    }
+    
+    // Receive state per remote speaker (decoders are created per stream)
+    SpeakerStreams::Config streams_config;
+    streams_config.sample_rate = config.sample_rate;
+    streams_config.frame_size = config.frame_size;
+    streams_config.jitter_buffer_frames = config.jitter_buffer_frames;
+    streams_config.idle_timeout_us = static_cast<uint64_t>(config.speaker_idle_timeout_ms) * 1000;
+    streams_config.max_streams = config.max_speaker_streams;
+    speaker_streams_ = std::make_unique<SpeakerStreams>(streams_config);
+    
+    // Any sender may aggregate, so splitting is always on
+    auto unpacker_result = audio::OpusRepacketizer::create();
+    if (!unpacker_result.is_ok()) {
+        return Err<void>(unpacker_result.error().code(),
+                        "Failed to create repacketizer: " + unpacker_result.error().message());
     }
-    decoder_ = std::move(decoder_result.value());
+    unpacker_ = std::move(unpacker_result.value());
     
     // Create jitter buffer
     jitter_buffer_ = std::make_unique<audio::JitterBuffer>(
         config.jitter_buffer_frames,
-        config.frame_size
+        config.frame_size,
+        config.sample_rate
     );
     
+    // FIFOs between the device/network threads and the voice worker
+    // (AudioBufferQueue holds capacity - 1 frames)
+    capture_fifo_ = std::make_unique<AudioBufferQueue>(8 + 1, config.frame_size);
+    playback_fifo_ = std::make_unique<AudioBufferQueue>(config.playback_queue_frames + 1, config.frame_size);
+    receive_fifo_ = std::make_unique<LockFreeQueue<ReceivedPacket>>(256);
+    
     // Create network socket
     network_ = std::make_unique<network::UdpVoiceSocket>();
     
@@ -63,7 +200,28 @@ Result<void> VoiceSession::initialize(const Config& config) {
         this->on_packet_received(packet);
     });
     
+    // Keepalive probes keep the NAT binding open through silences and
+    // measure RTT and path loss for the quality controller
+    link_monitor_.reset();
+    if (config.keepalive_interval_ms > 0) {
+        network::LinkMonitor::Config link_config;
+        link_config.interval_ms = config.keepalive_interval_ms;
+        link_config.timeout_ms = std::max<uint32_t>(2000, config.keepalive_interval_ms * 2);
+        link_monitor_ = std::make_unique<network::LinkMonitor>(link_config);
+        network_->set_keepalive_callback([this](const network::KeepalivePacket& echo) {
+            this->on_keepalive_echo(echo);
+        });
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(voice_aliases_mutex_);
+        if (voice_aliases_) {
+            network_->set_voice_aliases(*voice_aliases_);
+        }
+    }
+    
     // Connect to server
+    network_->set_socket_options(config.socket_options);
     auto connect_result = network_->connect(config.server_address, config.server_port);
     if (!connect_result.is_ok()) {
         return Err<void>(connect_result.error().code(),
@@ -74,40 +232,38 @@ Result<void> VoiceSession::initialize(const Config& config) {
     capture_buffer_.resize(config.frame_size * config.channels);
     playback_buffer_.resize(config.frame_size * config.channels);
     encode_buffer_.resize(4000);  // Max Opus frame size
+    max_decode_frame_size_ = audio::OpusDecoder::max_frame_size(config.sample_rate);
     
-    std::cout << "VoiceSession initialized:\n";
-    std::cout << "  Server: " << config.server_address << ":" << config.server_port << "\n";
-    std::cout << "  Sample rate: " << config.sample_rate << " Hz\n";
-    std::cout << "  Frame size: " << config.frame_size << " samples\n";
-    std::cout << "  Bitrate: " << config.bitrate << " bps\n";
-    std::cout << "  Channel ID: " << config.channel_id << "\n";
-    std::cout << "  User ID: " << config.user_id << "\n";
+    VOIP_LOG_INFO("VoiceSession initialized: server " << config.server_address << ":" << config.server_port
+                  << ", " << config.sample_rate << " Hz, frame " << config.frame_size << " samples ("
+                  << frame_duration_us(config.sample_rate, config.frame_size) / 1000.0 << "ms), "
+                  << config.bitrate << " bps" << (config.adaptive_quality ? " adaptive" : "")
+                  << ", channel " << config.channel_id << ", user " << config.user_id);
     
     return Ok();
 }
 
 void VoiceSession::shutdown() {
-    std::cout << "🔧 Shutting down voice session..." << std::endl;
+    VOIP_LOG_INFO("🔧 Shutting down voice session...");
     
     // Stop session if still active
     stop();
     
     // Disconnect network (this will close UDP socket)
     if (network_) {
-        std::cout << "  📡 Disconnecting network..." << std::endl;
+        VOIP_LOG_DEBUG("  📡 Disconnecting network...");
         network_->disconnect();
     }
     
     // Shutdown audio engine
     if (audio_engine_) {
-        std::cout << "  🔊 Shutting down audio engine..." << std::endl;
+        VOIP_LOG_DEBUG("  🔊 Shutting down audio engine...");
         audio_engine_->shutdown();
     }
     
     // Clean up multi-channel buffers
     {
         std::lock_guard<std::mutex> lock(channels_mutex_);
-        channel_buffers_.clear();
         listening_channels_.clear();
         channel_muted_.clear();
     }
@@ -119,12 +275,16 @@ void VoiceSession::shutdown() {
     
     // Clean up components
     network_.reset();
+    quality_controller_.reset();
+    cpu_monitor_.reset();
+    latency_probe_.reset();
+    vad_.reset();
     jitter_buffer_.reset();
-    decoder_.reset();
+    speaker_streams_.reset();
     encoder_.reset();
     audio_engine_.reset();
     
-    std::cout << "✅ Voice session shutdown complete\n";
+    VOIP_LOG_INFO("✅ Voice session shutdown complete");
 }
 
 Result<void> VoiceSession::start() {
@@ -132,16 +292,49 @@ Result<void> VoiceSession::start() {
         return Err<void>(ErrorCode::AudioStreamFailed, "Session already active");
     }
     
+    // Latency figures describe this run only
+    mouth_to_ear_.reset();
+    playout_delay_.reset();
+    probe_latency_.reset();
+    latency_publish_us_ = 0;
+    
+    // Nothing left over from a previous run; no callbacks or worker are running
+    uint64_t stale_time_us = 0;
+    while (capture_fifo_->try_pop(capture_buffer_.data(), config_.frame_size, &stale_time_us)) {}
+    while (playback_fifo_->try_pop(playback_buffer_.data(), config_.frame_size)) {}
+    frames_mixed_ = 0;
+    frames_popped_ = 0;
+    playout_origin_us_ = NO_PLAYOUT_ORIGIN;
+    
+    // On a hub the shared devices and worker call into us from now on
+    if (hub_) {
+        active_ = true;
+        auto attach_result = hub_->attach(this);
+        if (!attach_result.is_ok()) {
+            active_ = false;
+            return attach_result;
+        }
+        VOIP_LOG_INFO("🎤 Voice session started on shared audio (" << config_.server_address << ")");
+        return Ok();
+    }
+    
     // Set up audio callbacks
     audio_engine_->set_capture_callback(
-        [this](const float* pcm, size_t frames) {
-            this->on_audio_captured(pcm, frames);
+        [this](const float* pcm, size_t frames, uint64_t capture_time_us) {
+            this->on_audio_captured(pcm, frames, capture_time_us);
         }
     );
     
+    // A device off the wall clock (virtual, scaled or manual) paces the
+    // worker itself: one tick per codec frame, just before it is played.
+    // A wall-clock timer would starve or overflow the playback FIFO there.
+    const bool device_paced = !audio_engine_->backend()->wall_clock();
     audio_engine_->set_playback_callback(
-        [this](float* pcm, size_t frames) {
-            this->on_audio_playback_needed(pcm, frames);
+        [this, device_paced](float* pcm, size_t frames, uint64_t playout_time_us) {
+            if (device_paced) {
+                this->worker_tick();
+            }
+            this->on_audio_playback_needed(pcm, frames, playout_time_us);
         }
     );
     
@@ -161,7 +354,24 @@ Result<void> VoiceSession::start() {
     }
     
     active_ = true;
-    std::cout << "\n🎤 Voice session started - speak into your microphone!\n\n";
+    if (device_paced) {
+        VOIP_LOG_INFO("🎤 Voice session started on a virtual clock (worker runs on device ticks)");
+        return Ok();
+    }
+    
+    RtThread::Config worker_config;
+    worker_config.period_us = frame_duration_us(config_.sample_rate, config_.frame_size);
+    worker_config.realtime = config_.worker_realtime;
+    worker_config.cpu = config_.worker_cpu;
+    auto worker_result = worker_.start(worker_config, [this] { worker_tick(); });
+    if (!worker_result.is_ok()) {
+        active_ = false;
+        auto _ = audio_engine_->stop_capture();
+        auto __ = audio_engine_->stop_playback();
+        return worker_result;
+    }
+    
+    VOIP_LOG_INFO("🎤 Voice session started - speak into your microphone!");
     
     return Ok();
 }
@@ -171,27 +381,44 @@ void VoiceSession::stop() {
         return;
     }
     
-    std::cout << "🛑 Stopping voice session..." << std::endl;
+    VOIP_LOG_INFO("🛑 Stopping voice session...");
     
     // Mark as inactive immediately to stop new packets
     active_ = false;
     
+    if (hub_) {
+        // Returns once the shared callbacks and worker are out of this session
+        hub_->detach(this);
+        flush_aggregate();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        VOIP_LOG_INFO("✅ Voice session stopped");
+        return;
+    }
+    
     // Stop audio capture first (no more outgoing audio)
     if (audio_engine_) {
-        std::cout << "  ⏹️ Stopping audio capture..." << std::endl;
+        VOIP_LOG_DEBUG("  ⏹️ Stopping audio capture...");
         auto _ = audio_engine_->stop_capture();
     }
     
+    // Stop the voice worker (it finishes the tick in progress). Ticks run
+    // from a device-paced playback callback see active_ cleared and return
+    // at once; closing the capture stream waited out the one in progress.
+    worker_.stop();
+    
+    // Frames held for a multi-frame packet are the tail of what was said
+    flush_aggregate();
+    
     // Give pending packets time to be sent (100ms)
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
     
     // Stop audio playback
     if (audio_engine_) {
-        std::cout << "  ⏹️ Stopping audio playback..." << std::endl;
+        VOIP_LOG_DEBUG("  ⏹️ Stopping audio playback...");
         auto _ = audio_engine_->stop_playback();
     }
     
-    std::cout << "✅ Voice session stopped\n";
+    VOIP_LOG_INFO("✅ Voice session stopped");
 }
 
 bool VoiceSession::is_active() const noexcept {
@@ -199,17 +426,19 @@ bool VoiceSession::is_active() const noexcept {
 }
 
 float VoiceSession::get_input_level() const noexcept {
-    if (!audio_engine_ || !active_) {
+    const audio::AudioEngine* audio = engine();
+    if (!audio || !active_) {
         return 0.0f;
     }
-    return audio_engine_->get_input_level();
+    return audio->get_input_level();
 }
 
 float VoiceSession::get_output_level() const noexcept {
-    if (!audio_engine_ || !active_) {
+    const audio::AudioEngine* audio = engine();
+    if (!audio || !active_) {
         return 0.0f;
     }
-    return audio_engine_->get_output_level();
+    return audio->get_output_level();
 }
 
 void VoiceSession::set_muted(bool muted) noexcept {
@@ -222,12 +451,12 @@ void VoiceSession::set_deafened(bool deafened) noexcept {
 
 void VoiceSession::set_user_id(UserId user_id) noexcept {
     config_.user_id = user_id;
-    std::cout << "🆔 VoiceSession user ID updated to: " << user_id << std::endl;
+    VOIP_LOG_INFO("🆔 VoiceSession user ID updated to: " << user_id);
 }
 
 void VoiceSession::send_presence_packet(ChannelId channel_id) {
     if (!network_ || !active_) {
-        std::cout << "⚠️ Cannot send presence packet - network not ready or session inactive" << std::endl;
+        VOIP_LOG_WARN("⚠️ Cannot send presence packet - network not ready or session inactive");
         return;
     }
     
@@ -246,17 +475,23 @@ void VoiceSession::send_presence_packet(ChannelId channel_id) {
     // Minimal payload (1 byte of silence)
     packet.encrypted_payload.resize(1, 0);
     
-    std::cout << "📍 Sending UDP presence packet for channel " << channel_id 
-              << " (user " << config_.user_id << ") to register address with server" << std::endl;
+    VOIP_LOG_DEBUG("📍 Sending UDP presence packet for channel " << channel_id
+                   << " (user " << config_.user_id << ") to register address with server");
     
-    auto send_result = network_->send_packet(packet);
+    // Control priority: may be called from the UI thread at any time and
+    // must never queue ahead of voice
+    auto send_result = network_->send_packet(packet, network::SendPriority::Control);
     if (!send_result.is_ok()) {
-        std::cout << "⚠️ Failed to send presence packet: " << send_result.error().message() << std::endl;
+        VOIP_LOG_WARN("⚠️ Failed to send presence packet: " << send_result.error().message());
     } else {
-        std::cout << "✅ Presence packet sent - UDP address should now be registered" << std::endl;
+        VOIP_LOG_INFO("✅ Presence packet sent for channel " << channel_id);
     }
 }
 
+bool VoiceSession::is_speaking() const noexcept {
+    return active_ && speaking_;
+}
+
 bool VoiceSession::is_muted() const noexcept {
     return is_muted_;
 }
@@ -266,13 +501,28 @@ bool VoiceSession::is_deafened() const noexcept {
 }
 
 audio::AudioEngine* VoiceSession::get_audio_engine() noexcept {
-    return audio_engine_.get();
+    return engine();
+}
+
+audio::AudioEngine* VoiceSession::engine() const noexcept {
+    return hub_ ? hub_->get_audio_engine() : audio_engine_.get();
 }
 
 void VoiceSession::set_srtp_session(std::unique_ptr<crypto::SrtpSession> srtp_session) {
     std::lock_guard<std::mutex> lock(srtp_mutex_);
     srtp_session_ = std::move(srtp_session);
-    std::cout << "🔒 SRTP session installed - voice encryption enabled" << std::endl;
+    next_srtp_index_ = 1;  // New key, new replay window at the server
+    VOIP_LOG_INFO("🔒 SRTP session installed - voice encryption enabled");
+}
+
+void VoiceSession::set_voice_aliases(const network::VoiceAliases& aliases) {
+    std::lock_guard<std::mutex> lock(voice_aliases_mutex_);
+    voice_aliases_ = aliases;
+    if (network_) {
+        network_->set_voice_aliases(aliases);
+    }
+    VOIP_LOG_INFO("🗜️ Compact voice header enabled (" << aliases.users.size() << " user, "
+                  << aliases.channels.size() << " channel aliases)");
 }
 
 VoiceSession::Stats VoiceSession::get_stats() const {
@@ -280,37 +530,157 @@ VoiceSession::Stats VoiceSession::get_stats() const {
     
     stats.frames_captured = frames_captured_.load();
     stats.frames_played = frames_played_.load();
+    stats.frame_duration_ms = frame_duration_us(config_.sample_rate, config_.frame_size) / 1000.0f;
     stats.frames_encoded = frames_encoded_.load();
     stats.encode_errors = encode_errors_.load();
+    stats.vad_gated_frames = vad_gated_frames_.load();
+    stats.comfort_noise_frames = comfort_noise_frames_.load();
+    stats.speaking = is_speaking();
     stats.frames_decoded = frames_decoded_.load();
     stats.decode_errors = decode_errors_.load();
     stats.plc_frames = plc_frames_.load();
     stats.jitter_buffer_underruns = jitter_underruns_.load();
+    stats.target_bitrate = target_bitrate_.load();
+    stats.encoder_complexity = encoder_complexity_.load();
+    stats.fec_enabled = fec_enabled_.load();
+    stats.expected_loss_perc = expected_loss_perc_.load();
+    stats.frames_per_packet = frames_per_packet_.load();
+    stats.measured_loss_percent = measured_loss_percent_.load();
+    stats.quality_adjustments = quality_adjustments_.load();
+    stats.encode_time_p50_us = encode_time_p50_us_.load();
+    stats.encode_time_p95_us = encode_time_p95_us_.load();
+    stats.encode_time_p99_us = encode_time_p99_us_.load();
+    stats.complexity_cap = complexity_cap_.load();
+    
+    const auto worker_stats = hub_ ? hub_->worker_stats() : worker_.get_stats();
+    stats.worker_realtime = worker_stats.realtime;
+    stats.worker_missed_ticks = worker_stats.missed_ticks;
+    stats.worker_lateness_p50_us = worker_stats.lateness_p50_us;
+    stats.worker_lateness_p99_us = worker_stats.lateness_p99_us;
+    stats.worker_lateness_max_us = worker_stats.lateness_max_us;
+    stats.worker_queue_drops = worker_queue_drops_.load();
+    stats.playback_underruns = playback_underruns_.load();
+    
+    {
+        std::lock_guard<std::mutex> lock(link_mutex_);
+        if (link_monitor_) {
+            const auto& link = link_monitor_->stats();
+            stats.rtt_ms = link.rtt_ms;
+            stats.rtt_min_ms = link.min_rtt_ms;
+            stats.rtt_var_ms = link.rtt_var_ms;
+            stats.path_loss_percent = link.loss_fraction * 100.0f;
+            stats.keepalives_sent = link.probes_sent;
+            stats.keepalives_lost = link.probes_lost;
+        }
+    }
     
     if (network_) {
         auto net_stats = network_->get_stats();
         stats.packets_sent = net_stats.packets_sent;
         stats.packets_received = net_stats.packets_received;
         stats.network_errors = net_stats.send_errors + net_stats.receive_errors;
+        stats.socket_options = net_stats.effective_options;
+        stats.send_queue = net_stats.send_queue;
     }
     
     if (jitter_buffer_) {
         auto jb_stats = jitter_buffer_->get_stats();
         stats.jitter_ms = jb_stats.jitter_ms;
     }
+    if (speaker_streams_) {
+        // Multi-channel voice lands in per-speaker streams
+        const auto streams = speaker_streams_->stats();
+        stats.jitter_ms = std::max(stats.jitter_ms, streams.jitter_ms);
+        stats.speaker_streams = streams.active;
+        stats.speaker_stream_resets = streams.epoch_resets;
+        stats.speaker_streams_reclaimed = streams.reclaimed + streams.evicted;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(latency_mutex_);
+        stats.mouth_to_ear = published_mouth_to_ear_;
+        stats.playout_delay = published_playout_delay_;
+        stats.probe = published_probe_;
+    }
+    if (latency_probe_) {
+        stats.probe_markers_sent = latency_probe_->markers_sent();
+        stats.probe_markers_detected = latency_probe_->markers_detected();
+    }
     
-    // Estimate latency: encoding + network + jitter buffer + decoding
-    // Very rough estimate: 20ms capture + jitter buffer + 20ms playback
-    stats.estimated_latency_ms = 40.0f + (stats.jitter_ms * 2.0f);
+    // Prefer measured end-to-end figures; fall back to device latencies plus
+    // buffering when nothing has been played back yet
+    float device_latency_ms = stats.frame_duration_ms * 2.0f;
+    float input_latency_ms = stats.frame_duration_ms;
+    if (const audio::AudioEngine* audio = engine()) {
+        const auto audio_stats = audio->get_stats();
+        device_latency_ms = audio_stats.estimated_latency_ms;
+        input_latency_ms = audio_stats.input_latency_us / 1000.0f + stats.frame_duration_ms;
+    }
+    
+    if (stats.mouth_to_ear.samples > 0) {
+        stats.estimated_latency_ms = stats.mouth_to_ear.p50_ms;
+    } else if (stats.probe.samples > 0) {
+        stats.estimated_latency_ms = stats.probe.p50_ms;
+    } else if (stats.playout_delay.samples > 0) {
+        stats.estimated_latency_ms = stats.playout_delay.p50_ms + input_latency_ms;
+    } else {
+        stats.estimated_latency_ms = device_latency_ms + (stats.jitter_ms * 2.0f);
+    }
     
     return stats;
 }
 
+void VoiceSession::hub_capture(const float* pcm, size_t frames, uint64_t capture_time_us) {
+    on_audio_captured(pcm, frames, capture_time_us);
+}
+
+void VoiceSession::hub_playback(float* pcm, size_t frames, uint64_t playout_time_us) {
+    on_audio_playback_needed(pcm, frames, playout_time_us);
+}
+
+void VoiceSession::hub_tick() {
+    worker_tick();
+}
+
 // Audio capture callback (runs in audio thread - must be RT-safe!)
-void VoiceSession::on_audio_captured(const float* pcm, size_t frames) {
-    static int capture_count = 0;
-    if (capture_count++ % 100 == 0) {  // Print every 100 frames (every 2 seconds)
-        std::cout << "🎤 Capturing audio: frame " << capture_count << std::endl;
+void VoiceSession::on_audio_captured(const float* pcm, size_t frames, uint64_t capture_time_us) {
+    if (!active_ || frames != config_.frame_size) {
+        return;
+    }
+    if (!capture_fifo_->try_push(pcm, frames, capture_time_us)) {
+        worker_queue_drops_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Voice worker: one frame period of network, playback and capture work
+void VoiceSession::worker_tick() {
+    if (!active_) {
+        return;
+    }
+    
+    service_keepalive();
+    
+    // Decode what arrived first so it can be mixed this tick
+    ReceivedPacket received;
+    while (receive_fifo_->try_pop(received)) {
+        process_packet(received.packet, received.arrival_us);
+    }
+    
+    // Keep the playback FIFO topped up (it self-corrects for drift
+    // between our timer and the device clock)
+    while (playback_fifo_->size() < config_.playback_queue_frames) {
+        render_playback_frame();
+    }
+    
+    uint64_t capture_time_us = 0;
+    while (capture_fifo_->try_pop(capture_buffer_.data(), config_.frame_size, &capture_time_us)) {
+        process_capture(capture_buffer_.data(), config_.frame_size, capture_time_us);
+    }
+}
+
+void VoiceSession::process_capture(const float* pcm, size_t frames, uint64_t capture_time_us) {
+    if (capture_log_count_++ % 100 == 0) {  // Every 100 frames (every 2 seconds)
+        VOIP_LOG_DEBUG("🎤 Capturing audio: frame " << capture_log_count_);
     }
     
     if (!active_ || frames != config_.frame_size) {
@@ -319,26 +689,34 @@ void VoiceSession::on_audio_captured(const float* pcm, size_t frames) {
     
     // Don't transmit if muted
     if (is_muted_) {
-        static int mute_warn_count = 0;
-        if (mute_warn_count++ % 100 == 0) {  // Warn every 2 seconds
-            std::cout << "⚠️ Audio muted - not transmitting (frame " << capture_count << ")" << std::endl;
+        flush_aggregate();
+        speaking_ = false;
+        if (mute_log_count_++ % 100 == 0) {  // Every 2 seconds
+            VOIP_LOG_DEBUG("⚠️ Audio muted - not transmitting (frame " << capture_log_count_ << ")");
         }
         return;
     }
     
     frames_captured_++;
     
-    // Encode with Opus
-    auto encode_result = encoder_->encode(pcm, frames);
-    if (!encode_result.is_ok()) {
-        encode_errors_++;
-        return;
+    update_quality();
+    
+    // Loopback test mode: the marker signal replaces the microphone
+    if (latency_probe_) {
+        latency_probe_->inject(capture_buffer_.data(), frames, capture_time_us);
+        pcm = capture_buffer_.data();
     }
     
-    frames_encoded_++;
-    auto& encoded = encode_result.value();
+    // Voice activity runs on every captured frame so its noise floor keeps up
+    // (the probe's silence between markers must still be sent)
+    bool voice = true;
+    {
+        VOIP_TRACE_SCOPE("vad");
+        voice = (!vad_ || vad_->process(pcm, frames)) || latency_probe_ != nullptr;
+    }
     
     // Determine which channels to transmit to
+    TraceScope targets_trace("targets");
     // Hot mic channel (if set)
     ChannelId hot_mic = hot_mic_channel_.load();
     
@@ -360,89 +738,186 @@ void VoiceSession::on_audio_captured(const float* pcm, size_t frames) {
     }
     
     // Debug logging - track when targets change
-    static std::set<ChannelId> last_targets;
-    static int tx_count = 0;
-    bool targets_changed = (target_channels != last_targets);
+    bool targets_changed = (target_channels != last_targets_);
     
     // Log immediately when targets change, or every 50 frames (~1 second)
-    if (targets_changed || (tx_count++ % 50 == 0)) {
-        std::cout << "📡 Transmit targets: ";
+    if (targets_changed || (targets_log_count_++ % 50 == 0)) {
         if (target_channels.empty()) {
-            std::cout << "(none - will drop audio)";
+            VOIP_LOG_DEBUG("📡 Transmit targets: (none - will drop audio)");
         } else {
-            std::cout << "Channels: ";
-            for (auto ch : target_channels) {
-                std::cout << ch << " ";
-            }
-            std::cout << "| Hot mic: " << (hot_mic != 0 ? std::to_string(hot_mic) : "off");
-            std::cout << " | PTT: ";
-            if (ptt_targets.empty()) {
-                std::cout << "none";
-            } else {
-                for (auto ch : ptt_targets) {
-                    std::cout << ch << " ";
-                }
-            }
+            VOIP_LOG_DEBUG("📡 Transmit targets: Channels: " << log_join(target_channels)
+                           << " | Hot mic: " << hot_mic
+                           << " | PTT: " << (ptt_targets.empty() ? "none" : "") << log_join(ptt_targets));
         }
-        std::cout << std::endl;
-        last_targets = target_channels;
+        last_targets_ = target_channels;
     }
+    targets_trace.end();
     
     // If no targets, don't transmit
     if (target_channels.empty()) {
+        flush_aggregate();
+        speaking_ = false;
+        return;
+    }
+    
+    // Voice activity gate (hot mic only - holding PTT is an explicit decision to talk)
+    constexpr uint64_t COMFORT_NOISE_INTERVAL_US = 400000;
+    bool comfort_noise = false;
+    
+    if (voice || !ptt_targets.empty()) {
+        // First silent frame after speech sends comfort noise straight away
+        silence_us_ = COMFORT_NOISE_INTERVAL_US;
+    } else {
+        if (silence_us_ < COMFORT_NOISE_INTERVAL_US) {
+            silence_us_ += frame_duration_us(config_.sample_rate, config_.frame_size);
+            vad_gated_frames_++;
+            flush_aggregate();
+            speaking_ = false;
+            return;
+        }
+        silence_us_ = 0;
+        comfort_noise = true;
+    }
+    
+    // Encode with Opus (timed against the CPU budget)
+    TraceScope encode_trace("encode");
+    const auto encode_start = std::chrono::steady_clock::now();
+    auto encode_result = encoder_->encode(pcm, frames);
+    const auto encode_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - encode_start
+    ).count();
+    encode_trace.end();
+    encode_time_metric_.record(static_cast<uint64_t>(encode_us));
+    
+    if (cpu_monitor_) {
+        if (cpu_monitor_->record(static_cast<uint32_t>(encode_us))) {
+            complexity_cap_ = cpu_monitor_->complexity_cap();
+            apply_complexity();
+            VOIP_LOG_INFO("⏱️ Encoder complexity cap now " << cpu_monitor_->complexity_cap()
+                          << " (p95 encode " << cpu_monitor_->percentiles().p95_us << "us, budget "
+                          << cpu_monitor_->budget_us() << "us)");
+        }
+        const auto& percentiles = cpu_monitor_->percentiles();
+        encode_time_p50_us_.store(percentiles.p50_us, std::memory_order_relaxed);
+        encode_time_p95_us_.store(percentiles.p95_us, std::memory_order_relaxed);
+        encode_time_p99_us_.store(percentiles.p99_us, std::memory_order_relaxed);
+    }
+    
+    if (!encode_result.is_ok()) {
+        encode_errors_++;
+        codec_errors_metric_.add();
+        return;
+    }
+    
+    frames_encoded_++;
+    auto& encoded = encode_result.value();
+    
+    // Mark comfort noise (Opus DTX emits it in-band as a 1-2 byte packet)
+    if (comfort_noise) {
+        encoded.is_dtx = true;
+        comfort_noise_frames_++;
+    }
+    speaking_ = !comfort_noise;
+    
+    // Aggregation: hold frames until frames_per_packet_ are pending. A frame
+    // that can't join the pending packet (new targets, or the encoder
+    // switched bandwidth or mode) sends that packet off first.
+    const uint32_t frames_per_packet = frames_per_packet_.load(std::memory_order_relaxed);
+    if (frames_per_packet > 1) {
+        if (target_channels != aggregate_targets_) {
+            flush_aggregate();
+        }
+        if (packer_->frame_count() > 0 && !packer_->add(encoded.data.data(), encoded.data.size()).is_ok()) {
+            flush_aggregate();
+        }
+        if (packer_->frame_count() == 0) {
+            aggregate_targets_ = target_channels;
+            aggregate_capture_time_us_ = capture_time_us;
+            if (!packer_->add(encoded.data.data(), encoded.data.size()).is_ok()) {
+                send_encoded(encoded.data, 1, target_channels, capture_time_us);
+                return;
+            }
+        }
+        // Comfort noise is sparse; don't sit on it
+        if (comfort_noise || packer_->frame_count() >= frames_per_packet) {
+            flush_aggregate();
+        }
         return;
     }
     
+    flush_aggregate();  // Aggregation was just switched off
+    send_encoded(encoded.data, 1, target_channels, capture_time_us);
+}
+
+void VoiceSession::flush_aggregate() {
+    const size_t frames = packer_ ? packer_->frame_count() : 0;
+    if (frames == 0) {
+        return;
+    }
+    
+    auto packed = packer_->take();
+    if (!packed.is_ok()) {
+        encode_errors_ += frames;
+        codec_errors_metric_.add();
+        return;
+    }
+    send_encoded(packed.value(), frames, aggregate_targets_, aggregate_capture_time_us_);
+}
+
+void VoiceSession::send_encoded(const std::vector<uint8_t>& opus_data, size_t frames,
+                                const std::set<ChannelId>& targets, uint64_t capture_time_us) {
+    // One sequence number per frame, so receivers can tell lost frames
+    // from aggregated ones. Reserved once: each target channel is its own
+    // stream at the receivers and must see contiguous numbers.
+    const SequenceNumber sequence = next_sequence_.fetch_add(frames);
+    
     // Send to each target channel
-    for (auto channel_id : target_channels) {
+    for (auto channel_id : targets) {
         network::VoicePacket packet;
         packet.header.magic = VOICE_PACKET_MAGIC;
-        packet.header.sequence = next_sequence_++;
-        packet.header.timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
-            std::chrono::steady_clock::now().time_since_epoch()
-        ).count());
+        packet.header.sequence = sequence;
+        packet.header.timestamp = capture_time_us;  // When the (first) frame hit the ADC
         packet.header.channel_id = channel_id;
         packet.header.user_id = config_.user_id;
 
         // Encrypt voice data with SRTP if session is available
         {
+            VOIP_TRACE_SCOPE("encrypt");
             std::lock_guard<std::mutex> lock(srtp_mutex_);
             if (srtp_session_) {
                 // Encrypt opus-encoded voice data
-                std::vector<uint8_t> plaintext(encoded.data.begin(), encoded.data.end());
-                std::vector<uint8_t> encrypted = srtp_session_->encrypt(plaintext, packet.header.sequence);
+                std::vector<uint8_t> plaintext(opus_data.begin(), opus_data.end());
+                // The copies share a header sequence, not an SRTP index: the
+                // server checks replays per sender, across channels
+                std::vector<uint8_t> encrypted = srtp_session_->encrypt(plaintext, next_srtp_index_++);
                 if (!encrypted.empty()) {
                     packet.encrypted_payload = std::move(encrypted);
                 } else {
-                    std::cerr << "❌ SRTP encryption failed, dropping packet" << std::endl;
+                    VOIP_LOG_ERROR("❌ SRTP encryption failed, dropping packet");
                     continue;  // Skip this packet
                 }
             } else {
                 // Development mode: send unencrypted
-                packet.encrypted_payload.assign(encoded.data.begin(), encoded.data.end());
+                packet.encrypted_payload.assign(opus_data.begin(), opus_data.end());
             }
         }
 
         // Send to server (async, won't block)
+        VOIP_TRACE_SCOPE("send");
         auto send_result = network_->send_packet(packet);
         if (!send_result.is_ok()) {
-            // Track send errors
-            static int send_error_count = 0;
-            if (send_error_count++ % 10 == 0) {  // Warn every 10 errors
-                std::cout << "⚠️ UDP send failed for channel " << channel_id 
-                          << " (error count: " << send_error_count << ")" << std::endl;
-            }
+            VOIP_LOG_WARN("⚠️ UDP send failed for channel " << channel_id
+                          << ": " << send_result.error().message());
         }
     }
 }
 
 // Network receive callback (runs in network thread)
 void VoiceSession::on_packet_received(const network::VoicePacket& packet) {
-    static int recv_count = 0;
-    if (recv_count++ % 50 == 0) {  // Print every 50 packets
-        std::cout << "📥 Received packet: seq=" << packet.header.sequence 
-                  << " ch=" << packet.header.channel_id 
-                  << " user=" << packet.header.user_id << std::endl;
+    if (recv_log_count_++ % 50 == 0) {  // Every 50 packets
+        VOIP_LOG_DEBUG("📥 Received packet: seq=" << packet.header.sequence
+                       << " ch=" << packet.header.channel_id
+                       << " user=" << packet.header.user_id);
     }
     
     if (!active_) return;
@@ -465,17 +940,29 @@ void VoiceSession::on_packet_received(const network::VoicePacket& packet) {
     if (!is_listening || is_muted) {
         return;
     }
+    
+    // Kernel receive time when the socket has it, so scheduling on the
+    // receive path doesn't count as network jitter
+    const uint64_t arrival_us = packet.received_at_us != 0 ? packet.received_at_us : steady_time_us();
+    
+    if (!receive_fifo_->try_push(ReceivedPacket{packet, arrival_us})) {
+        worker_queue_drops_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void VoiceSession::process_packet(const network::VoicePacket& packet, uint64_t arrival_us) {
+    const ChannelId channel_id = packet.header.channel_id;
 
     // Decrypt voice data with SRTP if session is available
     std::vector<uint8_t> opus_data;
     {
+        VOIP_TRACE_SCOPE("decrypt");
         std::lock_guard<std::mutex> lock(srtp_mutex_);
         if (srtp_session_) {
             // Decrypt SRTP packet to get opus-encoded voice data
             opus_data = srtp_session_->decrypt(packet.encrypted_payload);
             if (opus_data.empty()) {
-                std::cerr << "❌ SRTP decryption failed, dropping packet seq="
-                          << packet.header.sequence << std::endl;
+                VOIP_LOG_WARN("⚠️ SRTP decryption failed, dropping packet seq=" << packet.header.sequence);
                 decode_errors_++;
                 return;
             }
@@ -485,68 +972,346 @@ void VoiceSession::on_packet_received(const network::VoicePacket& packet) {
         }
     }
 
-    // Decode Opus
-    std::vector<float> decoded_samples(config_.frame_size * config_.channels);
-
-    auto decode_result = decoder_->decode(
-        opus_data.data(),
-        opus_data.size(),
-        decoded_samples.data(),
-        config_.frame_size
-    );
-    
-    if (!decode_result.is_ok()) {
+    // Aggregated packets carry several frames; each gets its own jitter
+    // buffer slot, numbered on from the packet's sequence and timestamp
+    auto split_result = unpacker_->split(opus_data.data(), opus_data.size());
+    if (!split_result.is_ok()) {
         decode_errors_++;
         return;
     }
+    const auto& frames = split_result.value();
+    track_reception(packet, arrival_us, frames.size());
+    
+    // The speaker's stream (a new one on first contact or after the sender
+    // restarted its numbering), with a decoder of its own
+    SpeakerStream* stream = speaker_streams_->route(channel_id, packet.header.user_id, packet.header.sequence,
+                                                    packet.header.timestamp, frames.size(), arrival_us);
+    if (!stream) {
+        return;  // Straggler from a run already reclaimed
+    }
+    if (!stream->decoder) {
+        auto decoder_result = audio::OpusDecoder::create(config_.sample_rate, 1);
+        if (!decoder_result.is_ok()) {
+            decode_errors_++;
+            codec_errors_metric_.add();
+            return;
+        }
+        stream->decoder = std::move(decoder_result.value());
+    }
+    
+    uint64_t offset_us = 0;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        const auto& frame = frames[i];
+        
+        // Decode Opus (sender picks the frame duration; the TOC byte tells us)
+        auto frame_size_result = audio::OpusDecoder::packet_frame_size(
+            frame.data(),
+            frame.size(),
+            config_.sample_rate
+        );
+        if (!frame_size_result.is_ok() || frame_size_result.value() > max_decode_frame_size_) {
+            decode_errors_++;
+            return;
+        }
+        const uint64_t frame_offset_us = offset_us;
+        offset_us += frame_duration_us(config_.sample_rate, static_cast<uint32_t>(frame_size_result.value()));
+        
+        std::vector<float> decoded_samples(frame_size_result.value() * config_.channels);
+
+        const uint64_t decode_start_us = steady_time_us();
+        auto decode_result = stream->decoder->decode(
+            frame.data(),
+            frame.size(),
+            decoded_samples.data(),
+            frame_size_result.value()
+        );
+        const uint64_t decode_end_us = steady_time_us();
+        decode_time_metric_.record(decode_end_us - decode_start_us);
+        Tracer::record("decode", decode_start_us, decode_end_us);
+        
+        if (!decode_result.is_ok()) {
+            decode_errors_++;
+            codec_errors_metric_.add();
+            continue;
+        }
+        
+        frames_decoded_++;
+        decoded_samples.resize(decode_result.value() * config_.channels);
+        
+        // Add to the speaker's jitter buffer. Later frames of a packet
+        // count as arriving on their own schedule, so waiting in the
+        // sender's packer doesn't read as network jitter.
+        audio::AudioPacket audio_packet;
+        audio_packet.sequence = packet.header.sequence + i;
+        audio_packet.timestamp = Timestamp(packet.header.timestamp + frame_offset_us);
+        audio_packet.samples = std::move(decoded_samples);
+        audio_packet.frame_size = decode_result.value();
+        audio_packet.sender = packet.header.user_id;
+        audio_packet.arrival_us = arrival_us + frame_offset_us;
+        
+        {
+            VOIP_TRACE_SCOPE("jitter push");
+            stream->jitter_buffer->push(std::move(audio_packet));
+        }
+    }
+}
+
+void VoiceSession::track_reception(const network::VoicePacket& packet, uint64_t arrival_us, size_t frames) {
+    // Sequence gap this large means the sender restarted
+    constexpr SequenceNumber RESET_GAP = 1000;
+    
+    // Sequence numbers count frames; the packet's is its first frame's
+    const SequenceNumber seq = packet.header.sequence + std::max<size_t>(frames, 1) - 1;
+    
+    std::lock_guard<std::mutex> lock(senders_mutex_);
+    auto [it, inserted] = senders_.try_emplace({packet.header.channel_id, packet.header.user_id});
+    auto& sender = it->second;
+    
+    if (inserted || seq > sender.highest_sequence + RESET_GAP ||
+        seq + RESET_GAP < sender.highest_sequence) {
+        sender = SenderReception{};
+        sender.highest_sequence = seq;
+        sender.received = frames;
+        sender.expected = frames;
+        sender.jitter.update(packet.header.timestamp, arrival_us);
+        return;
+    }
     
-    frames_decoded_++;
+    sender.received += frames;
+    if (seq > sender.highest_sequence) {
+        sender.expected += seq - sender.highest_sequence;
+        sender.highest_sequence = seq;
+    }
     
-    // Add to channel-specific jitter buffer
-    audio::AudioPacket audio_packet;
-    audio_packet.sequence = packet.header.sequence;
-    audio_packet.timestamp = Timestamp(packet.header.timestamp);
-    audio_packet.samples = std::move(decoded_samples);
-    audio_packet.frame_size = config_.frame_size;
+    sender.jitter.update(packet.header.timestamp, arrival_us);
+}
+
+QualityFeedback VoiceSession::sample_feedback() {
+    uint64_t received = 0;
+    uint64_t expected = 0;
+    float jitter_us = 0.0f;
     
-    // Get or create jitter buffer for this channel
     {
-        std::lock_guard<std::mutex> lock(channels_mutex_);
-        auto it = channel_buffers_.find(channel_id);
-        if (it != channel_buffers_.end()) {
-            if (!it->second->push(std::move(audio_packet))) {
-                // Buffer full - this is rare but can happen
+        std::lock_guard<std::mutex> lock(senders_mutex_);
+        for (auto it = senders_.begin(); it != senders_.end();) {
+            auto& sender = it->second;
+            if (sender.received == 0) {
+                it = senders_.erase(it);  // Sender went quiet
+                continue;
             }
+            received += std::min(sender.received, sender.expected);
+            expected += sender.expected;
+            jitter_us = std::max(jitter_us, sender.jitter.jitter_us());
+            sender.received = 0;
+            sender.expected = 0;
+            ++it;
         }
     }
+    
+    QualityFeedback feedback;
+    if (expected > 0) {
+        feedback.loss_fraction = static_cast<float>(expected - received) / static_cast<float>(expected);
+    }
+    feedback.jitter_ms = jitter_us / 1000.0f;
+    return feedback;
+}
+
+void VoiceSession::update_quality() {
+    constexpr uint64_t QUALITY_INTERVAL_US = 1000000;
+    
+    quality_interval_us_ += frame_duration_us(config_.sample_rate, config_.frame_size);
+    if (quality_interval_us_ < QUALITY_INTERVAL_US) {
+        return;
+    }
+    quality_interval_us_ = 0;
+    
+    QualityFeedback feedback = sample_feedback();
+    measured_loss_percent_ = feedback.loss_fraction * 100.0f;
+    
+    // Keepalives see the path even when nobody else is talking. The
+    // controller protects our upstream, so take the worse loss estimate.
+    feedback.loss_fraction = std::max(feedback.loss_fraction,
+                                      link_one_way_loss_.load(std::memory_order_relaxed));
+    feedback.rtt_ms = link_rtt_ms_.load(std::memory_order_relaxed);
+    
+    if (!quality_controller_ || !quality_controller_->update(feedback)) {
+        return;
+    }
+    
+    const auto& decision = quality_controller_->decision();
+    apply_quality_decision(decision);
+    
+    VOIP_LOG_INFO("📶 Quality adjusted: " << decision.bitrate << " bps, complexity " << decision.complexity
+                  << ", FEC " << (decision.enable_fec ? "on" : "off")
+                  << ", expected loss " << decision.packet_loss_perc << "%"
+                  << ", " << decision.frames_per_packet << " frame(s)/packet"
+                  << " (measured loss " << feedback.loss_fraction * 100.0f
+                  << "%, jitter " << feedback.jitter_ms << "ms, RTT " << feedback.rtt_ms << "ms)");
+}
+
+void VoiceSession::service_keepalive() {
+    if (!link_monitor_ || !network_->is_connected()) {
+        return;  // Hostname connects pick their path in the background
+    }
+    
+    const uint64_t now_us = steady_time_us();
+    std::optional<uint32_t> sequence;
+    {
+        std::unique_lock<std::mutex> lock(link_mutex_, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return;  // An echo is being recorded; next tick will do
+        }
+        sequence = link_monitor_->poll(now_us);
+        link_one_way_loss_.store(link_monitor_->one_way_loss(), std::memory_order_relaxed);
+    }
+    if (!sequence) {
+        return;
+    }
+    
+    network::KeepalivePacket probe;
+    probe.sequence = *sequence;
+    probe.sent_at_us = now_us;
+    probe.user_id = config_.user_id;
+    auto _ = network_->send_keepalive(probe);  // Failures show up as probe loss
+}
+
+void VoiceSession::on_keepalive_echo(const network::KeepalivePacket& echo) {
+    const uint64_t now_us = echo.received_at_us != 0 ? echo.received_at_us : steady_time_us();
+    
+    std::lock_guard<std::mutex> lock(link_mutex_);
+    if (!link_monitor_ || !link_monitor_->on_echo(echo.sequence, now_us)) {
+        return;
+    }
+    
+    const auto& link = link_monitor_->stats();
+    link_rtt_ms_.store(link.rtt_ms, std::memory_order_relaxed);
+    link_one_way_loss_.store(link_monitor_->one_way_loss(), std::memory_order_relaxed);
+    udp_rtt_metric_.record(static_cast<uint64_t>(link.last_rtt_ms * 1000.0f));
+}
+
+void VoiceSession::apply_quality_decision(const QualityDecision& decision) {
+    if (!encoder_) {
+        return;
+    }
+    
+    // Encoder is only used from the capture thread, so no locking needed
+    if (encoder_->set_bitrate(decision.bitrate).is_ok()) {
+        target_bitrate_ = decision.bitrate;
+        bitrate_metric_->set(decision.bitrate);
+    }
+    requested_complexity_ = decision.complexity;
+    apply_complexity();
+    if (encoder_->enable_fec(decision.enable_fec).is_ok()) {
+        fec_enabled_ = decision.enable_fec;
+    }
+    if (encoder_->set_packet_loss_perc(decision.packet_loss_perc).is_ok()) {
+        expected_loss_perc_ = static_cast<uint32_t>(decision.packet_loss_perc);
+    }
+    // Takes effect from the next frame; frames already held go out as one packet
+    frames_per_packet_ = std::clamp(decision.frames_per_packet, 1u, max_frames_per_packet_);
+    frames_per_packet_metric_->set(frames_per_packet_.load());
+    quality_adjustments_ = quality_controller_ ? quality_controller_->adjustments() : 0;
+}
+
+void VoiceSession::apply_complexity() {
+    const int complexity = cpu_monitor_
+        ? std::min(requested_complexity_, cpu_monitor_->complexity_cap())
+        : requested_complexity_;
+    
+    if (complexity != encoder_complexity_.load() && encoder_->set_complexity(complexity).is_ok()) {
+        encoder_complexity_ = complexity;
+        complexity_metric_->set(complexity);
+    }
 }
 
 // Audio playback callback (runs in audio thread - must be RT-safe!)
-void VoiceSession::on_audio_playback_needed(float* pcm, size_t frames) {
-    if (!active_) {
+void VoiceSession::on_audio_playback_needed(float* pcm, size_t frames, uint64_t playout_time_us) {
+    if (!active_ || frames != config_.frame_size) {
         // Fill with silence
         std::fill(pcm, pcm + frames, 0.0f);
         return;
     }
     
-    // Output silence if deafened
-    if (is_deafened_) {
+    if (!playback_fifo_->try_pop(pcm, frames)) {
         std::fill(pcm, pcm + frames, 0.0f);
+        playback_underruns_.fetch_add(1, std::memory_order_relaxed);
         return;
     }
     
-    frames_played_++;
+    // Frame n is heard at origin + n frame durations
+    const auto offset_us = static_cast<int64_t>(frames_popped_ * frames * 1000000 / config_.sample_rate);
+    playout_origin_us_.store(static_cast<int64_t>(playout_time_us) - offset_us, std::memory_order_relaxed);
+    frames_popped_++;
+}
+
+void VoiceSession::render_playback_frame() {
+    const size_t frames = config_.frame_size;
+    float* pcm = playback_buffer_.data();
     
-    // Mix audio from all listening channels
-    mix_channels(pcm, frames);
+    // When this frame will be heard (0 until the first playback callback)
+    const int64_t origin_us = playout_origin_us_.load(std::memory_order_relaxed);
+    const uint64_t playout_time_us = origin_us == NO_PLAYOUT_ORIGIN ? 0 :
+        static_cast<uint64_t>(origin_us + static_cast<int64_t>(frames_mixed_ * frames * 1000000 / config_.sample_rate));
+    frames_mixed_++;
+    
+    if (is_deafened_) {
+        std::fill(pcm, pcm + frames, 0.0f);
+    } else {
+        frames_played_++;
+        
+        // Mix audio from all listening channels
+        {
+            VOIP_TRACE_SCOPE("mix");
+            mix_channels(pcm, frames, playout_time_us);
+        }
+        
+        uint64_t probe_latency_us = 0;
+        if (latency_probe_ && playout_time_us != 0 &&
+            latency_probe_->detect(pcm, frames, playout_time_us, probe_latency_us)) {
+            probe_latency_.record(probe_latency_us);
+        }
+        
+        publish_latency(frames);
+    }
+    
+    playback_fifo_->try_push(pcm, frames);
+}
+
+void VoiceSession::publish_latency(size_t frames) {
+    constexpr uint64_t PUBLISH_INTERVAL_US = 1000000;
+    
+    latency_publish_us_ += frame_duration_us(config_.sample_rate, static_cast<uint32_t>(frames));
+    if (latency_publish_us_ < PUBLISH_INTERVAL_US) {
+        return;
+    }
+    
+    // Never block the audio thread; try again next frame if stats are being read
+    std::unique_lock<std::mutex> lock(latency_mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return;
+    }
+    latency_publish_us_ = 0;
+    
+    auto summarize = [](const LatencyHistogram& histogram) {
+        return LatencyPercentiles{
+            .p50_ms = histogram.percentile(50) / 1000.0f,
+            .p95_ms = histogram.percentile(95) / 1000.0f,
+            .p99_ms = histogram.percentile(99) / 1000.0f,
+            .samples = histogram.count()
+        };
+    };
+    published_mouth_to_ear_ = summarize(mouth_to_ear_);
+    published_playout_delay_ = summarize(playout_delay_);
+    published_probe_ = summarize(probe_latency_);
 }
 
-// Mix audio from multiple channels (called from audio thread - RT-safe)
-void VoiceSession::mix_channels(float* output, size_t frames) {
+// Mix audio from multiple channels (called from the voice worker)
+void VoiceSession::mix_channels(float* output, size_t frames, uint64_t playout_time_us) {
     // Start with silence
     std::fill(output, output + frames, 0.0f);
     
-    // Get snapshot of channels (avoid holding mutex too long)
+    // Get snapshot of channels (avoid holding mutex too long); streams of
+    // channels we left or of speakers gone quiet are reclaimed meanwhile
     std::vector<ChannelId> channels_to_mix;
     {
         std::lock_guard<std::mutex> lock(channels_mutex_);
@@ -558,38 +1323,74 @@ void VoiceSession::mix_channels(float* output, size_t frames) {
             }
             channels_to_mix.push_back(channel_id);
         }
+        speaker_streams_->reclaim(steady_time_us(), [this](ChannelId channel_id) {
+            return listening_channels_.count(channel_id) > 0;
+        });
     }
     
-    // Mix each channel
-    std::vector<float> temp_buffer(frames);
-    for (auto channel_id : channels_to_mix) {
-        // Get jitter buffer for this channel
-        audio::JitterBuffer* buffer = nullptr;
-        {
-            std::lock_guard<std::mutex> lock(channels_mutex_);
-            auto it = channel_buffers_.find(channel_id);
-            if (it != channel_buffers_.end()) {
-                buffer = it->second.get();
-            }
+    // Mix each speaker of those channels
+    speaker_streams_->for_each([&](SpeakerStream& stream) {
+        if (std::find(channels_to_mix.begin(), channels_to_mix.end(), stream.key.channel_id) == channels_to_mix.end()) {
+            return;
         }
+        audio::JitterBuffer* buffer = stream.jitter_buffer.get();
+        SpeakerStream* playout = &stream;
         
-        if (!buffer) continue;
-        
-        // Try to get audio from this channel
-        auto packet_opt = buffer->pop();
-        if (packet_opt.has_value()) {
-            auto& packet = packet_opt.value();
-            size_t samples_to_mix = (std::min)(frames, packet.samples.size());
+        // Fill the output frame from as many packets as it spans
+        // (e.g. two 10ms packets per 20ms frame, or half a 40ms packet)
+        size_t filled = 0;
+        while (filled < frames) {
+            if (playout->read_pos >= playout->samples.size()) {
+                TraceScope pop_trace("jitter pop");
+                auto packet_opt = buffer->pop();
+                pop_trace.end();
+                if (!packet_opt.has_value()) {
+                    break;  // Underrun - rest of this speaker stays silent
+                }
+                
+                auto& packet = packet_opt.value();
+                if (packet.samples.empty()) {
+                    // Lost packet: conceal with silence for its duration
+                    plc_frames_++;
+                    plc_frames_metric_.add();
+                    playout->samples.assign(packet.frame_size, 0.0f);
+                } else {
+                    // The packet's first sample is heard at this output position
+                    const uint64_t heard_us = playout_time_us +
+                        frame_duration_us(config_.sample_rate, static_cast<uint32_t>(filled));
+                    if (playout_time_us != 0 && packet.arrival_us != 0 && heard_us > packet.arrival_us) {
+                        playout_delay_.record(heard_us - packet.arrival_us);
+                    }
+                    // Sender timestamps share our clock only for our own echoed voice
+                    const auto captured_us = static_cast<uint64_t>(packet.timestamp.count());
+                    if (playout_time_us != 0 && packet.sender == config_.user_id &&
+                        captured_us != 0 && heard_us > captured_us) {
+                        mouth_to_ear_.record(heard_us - captured_us);
+                        mouth_to_ear_metric_.record(heard_us - captured_us);
+                    }
+                    playout->samples = std::move(packet.samples);
+                }
+                playout->read_pos = 0;
+                continue;
+            }
+            
+            const size_t samples_to_mix = (std::min)(frames - filled,
+                                                     playout->samples.size() - playout->read_pos);
+            const float* source = &playout->samples[playout->read_pos];
             
             // Additive mixing with clipping
             for (size_t i = 0; i < samples_to_mix; i++) {
-                output[i] += packet.samples[i];
+                float& sample = output[filled + i];
+                sample += source[i];
                 // Manual clamp to [-1.0, 1.0]
-                if (output[i] > 1.0f) output[i] = 1.0f;
-                else if (output[i] < -1.0f) output[i] = -1.0f;
+                if (sample > 1.0f) sample = 1.0f;
+                else if (sample < -1.0f) sample = -1.0f;
             }
+            
+            filled += samples_to_mix;
+            playout->read_pos += samples_to_mix;
         }
-    }
+    });
 }
 
 // === MULTI-CHANNEL CONTROL METHODS ===
@@ -602,13 +1403,8 @@ Result<void> VoiceSession::join_channel(ChannelId channel_id) {
         listening_channels_.insert(channel_id);
         channel_muted_[channel_id] = false;  // Not muted by default
         
-        // Create jitter buffer for this channel
-        channel_buffers_[channel_id] = std::make_unique<audio::JitterBuffer>(
-            config_.jitter_buffer_frames,
-            config_.frame_size
-        );
-        
-        std::cout << "✅ Joined channel " << channel_id << " for listening\n";
+        // Speakers get their receive state when first heard
+        VOIP_LOG_INFO("✅ Joined channel " << channel_id << " for listening");
     }
     
     // Send presence packet to register UDP address for this channel
@@ -623,12 +1419,11 @@ Result<void> VoiceSession::join_channel(ChannelId channel_id) {
 Result<void> VoiceSession::leave_channel(ChannelId channel_id) {
     std::lock_guard<std::mutex> lock(channels_mutex_);
     
-    // Remove from listening channels
+    // Remove from listening channels (the worker reclaims its speakers)
     listening_channels_.erase(channel_id);
     channel_muted_.erase(channel_id);
-    channel_buffers_.erase(channel_id);
     
-    std::cout << "👋 Left channel " << channel_id << "\n";
+    VOIP_LOG_INFO("👋 Left channel " << channel_id);
     return Ok();
 }
 
@@ -638,8 +1433,8 @@ void VoiceSession::set_channel_muted(ChannelId channel_id, bool muted) {
     // Only allow muting channels we're listening to
     if (listening_channels_.count(channel_id) > 0) {
         channel_muted_[channel_id] = muted;
-        std::cout << (muted ? "🔇" : "🔊") << " Channel " << channel_id 
-                  << (muted ? " muted" : " unmuted") << "\n";
+        VOIP_LOG_INFO((muted ? "🔇" : "🔊") << " Channel " << channel_id
+                      << (muted ? " muted" : " unmuted"));
     }
 }
 
@@ -657,9 +1452,9 @@ std::set<ChannelId> VoiceSession::get_joined_channels() const {
 void VoiceSession::set_hot_mic_channel(ChannelId channel_id) {
     hot_mic_channel_.store(channel_id);
     if (channel_id == 0) {
-        std::cout << "🎤 Hot mic disabled\n";
+        VOIP_LOG_INFO("🎤 Hot mic disabled");
     } else {
-        std::cout << "🎤 Hot mic set to channel " << channel_id << "\n";
+        VOIP_LOG_INFO("🎤 Hot mic set to channel " << channel_id);
     }
 }
 
@@ -672,13 +1467,9 @@ void VoiceSession::start_ptt(ChannelId channel_id) {
         std::lock_guard<std::mutex> lock(ptt_mutex_);
         ptt_channels_.insert(channel_id);
         
-        std::cout << "🎤 PTT started for channel " << channel_id;
-        std::cout << " | Active PTT channels now: ";
-        for (auto ch : ptt_channels_) {
-            std::cout << ch << " ";
-        }
-        std::cout << " | Hot mic: " << (hot_mic_channel_.load() != 0 ? std::to_string(hot_mic_channel_.load()) : "off");
-        std::cout << std::endl;
+        VOIP_LOG_INFO("🎤 PTT started for channel " << channel_id
+                      << " | Active PTT channels now: " << log_join(ptt_channels_)
+                      << " | Hot mic: " << hot_mic_channel_.load());
     }
     
     // Send presence packet to ensure UDP address is registered for this channel
@@ -692,17 +1483,10 @@ void VoiceSession::stop_ptt(ChannelId channel_id) {
     std::lock_guard<std::mutex> lock(ptt_mutex_);
     ptt_channels_.erase(channel_id);
     
-    std::cout << "🔇 PTT stopped for channel " << channel_id;
-    std::cout << " | Remaining PTT channels: ";
-    if (ptt_channels_.empty()) {
-        std::cout << "(none)";
-    } else {
-        for (auto ch : ptt_channels_) {
-            std::cout << ch << " ";
-        }
-    }
-    std::cout << " | Hot mic: " << (hot_mic_channel_.load() != 0 ? std::to_string(hot_mic_channel_.load()) : "off");
-    std::cout << std::endl;
+    VOIP_LOG_INFO("🔇 PTT stopped for channel " << channel_id
+                  << " | Remaining PTT channels: " << (ptt_channels_.empty() ? "(none)" : "")
+                  << log_join(ptt_channels_)
+                  << " | Hot mic: " << hot_mic_channel_.load());
 }
 
 std::set<ChannelId> VoiceSession::get_active_ptt_channels() const {
@@ -31,6 +31,11 @@ MainWindow::MainWindow(QWidget* parent)
     connect(statsTimer_, &QTimer::timeout, this, &MainWindow::onVoiceStatsUpdate);
     statsTimer_->start(1000);
     
+    // Speaking indicator needs to feel immediate
+    speakingTimer_ = new QTimer(this);
+    connect(speakingTimer_, &QTimer::timeout, this, &MainWindow::onSpeakingUpdate);
+    speakingTimer_->start(100);
+    
     setWindowTitle("DadLink v1.0.3 - Voice Chat");
     resize(1000, 700);
     
@@ -209,6 +214,10 @@ void MainWindow::setupUI() {
     auto* settingsButton = new QPushButton("⚙️ Settings", this);
     buttonLayout->addWidget(settingsButton);
     
+    auto* addServerButton = new QPushButton("➕ Add Server", this);
+    addServerButton->setToolTip("Connect to another server at the same time");
+    buttonLayout->addWidget(addServerButton);
+    
     auto* disconnectButton = new QPushButton("🚪 Disconnect", this);
     buttonLayout->addWidget(disconnectButton);
     
@@ -220,6 +229,7 @@ void MainWindow::setupUI() {
     connect(deafenButton_, &QPushButton::toggled, this, &MainWindow::onDeafenToggled);
     connect(pttButton_, &QPushButton::toggled, this, &MainWindow::onPushToTalkToggled);
     connect(settingsButton, &QPushButton::clicked, this, &MainWindow::onSettingsClicked);
+    connect(addServerButton, &QPushButton::clicked, this, &MainWindow::addServerRequested);
     connect(disconnectButton, &QPushButton::clicked, this, &MainWindow::onDisconnectClicked);
     connect(channelList_, &QListWidget::itemDoubleClicked, this, &MainWindow::onChannelItemDoubleClicked);
 
@@ -293,6 +303,32 @@ void MainWindow::setupWebSocketCallbacks() {
         QMetaObject::invokeMethod(this, "onWsDisconnected", Qt::QueuedConnection);
     });
     
+    // Control-plane drops: the voice session keeps running while the
+    // client reconnects and resumes, so there is nothing to tear down here
+    wsClient_->set_reconnecting_callback([this](uint32_t attempt, uint32_t delayMs) {
+        QMetaObject::invokeMethod(this, "onWsReconnecting", Qt::QueuedConnection,
+            Q_ARG(uint32_t, attempt),
+            Q_ARG(uint32_t, delayMs));
+    });
+    
+    wsClient_->set_resumed_callback([this](const protocol::ResumeResponse& response) {
+        // Alias updates may have been missed while disconnected
+        wsClient_->request_compact_voice_header();
+        QMetaObject::invokeMethod(this, "onWsResumed", Qt::QueuedConnection,
+            Q_ARG(bool, !response.key_exchange_required));
+    });
+    
+    // Compact voice header: the server's aliases for users and channels
+    wsClient_->set_voice_aliases_callback([this](const protocol::VoiceAliasesResponse& response) {
+        if (!response.compact || !voiceSession_) {
+            return;
+        }
+        network::VoiceAliases aliases;
+        aliases.users = response.users;
+        aliases.channels = response.channels;
+        voiceSession_->set_voice_aliases(aliases);
+    });
+    
     // After login response, auto-join channel 1
     wsClient_->set_login_callback([this](const protocol::LoginResponse& response) {
         if (response.success) {
@@ -312,6 +348,9 @@ void MainWindow::setupWebSocketCallbacks() {
                 std::cout << "🔧 Updating VoiceSession user ID from hardcoded 42 to "
                           << userId_ << std::endl;
                 voiceSession_->set_user_id(userId_);
+                
+                // Ask for the short packet header (falls back to legacy if declined)
+                wsClient_->request_compact_voice_header();
 
                 // NOW auto-join Channel 1 with correct user ID
                 auto result = voiceSession_->join_channel(1);
@@ -609,6 +648,40 @@ void MainWindow::onVoiceStatsUpdate() {
     updateVoiceStats();
 }
 
+void MainWindow::onSpeakingUpdate() {
+    if (!rosterManager_) {
+        return;
+    }
+    
+    const bool speaking = voiceSession_ && voiceSession_->is_speaking();
+    
+    // Channels we're talking into: PTT overrides hot mic
+    std::set<ChannelId> channels;
+    if (speaking) {
+        channels = voiceSession_->get_active_ptt_channels();
+        if (channels.empty() && voiceSession_->get_hot_mic_channel() != 0) {
+            channels.insert(voiceSession_->get_hot_mic_channel());
+        }
+    }
+    
+    if (channels == speakingChannels_) {
+        return;
+    }
+    
+    for (ChannelId channelId : speakingChannels_) {
+        if (channels.count(channelId) == 0) {
+            rosterManager_->updateUserSpeaking(channelId, userId_, false);
+        }
+    }
+    for (ChannelId channelId : channels) {
+        if (speakingChannels_.count(channelId) == 0) {
+            rosterManager_->updateUserSpeaking(channelId, userId_, true);
+        }
+    }
+    
+    speakingChannels_ = std::move(channels);
+}
+
 void MainWindow::updateVoiceStats() {
     if (!voiceSession_ || !voiceSession_->is_active()) {
         inputMeter_->setValue(0);
@@ -667,6 +740,12 @@ void MainWindow::updateVoiceStats() {
         qualityText = QString("Quality: ⭐⭐ Poor (%1% loss)").arg(packetLoss, 0, 'f', 1);
     }
     qualityLabel_->setText(qualityText);
+    qualityLabel_->setToolTip(QString("Sending %1 kbps, FEC %2, complexity %3\nMeasured loss: %4%\nEncode time p95: %5 ms")
+        .arg(stats.target_bitrate / 1000.0, 0, 'f', 1)
+        .arg(stats.fec_enabled ? "on" : "off")
+        .arg(stats.encoder_complexity)
+        .arg(stats.measured_loss_percent, 0, 'f', 1)
+        .arg(stats.encode_time_p95_us / 1000.0, 0, 'f', 2));
 }
 
 void MainWindow::addLogMessage(const QString& message) {
@@ -759,6 +838,22 @@ void MainWindow::onWsDisconnected() {
     statusBar()->showMessage("Status: Disconnected");
 }
 
+void MainWindow::onWsReconnecting(uint32_t attempt, uint32_t delayMs) {
+    addLogMessage(QString("🔄 Reconnecting in %1 ms (attempt %2)").arg(delayMs).arg(attempt));
+    statusBar()->showMessage("Status: Reconnecting...");
+}
+
+void MainWindow::onWsResumed(bool keysRetained) {
+    addLogMessage(keysRetained ? "✅ Reconnected - session resumed"
+                               : "✅ Reconnected - session resumed, renegotiating voice keys");
+    statusBar()->showMessage("Status: Connected");
+
+    // Our address may have changed with the network; re-register it for voice routing
+    if (voiceSession_ && voiceSession_->is_active() && currentChannelId_ != 0) {
+        voiceSession_->send_presence_packet(currentChannelId_);
+    }
+}
+
 void MainWindow::onWsError(const std::string& error) {
     addLogMessage(QString("❌ WebSocket error: %1").arg(QString::fromStdString(error)));
 }
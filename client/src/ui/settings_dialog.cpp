@@ -10,8 +10,8 @@ namespace voip::ui {
 SettingsDialog::SettingsDialog(audio::AudioEngine* audioEngine, QWidget* parent)
     : QDialog(parent)
     , audioEngine_(audioEngine)
-    , selectedInputId_(paNoDevice)
-    , selectedOutputId_(paNoDevice)
+    , selectedInputId_(NO_DEVICE)
+    , selectedOutputId_(NO_DEVICE)
 {
     setupUI();
     loadDevices();
@@ -309,7 +309,7 @@ void SettingsDialog::onApply() {
     }
     
     // Apply input device
-    if (selectedInputId_ != paNoDevice) {
+    if (selectedInputId_ != NO_DEVICE) {
         auto result = audioEngine_->set_input_device(selectedInputId_);
         if (!result.is_ok()) {
             QMessageBox::warning(this, "Device Error",
@@ -319,7 +319,7 @@ void SettingsDialog::onApply() {
     }
     
     // Apply output device
-    if (selectedOutputId_ != paNoDevice) {
+    if (selectedOutputId_ != NO_DEVICE) {
         auto result = audioEngine_->set_output_device(selectedOutputId_);
         if (!result.is_ok()) {
             QMessageBox::warning(this, "Device Error",
@@ -1,16 +1,36 @@
 #include <QApplication>
 #include <QFile>
 #include <QMessageBox>
+#include <QPointer>
 #include <QTimer>
 #include "ui/login_dialog.h"
 #include "ui/main_window.h"
 #include "session/voice_session.h"
+#include "session/voice_hub.h"
 #include "network/websocket_client.h"
+#include "common/logger.h"
+#include <functional>
 #include <iostream>
+#include <vector>
 
 using namespace voip;
 
+namespace {
+
+// Login and registration for a login dialog (one is open at a time)
+void wireLoginDialog(ui::LoginDialog& loginDialog);
+
+// One server connection: a window with its own control connection and
+// voice session, whose audio goes through the shared hub
+ui::MainWindow* openServerWindow(const ui::LoginDialog& loginDialog, session::VoiceHub& voiceHub,
+                                 std::shared_ptr<session::VoiceSession>& voiceSession);
+
+} // namespace
+
 int main(int argc, char *argv[]) {
+    // Log writer thread up before audio or network threads log
+    Logger::start();
+
     // Write to file to see if main() even runs
     FILE* debug_log = fopen("C:\\dev\\VoIP-System\\client\\debug.txt", "w");
     if (debug_log) {
@@ -126,11 +146,85 @@ int main(int argc, char *argv[]) {
     std::cout << "LoginDialog created!" << std::endl;
     std::cout.flush();
     
+    wireLoginDialog(loginDialog);
+    
+    if (loginDialog.exec() != QDialog::Accepted) {
+        return 0;
+    }
+    
+    // Audio devices and the voice worker live in a hub so further server
+    // connections can share them (one VoiceSession per server)
+    auto voiceHub = std::make_unique<session::VoiceHub>();
+    session::VoiceHub::Config hubConfig;  // 48 kHz, 20ms frames
+    auto hubResult = voiceHub->initialize(hubConfig);
+    if (!hubResult.is_ok()) {
+        std::cerr << "❌ Audio initialization failed: " << hubResult.error().message() << std::endl;
+    }
+    
+    // Tracked: with several windows open, this one may close (and delete
+    // itself) before the application quits
+    std::shared_ptr<session::VoiceSession> voiceSession;
+    QPointer<ui::MainWindow> mainWindow = openServerWindow(loginDialog, *voiceHub, voiceSession);
+    
+    // "Add Server": log in to another server, in a window of its own that
+    // shares the hub (closing it shuts down only that server's session)
+    std::vector<QPointer<ui::MainWindow>> serverWindows;
+    std::function<void(ui::MainWindow*)> offerAddServer = [&](ui::MainWindow* window) {
+        QObject::connect(window, &ui::MainWindow::addServerRequested, window, [&, window]() {
+            ui::LoginDialog addDialog(window);
+            addDialog.setWindowTitle("Add Server");
+            wireLoginDialog(addDialog);
+            if (addDialog.exec() != QDialog::Accepted) {
+                return;
+            }
+            std::shared_ptr<session::VoiceSession> serverSession;
+            auto* serverWindow = openServerWindow(addDialog, *voiceHub, serverSession);
+            serverWindows.emplace_back(serverWindow);
+            offerAddServer(serverWindow);
+        });
+    };
+    offerAddServer(mainWindow);
+    
+    // Run application event loop
+    int result = app.exec();
+    
+    std::cout << "\n=== APPLICATION EXITING ===" << std::endl;
+    
+    // Cleanup voice session explicitly before MainWindow destructor
+    // This ensures proper shutdown order
+    if (voiceSession) {
+        std::cout << "🧹 Explicit cleanup of voice session..." << std::endl;
+        voiceSession->stop();
+        voiceSession->shutdown();
+        voiceSession.reset();  // Release shared_ptr
+    }
+    
+    // Windows of further servers still open (each shuts its own session down)
+    for (auto& serverWindow : serverWindows) {
+        delete serverWindow.data();
+    }
+    
+    // Delete main window explicitly to see destructor output
+    std::cout << "🧹 Deleting main window..." << std::endl;
+    delete mainWindow;
+    mainWindow = nullptr;
+    
+    // Sessions are gone; the shared devices can close
+    voiceHub->shutdown();
+    
+    std::cout << "✅ Application cleanup complete\n" << std::endl;
+    
+    return result;
+}
+
+namespace {
+
+void wireLoginDialog(ui::LoginDialog& loginDialog) {
     // Handle login button - need to actually authenticate
     static std::shared_ptr<network::WebSocketClient> loginWs;
     static bool loginInProgress = false;
     
-    QObject::connect(&loginDialog, &ui::LoginDialog::loginRequested, [&](const QString& username, const QString& password, const QString& server) {
+    QObject::connect(&loginDialog, &ui::LoginDialog::loginRequested, [&loginDialog](const QString& username, const QString& password, const QString& server) {
         if (username.isEmpty()) {
             loginDialog.setStatusMessage("Please enter a username", true);
             return;
@@ -204,7 +298,7 @@ int main(int argc, char *argv[]) {
     // Handle register button - need to keep WebSocket alive
     static std::shared_ptr<network::WebSocketClient> registrationWs;
 
-    QObject::connect(&loginDialog, &ui::LoginDialog::registerRequested, [&](const QString& username, const QString& password, const QString& server, bool useTls) {
+    QObject::connect(&loginDialog, &ui::LoginDialog::registerRequested, [&loginDialog](const QString& username, const QString& password, const QString& server, bool useTls) {
         std::cout << "📝 Registration requested for user: " << username.toStdString() << " (TLS: " << (useTls ? "enabled" : "disabled") << ")" << std::endl;
 
         // Parse server address and port
@@ -260,12 +354,11 @@ int main(int argc, char *argv[]) {
             }
         });
     });
-    
-    if (loginDialog.exec() != QDialog::Accepted) {
-        return 0;
-    }
-    
-    // Create main window
+}
+
+ui::MainWindow* openServerWindow(const ui::LoginDialog& loginDialog, session::VoiceHub& voiceHub,
+                                 std::shared_ptr<session::VoiceSession>& voiceSession) {
+    // Create the window for this server
     auto* mainWindow = new ui::MainWindow();
     mainWindow->setUserInfo(loginDialog.username(), 42);
     mainWindow->setAttribute(Qt::WA_DeleteOnClose);
@@ -309,20 +402,20 @@ int main(int argc, char *argv[]) {
     session::VoiceSession::Config voiceConfig;
     voiceConfig.server_address = loginDialog.serverAddress().toStdString();
     voiceConfig.server_port = 9001;
-    voiceConfig.sample_rate = 48000;
-    voiceConfig.frame_size = 960;
+    voiceConfig.sample_rate = voiceHub.config().sample_rate;
+    voiceConfig.frame_size = voiceHub.config().frame_size;
     voiceConfig.channels = 1;
     voiceConfig.bitrate = 32000;
     voiceConfig.enable_fec = true;
-    voiceConfig.enable_dtx = false;
+    voiceConfig.enable_dtx = true;
     voiceConfig.channel_id = 1;
     voiceConfig.user_id = 42;
     voiceConfig.jitter_buffer_frames = 5;
     
     // Create and initialize voice session (but DON'T start yet!)
     // We'll start it AFTER WebSocket connects and joins channel
-    auto voiceSession = std::make_shared<session::VoiceSession>();
-    auto initResult = voiceSession->initialize(voiceConfig);
+    voiceSession = std::make_shared<session::VoiceSession>();
+    auto initResult = voiceSession->initialize(voiceConfig, voiceHub);
     
     if (initResult.is_ok()) {
         // Pass to MainWindow - it will start after channel join
@@ -333,27 +426,7 @@ int main(int argc, char *argv[]) {
     }
     
     mainWindow->show();
-    
-    // Run application event loop
-    int result = app.exec();
-    
-    std::cout << "\n=== APPLICATION EXITING ===" << std::endl;
-    
-    // Cleanup voice session explicitly before MainWindow destructor
-    // This ensures proper shutdown order
-    if (voiceSession) {
-        std::cout << "🧹 Explicit cleanup of voice session..." << std::endl;
-        voiceSession->stop();
-        voiceSession->shutdown();
-        voiceSession.reset();  // Release shared_ptr
-    }
-    
-    // Delete main window explicitly to see destructor output
-    std::cout << "🧹 Deleting main window..." << std::endl;
-    delete mainWindow;
-    mainWindow = nullptr;
-    
-    std::cout << "✅ Application cleanup complete\n" << std::endl;
-    
-    return result;
+    return mainWindow;
 }
+
+} // namespace
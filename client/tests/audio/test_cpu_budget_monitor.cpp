@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include "audio/cpu_budget_monitor.h"
+
+using namespace voip::audio;
+
+namespace {
+
+CpuBudgetMonitor::Config make_config() {
+    CpuBudgetMonitor::Config config;
+    config.frame_duration_us = 20000;
+    config.budget_fraction = 0.25f;  // 5000us budget
+    config.window_frames = 10;
+    config.raise_after_windows = 3;
+    return config;
+}
+
+// Feed one full window of identical encode times
+bool feed_window(CpuBudgetMonitor& monitor, uint32_t encode_us, uint32_t frames = 10) {
+    bool changed = false;
+    for (uint32_t i = 0; i < frames; ++i) {
+        changed = monitor.record(encode_us) || changed;
+    }
+    return changed;
+}
+
+} // namespace
+
+TEST(CpuBudgetMonitorTest, StartsAtMaxComplexity) {
+    CpuBudgetMonitor monitor(make_config());
+    EXPECT_EQ(monitor.complexity_cap(), 10);
+    EXPECT_EQ(monitor.budget_us(), 5000u);
+}
+
+TEST(CpuBudgetMonitorTest, LowersComplexityWhenOverBudget) {
+    CpuBudgetMonitor monitor(make_config());
+
+    EXPECT_TRUE(feed_window(monitor, 8000));
+    EXPECT_EQ(monitor.complexity_cap(), 9);
+    EXPECT_TRUE(feed_window(monitor, 8000));
+    EXPECT_EQ(monitor.complexity_cap(), 8);
+
+    // Stops at the floor
+    for (int i = 0; i < 20; ++i) {
+        feed_window(monitor, 8000);
+    }
+    EXPECT_EQ(monitor.complexity_cap(), 0);
+}
+
+TEST(CpuBudgetMonitorTest, RaisesOnlyAfterSustainedHeadroom) {
+    CpuBudgetMonitor monitor(make_config());
+    feed_window(monitor, 8000);
+    feed_window(monitor, 8000);
+    ASSERT_EQ(monitor.complexity_cap(), 8);
+
+    // Within budget but without much headroom: hold
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_FALSE(feed_window(monitor, 4000));
+    }
+    EXPECT_EQ(monitor.complexity_cap(), 8);
+
+    // Lots of headroom: one step per raise_after_windows windows
+    EXPECT_FALSE(feed_window(monitor, 1000));
+    EXPECT_FALSE(feed_window(monitor, 1000));
+    EXPECT_TRUE(feed_window(monitor, 1000));
+    EXPECT_EQ(monitor.complexity_cap(), 9);
+}
+
+TEST(CpuBudgetMonitorTest, OccasionalSpikesDoNotTrigger) {
+    CpuBudgetMonitor::Config config = make_config();
+    config.window_frames = 100;
+    CpuBudgetMonitor monitor(config);
+
+    // 2% of frames over budget stays under the p95 threshold
+    for (int i = 0; i < 100; ++i) {
+        monitor.record(i % 50 == 0 ? 20000 : 3000);
+    }
+    EXPECT_EQ(monitor.complexity_cap(), 10);
+    EXPECT_EQ(monitor.percentiles().p50_us, 3000u);
+    EXPECT_EQ(monitor.percentiles().p95_us, 3000u);
+    EXPECT_EQ(monitor.percentiles().p99_us, 20000u);
+}
@@ -1,7 +1,7 @@
 #include <gtest/gtest.h>
 #include "audio/jitter_buffer.h"
 
-using namespace voip::audio;
+namespace voip::audio {
 
 // Helper to create test packet
 AudioPacket create_packet(SequenceNumber seq, size_t frame_size) {
@@ -48,7 +48,7 @@ TEST(JitterBufferTest, InOrderPackets) {
 
 TEST(JitterBufferTest, OutOfOrderPackets) {
     constexpr size_t FRAME_SIZE = 960;
-    JitterBuffer buffer(5, FRAME_SIZE);
+    JitterBuffer buffer(4, FRAME_SIZE);  // Target = packets pushed, so playout starts
     
     // Push packets out of order
     buffer.push(create_packet(0, FRAME_SIZE));
@@ -66,7 +66,7 @@ TEST(JitterBufferTest, OutOfOrderPackets) {
 
 TEST(JitterBufferTest, PacketLoss) {
     constexpr size_t FRAME_SIZE = 960;
-    JitterBuffer buffer(5, FRAME_SIZE);
+    JitterBuffer buffer(4, FRAME_SIZE);  // Target = packets pushed, so playout starts
     
     // Push packets with gap
     buffer.push(create_packet(0, FRAME_SIZE));
@@ -149,7 +149,7 @@ TEST(JitterBufferTest, BufferReady) {
 
 TEST(JitterBufferTest, Underrun) {
     constexpr size_t FRAME_SIZE = 960;
-    JitterBuffer buffer(5, FRAME_SIZE);
+    JitterBuffer buffer(1, FRAME_SIZE);  // Playout starts with the first packet
     
     // Try to pop from empty buffer
     auto result = buffer.pop();
@@ -195,7 +195,7 @@ TEST(JitterBufferTest, Reset) {
 
 TEST(JitterBufferTest, Statistics) {
     constexpr size_t FRAME_SIZE = 960;
-    JitterBuffer buffer(5, FRAME_SIZE);
+    JitterBuffer buffer(3, FRAME_SIZE);  // Target = distinct packets pushed
     
     // Add packets with some loss and duplicates
     buffer.push(create_packet(0, FRAME_SIZE));
@@ -214,3 +214,57 @@ TEST(JitterBufferTest, Statistics) {
     EXPECT_EQ(stats.packets_duplicate, 1);
     EXPECT_GT(stats.packets_late, 0);  // Packet 2 was marked as late/lost
 }
+
+TEST(JitterBufferTest, PerPacketFrameSize) {
+    // Buffer defaults to 20ms, but the sender switches to 10ms then 40ms
+    JitterBuffer buffer(2, 960, 48000);
+    
+    buffer.push(create_packet(0, 480));
+    buffer.push(create_packet(1, 480));
+    buffer.push(create_packet(2, 1920));
+    buffer.push(create_packet(4, 1920));  // Gap at 3
+    
+    auto first = buffer.pop();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->frame_size, 480u);
+    EXPECT_EQ(first->samples.size(), 480u);
+    
+    buffer.pop();
+    auto third = buffer.pop();
+    ASSERT_TRUE(third.has_value());
+    EXPECT_EQ(third->frame_size, 1920u);
+    
+    // Concealment covers the stream's current frame duration
+    buffer.push(create_packet(5, 1920));
+    buffer.push(create_packet(6, 1920));
+    auto lost = buffer.pop();
+    ASSERT_TRUE(lost.has_value());
+    EXPECT_EQ(lost->sequence, 3u);
+    EXPECT_TRUE(lost->samples.empty());
+    EXPECT_EQ(lost->frame_size, 1920u);
+    
+    EXPECT_EQ(buffer.get_stats().frame_duration_us, 40000u);
+}
+
+TEST(JitterBufferTest, JitterFollowsArrivalTimes) {
+    JitterBuffer buffer(2, 960, 48000);
+    
+    // Packets pushed back to back, but stamped as arriving with 0/6ms extra delay
+    for (SequenceNumber seq = 0; seq < 100; seq++) {
+        auto packet = create_packet(seq, 960);
+        packet.arrival_us = 1'000'000 + seq * 20000 + ((seq % 2) ? 6000 : 0);
+        buffer.push(packet);
+        buffer.pop();
+    }
+    EXPECT_NEAR(buffer.get_stats().jitter_ms, 6.0f, 0.1f);
+    
+    // Without arrival times there is nothing to measure
+    JitterBuffer unstamped(2, 960, 48000);
+    for (SequenceNumber seq = 0; seq < 10; seq++) {
+        unstamped.push(create_packet(seq, 960));
+        unstamped.pop();
+    }
+    EXPECT_FLOAT_EQ(unstamped.get_stats().jitter_ms, 0.0f);
+}
+
+} // namespace voip::audio
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "audio/latency_probe.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <vector>
+
+using namespace voip::audio;
+
+namespace {
+
+constexpr uint32_t SAMPLE_RATE = 48000;
+constexpr size_t FRAME = 960;  // 20ms
+constexpr uint64_t FRAME_US = 20000;
+
+LatencyProbe::Config make_config() {
+    LatencyProbe::Config config;
+    config.sample_rate = SAMPLE_RATE;
+    config.interval_ms = 500;
+    return config;
+}
+
+// Run the probe through a pure delay line for a number of frames
+std::vector<uint64_t> run_delay_line(LatencyProbe& probe, size_t delay_samples, size_t frames) {
+    std::deque<float> line(delay_samples, 0.0f);
+    std::vector<float> capture(FRAME);
+    std::vector<float> output(FRAME);
+    std::vector<uint64_t> latencies;
+
+    const uint64_t start_us = 1000000;
+    for (size_t f = 0; f < frames; ++f) {
+        const uint64_t time_us = start_us + f * FRAME_US;
+        probe.inject(capture.data(), FRAME, time_us);
+        line.insert(line.end(), capture.begin(), capture.end());
+        std::copy(line.begin(), line.begin() + FRAME, output.begin());
+        line.erase(line.begin(), line.begin() + FRAME);
+
+        uint64_t latency_us = 0;
+        if (probe.detect(output.data(), FRAME, time_us, latency_us)) {
+            latencies.push_back(latency_us);
+        }
+    }
+    return latencies;
+}
+
+} // namespace
+
+TEST(LatencyProbeTest, InjectsMarkerOncePerInterval) {
+    LatencyProbe probe(make_config());
+    std::vector<float> frame(FRAME, 1.0f);  // Microphone input is replaced
+
+    size_t loud_frames = 0;
+    for (size_t f = 0; f < 50; ++f) {  // 1 second
+        probe.inject(frame.data(), FRAME, 1000000 + f * FRAME_US);
+        const float peak = std::fabs(*std::max_element(frame.begin(), frame.end(),
+            [](float a, float b) { return std::fabs(a) < std::fabs(b); }));
+        if (peak > 0.0f) {
+            EXPECT_NEAR(peak, 0.5f, 0.01f);
+            loud_frames++;
+        }
+    }
+
+    EXPECT_EQ(probe.markers_sent(), 2u);
+    EXPECT_EQ(loud_frames, 2u);  // One 20ms burst per marker
+}
+
+TEST(LatencyProbeTest, MeasuresDelayLine) {
+    LatencyProbe probe(make_config());
+    const size_t delay_samples = 4800 + 123;  // ~102.6ms, not frame aligned
+
+    auto latencies = run_delay_line(probe, delay_samples, 100);
+
+    ASSERT_EQ(latencies.size(), 4u);
+    EXPECT_EQ(probe.markers_detected(), 4u);
+
+    // The onset is found within a few samples of the tone crossing the threshold
+    const double expected_us = delay_samples * 1e6 / SAMPLE_RATE;
+    for (uint64_t latency_us : latencies) {
+        EXPECT_NEAR(static_cast<double>(latency_us), expected_us, 100.0);
+    }
+}
+
+TEST(LatencyProbeTest, IgnoresAudioBeforeFirstMarker) {
+    LatencyProbe probe(make_config());
+    std::vector<float> output(FRAME, 0.5f);
+
+    // Another talker on the channel before any marker was sent
+    uint64_t latency_us = 0;
+    EXPECT_FALSE(probe.detect(output.data(), FRAME, 1000000, latency_us));
+    EXPECT_EQ(probe.markers_detected(), 0u);
+}
+
+TEST(LatencyProbeTest, SilenceIsNeverDetected) {
+    LatencyProbe probe(make_config());
+    std::vector<float> output(FRAME, 0.0f);
+
+    std::vector<float> capture(FRAME);
+    probe.inject(capture.data(), FRAME, 1000000);
+
+    uint64_t latency_us = 0;
+    for (size_t f = 0; f < 50; ++f) {
+        EXPECT_FALSE(probe.detect(output.data(), FRAME, 1000000 + f * FRAME_US, latency_us));
+    }
+    EXPECT_EQ(probe.markers_sent(), 1u);
+}
@@ -3,7 +3,8 @@
 #include <cmath>
 #include <vector>
 
-using namespace voip::audio;
+// Inside the namespace so OpusEncoder/OpusDecoder don't clash with libopus
+namespace voip::audio {
 
 // Helper: Generate sine wave test signal
 std::vector<float> generate_sine_wave(float frequency, uint32_t sample_rate, size_t samples) {
@@ -213,3 +214,104 @@ TEST(OpusCodecTest, MultipleFrames) {
         ASSERT_TRUE(decode_result.is_ok()) << "Frame " << frame << " decode failed";
     }
 }
+
+TEST(OpusCodecTest, FrameDurations) {
+    constexpr uint32_t SAMPLE_RATE = 48000;
+    
+    OpusConfig config;
+    config.sample_rate = SAMPLE_RATE;
+    
+    auto encoder = OpusEncoder::create(config).unwrap();
+    auto decoder = OpusDecoder::create(SAMPLE_RATE, 1).unwrap();
+    
+    // 2.5, 5, 10, 20, 40 and 60ms; the decoder learns the size from the packet
+    for (uint32_t duration_us : {2500u, 5000u, 10000u, 20000u, 40000u, 60000u}) {
+        const uint32_t frame_size = voip::frame_size_for_duration_us(SAMPLE_RATE, duration_us);
+        ASSERT_TRUE(voip::is_valid_opus_frame_size(SAMPLE_RATE, frame_size));
+        
+        auto input = generate_sine_wave(440.0f, SAMPLE_RATE, frame_size);
+        auto encode_result = encoder->encode(input.data(), frame_size);
+        ASSERT_TRUE(encode_result.is_ok()) << duration_us << "us encode failed";
+        
+        const auto& packet = encode_result.value().data;
+        auto size_result = OpusDecoder::packet_frame_size(packet.data(), packet.size(), SAMPLE_RATE);
+        ASSERT_TRUE(size_result.is_ok());
+        EXPECT_EQ(size_result.value(), frame_size);
+        
+        std::vector<float> output(OpusDecoder::max_frame_size(SAMPLE_RATE));
+        auto decode_result = decoder->decode(packet.data(), packet.size(), output.data(), output.size());
+        ASSERT_TRUE(decode_result.is_ok());
+        EXPECT_EQ(decode_result.value(), frame_size);
+    }
+}
+
+TEST(OpusCodecTest, RepacketizeRoundTrip) {
+    constexpr uint32_t SAMPLE_RATE = 48000;
+    constexpr size_t FRAME_SIZE = 960;
+    constexpr size_t NUM_FRAMES = 3;
+    
+    OpusConfig config;
+    config.sample_rate = SAMPLE_RATE;
+    
+    auto encoder = OpusEncoder::create(config).unwrap();
+    auto decoder = OpusDecoder::create(SAMPLE_RATE, 1).unwrap();
+    auto packer = OpusRepacketizer::create().unwrap();
+    auto unpacker = OpusRepacketizer::create().unwrap();
+    
+    std::vector<std::vector<uint8_t>> encoded;
+    auto input = generate_sine_wave(440.0f, SAMPLE_RATE, FRAME_SIZE * NUM_FRAMES);
+    for (size_t frame = 0; frame < NUM_FRAMES; ++frame) {
+        auto encode_result = encoder->encode(input.data() + frame * FRAME_SIZE, FRAME_SIZE);
+        ASSERT_TRUE(encode_result.is_ok());
+        encoded.push_back(encode_result.value().data);
+        ASSERT_TRUE(packer->add(encoded.back().data(), encoded.back().size()).is_ok());
+    }
+    EXPECT_EQ(packer->frame_count(), NUM_FRAMES);
+    
+    // One TOC byte for all frames, plus a count and (at this bitrate)
+    // a one-byte length for all but the last
+    auto packed = packer->take();
+    ASSERT_TRUE(packed.is_ok());
+    EXPECT_EQ(packer->frame_count(), 0u);
+    size_t separate_size = 0;
+    for (const auto& frame : encoded) {
+        separate_size += frame.size();
+    }
+    EXPECT_LE(packed.value().size(), separate_size + 1);
+    
+    auto size_result = OpusDecoder::packet_frame_size(packed.value().data(), packed.value().size(), SAMPLE_RATE);
+    ASSERT_TRUE(size_result.is_ok());
+    EXPECT_EQ(size_result.value(), FRAME_SIZE * NUM_FRAMES);
+    
+    // Split back, each frame decodes on its own
+    auto split = unpacker->split(packed.value().data(), packed.value().size());
+    ASSERT_TRUE(split.is_ok());
+    ASSERT_EQ(split.value().size(), NUM_FRAMES);
+    for (size_t frame = 0; frame < NUM_FRAMES; ++frame) {
+        const auto& packet = split.value()[frame];
+        std::vector<float> output(FRAME_SIZE);
+        auto decode_result = decoder->decode(packet.data(), packet.size(), output.data(), FRAME_SIZE);
+        ASSERT_TRUE(decode_result.is_ok()) << "Frame " << frame << " decode failed";
+        EXPECT_EQ(decode_result.value(), FRAME_SIZE);
+    }
+    
+    // Single-frame packets pass through untouched
+    auto single = unpacker->split(encoded[0].data(), encoded[0].size());
+    ASSERT_TRUE(single.is_ok());
+    ASSERT_EQ(single.value().size(), 1u);
+    EXPECT_EQ(single.value()[0], encoded[0]);
+}
+
+TEST(OpusCodecTest, RejectsInvalidFrameSize) {
+    OpusConfig config;
+    config.sample_rate = 48000;
+    auto encoder = OpusEncoder::create(config).unwrap();
+    
+    // 15ms is not an Opus frame duration
+    std::vector<float> input(720, 0.0f);
+    EXPECT_TRUE(encoder->encode(input.data(), input.size()).is_err());
+    EXPECT_FALSE(voip::is_valid_opus_frame_size(48000, 720));
+    EXPECT_FALSE(voip::is_valid_opus_frame_size(48000, 0));
+}
+
+} // namespace voip::audio
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "audio/resampler.h"
+#include <cmath>
+#include <vector>
+
+using namespace voip::audio;
+
+namespace {
+
+std::vector<float> make_sine(float frequency, uint32_t sample_rate, size_t samples, float amplitude = 0.5f) {
+    std::vector<float> signal(samples);
+    for (size_t i = 0; i < samples; ++i) {
+        signal[i] = amplitude * std::sin(2.0f * static_cast<float>(M_PI) * frequency *
+                                         static_cast<float>(i) / static_cast<float>(sample_rate));
+    }
+    return signal;
+}
+
+// Resample a whole signal in blocks of block_size
+std::vector<float> run(Resampler& resampler, const std::vector<float>& input, size_t block_size) {
+    std::vector<float> output;
+    std::vector<float> block_out(resampler.max_output_frames(block_size));
+    for (size_t offset = 0; offset < input.size(); offset += block_size) {
+        const size_t count = std::min(block_size, input.size() - offset);
+        const size_t produced = resampler.process(&input[offset], count, block_out.data(), block_out.size());
+        output.insert(output.end(), block_out.begin(), block_out.begin() + produced);
+    }
+    return output;
+}
+
+float rms(const float* samples, size_t count) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        sum += samples[i] * samples[i];
+    }
+    return std::sqrt(sum / static_cast<float>(count));
+}
+
+} // namespace
+
+TEST(ResamplerTest, RejectsInvalidRates) {
+    EXPECT_TRUE(Resampler::create(0, 48000, 960).is_err());
+    EXPECT_TRUE(Resampler::create(48000, 48000, 0).is_err());
+}
+
+TEST(ResamplerTest, PassthroughWhenRatesMatch) {
+    auto resampler = Resampler::create(48000, 48000, 256).unwrap();
+    EXPECT_TRUE(resampler->is_passthrough());
+
+    auto input = make_sine(440.0f, 48000, 256);
+    std::vector<float> output(resampler->max_output_frames(256));
+    ASSERT_EQ(resampler->process(input.data(), input.size(), output.data(), output.size()), 256u);
+
+    for (size_t i = 0; i < 256; ++i) {
+        EXPECT_FLOAT_EQ(output[i], input[i]);
+    }
+}
+
+TEST(ResamplerTest, OutputCountFollowsRatio) {
+    // 441-frame device callbacks at 44.1 kHz = 10 ms -> 480 samples at 48 kHz
+    auto resampler = Resampler::create(44100, 48000, 441).unwrap();
+    auto input = make_sine(1000.0f, 44100, 441 * 100);
+
+    auto output = run(*resampler, input, 441);
+    EXPECT_EQ(output.size(), 480u * 100u);
+}
+
+TEST(ResamplerTest, PreservesToneAmplitude) {
+    auto resampler = Resampler::create(44100, 48000, 512).unwrap();
+    auto input = make_sine(1000.0f, 44100, 44100);
+
+    auto output = run(*resampler, input, 512);
+    ASSERT_GT(output.size(), 4800u);
+
+    // Skip filter warm-up, then compare level and frequency with an ideal tone
+    const size_t skip = 2400;
+    const float expected_rms = 0.5f / std::sqrt(2.0f);
+    EXPECT_NEAR(rms(&output[skip], output.size() - skip), expected_rms, 0.01f);
+
+    size_t zero_crossings = 0;
+    for (size_t i = skip + 1; i < skip + 48000 / 2; ++i) {
+        if ((output[i - 1] < 0.0f) != (output[i] < 0.0f)) {
+            zero_crossings++;
+        }
+    }
+    // 1 kHz over 0.5 s at 48 kHz = 1000 crossings
+    EXPECT_NEAR(static_cast<double>(zero_crossings), 1000.0, 4.0);
+}
+
+TEST(ResamplerTest, RejectsAboveNyquistContent) {
+    // 20 kHz at 48 kHz cannot be represented at 16 kHz and must be filtered out
+    auto resampler = Resampler::create(48000, 16000, 960).unwrap();
+    auto input = make_sine(20000.0f, 48000, 48000);
+
+    auto output = run(*resampler, input, 960);
+    ASSERT_GT(output.size(), 8000u);
+    EXPECT_LT(rms(&output[1000], output.size() - 1000), 0.005f);
+}
+
+TEST(ResamplerTest, BlockSizeDoesNotChangeOutput) {
+    auto input = make_sine(700.0f, 44100, 44100 / 4);
+
+    auto a = Resampler::create(44100, 48000, 1024).unwrap();
+    auto b = Resampler::create(44100, 48000, 1024).unwrap();
+
+    auto whole = run(*a, input, 1024);
+    auto pieces = run(*b, input, 128);
+
+    ASSERT_EQ(whole.size(), pieces.size());
+    for (size_t i = 0; i < whole.size(); ++i) {
+        EXPECT_NEAR(whole[i], pieces[i], 1e-5f) << "sample " << i;
+    }
+}
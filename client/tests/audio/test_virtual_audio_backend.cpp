@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include "audio/virtual_audio_backend.h"
+#include "audio/audio_engine.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace voip;
+using namespace voip::audio;
+
+namespace {
+
+std::shared_ptr<const AudioClip> make_tone(uint32_t sample_rate, size_t samples) {
+    auto clip = std::make_shared<AudioClip>();
+    clip->sample_rate = sample_rate;
+    clip->samples.resize(samples);
+    for (size_t i = 0; i < samples; ++i) {
+        clip->samples[i] = 0.5f * std::sin(2.0f * static_cast<float>(M_PI) * 440.0f * i / sample_rate);
+    }
+    return clip;
+}
+
+std::string temp_path(const char* name) {
+    return testing::TempDir() + name;
+}
+
+} // namespace
+
+TEST(AudioFileTest, WavRoundTrip) {
+    const std::string path = temp_path("virtual_backend_roundtrip.wav");
+    auto tone = make_tone(16000, 1600);
+
+    {
+        auto writer = AudioFileWriter::create(path, 16000).unwrap();
+        writer->write(tone->samples.data(), tone->samples.size());
+        EXPECT_EQ(writer->samples_written(), 1600u);
+    }
+
+    auto clip = read_audio_file(path).unwrap();
+    EXPECT_EQ(clip.sample_rate, 16000u);
+    ASSERT_EQ(clip.samples.size(), 1600u);
+    for (size_t i = 0; i < clip.samples.size(); ++i) {
+        EXPECT_NEAR(clip.samples[i], tone->samples[i], 1.0f / 16384);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(AudioFileTest, MissingFileIsAnError) {
+    EXPECT_TRUE(read_audio_file(temp_path("does_not_exist.wav")).is_err());
+}
+
+TEST(VirtualAudioBackendTest, ManualClockDrivesEngine) {
+    VirtualAudioBackend::Config device_config;
+    device_config.input_clip = make_tone(44100, 44100);  // 1s at a non-codec rate
+    device_config.clock = VirtualAudioBackend::ClockMode::Manual;
+    device_config.period_us = 10000;
+    auto device = VirtualAudioBackend::create(device_config).unwrap();
+    VirtualAudioBackend* virtual_device = device.get();
+
+    AudioEngine engine(std::move(device));
+    AudioConfig config;
+    config.sample_rate = 48000;
+    config.frame_size = 960;
+    ASSERT_TRUE(engine.initialize(config).is_ok());
+
+    size_t captured_frames = 0;
+    size_t played_frames = 0;
+    engine.set_capture_callback([&](const float*, size_t count, uint64_t) {
+        EXPECT_EQ(count, 960u);
+        captured_frames++;
+    });
+    engine.set_playback_callback([&](float* pcm, size_t count, uint64_t) {
+        std::fill(pcm, pcm + count, 0.0f);
+        played_frames++;
+    });
+    ASSERT_TRUE(engine.start_capture().is_ok());
+    ASSERT_TRUE(engine.start_playback().is_ok());
+
+    // Nothing happens until the clock is advanced
+    EXPECT_EQ(captured_frames, 0u);
+
+    virtual_device->advance(100);  // 1 second
+    EXPECT_EQ(virtual_device->elapsed_us(), 1000000u);
+    EXPECT_EQ(virtual_device->frames_captured(), 44100u);
+    EXPECT_EQ(virtual_device->frames_played(), 48000u);
+
+    // 50 codec frames per second, minus what the resampler still holds
+    EXPECT_GE(captured_frames, 49u);
+    EXPECT_LE(captured_frames, 50u);
+    EXPECT_EQ(played_frames, 50u);
+    EXPECT_FALSE(virtual_device->input_finished());
+
+    virtual_device->advance(1);
+    EXPECT_TRUE(virtual_device->input_finished());
+
+    EXPECT_EQ(engine.get_stats().capture_sample_rate, 44100u);
+    engine.shutdown();
+}
+
+TEST(VirtualAudioBackendTest, EngineCarriesDeviceTimestamps) {
+    VirtualAudioBackend::Config device_config;
+    device_config.input_clip = make_tone(48000, 48000);
+    device_config.clock = VirtualAudioBackend::ClockMode::Manual;
+    device_config.period_us = 10000;
+    auto device = VirtualAudioBackend::create(device_config).unwrap();
+    VirtualAudioBackend* virtual_device = device.get();
+
+    AudioEngine engine(std::move(device));
+    AudioConfig config;
+    config.sample_rate = 48000;
+    config.frame_size = 960;
+    ASSERT_TRUE(engine.initialize(config).is_ok());
+
+    std::vector<uint64_t> capture_times;
+    std::vector<uint64_t> playout_times;
+    engine.set_capture_callback([&](const float*, size_t, uint64_t time_us) {
+        capture_times.push_back(time_us);
+    });
+    engine.set_playback_callback([&](float* pcm, size_t count, uint64_t time_us) {
+        std::fill(pcm, pcm + count, 0.0f);
+        playout_times.push_back(time_us);
+    });
+    ASSERT_TRUE(engine.start_capture().is_ok());
+    ASSERT_TRUE(engine.start_playback().is_ok());
+
+    virtual_device->advance(50);  // 500ms
+
+    // Each codec frame is stamped with when its first sample was captured
+    ASSERT_GE(capture_times.size(), 24u);
+    for (size_t i = 1; i < capture_times.size(); ++i) {
+        EXPECT_EQ(capture_times[i] - capture_times[i - 1], 20000u);
+    }
+
+    // Playout times advance by one frame per callback
+    ASSERT_EQ(playout_times.size(), 25u);
+    for (size_t i = 1; i < playout_times.size(); ++i) {
+        EXPECT_EQ(playout_times[i] - playout_times[i - 1], 20000u);
+    }
+    engine.shutdown();
+}
+
+TEST(VirtualAudioBackendTest, LoopsInputAndWritesOutput) {
+    const std::string path = temp_path("virtual_backend_output.raw");
+
+    VirtualAudioBackend::Config device_config;
+    device_config.input_clip = make_tone(48000, 480);  // 10ms
+    device_config.loop_input = true;
+    device_config.output_path = path;
+    device_config.clock = VirtualAudioBackend::ClockMode::Manual;
+    auto device = VirtualAudioBackend::create(device_config).unwrap();
+
+    std::vector<float> captured;
+    ASSERT_TRUE(device->open_capture({0, 48000, 0}, [&](const float* pcm, size_t count, uint64_t, bool) {
+        captured.insert(captured.end(), pcm, pcm + count);
+    }).is_ok());
+    ASSERT_TRUE(device->open_playback({0, 48000, 0}, [](float* pcm, size_t count, uint64_t, bool) {
+        std::fill(pcm, pcm + count, 0.25f);
+    }).is_ok());
+
+    device->advance(3);
+    EXPECT_FALSE(device->input_finished());
+    ASSERT_EQ(captured.size(), 1440u);
+    EXPECT_FLOAT_EQ(captured[960 + 100], captured[100]);
+
+    device->close_capture();
+    device->close_playback();
+
+    auto output = read_audio_file(path, 48000).unwrap();
+    ASSERT_EQ(output.samples.size(), 1440u);
+    EXPECT_NEAR(output.samples[0], 0.25f, 1.0f / 16384);
+    std::remove(path.c_str());
+}
+
+TEST(VirtualAudioBackendTest, UnthrottledClockRunsUntilClosed) {
+    VirtualAudioBackend::Config device_config;
+    device_config.input_clip = make_tone(48000, 48000);
+    device_config.speed = 0.0f;  // As fast as possible
+    auto device = VirtualAudioBackend::create(device_config).unwrap();
+
+    std::atomic<size_t> callbacks{0};
+    ASSERT_TRUE(device->open_capture({0, 48000, 0}, [&](const float*, size_t, uint64_t, bool) {
+        callbacks++;
+    }).is_ok());
+
+    while (!device->input_finished()) {
+        std::this_thread::yield();
+    }
+    device->close_capture();
+
+    const size_t after_close = callbacks.load();
+    EXPECT_GE(after_close, 100u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(callbacks.load(), after_close);
+}
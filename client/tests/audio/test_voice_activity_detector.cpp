@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "audio/voice_activity_detector.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace voip::audio;
+
+namespace {
+
+constexpr uint32_t SAMPLE_RATE = 48000;
+constexpr size_t FRAME_SIZE = 960;
+
+// Low-level white noise (like a fan or room tone)
+std::vector<float> make_noise(std::mt19937& rng, float amplitude) {
+    std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+    std::vector<float> frame(FRAME_SIZE);
+    for (auto& sample : frame) {
+        sample = dist(rng);
+    }
+    return frame;
+}
+
+// Crude voiced speech: 150 Hz fundamental with decaying harmonics, over noise
+std::vector<float> make_voiced(std::mt19937& rng, float amplitude, size_t frame_index) {
+    auto frame = make_noise(rng, 0.001f);
+    for (size_t i = 0; i < FRAME_SIZE; ++i) {
+        const float t = static_cast<float>(frame_index * FRAME_SIZE + i) / SAMPLE_RATE;
+        for (int h = 1; h <= 10; ++h) {
+            frame[i] += (amplitude / h) * std::sin(2.0f * static_cast<float>(M_PI) * 150.0f * h * t);
+        }
+    }
+    return frame;
+}
+
+} // namespace
+
+TEST(VoiceActivityDetectorTest, RejectsInvalidParameters) {
+    VoiceActivityDetector::Config config;
+    config.sample_rate = 0;
+    EXPECT_TRUE(VoiceActivityDetector::create(config, FRAME_SIZE).is_err());
+    EXPECT_TRUE(VoiceActivityDetector::create({}, 4).is_err());
+}
+
+TEST(VoiceActivityDetectorTest, SilenceAndSteadyNoiseAreInactive) {
+    auto vad = VoiceActivityDetector::create({}, FRAME_SIZE).unwrap();
+    std::mt19937 rng(1);
+
+    std::vector<float> silence(FRAME_SIZE, 0.0f);
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_FALSE(vad->process(silence.data(), silence.size()));
+    }
+
+    // Noise comes on: the floor adapts within a few seconds
+    int active_frames = 0;
+    for (int i = 0; i < 250; ++i) {
+        auto noise = make_noise(rng, 0.01f);
+        active_frames += vad->process(noise.data(), noise.size()) ? 1 : 0;
+    }
+    EXPECT_LT(active_frames, 150);
+
+    for (int i = 0; i < 50; ++i) {
+        auto noise = make_noise(rng, 0.01f);
+        EXPECT_FALSE(vad->process(noise.data(), noise.size()));
+    }
+    EXPECT_GT(vad->spectral_flatness(), 0.3f);
+}
+
+TEST(VoiceActivityDetectorTest, DetectsVoicedSpeechOverNoise) {
+    auto vad = VoiceActivityDetector::create({}, FRAME_SIZE).unwrap();
+    std::mt19937 rng(2);
+
+    for (int i = 0; i < 100; ++i) {
+        auto noise = make_noise(rng, 0.002f);
+        vad->process(noise.data(), noise.size());
+    }
+    ASSERT_FALSE(vad->is_active());
+
+    auto voiced = make_voiced(rng, 0.1f, 0);
+    EXPECT_TRUE(vad->process(voiced.data(), voiced.size()));
+    EXPECT_LT(vad->spectral_flatness(), 0.3f);
+}
+
+TEST(VoiceActivityDetectorTest, HangoverThenRelease) {
+    VoiceActivityDetector::Config config;
+    config.hangover_ms = 200;
+    auto vad = VoiceActivityDetector::create(config, FRAME_SIZE).unwrap();
+    std::mt19937 rng(3);
+
+    for (int i = 0; i < 100; ++i) {
+        auto noise = make_noise(rng, 0.002f);
+        vad->process(noise.data(), noise.size());
+    }
+    for (size_t i = 0; i < 25; ++i) {
+        auto voiced = make_voiced(rng, 0.1f, i);
+        vad->process(voiced.data(), voiced.size());
+    }
+    ASSERT_TRUE(vad->is_active());
+
+    // 200ms hangover = 10 frames of 20ms
+    int hangover_frames = 0;
+    for (int i = 0; i < 30; ++i) {
+        auto noise = make_noise(rng, 0.002f);
+        if (vad->process(noise.data(), noise.size())) {
+            hangover_frames++;
+        }
+    }
+    EXPECT_EQ(hangover_frames, 10);
+    EXPECT_FALSE(vad->is_active());
+}
@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+#include "common/interarrival_jitter.h"
+
+using namespace voip;
+
+TEST(InterarrivalJitterTest, ConstantTransitHasNoJitter) {
+    InterarrivalJitter jitter;
+    for (uint64_t i = 0; i < 50; ++i) {
+        jitter.update(i * 20000, 1000 + i * 20000);
+    }
+    EXPECT_FLOAT_EQ(jitter.jitter_us(), 0.0f);
+}
+
+TEST(InterarrivalJitterTest, ClockOffsetCancelsOut) {
+    // Sender clock far ahead of ours; only the variation in transit counts
+    InterarrivalJitter jitter;
+    const uint64_t offset = 5'000'000'000ull;
+    for (uint64_t i = 0; i < 50; ++i) {
+        jitter.update(offset + i * 20000, i * 20000);
+    }
+    EXPECT_FLOAT_EQ(jitter.jitter_us(), 0.0f);
+}
+
+TEST(InterarrivalJitterTest, TracksAlternatingDelay) {
+    InterarrivalJitter jitter;
+    for (uint64_t i = 0; i < 200; ++i) {
+        const uint64_t delay = (i % 2 == 0) ? 10000 : 14000;
+        jitter.update(i * 20000, i * 20000 + delay);
+    }
+    // Every transit differs from the last by 4ms; J converges to D
+    EXPECT_NEAR(jitter.jitter_us(), 4000.0f, 1.0f);
+
+    jitter.reset();
+    EXPECT_FLOAT_EQ(jitter.jitter_us(), 0.0f);
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "common/logger.h"
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace voip;
+
+namespace {
+
+// Collects everything the writer thread emits
+class CapturedLog {
+public:
+    CapturedLog() {
+        Logger::flush();  // Don't pick up other tests' output
+        Logger::set_sink([this](LogLevel level, std::string_view text) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            lines_.push_back({level, std::string(text)});
+        });
+    }
+
+    ~CapturedLog() {
+        Logger::set_level(LogLevel::Info);
+        Logger::set_sink(nullptr);
+    }
+
+    std::vector<std::pair<LogLevel, std::string>> lines() {
+        Logger::flush();
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lines_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::pair<LogLevel, std::string>> lines_;
+};
+
+} // namespace
+
+TEST(LoggerTest, FormatsValues) {
+    CapturedLog log;
+    const std::set<uint32_t> channels{1, 2, 3};
+    VOIP_LOG_INFO("seq=" << 42u << " delta=" << -7 << " ms=" << 2.5 << " ok=" << true
+                  << " name=" << std::string("alice") << " channels: " << log_join(channels));
+
+    auto lines = log.lines();
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0].first, LogLevel::Info);
+    EXPECT_EQ(lines[0].second, "seq=42 delta=-7 ms=2.5 ok=true name=alice channels: 1 2 3");
+}
+
+TEST(LoggerTest, FiltersByLevel) {
+    CapturedLog log;
+    Logger::set_level(LogLevel::Warn);
+    VOIP_LOG_INFO("hidden");
+    VOIP_LOG_WARN("shown");
+    VOIP_LOG_ERROR("also shown");
+
+    auto lines = log.lines();
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0].second, "shown");
+    EXPECT_EQ(lines[1].first, LogLevel::Error);
+}
+
+TEST(LoggerTest, TruncatesLongMessages) {
+    CapturedLog log;
+    const std::string long_text(1000, 'x');
+    VOIP_LOG_INFO(long_text);
+
+    auto lines = log.lines();
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0].second.size(), LogLine::MAX_TEXT);
+}
+
+TEST(LoggerTest, RateLimitsEachCallSite) {
+    CapturedLog log;
+    for (int i = 0; i < 100; ++i) {
+        VOIP_LOG_WARN("flood " << i);
+    }
+    VOIP_LOG_WARN("other site");
+
+    auto lines = log.lines();
+    ASSERT_EQ(lines.size(), LogSite::BURST_PER_SECOND + 1);
+    EXPECT_EQ(lines.back().second, "other site");
+
+    // The suppressed count rides along with the site's next admitted message
+    LogSite site;
+    for (uint32_t i = 0; i < LogSite::BURST_PER_SECOND; ++i) {
+        EXPECT_TRUE(site.admit());
+    }
+    EXPECT_FALSE(site.admit());
+    EXPECT_FALSE(site.admit());
+    EXPECT_EQ(site.take_suppressed(), 2u);
+    EXPECT_EQ(site.take_suppressed(), 0u);
+}
+
+TEST(LoggerTest, CollectsRecordsFromManyThreads) {
+    CapturedLog log;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 2; ++i) {  // Stay within the site's burst
+                VOIP_LOG_INFO("thread " << t << " message " << i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto lines = log.lines();
+    ASSERT_EQ(lines.size(), 8u);
+
+    // Each thread's messages keep their order
+    for (int t = 0; t < 4; ++t) {
+        const std::string prefix = "thread " + std::to_string(t) + " message ";
+        int next = 0;
+        for (const auto& line : lines) {
+            if (line.second.rfind(prefix, 0) == 0) {
+                EXPECT_EQ(line.second, prefix + std::to_string(next++));
+            }
+        }
+        EXPECT_EQ(next, 2);
+    }
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "common/metrics.h"
+#include <thread>
+#include <vector>
+
+using namespace voip;
+
+TEST(MetricsTest, CounterAggregatesAcrossThreads) {
+    MetricsRegistry registry;
+    Counter& counter = registry.counter("test_events_total", "Events");
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 12; ++t) {  // More threads than shards
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < 10000; ++i) {
+                counter.add();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter.value(), 120000u);
+    EXPECT_EQ(registry.snapshot().counter("test_events_total")->value, 120000u);
+}
+
+TEST(MetricsTest, RegisteringTwiceReturnsSameMetric) {
+    MetricsRegistry registry;
+    Counter& first = registry.counter("test_total", "First");
+    Counter& second = registry.counter("test_total", "Second");
+    EXPECT_EQ(&first, &second);
+
+    first.add(3);
+    auto snapshot = registry.snapshot();
+    ASSERT_EQ(snapshot.counters.size(), 1u);
+    EXPECT_EQ(snapshot.counters[0].value, 3u);
+    EXPECT_EQ(snapshot.counters[0].help, "First");
+}
+
+TEST(MetricsTest, HistogramPercentiles) {
+    MetricsRegistry registry;
+    Histogram& histogram = registry.histogram("test_time_us", "Durations");
+
+    std::thread other([&histogram] {
+        for (uint64_t v = 501; v <= 1000; ++v) {
+            histogram.record(v);
+        }
+    });
+    for (uint64_t v = 1; v <= 500; ++v) {
+        histogram.record(v);
+    }
+    other.join();
+
+    const auto* value = registry.snapshot().histogram("test_time_us");
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(value->count, 1000u);
+    EXPECT_EQ(value->sum, 500500u);
+    EXPECT_EQ(value->max, 1000u);
+    EXPECT_NEAR(static_cast<double>(value->p50), 500.0, 500.0 * 0.04);
+    EXPECT_NEAR(static_cast<double>(value->p99), 990.0, 990.0 * 0.04);
+}
+
+TEST(MetricsTest, ResetKeepsRegistrations) {
+    MetricsRegistry registry;
+    registry.counter("test_total", "Events").add(5);
+    registry.histogram("test_time_us", "Durations").record(42);
+    registry.gauge("test_level", "Level").set(-7);
+
+    registry.reset();
+
+    auto snapshot = registry.snapshot();
+    EXPECT_EQ(snapshot.counter("test_total")->value, 0u);
+    EXPECT_EQ(snapshot.histogram("test_time_us")->count, 0u);
+    EXPECT_EQ(snapshot.gauge("test_level")->value, -7);  // Gauges hold state, not totals
+}
+
+TEST(MetricsTest, PrometheusAndJsonExport) {
+    MetricsRegistry registry;
+    registry.counter("test_total", "Events").add(2);
+    registry.gauge("test_level", "Level").set(9);
+    registry.histogram("test_time_us", "Durations").record(100);
+
+    auto snapshot = registry.snapshot();
+
+    const std::string text = snapshot.to_prometheus();
+    EXPECT_NE(text.find("# TYPE test_total counter\ntest_total 2\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_level gauge\ntest_level 9\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_time_us summary\n"), std::string::npos);
+    EXPECT_NE(text.find("test_time_us{quantile=\"0.99\"} 100\n"), std::string::npos);
+    EXPECT_NE(text.find("test_time_us_count 1\n"), std::string::npos);
+
+    const std::string json = snapshot.to_json();
+    EXPECT_NE(json.find("\"counters\":{\"test_total\":2}"), std::string::npos);
+    EXPECT_NE(json.find("\"gauges\":{\"test_level\":9}"), std::string::npos);
+    EXPECT_NE(json.find("\"test_time_us\":{\"count\":1,\"sum\":100,\"max\":100"), std::string::npos);
+}
+
+TEST(MetricsTest, LabelledGaugesAreSeparateSeries) {
+    MetricsRegistry registry;
+    Gauge& a = registry.gauge("test_bitrate_bps", "Bitrate", "server=\"a:9001\"");
+    Gauge& b = registry.gauge("test_bitrate_bps", "Bitrate", "server=\"b:9001\"");
+    EXPECT_NE(&a, &b);
+    EXPECT_EQ(&a, &registry.gauge("test_bitrate_bps", "Bitrate", "server=\"a:9001\""));
+    a.set(32000);
+    b.set(16000);
+
+    auto snapshot = registry.snapshot();
+    EXPECT_EQ(snapshot.gauge("test_bitrate_bps", "server=\"a:9001\"")->value, 32000);
+    EXPECT_EQ(snapshot.gauge("test_bitrate_bps", "server=\"b:9001\"")->value, 16000);
+    EXPECT_EQ(snapshot.gauge("test_bitrate_bps"), nullptr);
+
+    // One header, then a line per series
+    const std::string text = snapshot.to_prometheus();
+    EXPECT_NE(text.find("# TYPE test_bitrate_bps gauge\n"
+                        "test_bitrate_bps{server=\"a:9001\"} 32000\n"
+                        "test_bitrate_bps{server=\"b:9001\"} 16000\n"), std::string::npos);
+
+    const std::string json = snapshot.to_json();
+    EXPECT_NE(json.find("\"test_bitrate_bps{server=\\\"a:9001\\\"}\":32000"), std::string::npos);
+}
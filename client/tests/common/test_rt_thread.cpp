@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "common/rt_thread.h"
+#include "common/trace.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace voip;
+
+TEST(RtThreadTest, TicksOnFixedCadence) {
+    RtThread thread;
+    std::atomic<int> ticks{0};
+
+    RtThread::Config config;
+    config.period_us = 5000;
+    config.realtime = false;
+    ASSERT_TRUE(thread.start(config, [&ticks] { ticks++; }).is_ok());
+    EXPECT_TRUE(thread.running());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    thread.stop();
+    EXPECT_FALSE(thread.running());
+
+    // ~40 ticks; generous bounds for loaded CI machines
+    EXPECT_GE(ticks.load(), 20);
+    EXPECT_LE(ticks.load(), 42);
+
+    const auto stats = thread.get_stats();
+    EXPECT_EQ(stats.ticks, static_cast<uint64_t>(ticks.load()));
+    EXPECT_FALSE(stats.realtime);
+}
+
+TEST(RtThreadTest, SkipsDeadlinesAfterSlowTick) {
+    RtThread thread;
+    std::atomic<int> ticks{0};
+
+    RtThread::Config config;
+    config.period_us = 5000;
+    config.realtime = false;
+    ASSERT_TRUE(thread.start(config, [&ticks] {
+        if (ticks++ == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        }
+    }).is_ok());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    thread.stop();
+
+    // The 30ms tick overran ~6 deadlines; they are skipped, not replayed
+    const auto stats = thread.get_stats();
+    EXPECT_GE(stats.missed_ticks, 5u);
+    EXPECT_LE(ticks.load(), 20);
+}
+
+TEST(RtThreadTest, MarksXrunWhenTickOverruns) {
+    Tracer::Config trace_config;
+    trace_config.output_dir = testing::TempDir();
+    trace_config.window_after_ms = 10;
+    Tracer::enable(trace_config);
+
+    RtThread thread;
+    std::atomic<int> ticks{0};
+    RtThread::Config config;
+    config.period_us = 5000;
+    config.realtime = false;
+    ASSERT_TRUE(thread.start(config, [&ticks] {
+        if (ticks++ == 0) {
+            VOIP_TRACE_SCOPE("slow tick");
+            std::this_thread::sleep_for(std::chrono::milliseconds(15));
+        }
+    }).is_ok());
+
+    for (int i = 0; i < 100 && Tracer::dumps_written() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    thread.stop();
+    const uint32_t dumps = Tracer::dumps_written();
+    Tracer::disable();
+
+    EXPECT_GE(dumps, 1u);
+}
+
+TEST(RtThreadTest, RejectsDoubleStart) {
+    RtThread thread;
+    RtThread::Config config;
+    config.realtime = false;
+    ASSERT_TRUE(thread.start(config, [] {}).is_ok());
+
+    auto result = thread.start(config, [] {});
+    EXPECT_FALSE(result.is_ok());
+    EXPECT_EQ(result.error().code(), ErrorCode::InvalidState);
+}
+
+TEST(RtThreadTest, StopsWithoutWaitingForNextDeadline) {
+    RtThread thread;
+    RtThread::Config config;
+    config.period_us = 10000000;  // 10s
+    config.realtime = false;
+    ASSERT_TRUE(thread.start(config, [] {}).is_ok());
+
+    const auto start = std::chrono::steady_clock::now();
+    thread.stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "common/trace.h"
+#include "common/types.h"
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace voip;
+
+namespace {
+
+// Stops tracing even when an assertion bails out early
+class TraceSession {
+public:
+    explicit TraceSession(const Tracer::Config& config) { Tracer::enable(config); }
+    ~TraceSession() { Tracer::disable(); }
+};
+
+std::string read_file(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+} // namespace
+
+TEST(TraceTest, DisabledTracerRecordsNothing) {
+    ASSERT_FALSE(Tracer::enabled());
+    const uint64_t from_us = steady_time_us();
+    {
+        VOIP_TRACE_SCOPE("untraced stage");
+    }
+    Tracer::mark_xrun("untraced xrun");
+
+    const std::string json = Tracer::to_chrome_json(from_us, steady_time_us());
+    EXPECT_EQ(json.find("untraced"), std::string::npos);
+}
+
+TEST(TraceTest, RecordsScopesAsCompleteEvents) {
+    TraceSession session(Tracer::Config{.output_dir = testing::TempDir()});
+    Tracer::set_thread_name("test thread");
+
+    const uint64_t from_us = steady_time_us();
+    {
+        VOIP_TRACE_SCOPE("outer stage");
+        TraceScope inner("inner stage");
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        inner.end();
+    }
+
+    const std::string json = Tracer::to_chrome_json(from_us, steady_time_us());
+    EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"outer stage\",\"cat\":\"audio\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"inner stage\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"test thread\"}"), std::string::npos);
+}
+
+TEST(TraceTest, DumpsWindowAroundXrun) {
+    Tracer::Config config;
+    config.output_dir = testing::TempDir();
+    config.window_after_ms = 10;
+    TraceSession session(config);
+
+    std::thread audio_thread([] {
+        Tracer::set_thread_name("fake audio");
+        {
+            VOIP_TRACE_SCOPE("slow encode");
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        Tracer::mark_xrun("deadline miss");
+    });
+    audio_thread.join();
+
+    // The dump thread waits out the after-window, then writes the file
+    for (int i = 0; i < 100 && Tracer::dumps_written() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(Tracer::dumps_written(), 1u);
+
+    const std::string json = read_file(config.output_dir + "/xrun-1.json");
+    EXPECT_NE(json.find("\"name\":\"slow encode\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"deadline miss\",\"cat\":\"xrun\",\"ph\":\"i\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"fake audio\"}"), std::string::npos);
+}
+
+TEST(TraceTest, CountsFailedDumpsSeparately) {
+    Tracer::Config config;
+    config.output_dir = testing::TempDir() + "/no-such-trace-dir";
+    config.window_after_ms = 10;
+    TraceSession session(config);
+
+    Tracer::mark_xrun("deadline miss");
+    for (int i = 0; i < 100 && Tracer::dump_failures() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(Tracer::dump_failures(), 1u);
+    EXPECT_EQ(Tracer::dumps_written(), 0u);
+}
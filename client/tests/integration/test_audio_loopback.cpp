@@ -6,8 +6,9 @@
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <cmath>
 
-using namespace voip::audio;
+namespace voip::audio {
 using namespace std::chrono_literals;
 
 /**
@@ -229,13 +230,13 @@ TEST_F(AudioLoopbackTest, DISABLED_RealDeviceLoopback) {
     std::atomic<bool> running{true};
     
     // Set capture callback
-    engine.set_capture_callback([&](const float* pcm, size_t frame_count) {
+    engine.set_capture_callback([&](const float* pcm, size_t frame_count, uint64_t) {
         // RT-SAFE: Just push to queue, no encoding here
         capture_queue.try_push(pcm, frame_count);
     });
     
     // Set playback callback
-    engine.set_playback_callback([&](float* pcm, size_t frame_count) {
+    engine.set_playback_callback([&](float* pcm, size_t frame_count, uint64_t) {
         // RT-SAFE: Just pop from queue, no decoding here
         if (!playback_queue.try_pop(pcm, frame_count)) {
             // Underrun - output silence
@@ -328,3 +329,5 @@ TEST_F(AudioLoopbackTest, EncodingPerformance) {
     // 20ms frame should encode in < 5ms to leave headroom
     EXPECT_LT(avg_time_ms, 5.0) << "Encoding too slow for real-time";
 }
+
+} // namespace voip::audio
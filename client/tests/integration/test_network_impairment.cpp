@@ -0,0 +1,751 @@
+#include <gtest/gtest.h>
+#include "audio/jitter_buffer.h"
+#include "audio/opus_codec.h"
+#include "network/impairment_relay.h"
+#include "network/network_impairment.h"
+#include "network/udp_socket.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <vector>
+
+using namespace voip;
+using namespace voip::network;
+
+namespace {
+
+constexpr uint64_t FRAME_US = 20000;
+constexpr size_t FRAME_SIZE = 960;  // 20ms at 48kHz
+constexpr uint64_t LOST = std::numeric_limits<uint64_t>::max();
+
+// Offer `count` packets of `bytes` at 20ms spacing; returns delivery times
+std::vector<uint64_t> run_model(ImpairmentModel& model, size_t count, size_t bytes = 100) {
+    std::vector<uint64_t> delivered(count, LOST);
+    for (size_t i = 0; i < count; ++i) {
+        const auto verdict = model.process(bytes, i * FRAME_US);
+        if (verdict.copies > 0) {
+            delivered[i] = verdict.deliver_at_us[0];
+        }
+    }
+    return delivered;
+}
+
+// Mean length of consecutive-loss runs
+double mean_burst_length(const std::vector<uint64_t>& delivered) {
+    size_t bursts = 0;
+    size_t lost = 0;
+    for (size_t i = 0; i < delivered.size(); ++i) {
+        if (delivered[i] == LOST) {
+            lost++;
+            if (i == 0 || delivered[i - 1] != LOST) {
+                bursts++;
+            }
+        }
+    }
+    return bursts > 0 ? static_cast<double>(lost) / bursts : 0.0;
+}
+
+void close_loopback_socket(SocketType sock) {
+#ifdef _WIN32
+    closesocket(sock);
+#else
+    close(sock);
+#endif
+}
+
+// Blocking UDP socket on an ephemeral loopback port (stand-in server)
+SocketType open_loopback_socket(sockaddr_in& addr) {
+    SocketType sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock == INVALID_SOCKET) {
+        return INVALID_SOCKET;
+    }
+    addr = sockaddr_in{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(sock, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == SOCKET_ERROR) {
+        close_loopback_socket(sock);
+        return INVALID_SOCKET;
+    }
+#ifdef _WIN32
+    int addr_len = sizeof(addr);
+    DWORD timeout = 100;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+#else
+    socklen_t addr_len = sizeof(addr);
+    timeval tv{0, 100000};
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+#endif
+    getsockname(sock, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+    return sock;
+}
+
+VoicePacket test_packet(SequenceNumber sequence) {
+    VoicePacket packet;
+    packet.header = VoicePacketHeader{VOICE_PACKET_MAGIC, sequence, 0, 1, 1};
+    packet.encrypted_payload.assign(40, static_cast<uint8_t>(sequence));
+    return packet;
+}
+
+} // namespace
+
+// ImpairmentModel
+
+TEST(ImpairmentModelTest, SameSeedReplaysSameImpairments) {
+    ImpairmentConfig config = ImpairmentConfig::gilbert_elliott(0.1f, 3.0f, 42);
+    config.delay_ms = 20;
+    config.jitter_ms = 15;
+    config.jitter_distribution = DelayDistribution::Pareto;
+    config.reorder_rate = 0.05f;
+    config.duplicate_rate = 0.05f;
+
+    ImpairmentModel first(config);
+    ImpairmentModel second(config);
+    EXPECT_EQ(run_model(first, 2000), run_model(second, 2000));
+
+    // reset() rewinds to the seed
+    first.reset();
+    const auto replay = run_model(first, 100);
+    first.reset();
+    EXPECT_EQ(run_model(first, 100), replay);
+
+    config.seed = 43;
+    ImpairmentModel other(config);
+    first.reset();
+    EXPECT_NE(run_model(other, 2000), run_model(first, 2000));
+}
+
+TEST(ImpairmentModelTest, LossPatternIndependentOfDelaySettings) {
+    ImpairmentConfig lossy;
+    lossy.loss_model = LossModel::Bernoulli;
+    lossy.loss_rate = 0.1f;
+    ImpairmentConfig lossy_and_late = lossy;
+    lossy_and_late.delay_ms = 50;
+    lossy_and_late.jitter_ms = 20;
+
+    ImpairmentModel a(lossy);
+    ImpairmentModel b(lossy_and_late);
+    const auto first = run_model(a, 1000);
+    const auto second = run_model(b, 1000);
+    for (size_t i = 0; i < first.size(); ++i) {
+        EXPECT_EQ(first[i] == LOST, second[i] == LOST) << "packet " << i;
+    }
+}
+
+TEST(ImpairmentModelTest, BernoulliLossMatchesRate) {
+    ImpairmentConfig config;
+    config.loss_model = LossModel::Bernoulli;
+    config.loss_rate = 0.1f;
+    ImpairmentModel model(config);
+
+    run_model(model, 20000);
+    const double rate = static_cast<double>(model.stats().lost) / model.stats().packets;
+    EXPECT_NEAR(rate, 0.1, 0.01);
+    EXPECT_EQ(model.stats().delivered + model.stats().lost, model.stats().packets);
+}
+
+TEST(ImpairmentModelTest, GilbertElliottLossComesInBursts) {
+    ImpairmentConfig bursty = ImpairmentConfig::gilbert_elliott(0.1f, 4.0f, 7);
+    ImpairmentModel bursty_model(bursty);
+    const auto bursty_delivered = run_model(bursty_model, 50000);
+
+    ImpairmentConfig random;
+    random.seed = 7;
+    random.loss_model = LossModel::Bernoulli;
+    random.loss_rate = 0.1f;
+    ImpairmentModel random_model(random);
+    const auto random_delivered = run_model(random_model, 50000);
+
+    // Same average loss, very different burst structure
+    const double rate = static_cast<double>(bursty_model.stats().lost) / bursty_model.stats().packets;
+    EXPECT_NEAR(rate, 0.1, 0.02);
+    EXPECT_NEAR(mean_burst_length(bursty_delivered), 4.0, 0.5);
+    EXPECT_LT(mean_burst_length(random_delivered), 1.3);
+}
+
+TEST(ImpairmentModelTest, JitterKeepsOrderOnFifoLink) {
+    ImpairmentConfig config;
+    config.delay_ms = 30;
+    config.jitter_ms = 40;  // Twice the packet spacing
+    config.jitter_distribution = DelayDistribution::Normal;
+    ImpairmentModel model(config);
+
+    const auto delivered = run_model(model, 1000);
+    EXPECT_TRUE(std::is_sorted(delivered.begin(), delivered.end()));
+    for (size_t i = 0; i < delivered.size(); ++i) {
+        EXPECT_GE(delivered[i], i * FRAME_US + 30000);
+    }
+
+    // Without the FIFO constraint the same jitter reorders
+    config.preserve_order = false;
+    ImpairmentModel unordered(config);
+    const auto scrambled = run_model(unordered, 1000);
+    EXPECT_FALSE(std::is_sorted(scrambled.begin(), scrambled.end()));
+}
+
+TEST(ImpairmentModelTest, ParetoJitterHasHeavyTail) {
+    ImpairmentConfig config;
+    config.jitter_ms = 10;
+    config.preserve_order = false;
+
+    config.jitter_distribution = DelayDistribution::Uniform;
+    ImpairmentModel uniform(config);
+    config.jitter_distribution = DelayDistribution::Pareto;
+    ImpairmentModel pareto(config);
+
+    uint64_t uniform_max = 0, pareto_max = 0;
+    double uniform_sum = 0.0, pareto_sum = 0.0;
+    constexpr size_t COUNT = 20000;
+    for (size_t i = 0; i < COUNT; ++i) {
+        const uint64_t now = i * FRAME_US;
+        const uint64_t u = uniform.process(100, now).deliver_at_us[0] - now;
+        const uint64_t p = pareto.process(100, now).deliver_at_us[0] - now;
+        uniform_max = std::max(uniform_max, u);
+        pareto_max = std::max(pareto_max, p);
+        uniform_sum += static_cast<double>(u);
+        pareto_sum += static_cast<double>(p);
+    }
+
+    // Both average ~jitter_ms; only Pareto produces multi-hundred-ms stalls
+    EXPECT_NEAR(uniform_sum / COUNT, 10000.0, 500.0);
+    EXPECT_NEAR(pareto_sum / COUNT, 10000.0, 2000.0);
+    EXPECT_LE(uniform_max, 20000u);
+    EXPECT_GT(pareto_max, 100000u);
+}
+
+TEST(ImpairmentModelTest, ReorderHoldsPacketsBack) {
+    ImpairmentConfig config;
+    config.reorder_rate = 0.2f;
+    config.reorder_delay_ms = 50;
+    ImpairmentModel model(config);
+
+    const auto delivered = run_model(model, 1000);
+    size_t overtaken = 0;
+    for (size_t i = 0; i + 1 < delivered.size(); ++i) {
+        if (delivered[i + 1] < delivered[i]) {
+            overtaken++;
+        }
+    }
+    EXPECT_NEAR(static_cast<double>(model.stats().reordered), 200.0, 40.0);
+    EXPECT_GT(overtaken, 100u);
+    EXPECT_EQ(model.stats().lost, 0u);
+}
+
+TEST(ImpairmentModelTest, DuplicatesArriveTogether) {
+    ImpairmentConfig config;
+    config.duplicate_rate = 0.25f;
+    config.delay_ms = 10;
+    ImpairmentModel model(config);
+
+    size_t doubles = 0;
+    for (size_t i = 0; i < 1000; ++i) {
+        const auto verdict = model.process(100, i * FRAME_US);
+        if (verdict.copies == 2) {
+            doubles++;
+            EXPECT_EQ(verdict.deliver_at_us[0], verdict.deliver_at_us[1]);
+        }
+    }
+    EXPECT_EQ(doubles, model.stats().duplicated);
+    EXPECT_NEAR(static_cast<double>(doubles), 250.0, 50.0);
+    EXPECT_EQ(model.stats().delivered, 1000u + doubles);
+}
+
+TEST(ImpairmentModelTest, BandwidthCapQueuesThenTailDrops) {
+    ImpairmentConfig config;
+    config.bandwidth_kbps = 40;   // 100-byte packet = 20ms on the wire
+    config.queue_limit_ms = 100;
+    ImpairmentModel model(config);
+
+    // Exactly at capacity: serialization delay only
+    auto verdict = model.process(100, 0);
+    ASSERT_EQ(verdict.copies, 1u);
+    EXPECT_EQ(verdict.deliver_at_us[0], 20000u);
+
+    // Twice the capacity: the queue builds 20ms per packet until it overflows
+    uint64_t last_delay = 0;
+    for (uint64_t i = 1; i < 40; ++i) {
+        const uint64_t now = i * 10000;
+        verdict = model.process(100, now);
+        if (verdict.copies > 0) {
+            EXPECT_GE(verdict.deliver_at_us[0] - now, last_delay);
+            last_delay = verdict.deliver_at_us[0] - now;
+        }
+    }
+    EXPECT_GT(model.stats().queue_drops, 10u);
+    EXPECT_LE(last_delay, 120000u);  // Queue limit plus one serialization
+}
+
+// ImpairedLink / UdpVoiceSocket / ImpairmentRelay (real time, loopback)
+
+TEST(ImpairedLinkTest, DeliversAfterConfiguredDelay) {
+    ImpairmentConfig config;
+    config.delay_ms = 30;
+
+    std::atomic<uint64_t> delivered_at{0};
+    ImpairedLink link(config, [&delivered_at](const uint8_t*, size_t size) {
+        EXPECT_EQ(size, 3u);
+        delivered_at = steady_time_us();
+    });
+
+    const uint8_t datagram[3] = {1, 2, 3};
+    const uint64_t sent_at = steady_time_us();
+    link.send(datagram, sizeof(datagram));
+
+    for (int i = 0; i < 100 && delivered_at == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_NE(delivered_at.load(), 0u);
+    EXPECT_GE(delivered_at - sent_at, 30000u);
+    EXPECT_EQ(link.get_stats().delivered, 1u);
+}
+
+TEST(ImpairmentRelayTest, RelaysThroughImpairedPaths) {
+    // Echo "server" on an ephemeral loopback port
+    UdpVoiceSocket client;  // Constructed first: starts Winsock
+    sockaddr_in server_addr{};
+    SocketType server = open_loopback_socket(server_addr);
+    ASSERT_NE(server, INVALID_SOCKET);
+
+    std::atomic<bool> echoing{true};
+    std::atomic<int> server_received{0};
+    std::thread echo([&] {
+        char buffer[2048];
+        while (echoing) {
+            sockaddr_in from{};
+#ifdef _WIN32
+            int from_len = sizeof(from);
+#else
+            socklen_t from_len = sizeof(from);
+#endif
+            const int n = recvfrom(server, buffer, sizeof(buffer), 0, reinterpret_cast<sockaddr*>(&from), &from_len);
+            if (n > 0) {
+                server_received++;
+                sendto(server, buffer, n, 0, reinterpret_cast<const sockaddr*>(&from), from_len);
+            }
+        }
+    });
+
+    ImpairmentRelay::Config config;
+    config.server_port = ntohs(server_addr.sin_port);
+    config.upstream.delay_ms = 10;
+    config.downstream.duplicate_rate = 1.0f;  // Every echo arrives twice
+    auto relay_result = ImpairmentRelay::start(config);
+    ASSERT_TRUE(relay_result.is_ok()) << relay_result.error().message();
+    auto relay = relay_result.unwrap();
+    ASSERT_NE(relay->port(), 0);
+
+    std::atomic<int> client_received{0};
+    client.set_receive_callback([&client_received](const VoicePacket&) { client_received++; });
+    ASSERT_TRUE(client.connect("127.0.0.1", relay->port()).is_ok());
+
+    constexpr int PACKETS = 20;
+    for (int i = 0; i < PACKETS; ++i) {
+        ASSERT_TRUE(client.send_packet(test_packet(static_cast<SequenceNumber>(i))).is_ok());
+    }
+
+    for (int i = 0; i < 100 && client_received < 2 * PACKETS; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(server_received.load(), PACKETS);
+    EXPECT_EQ(client_received.load(), 2 * PACKETS);
+
+    const auto stats = relay->get_stats();
+    EXPECT_EQ(stats.upstream.packets, static_cast<uint64_t>(PACKETS));
+    EXPECT_EQ(stats.downstream.duplicated, static_cast<uint64_t>(PACKETS));
+
+    client.disconnect();
+    relay->stop();
+    echoing = false;
+    echo.join();
+    close_loopback_socket(server);
+}
+
+TEST(ImpairedSocketTest, DropsOutgoingPacketsOnLossyPath) {
+    UdpVoiceSocket sender;
+    sockaddr_in addr{};
+    SocketType receiver = open_loopback_socket(addr);
+    ASSERT_NE(receiver, INVALID_SOCKET);
+
+    ImpairmentConfig lossy;
+    lossy.loss_model = LossModel::Bernoulli;
+    lossy.loss_rate = 0.5f;
+
+    sender.set_impairment(lossy, ImpairmentConfig{});
+    ASSERT_TRUE(sender.connect("127.0.0.1", ntohs(addr.sin_port)).is_ok());
+
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_TRUE(sender.send_packet(test_packet(static_cast<SequenceNumber>(i))).is_ok());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const auto stats = sender.outgoing_impairment_stats();
+    EXPECT_EQ(stats.packets, 200u);
+    EXPECT_EQ(sender.get_stats().packets_sent, stats.delivered);
+    EXPECT_NEAR(static_cast<double>(stats.lost), 100.0, 30.0);
+
+    sender.disconnect();
+    close_loopback_socket(receiver);
+}
+
+// Quality harness
+//
+// Pushes a speech-like signal through the impairment model and the real
+// jitter buffer in virtual time (a 20ms playout tick), then scores what
+// would reach the speaker: segmental SNR against the source and
+// mouth-to-ear latency. Deterministic, so numbers are comparable between
+// runs and configurations.
+
+namespace {
+
+struct QualityReport {
+    double seg_snr_db = 0.0;        // Mean over non-silent source frames, each clamped to [-10, 35]
+    double latency_mean_ms = 0.0;   // Send to playout, frames actually played
+    double latency_p95_ms = 0.0;
+    size_t played = 0;              // Frames played from their own packet
+    size_t concealed = 0;           // Frames filled by PLC
+    size_t recovered = 0;           // Frames rebuilt from the next packet's FEC
+    size_t missing = 0;             // Source frames never played (lost or too late)
+    size_t undelivered = 0;         // Source frames the network never delivered
+    size_t stalls = 0;              // Playout ticks with nothing to play after start
+    ImpairmentStats network;
+};
+
+enum class Codec { Pcm, Opus };
+
+struct HarnessOptions {
+    Codec codec = Codec::Pcm;
+    bool fec = false;               // Opus: encode in-band FEC and use it
+    uint32_t buffer_frames = 3;
+    size_t frames = 250;            // 5 seconds
+};
+
+constexpr float SNR_FLOOR_DB = -10.0f;
+constexpr float SNR_CEILING_DB = 35.0f;
+constexpr size_t MAX_ALIGN_LAG = 480;  // Codec delay search (10ms)
+constexpr size_t TAIL_FRAMES = 25;     // Sent after the scored frames to flush the jitter buffer
+
+// Voiced "syllables" (gliding f0 with decaying harmonics) at ~4Hz, with pauses
+std::vector<float> speech_like_signal(size_t frames) {
+    std::vector<float> signal(frames * FRAME_SIZE, 0.0f);
+    double phase = 0.0;
+    for (size_t i = 0; i < signal.size(); ++i) {
+        const double t = static_cast<double>(i) / 48000.0;
+        const double in_phrase = std::fmod(t, 1.6);
+        if (in_phrase > 1.3) {
+            continue;  // 300ms pause
+        }
+        const double f0 = 140.0 + 30.0 * std::sin(2.0 * M_PI * 0.7 * t);
+        phase += 2.0 * M_PI * f0 / 48000.0;
+        const double envelope = 0.5 - 0.5 * std::cos(2.0 * M_PI * 4.0 * in_phrase);
+        double sample = 0.0;
+        for (int h = 1; h <= 12; ++h) {
+            sample += std::sin(h * phase) / h;
+        }
+        signal[i] = static_cast<float>(0.25 * envelope * sample);
+    }
+    return signal;
+}
+
+double segmental_snr(const std::vector<float>& source, const std::vector<float>& output, size_t frames, size_t lag) {
+    double total = 0.0;
+    size_t counted = 0;
+    for (size_t start = 0; start < frames * FRAME_SIZE; start += FRAME_SIZE) {
+        double signal = 0.0, noise = 0.0;
+        for (size_t n = start; n < start + FRAME_SIZE; ++n) {
+            const double error = source[n] - output[n + lag];
+            signal += source[n] * source[n];
+            noise += error * error;
+        }
+        if (signal < FRAME_SIZE * 1e-6) {
+            continue;  // Silent source frame (below -60 dBFS)
+        }
+        const double snr = noise > 0.0 ? 10.0 * std::log10(signal / noise) : SNR_CEILING_DB;
+        total += std::clamp<double>(snr, SNR_FLOOR_DB, SNR_CEILING_DB);
+        counted++;
+    }
+    return counted > 0 ? total / counted : 0.0;
+}
+
+QualityReport run_harness(const ImpairmentConfig& impairment, const HarnessOptions& options) {
+    const size_t sent_frames = options.frames + TAIL_FRAMES;
+    const std::vector<float> source = speech_like_signal(sent_frames);
+
+    std::unique_ptr<audio::OpusEncoder> encoder;
+    std::unique_ptr<audio::OpusDecoder> decoder;
+    if (options.codec == Codec::Opus) {
+        OpusConfig opus_config;
+        opus_config.enable_fec = options.fec;
+        opus_config.expected_packet_loss = options.fec ? 10 : 0;
+        auto encoder_result = audio::OpusEncoder::create(opus_config);
+        auto decoder_result = audio::OpusDecoder::create(48000, 1);
+        if (!encoder_result.is_ok() || !decoder_result.is_ok()) {
+            ADD_FAILURE() << "Opus codec unavailable";
+            return QualityReport{};
+        }
+        encoder = encoder_result.unwrap();
+        decoder = decoder_result.unwrap();
+    }
+
+    // Sender: one packet per frame through the network model
+    struct Arrival {
+        uint64_t at_us;
+        SequenceNumber sequence;
+    };
+    ImpairmentModel network(impairment);
+    std::vector<std::vector<uint8_t>> payloads(sent_frames);
+    std::vector<Arrival> arrivals;
+    for (size_t s = 0; s < sent_frames; ++s) {
+        size_t bytes = VOICE_PACKET_HEADER_SIZE + 80;  // PCM mode: sized like 32kbps Opus
+        if (encoder) {
+            auto encoded = encoder->encode(source.data() + s * FRAME_SIZE, FRAME_SIZE);
+            if (!encoded.is_ok()) {
+                ADD_FAILURE() << "encode failed";
+                return QualityReport{};
+            }
+            payloads[s] = encoded.unwrap().data;
+            bytes = VOICE_PACKET_HEADER_SIZE + payloads[s].size();
+        }
+        const auto verdict = network.process(bytes, s * FRAME_US);
+        for (uint32_t c = 0; c < verdict.copies; ++c) {
+            arrivals.push_back(Arrival{verdict.deliver_at_us[c], static_cast<SequenceNumber>(s)});
+        }
+    }
+    std::stable_sort(arrivals.begin(), arrivals.end(),
+                     [](const Arrival& a, const Arrival& b) { return a.at_us < b.at_us; });
+
+    // Receiver: push arrivals, pop one frame per 20ms tick
+    audio::JitterBuffer jitter_buffer(options.buffer_frames, FRAME_SIZE);
+    std::vector<float> output(source.size() + MAX_ALIGN_LAG, 0.0f);
+    std::vector<bool> arrived(sent_frames, false);
+    std::vector<double> latencies_ms;
+    std::vector<float> frame(FRAME_SIZE);
+    QualityReport report;
+    size_t next_arrival = 0;
+    bool started = false;
+    const size_t max_ticks = sent_frames + 100;
+
+    for (size_t tick = 0; tick < max_ticks; ++tick) {
+        const uint64_t now_us = tick * FRAME_US + 1;
+        for (; next_arrival < arrivals.size() && arrivals[next_arrival].at_us <= now_us; ++next_arrival) {
+            const SequenceNumber seq = arrivals[next_arrival].sequence;
+            audio::AudioPacket packet{
+                .sequence = seq,
+                .timestamp = Timestamp(static_cast<int64_t>(seq * FRAME_US)),
+                .samples = encoder ? std::vector<float>(1, 0.0f)  // Stand-in: decoded at playout
+                                   : std::vector<float>(source.begin() + seq * FRAME_SIZE,
+                                                        source.begin() + (seq + 1) * FRAME_SIZE),
+                .frame_size = FRAME_SIZE
+            };
+            if (jitter_buffer.push(std::move(packet))) {
+                arrived[seq] = true;
+            }
+        }
+
+        auto popped = jitter_buffer.pop();
+        if (!popped) {
+            if (started) {
+                report.stalls++;
+            }
+            continue;
+        }
+        started = true;
+        const SequenceNumber seq = popped->sequence;
+        if (seq >= options.frames) {
+            break;  // Every scored frame has been played or skipped
+        }
+
+        const bool lost = popped->samples.empty();
+        if (!encoder) {
+            std::fill(frame.begin(), frame.end(), 0.0f);  // PCM: silence for lost frames
+            if (!lost) {
+                std::copy(popped->samples.begin(), popped->samples.end(), frame.begin());
+            }
+        } else if (!lost) {
+            (void)decoder->decode(payloads[seq].data(), payloads[seq].size(), frame.data(), FRAME_SIZE);
+        } else if (options.fec && arrived[seq + 1]) {
+            (void)decoder->decode_fec(payloads[seq + 1].data(), payloads[seq + 1].size(), frame.data(), FRAME_SIZE);
+        } else {
+            (void)decoder->decode_plc(frame.data(), FRAME_SIZE);
+        }
+
+        if (!lost) {
+            report.played++;
+            latencies_ms.push_back(static_cast<double>(now_us - seq * FRAME_US) / 1000.0);
+        } else if (encoder && options.fec && arrived[seq + 1]) {
+            report.recovered++;
+        } else {
+            report.concealed++;
+        }
+        std::copy(frame.begin(), frame.end(), output.begin() + seq * FRAME_SIZE);
+    }
+
+    report.missing = options.frames - report.played - report.recovered;
+    std::vector<bool> delivered(options.frames, false);
+    for (const Arrival& arrival : arrivals) {
+        if (arrival.sequence < options.frames) {
+            delivered[arrival.sequence] = true;
+        }
+    }
+    report.undelivered = static_cast<size_t>(std::count(delivered.begin(), delivered.end(), false));
+    report.network = network.stats();
+
+    // Align for codec delay, then score
+    double best = SNR_FLOOR_DB;
+    const size_t max_lag = encoder ? MAX_ALIGN_LAG : 0;
+    for (size_t lag = 0; lag <= max_lag; ++lag) {
+        best = std::max(best, segmental_snr(source, output, options.frames, lag));
+    }
+    report.seg_snr_db = best;
+
+    if (!latencies_ms.empty()) {
+        double sum = 0.0;
+        for (double l : latencies_ms) {
+            sum += l;
+        }
+        report.latency_mean_ms = sum / latencies_ms.size();
+        std::sort(latencies_ms.begin(), latencies_ms.end());
+        report.latency_p95_ms = latencies_ms[latencies_ms.size() * 95 / 100];
+    }
+    return report;
+}
+
+void print_report(const std::string& name, const QualityReport& report) {
+    std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(8) << report.seg_snr_db << " dB"
+              << std::setw(8) << report.latency_mean_ms << " ms"
+              << std::setw(8) << report.latency_p95_ms << " ms"
+              << std::setw(7) << report.played
+              << std::setw(7) << report.concealed
+              << std::setw(7) << report.recovered
+              << std::setw(7) << report.stalls << "\n";
+}
+
+void print_header() {
+    std::cout << "  " << std::left << std::setw(22) << "configuration" << std::right
+              << std::setw(11) << "segSNR" << std::setw(11) << "latency" << std::setw(11) << "p95"
+              << std::setw(7) << "played" << std::setw(7) << "PLC" << std::setw(7) << "FEC"
+              << std::setw(7) << "stalls" << "\n";
+}
+
+ImpairmentConfig bernoulli(float loss, uint64_t seed = 1) {
+    ImpairmentConfig config;
+    config.seed = seed;
+    config.loss_model = LossModel::Bernoulli;
+    config.loss_rate = loss;
+    return config;
+}
+
+} // namespace
+
+TEST(ImpairmentQualityTest, PcmScoresEachConfiguration) {
+    const HarnessOptions pcm;
+
+    ImpairmentConfig jitter;
+    jitter.delay_ms = 30;
+    jitter.jitter_ms = 15;
+
+    ImpairmentConfig spikes;
+    spikes.delay_ms = 30;
+    spikes.jitter_ms = 10;
+    spikes.jitter_distribution = DelayDistribution::Pareto;
+
+    ImpairmentConfig reorder;
+    reorder.reorder_rate = 0.1f;
+    reorder.reorder_delay_ms = 30;
+
+    ImpairmentConfig duplicate;
+    duplicate.duplicate_rate = 0.2f;
+
+    ImpairmentConfig narrow;
+    narrow.bandwidth_kbps = 40;  // Below the 43kbps offered
+
+    const auto clean = run_harness(ImpairmentConfig{}, pcm);
+    const auto jittered = run_harness(jitter, pcm);
+    const auto spiky = run_harness(spikes, pcm);
+    const auto random_loss = run_harness(bernoulli(0.05f), pcm);
+    const auto burst_loss = run_harness(ImpairmentConfig::gilbert_elliott(0.05f, 4.0f), pcm);
+    const auto reordered = run_harness(reorder, pcm);
+    const auto duplicated = run_harness(duplicate, pcm);
+    const auto bottleneck = run_harness(narrow, pcm);
+
+    std::cout << "\nPCM passthrough, " << pcm.buffer_frames << "-frame jitter buffer\n";
+    print_header();
+    print_report("clean", clean);
+    print_report("jitter 30+U(0,30)ms", jittered);
+    print_report("jitter 30+pareto 10ms", spiky);
+    print_report("5% random loss", random_loss);
+    print_report("5% loss, bursts of 4", burst_loss);
+    print_report("10% reordered 30ms", reordered);
+    print_report("20% duplicated", duplicated);
+    print_report("40kbps bottleneck", bottleneck);
+
+    // Clean path: bit-exact audio, latency is the buffer's fill time
+    EXPECT_NEAR(clean.seg_snr_db, SNR_CEILING_DB, 0.01);
+    EXPECT_EQ(clean.played, pcm.frames);
+    EXPECT_EQ(clean.stalls, 0u);
+    EXPECT_NEAR(clean.latency_mean_ms, (pcm.buffer_frames - 1) * 20.0, 1.0);
+
+    // Delay adds latency without touching the audio
+    EXPECT_GT(jittered.latency_mean_ms, clean.latency_mean_ms + 30.0);
+    EXPECT_GT(spiky.latency_p95_ms, clean.latency_p95_ms + 30.0);
+
+    // Playout keeps going through every impairment: nearly everything the
+    // network delivered is played, and a stall only rebuilds the cushion
+    // after a spike or burst instead of wedging playout for good
+    const std::pair<const char*, const QualityReport*> impaired[] = {
+        {"jitter", &jittered}, {"pareto jitter", &spiky}, {"random loss", &random_loss},
+        {"burst loss", &burst_loss}, {"reorder", &reordered}, {"duplicate", &duplicated},
+    };
+    for (const auto& [name, report] : impaired) {
+        EXPECT_GE(report->played + 10, pcm.frames - report->undelivered) << name;
+        EXPECT_LE(report->played + report->concealed, pcm.frames) << name;
+        EXPECT_LE(report->stalls, pcm.frames / 10) << name;
+    }
+
+    // Loss costs quality and is concealed frame for frame
+    EXPECT_LT(random_loss.seg_snr_db, clean.seg_snr_db - 1.0);
+    EXPECT_LT(burst_loss.seg_snr_db, clean.seg_snr_db - 1.0);
+    EXPECT_NEAR(static_cast<double>(random_loss.missing), 0.05 * pcm.frames, 8.0);
+    EXPECT_EQ(random_loss.missing, random_loss.undelivered);
+    EXPECT_EQ(burst_loss.missing, burst_loss.undelivered);
+
+    // The jitter buffer absorbs reordering within its depth and drops duplicates
+    EXPECT_GT(reordered.seg_snr_db, random_loss.seg_snr_db);
+    EXPECT_NEAR(duplicated.seg_snr_db, SNR_CEILING_DB, 0.01);
+    EXPECT_GT(duplicated.network.duplicated, 0u);
+
+    // A bottleneck below the send rate builds queueing delay until tail drop
+    EXPECT_GT(bottleneck.latency_p95_ms, clean.latency_p95_ms + 50.0);
+    EXPECT_GT(bottleneck.network.queue_drops, 0u);
+}
+
+TEST(ImpairmentQualityTest, OpusFecBeatsConcealmentOnRandomLoss) {
+    HarnessOptions plc;
+    plc.codec = Codec::Opus;
+    HarnessOptions fec = plc;
+    fec.fec = true;
+
+    const auto clean = run_harness(ImpairmentConfig{}, plc);
+    const auto concealed = run_harness(bernoulli(0.1f), plc);
+    const auto recovered = run_harness(bernoulli(0.1f), fec);
+    const auto burst = run_harness(ImpairmentConfig::gilbert_elliott(0.1f, 4.0f), fec);
+
+    std::cout << "\nOpus 32kbps, " << plc.buffer_frames << "-frame jitter buffer\n";
+    print_header();
+    print_report("clean", clean);
+    print_report("10% loss, PLC", concealed);
+    print_report("10% loss, FEC", recovered);
+    print_report("10% bursts, FEC", burst);
+
+    EXPECT_GT(clean.seg_snr_db, concealed.seg_snr_db);
+    EXPECT_GT(recovered.recovered, 0u);
+    EXPECT_GE(recovered.seg_snr_db, concealed.seg_snr_db);
+
+    // FEC only covers one packet back: most of a burst is concealed, or
+    // stalled through when it empties the buffer
+    EXPECT_GT(burst.concealed + burst.stalls, burst.recovered);
+}
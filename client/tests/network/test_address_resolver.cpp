@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include "network/address_resolver.h"
+#include "network/udp_socket.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+using namespace voip;
+using namespace voip::network;
+
+namespace {
+
+Endpoint endpoint(const std::string& host, uint16_t port = 9001) {
+    auto result = parse_numeric_endpoint(host, port);
+    EXPECT_TRUE(result.is_ok()) << host;
+    return result.is_ok() ? result.value() : Endpoint{};
+}
+
+// Stand-in server on an ephemeral IPv4 loopback port that answers
+// keepalive probes the way the real server does
+class KeepaliveEchoServer {
+public:
+    KeepaliveEchoServer() {
+        socket_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(socket_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+#ifdef _WIN32
+        int addr_len = sizeof(addr);
+        DWORD timeout = 50;
+        setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+#else
+        socklen_t addr_len = sizeof(addr);
+        timeval tv{0, 50000};
+        setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+#endif
+        getsockname(socket_, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+        port_ = ntohs(addr.sin_port);
+
+        thread_ = std::thread([this] {
+            uint8_t buffer[2048];
+            while (running_) {
+                sockaddr_storage from{};
+                socklen_t from_len = sizeof(from);
+                const int received = recvfrom(socket_, reinterpret_cast<char*>(buffer), sizeof(buffer), 0,
+                                              reinterpret_cast<sockaddr*>(&from), &from_len);
+                if (received != static_cast<int>(KEEPALIVE_PACKET_SIZE)) {
+                    continue;
+                }
+                auto probe = KeepalivePacket::deserialize(buffer, KEEPALIVE_PACKET_SIZE);
+                if (!probe.is_ok() || probe.value().echo) {
+                    continue;
+                }
+                auto echo = probe.value();
+                echo.echo = true;
+                const auto data = echo.serialize();
+                sendto(socket_, reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size()), 0,
+                       reinterpret_cast<const sockaddr*>(&from), from_len);
+                probes_++;
+            }
+        });
+    }
+
+    ~KeepaliveEchoServer() {
+        running_ = false;
+        thread_.join();
+#ifdef _WIN32
+        closesocket(socket_);
+#else
+        close(socket_);
+#endif
+    }
+
+    uint16_t port() const { return port_; }
+    int probes() const { return probes_; }
+
+private:
+    SocketType socket_ = INVALID_SOCKET;
+    uint16_t port_ = 0;
+    std::atomic<bool> running_{true};
+    std::atomic<int> probes_{0};
+    std::thread thread_;
+};
+
+// Records the result handed to a connect callback
+class ConnectOutcome {
+public:
+    ConnectCallback callback() {
+        return [this](const Result<void>& result) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            connected_ = result.is_ok();
+            done_.notify_all();
+        };
+    }
+
+    std::optional<bool> wait(std::chrono::seconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait_for(lock, timeout, [this] { return connected_.has_value(); });
+        return connected_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::optional<bool> connected_;
+};
+
+// A loopback port with nobody listening
+uint16_t unused_port() {
+    SocketType sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(sock, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+#ifdef _WIN32
+    int addr_len = sizeof(addr);
+    getsockname(sock, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+    closesocket(sock);
+#else
+    socklen_t addr_len = sizeof(addr);
+    getsockname(sock, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+    close(sock);
+#endif
+    return ntohs(addr.sin_port);
+}
+
+} // namespace
+
+TEST(AddressResolverTest, ParsesIpv4Literal) {
+    const auto result = endpoint("192.0.2.7", 9001);
+    EXPECT_EQ(result.family(), AF_INET);
+    EXPECT_EQ(result.length, sizeof(sockaddr_in));
+    EXPECT_EQ(result.to_string(), "192.0.2.7:9001");
+}
+
+TEST(AddressResolverTest, ParsesIpv6Literal) {
+    const auto plain = endpoint("2001:db8::1", 9001);
+    EXPECT_EQ(plain.family(), AF_INET6);
+    EXPECT_EQ(plain.length, sizeof(sockaddr_in6));
+    EXPECT_EQ(plain.to_string(), "[2001:db8::1]:9001");
+
+    EXPECT_EQ(endpoint("[::1]", 5000).to_string(), "[::1]:5000");
+}
+
+TEST(AddressResolverTest, NumericParseRejectsHostnames) {
+    EXPECT_FALSE(parse_numeric_endpoint("localhost", 9001).is_ok());
+    EXPECT_FALSE(parse_numeric_endpoint("voice.example.com", 9001).is_ok());
+    EXPECT_FALSE(parse_numeric_endpoint("999.1.1.1", 9001).is_ok());
+}
+
+TEST(AddressResolverTest, ResolvesLocalhost) {
+    auto result = resolve_endpoints("localhost", 9001);
+    ASSERT_TRUE(result.is_ok()) << result.error().message();
+    for (const auto& resolved : result.value()) {
+        EXPECT_TRUE(resolved.family() == AF_INET || resolved.family() == AF_INET6);
+    }
+}
+
+TEST(AddressResolverTest, InterleavesFamilies) {
+    const std::vector<Endpoint> resolved = {
+        endpoint("2001:db8::1"), endpoint("2001:db8::2"), endpoint("2001:db8::3"),
+        endpoint("192.0.2.1"), endpoint("192.0.2.2"),
+    };
+
+    const auto ordered = interleave_families(resolved);
+    ASSERT_EQ(ordered.size(), 5u);
+    EXPECT_EQ(ordered[0].to_string(), "[2001:db8::1]:9001");
+    EXPECT_EQ(ordered[1].to_string(), "192.0.2.1:9001");
+    EXPECT_EQ(ordered[2].to_string(), "[2001:db8::2]:9001");
+    EXPECT_EQ(ordered[3].to_string(), "192.0.2.2:9001");
+    EXPECT_EQ(ordered[4].to_string(), "[2001:db8::3]:9001");
+
+    // The resolver's first family leads
+    const auto v4_first = interleave_families({endpoint("192.0.2.1"), endpoint("2001:db8::1")});
+    EXPECT_EQ(v4_first[0].family(), AF_INET);
+}
+
+TEST(UdpHostnameConnectTest, ConnectsInBackground) {
+    KeepaliveEchoServer server;
+    ConnectOutcome outcome;
+
+    UdpVoiceSocket socket;
+    socket.set_connect_callback(outcome.callback());
+    ASSERT_TRUE(socket.connect("localhost", server.port()).is_ok());
+
+    const auto connected = outcome.wait(std::chrono::seconds(5));
+    ASSERT_TRUE(connected.has_value());
+    ASSERT_TRUE(*connected);
+    EXPECT_TRUE(socket.is_connected());
+
+    // Only the IPv4 loopback answers, whatever else localhost resolves to
+    EXPECT_EQ(socket.server_endpoint(), "127.0.0.1:" + std::to_string(server.port()));
+
+    socket.disconnect();
+    EXPECT_FALSE(socket.is_connected());
+}
+
+TEST(UdpHostnameConnectTest, ReportsResolutionFailure) {
+    ConnectOutcome outcome;
+
+    UdpVoiceSocket socket;
+    socket.set_connect_callback(outcome.callback());
+    ASSERT_TRUE(socket.connect("no-such-host.invalid", 9001).is_ok());
+
+    const auto connected = outcome.wait(std::chrono::seconds(30));
+    ASSERT_TRUE(connected.has_value());
+    EXPECT_FALSE(*connected);
+    EXPECT_FALSE(socket.is_connected());
+}
+
+TEST(UdpPathRaceTest, PicksThePathThatEchoes) {
+    KeepaliveEchoServer server;
+    ConnectOutcome outcome;
+
+    UdpVoiceSocket socket;
+    socket.set_connect_callback(outcome.callback());
+
+    // The preferred (first) address has nobody listening
+    const std::vector<Endpoint> candidates = {
+        endpoint("127.0.0.1", unused_port()),
+        endpoint("127.0.0.1", server.port()),
+    };
+    ASSERT_TRUE(socket.connect(candidates).is_ok());
+
+    const auto connected = outcome.wait(std::chrono::seconds(5));
+    ASSERT_TRUE(connected.has_value());
+    ASSERT_TRUE(*connected);
+    EXPECT_EQ(socket.server_endpoint(), "127.0.0.1:" + std::to_string(server.port()));
+    EXPECT_EQ(server.probes(), 1);
+}
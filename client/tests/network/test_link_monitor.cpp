@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include "network/link_monitor.h"
+#include "network/udp_socket.h"
+
+using namespace voip;
+using namespace voip::network;
+
+namespace {
+
+constexpr uint64_t MS = 1000;
+
+LinkMonitor::Config config(uint32_t interval_ms = 1000, uint32_t timeout_ms = 2000) {
+    LinkMonitor::Config link_config;
+    link_config.interval_ms = interval_ms;
+    link_config.timeout_ms = timeout_ms;
+    return link_config;
+}
+
+} // namespace
+
+TEST(LinkMonitorTest, ProbesOncePerInterval) {
+    LinkMonitor monitor(config(1000));
+
+    EXPECT_EQ(monitor.poll(0), 0u);             // First poll sends straight away
+    EXPECT_FALSE(monitor.poll(500 * MS).has_value());
+    EXPECT_EQ(monitor.poll(1000 * MS), 1u);
+    EXPECT_FALSE(monitor.poll(1999 * MS).has_value());
+    EXPECT_EQ(monitor.poll(2000 * MS), 2u);
+    EXPECT_EQ(monitor.stats().probes_sent, 3u);
+}
+
+TEST(LinkMonitorTest, MeasuresRoundTrip) {
+    LinkMonitor monitor(config());
+
+    const auto sequence = monitor.poll(0);
+    ASSERT_TRUE(sequence.has_value());
+    EXPECT_TRUE(monitor.on_echo(*sequence, 40 * MS));
+
+    const auto& stats = monitor.stats();
+    EXPECT_FLOAT_EQ(stats.rtt_ms, 40.0f);
+    EXPECT_FLOAT_EQ(stats.min_rtt_ms, 40.0f);
+    EXPECT_FLOAT_EQ(stats.rtt_var_ms, 20.0f);
+    EXPECT_EQ(stats.echoes_received, 1u);
+}
+
+TEST(LinkMonitorTest, SmoothsRoundTrip) {
+    LinkMonitor monitor(config());
+
+    uint64_t now = 0;
+    for (int i = 0; i < 50; ++i) {
+        const auto sequence = monitor.poll(now);
+        ASSERT_TRUE(sequence.has_value());
+        // One spike among steady 20ms samples
+        const uint64_t rtt = (i == 5) ? 300 * MS : 20 * MS;
+        ASSERT_TRUE(monitor.on_echo(*sequence, now + rtt));
+        now += 1000 * MS;
+    }
+
+    const auto& stats = monitor.stats();
+    EXPECT_NEAR(stats.rtt_ms, 20.0f, 1.0f);   // Spike decayed away
+    EXPECT_FLOAT_EQ(stats.min_rtt_ms, 20.0f);
+    EXPECT_FLOAT_EQ(stats.last_rtt_ms, 20.0f);
+}
+
+TEST(LinkMonitorTest, CountsUnansweredProbesAsLost) {
+    LinkMonitor monitor(config(1000, 2000));
+
+    uint64_t now = 0;
+    for (int i = 0; i < 20; ++i) {
+        const auto sequence = monitor.poll(now);
+        ASSERT_TRUE(sequence.has_value());
+        if (i % 4 != 0) {
+            monitor.on_echo(*sequence, now + 30 * MS);
+        }
+        now += 1000 * MS;
+    }
+    monitor.poll(now + 5000 * MS);  // Let the last probes time out
+
+    const auto& stats = monitor.stats();
+    EXPECT_EQ(stats.probes_lost, 5u);
+    EXPECT_EQ(stats.echoes_received, 15u);
+    EXPECT_FLOAT_EQ(stats.loss_fraction, 5.0f / 20.0f);
+    EXPECT_GT(monitor.one_way_loss(), 0.0f);
+    EXPECT_LT(monitor.one_way_loss(), stats.loss_fraction);
+}
+
+TEST(LinkMonitorTest, IgnoresStrayEchoes) {
+    LinkMonitor monitor(config(1000, 2000));
+
+    const auto sequence = monitor.poll(0);
+    ASSERT_TRUE(sequence.has_value());
+
+    EXPECT_FALSE(monitor.on_echo(*sequence + 7, 10 * MS));  // Never sent
+    EXPECT_TRUE(monitor.on_echo(*sequence, 10 * MS));
+    EXPECT_FALSE(monitor.on_echo(*sequence, 11 * MS));      // Duplicate
+
+    const auto late = monitor.poll(1000 * MS);
+    ASSERT_TRUE(late.has_value());
+    monitor.poll(4000 * MS);                                // Counted lost
+    EXPECT_FALSE(monitor.on_echo(*late, 4100 * MS));
+
+    EXPECT_EQ(monitor.stats().stray_echoes, 3u);
+    EXPECT_EQ(monitor.stats().probes_lost, 1u);
+}
+
+TEST(LinkMonitorTest, LossWindowForgetsOldLoss) {
+    LinkMonitor monitor(config(1000, 2000));
+
+    uint64_t now = 0;
+    for (int i = 0; i < 10; ++i) {  // Outage: nothing comes back
+        monitor.poll(now);
+        now += 1000 * MS;
+    }
+    for (size_t i = 0; i < LinkMonitor::LOSS_WINDOW + 2; ++i) {
+        const auto sequence = monitor.poll(now);
+        ASSERT_TRUE(sequence.has_value());
+        monitor.on_echo(*sequence, now + 20 * MS);
+        now += 1000 * MS;
+    }
+
+    EXPECT_FLOAT_EQ(monitor.stats().loss_fraction, 0.0f);
+    EXPECT_EQ(monitor.stats().probes_lost, 10u);
+}
+
+TEST(KeepalivePacketTest, RoundTripsThroughWireFormat) {
+    KeepalivePacket probe;
+    probe.sequence = 0x01020304;
+    probe.sent_at_us = 0x1122334455667788ull;
+    probe.user_id = 42;
+
+    const auto bytes = probe.serialize();
+    ASSERT_EQ(bytes.size(), KEEPALIVE_PACKET_SIZE);
+    EXPECT_EQ(bytes[0], 'V');
+    EXPECT_EQ(bytes[3], 'A');
+
+    auto parsed = KeepalivePacket::deserialize(bytes.data(), bytes.size());
+    ASSERT_TRUE(parsed.is_ok());
+    EXPECT_EQ(parsed.value().sequence, probe.sequence);
+    EXPECT_EQ(parsed.value().sent_at_us, probe.sent_at_us);
+    EXPECT_EQ(parsed.value().user_id, 42u);
+    EXPECT_FALSE(parsed.value().echo);
+
+    // The server's echo differs only in the magic
+    auto echo_bytes = bytes;
+    echo_bytes[3] = 'E';
+    auto echo = KeepalivePacket::deserialize(echo_bytes.data(), echo_bytes.size());
+    ASSERT_TRUE(echo.is_ok());
+    EXPECT_TRUE(echo.value().echo);
+    EXPECT_EQ(echo.value().sequence, probe.sequence);
+}
+
+TEST(KeepalivePacketTest, RejectsOtherDatagrams) {
+    std::vector<uint8_t> bytes(KEEPALIVE_PACKET_SIZE, 0);
+    EXPECT_FALSE(KeepalivePacket::deserialize(bytes.data(), bytes.size()).is_ok());
+
+    KeepalivePacket probe;
+    const auto valid = probe.serialize();
+    EXPECT_FALSE(KeepalivePacket::deserialize(valid.data(), valid.size() - 1).is_ok());
+}
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+#include "network/send_scheduler.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace voip;
+using namespace voip::network;
+
+namespace {
+
+/**
+ * Records what the scheduler sends; can hold the send thread inside a
+ * transmit so the queues fill up behind it
+ */
+class Wire {
+public:
+    SendScheduler::Transmit transmit() {
+        return [this](const uint8_t* data, size_t size) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            sent_.push_back(Sent{size > 0 ? data[0] : uint8_t{0}, steady_time_us()});
+            in_transmit_ = true;
+            changed_.notify_all();
+            changed_.wait(lock, [this] { return !held_; });
+            in_transmit_ = false;
+        };
+    }
+
+    void hold() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_ = true;
+    }
+
+    void release() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            held_ = false;
+        }
+        changed_.notify_all();
+    }
+
+    void wait_in_transmit() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this] { return in_transmit_; });
+    }
+
+    bool wait_for(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return changed_.wait_for(lock, std::chrono::seconds(2), [&] { return sent_.size() >= count; });
+    }
+
+    struct Sent {
+        uint8_t tag;
+        uint64_t at_us;
+    };
+
+    std::vector<Sent> sent() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return sent_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::vector<Sent> sent_;
+    bool held_ = false;
+    bool in_transmit_ = false;
+};
+
+constexpr uint8_t VOICE = 'v';
+constexpr uint8_t CONTROL = 'c';
+
+} // namespace
+
+TEST(SendSchedulerTest, VoiceOvertakesControlBurst) {
+    SendSchedulerConfig config;
+    config.control_interval_us = 0;
+    Wire wire;
+    SendScheduler scheduler(config, wire.transmit());
+
+    // Park the thread in a send, queue a control burst, then one voice frame
+    wire.hold();
+    ASSERT_TRUE(scheduler.enqueue(SendPriority::Control, {CONTROL}));
+    wire.wait_in_transmit();
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(scheduler.enqueue(SendPriority::Control, {CONTROL}));
+    }
+    ASSERT_TRUE(scheduler.enqueue(SendPriority::Voice, {VOICE}));
+    wire.release();
+
+    ASSERT_TRUE(wire.wait_for(12));
+    const auto sent = wire.sent();
+    EXPECT_EQ(sent[0].tag, CONTROL);  // Already on its way
+    EXPECT_EQ(sent[1].tag, VOICE);    // Ahead of the whole burst
+
+    const auto stats = scheduler.get_stats();
+    EXPECT_EQ(stats.voice_sent, 1u);
+    EXPECT_EQ(stats.control_sent, 11u);
+    EXPECT_GT(stats.control_delay_max_us, stats.voice_delay_max_us);
+}
+
+TEST(SendSchedulerTest, PacesControlTraffic) {
+    SendSchedulerConfig config;
+    config.control_interval_us = 5000;
+    Wire wire;
+    SendScheduler scheduler(config, wire.transmit());
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(scheduler.enqueue(SendPriority::Control, {CONTROL}));
+    }
+    ASSERT_TRUE(wire.wait_for(4));
+
+    const auto sent = wire.sent();
+    for (size_t i = 1; i < sent.size(); ++i) {
+        EXPECT_GE(sent[i].at_us - sent[i - 1].at_us, config.control_interval_us);
+    }
+}
+
+TEST(SendSchedulerTest, VoiceIsNotPaced) {
+    SendSchedulerConfig config;
+    config.control_interval_us = 1000000;
+    Wire wire;
+    SendScheduler scheduler(config, wire.transmit());
+
+    // A control send starts the pacing interval; voice ignores it
+    ASSERT_TRUE(scheduler.enqueue(SendPriority::Control, {CONTROL}));
+    ASSERT_TRUE(scheduler.enqueue(SendPriority::Control, {CONTROL}));
+    ASSERT_TRUE(wire.wait_for(1));
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(scheduler.enqueue(SendPriority::Voice, {VOICE}));
+    }
+    ASSERT_TRUE(wire.wait_for(6));
+
+    const auto sent = wire.sent();
+    for (size_t i = 1; i < sent.size(); ++i) {
+        EXPECT_EQ(sent[i].tag, VOICE);
+    }
+}
+
+TEST(SendSchedulerTest, DropsOldestWhenFull) {
+    SendSchedulerConfig config;
+    config.voice_queue_limit = 4;
+    Wire wire;
+    SendScheduler scheduler(config, wire.transmit());
+
+    wire.hold();
+    ASSERT_TRUE(scheduler.enqueue(SendPriority::Voice, {0}));
+    wire.wait_in_transmit();
+    for (uint8_t i = 1; i <= 6; ++i) {
+        ASSERT_TRUE(scheduler.enqueue(SendPriority::Voice, {i}));
+    }
+    wire.release();
+
+    ASSERT_TRUE(wire.wait_for(5));
+    std::vector<uint8_t> tags;
+    for (const auto& sent : wire.sent()) {
+        tags.push_back(sent.tag);
+    }
+    EXPECT_EQ(tags, (std::vector<uint8_t>{0, 3, 4, 5, 6}));
+    EXPECT_EQ(scheduler.get_stats().voice_dropped, 2u);
+}
+
+TEST(SendSchedulerTest, DropsStaleVoice) {
+    SendSchedulerConfig config;
+    config.voice_max_age_us = 20000;
+    Wire wire;
+    SendScheduler scheduler(config, wire.transmit());
+
+    wire.hold();
+    ASSERT_TRUE(scheduler.enqueue(SendPriority::Voice, {0}));
+    wire.wait_in_transmit();
+    ASSERT_TRUE(scheduler.enqueue(SendPriority::Voice, {1}));
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    ASSERT_TRUE(scheduler.enqueue(SendPriority::Voice, {2}));
+    wire.release();
+
+    ASSERT_TRUE(wire.wait_for(2));
+    const auto sent = wire.sent();
+    EXPECT_EQ(sent[1].tag, 2);  // Frame 1 went stale behind the blocked send
+    EXPECT_EQ(scheduler.get_stats().voice_dropped, 1u);
+}
+
+TEST(SendSchedulerTest, RejectsAfterStop) {
+    Wire wire;
+    SendScheduler scheduler(SendSchedulerConfig{}, wire.transmit());
+
+    scheduler.stop();
+    EXPECT_FALSE(scheduler.enqueue(SendPriority::Voice, {VOICE}));
+    EXPECT_TRUE(wire.sent().empty());
+}
+
+TEST(SendSchedulerTest, VoiceKeepsFlowingWhileStatsAreRead) {
+    SendSchedulerConfig config;
+    config.voice_queue_limit = 1024;
+    Wire wire;
+    SendScheduler scheduler(config, wire.transmit());
+
+    // A reader hammering get_stats() shares nothing with the producer
+    std::atomic<bool> reading{true};
+    std::thread reader([&] {
+        while (reading.load()) {
+            (void)scheduler.get_stats();
+        }
+    });
+
+    constexpr size_t FRAMES = 500;
+    for (size_t i = 0; i < FRAMES; ++i) {
+        ASSERT_TRUE(scheduler.enqueue(SendPriority::Voice, {VOICE}));
+    }
+    EXPECT_TRUE(wire.wait_for(FRAMES));
+    reading = false;
+    reader.join();
+
+    const auto stats = scheduler.get_stats();
+    EXPECT_EQ(stats.voice_sent, FRAMES);
+    EXPECT_EQ(stats.voice_dropped, 0u);
+}
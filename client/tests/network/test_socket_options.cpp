@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include "network/udp_socket.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace voip;
+using namespace voip::network;
+
+namespace {
+
+// Bound IPv4 loopback socket standing in for the server
+class LoopbackPeer {
+public:
+    LoopbackPeer() {
+        socket_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        addr_.sin_family = AF_INET;
+        addr_.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(socket_, reinterpret_cast<const sockaddr*>(&addr_), sizeof(addr_));
+#ifdef _WIN32
+        int addr_len = sizeof(addr_);
+        DWORD timeout = 500;
+        setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+#else
+        socklen_t addr_len = sizeof(addr_);
+        timeval tv{0, 500000};
+        setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+#endif
+        getsockname(socket_, reinterpret_cast<sockaddr*>(&addr_), &addr_len);
+    }
+
+    ~LoopbackPeer() {
+#ifdef _WIN32
+        closesocket(socket_);
+#else
+        close(socket_);
+#endif
+    }
+
+    uint16_t port() const { return ntohs(addr_.sin_port); }
+
+    // Wait for one datagram and send `replies` copies of a voice packet back
+    int answer(int replies) {
+        uint8_t buffer[2048];
+        sockaddr_storage from{};
+        socklen_t from_len = sizeof(from);
+        const int received = recvfrom(socket_, reinterpret_cast<char*>(buffer), sizeof(buffer), 0,
+                                      reinterpret_cast<sockaddr*>(&from), &from_len);
+        if (received <= 0) {
+            return received;
+        }
+
+        for (int i = 0; i < replies; ++i) {
+            VoicePacket packet;
+            packet.header = VoicePacketHeader{VOICE_PACKET_MAGIC, static_cast<SequenceNumber>(i), 0, 1, 7};
+            packet.encrypted_payload.assign(60, static_cast<uint8_t>(i));
+            const auto data = packet.serialize();
+            sendto(socket_, reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size()), 0,
+                   reinterpret_cast<const sockaddr*>(&from), from_len);
+        }
+        return received;
+    }
+
+private:
+    SocketType socket_ = INVALID_SOCKET;
+    sockaddr_in addr_{};
+};
+
+VoicePacket hello() {
+    VoicePacket packet;
+    packet.header = VoicePacketHeader{VOICE_PACKET_MAGIC, 0, 0, 1, 1};
+    packet.encrypted_payload.assign(20, 0xAB);
+    return packet;
+}
+
+} // namespace
+
+TEST(SocketOptionsTest, ReportsEffectiveOptions) {
+    LoopbackPeer peer;
+
+    SocketOptions options;
+    options.dscp = 46;
+    options.receive_buffer_bytes = 65536;
+    options.send_buffer_bytes = 32768;
+
+    UdpVoiceSocket socket;
+    socket.set_socket_options(options);
+    EXPECT_FALSE(socket.get_stats().effective_options.has_value());
+    ASSERT_TRUE(socket.connect("127.0.0.1", peer.port()).is_ok());
+
+    const auto effective = socket.get_stats().effective_options;
+    ASSERT_TRUE(effective.has_value());
+    EXPECT_GE(effective->receive_buffer_bytes, options.receive_buffer_bytes);
+    EXPECT_GE(effective->send_buffer_bytes, options.send_buffer_bytes);
+#ifdef __linux__
+    EXPECT_EQ(effective->dscp, 46);
+    EXPECT_EQ(effective->priority, options.priority);
+#endif
+}
+
+TEST(SocketOptionsTest, UnmarkedWhenDscpDisabled) {
+    LoopbackPeer peer;
+
+    SocketOptions options;
+    options.dscp = -1;
+
+    UdpVoiceSocket socket;
+    socket.set_socket_options(options);
+    ASSERT_TRUE(socket.connect("127.0.0.1", peer.port()).is_ok());
+
+    const auto effective = socket.get_stats().effective_options;
+    ASSERT_TRUE(effective.has_value());
+    EXPECT_EQ(effective->dscp, 0);
+}
+
+TEST(SocketOptionsTest, ReceivesWithGroEnabled) {
+    LoopbackPeer peer;
+
+    SocketOptions options;
+    options.udp_gro = true;
+
+    std::atomic<int> received{0};
+    std::atomic<bool> intact{true};
+    UdpVoiceSocket socket;
+    socket.set_socket_options(options);
+    socket.set_receive_callback([&](const VoicePacket& packet) {
+        if (packet.encrypted_payload.size() != 60 ||
+            packet.encrypted_payload[0] != static_cast<uint8_t>(packet.header.sequence)) {
+            intact = false;
+        }
+        received++;
+    });
+    ASSERT_TRUE(socket.connect("127.0.0.1", peer.port()).is_ok());
+
+    // Whether or not the kernel coalesces them, every datagram comes out whole
+    ASSERT_TRUE(socket.send_packet(hello()).is_ok());
+    ASSERT_GT(peer.answer(20), 0);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (received < 20 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(received.load(), 20);
+    EXPECT_TRUE(intact);
+}
+
+TEST(SocketOptionsTest, StampsArrivalTimes) {
+    LoopbackPeer peer;
+
+    std::atomic<int> received{0};
+    std::atomic<bool> stamped{true};
+    UdpVoiceSocket socket;
+    socket.set_receive_callback([&](const VoicePacket& packet) {
+        const uint64_t now = steady_time_us();
+        // Arrival is in the recent past on the steady clock
+        if (packet.received_at_us == 0 || packet.received_at_us > now ||
+            now - packet.received_at_us > 1'000'000) {
+            stamped = false;
+        }
+        received++;
+    });
+    ASSERT_TRUE(socket.connect("127.0.0.1", peer.port()).is_ok());
+#ifdef __linux__
+    EXPECT_TRUE(socket.get_stats().effective_options->receive_timestamps);
+#endif
+
+    ASSERT_TRUE(socket.send_packet(hello()).is_ok());
+    ASSERT_GT(peer.answer(5), 0);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (received < 5 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(received.load(), 5);
+    EXPECT_TRUE(stamped);
+}
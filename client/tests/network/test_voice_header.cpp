@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include "network/voice_header.h"
+
+using namespace voip;
+using namespace voip::network;
+
+namespace {
+
+VoicePacket make_packet(SequenceNumber sequence, uint64_t timestamp, ChannelId channel = 100, UserId user = 42) {
+    VoicePacket packet;
+    packet.header = VoicePacketHeader{VOICE_PACKET_MAGIC, sequence, timestamp, channel, user};
+    packet.encrypted_payload.assign(60, static_cast<uint8_t>(sequence));
+    return packet;
+}
+
+VoiceAliases aliases() {
+    VoiceAliases table;
+    table.users = {{42, 3}, {7, 200}};
+    table.channels = {{100, 1}};
+    return table;
+}
+
+} // namespace
+
+TEST(CompactHeaderTest, RoundTripsFields) {
+    CompactHeader header;
+    header.user_alias = 300;  // Two varint bytes
+    header.channel_alias = 5;
+    header.sequence_lsb = 0xBEEF;
+    header.timestamp_lsb = 0x01234567;
+
+    std::vector<uint8_t> data;
+    header.write(data);
+    ASSERT_EQ(data.size(), 10u);
+    EXPECT_EQ(data[0], COMPACT_HEADER_VERSION);
+
+    const auto parsed = CompactHeader::parse(data.data(), data.size());
+    ASSERT_TRUE(parsed.is_ok());
+    EXPECT_EQ(parsed.value().user_alias, 300);
+    EXPECT_EQ(parsed.value().channel_alias, 5);
+    EXPECT_EQ(parsed.value().sequence_lsb, 0xBEEF);
+    EXPECT_EQ(parsed.value().timestamp_lsb, 0x01234567u);
+    EXPECT_EQ(parsed.value().size, 10u);
+
+    // Every truncation is rejected rather than read past the end
+    for (size_t length = 0; length < data.size(); ++length) {
+        EXPECT_FALSE(CompactHeader::parse(data.data(), length).is_ok()) << length;
+    }
+}
+
+TEST(CompactHeaderTest, ExtendsAcrossWraps) {
+    EXPECT_EQ(extend_lsb(65535, 0, 16), 65536u);
+    EXPECT_EQ(extend_lsb(65536, 65535, 16), 65535u);
+    EXPECT_EQ(extend_lsb(10, 65530, 16), 65530u);
+    EXPECT_EQ(extend_lsb(0x100000005ull, 3, 32), 0x100000003ull);
+}
+
+TEST(VoiceHeaderCodecTest, LegacyUntilAliasesArrive) {
+    VoiceHeaderCodec codec;
+    const auto packet = make_packet(1, 20000);
+    EXPECT_FALSE(codec.compact_enabled());
+    EXPECT_EQ(codec.serialize(packet).size(), VOICE_PACKET_HEADER_SIZE + 60);
+
+    codec.set_aliases(aliases());
+    EXPECT_TRUE(codec.compact_enabled());
+    EXPECT_EQ(codec.serialize(packet).size(), 9u + 60);
+
+    // No alias for this channel yet: legacy for that packet only
+    EXPECT_EQ(codec.serialize(make_packet(1, 20000, 555)).size(), VOICE_PACKET_HEADER_SIZE + 60);
+}
+
+TEST(VoiceHeaderCodecTest, ReceivesBothFormats) {
+    VoiceHeaderCodec sender;
+    VoiceHeaderCodec receiver;
+    sender.set_aliases(aliases());
+    receiver.set_aliases(aliases());
+
+    const uint64_t now = steady_time_us();
+    const auto compact = sender.serialize(make_packet(5, now));
+    auto parsed = receiver.deserialize(compact.data(), compact.size());
+    ASSERT_TRUE(parsed.is_ok());
+    EXPECT_EQ(parsed.value().header.user_id, 42u);
+    EXPECT_EQ(parsed.value().header.channel_id, 100u);
+    EXPECT_EQ(parsed.value().header.sequence, 5u);
+    // Restored around the local clock, so same-clock timestamps are exact
+    EXPECT_EQ(parsed.value().header.timestamp, now);
+    EXPECT_EQ(parsed.value().encrypted_payload.size(), 60u);
+
+    const auto legacy = make_packet(6, now + 20000, 100, 7).serialize();
+    parsed = receiver.deserialize(legacy.data(), legacy.size());
+    ASSERT_TRUE(parsed.is_ok());
+    EXPECT_EQ(parsed.value().header.user_id, 7u);
+    EXPECT_EQ(parsed.value().header.sequence, 6u);
+}
+
+TEST(VoiceHeaderCodecTest, RestoresSequenceThroughLossAndWrap) {
+    VoiceHeaderCodec sender;
+    VoiceHeaderCodec receiver;
+    sender.set_aliases(aliases());
+    receiver.set_aliases(aliases());
+
+    // Every third packet lost while the 16-bit sequence field wraps
+    const uint64_t base_time = steady_time_us();
+    for (SequenceNumber seq = 65500; seq < 65700; ++seq) {
+        if (seq % 3 == 0) {
+            continue;
+        }
+        const uint64_t timestamp = base_time + (seq - 65500) * 20000;
+        const auto data = sender.serialize(make_packet(seq, timestamp));
+        const auto parsed = receiver.deserialize(data.data(), data.size());
+        ASSERT_TRUE(parsed.is_ok());
+        EXPECT_EQ(parsed.value().header.sequence, seq);
+        EXPECT_EQ(parsed.value().header.timestamp, timestamp);
+    }
+
+    // A late packet restores correctly without rewinding the stream
+    const auto late = sender.serialize(make_packet(65690, base_time + 190 * 20000));
+    const auto parsed = receiver.deserialize(late.data(), late.size());
+    ASSERT_TRUE(parsed.is_ok());
+    EXPECT_EQ(parsed.value().header.sequence, 65690u);
+}
+
+TEST(VoiceHeaderCodecTest, ReanchorsStreamAfterLongSilence) {
+    VoiceHeaderCodec sender;
+    VoiceHeaderCodec receiver;
+    sender.set_aliases(aliases());
+    receiver.set_aliases(aliases());
+
+    const uint64_t start = steady_time_us();
+    auto data = sender.serialize(make_packet(100, start));
+    ASSERT_TRUE(receiver.deserialize(data.data(), data.size(), start).is_ok());
+
+    // Push-to-talk released for 40 minutes, past half the 32-bit timestamp range
+    const uint64_t resumed = start + 40ull * 60 * 1000000;
+    data = sender.serialize(make_packet(101, resumed));
+    const auto parsed = receiver.deserialize(data.data(), data.size(), resumed);
+    ASSERT_TRUE(parsed.is_ok());
+    EXPECT_EQ(parsed.value().header.sequence, 101u);
+    EXPECT_EQ(parsed.value().header.timestamp, resumed);
+}
+
+TEST(VoiceHeaderCodecTest, BoundsStreamTable) {
+    VoiceAliases table;
+    table.channels = {{100, 1}};
+    const size_t senders = VoiceHeaderCodec::MAX_STREAMS + 100;
+    for (size_t i = 0; i < senders; ++i) {
+        table.users.emplace_back(static_cast<UserId>(1000 + i), static_cast<uint16_t>(10 + i));
+    }
+    VoiceHeaderCodec sender;
+    VoiceHeaderCodec receiver;
+    sender.set_aliases(table);
+    receiver.set_aliases(table);
+
+    // Everyone talks within the idle window: the longest silent make room
+    uint64_t now = steady_time_us();
+    for (size_t i = 0; i < senders; ++i) {
+        const auto data = sender.serialize(make_packet(5, now, 100, static_cast<UserId>(1000 + i)));
+        ASSERT_TRUE(receiver.deserialize(data.data(), data.size(), now++).is_ok());
+    }
+    EXPECT_EQ(receiver.stream_count(), VoiceHeaderCodec::MAX_STREAMS);
+
+    // Once they fall idle, a new stream sweeps them all out
+    now += VoiceHeaderCodec::STREAM_IDLE_US + 1;
+    const auto data = sender.serialize(make_packet(9, now, 100, 1000));
+    const auto parsed = receiver.deserialize(data.data(), data.size(), now);
+    ASSERT_TRUE(parsed.is_ok());
+    EXPECT_EQ(parsed.value().header.sequence, 9u);
+    EXPECT_EQ(receiver.stream_count(), 1u);
+}
+
+TEST(VoiceHeaderCodecTest, RejectsUnknownAliases) {
+    VoiceHeaderCodec sender;
+    VoiceHeaderCodec receiver;
+    sender.set_aliases(aliases());
+
+    const auto data = sender.serialize(make_packet(1, 20000));
+    EXPECT_FALSE(receiver.deserialize(data.data(), data.size()).is_ok());
+
+    VoiceAliases other;
+    other.users = {{42, 4}};
+    other.channels = {{100, 1}};
+    receiver.set_aliases(other);
+    EXPECT_FALSE(receiver.deserialize(data.data(), data.size()).is_ok());
+}
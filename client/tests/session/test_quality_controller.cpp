@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "session/quality_controller.h"
+
+using namespace voip::session;
+
+namespace {
+
+QualityFeedback feedback(float loss, float jitter_ms = 5.0f, float rtt_ms = 0.0f) {
+    QualityFeedback fb;
+    fb.loss_fraction = loss;
+    fb.jitter_ms = jitter_ms;
+    fb.rtt_ms = rtt_ms;
+    return fb;
+}
+
+} // namespace
+
+TEST(QualityControllerTest, StartsAtMaxBitrate) {
+    QualityController::Config config;
+    config.max_bitrate = 32000;
+    QualityController controller(config);
+
+    EXPECT_EQ(controller.decision().bitrate, 32000u);
+    EXPECT_TRUE(controller.decision().enable_fec);
+}
+
+TEST(QualityControllerTest, BacksOffUnderLoss) {
+    QualityController::Config config;
+    config.min_bitrate = 12000;
+    config.max_bitrate = 32000;
+    QualityController controller(config);
+
+    for (int i = 0; i < 20; ++i) {
+        controller.update(feedback(0.15f));
+    }
+
+    const auto& decision = controller.decision();
+    EXPECT_EQ(decision.bitrate, 12000u);  // Clamped at the floor
+    EXPECT_TRUE(decision.enable_fec);
+    EXPECT_GE(decision.packet_loss_perc, 10);
+    EXPECT_EQ(decision.complexity, config.complexity);  // Full complexity at low bitrate
+}
+
+TEST(QualityControllerTest, BacksOffOnHighRtt) {
+    QualityController::Config config;
+    QualityController controller(config);
+
+    EXPECT_TRUE(controller.update(feedback(0.0f, 5.0f, 800.0f)));
+    EXPECT_LT(controller.decision().bitrate, config.max_bitrate);
+}
+
+TEST(QualityControllerTest, RecoversSlowlyWhenClean) {
+    QualityController::Config config;
+    config.min_bitrate = 12000;
+    config.max_bitrate = 32000;
+    config.increase_after = 5;
+    QualityController controller(config);
+
+    for (int i = 0; i < 20; ++i) {
+        controller.update(feedback(0.2f));
+    }
+    // Let the smoothed loss decay below the clean threshold
+    while (controller.smoothed_loss() >= config.loss_low) {
+        controller.update(feedback(0.0f));
+    }
+    const uint32_t low = controller.decision().bitrate;
+
+    // Additive increase only after several clean intervals
+    // (the update that crossed the threshold was the first)
+    uint32_t clean_updates = 1;
+    while (controller.decision().bitrate == low && clean_updates < 100) {
+        controller.update(feedback(0.0f));
+        clean_updates++;
+    }
+    EXPECT_EQ(clean_updates, config.increase_after);
+    EXPECT_EQ(controller.decision().bitrate, low + config.increase_step);
+
+    for (int i = 0; i < 200; ++i) {
+        controller.update(feedback(0.0f));
+    }
+    EXPECT_EQ(controller.decision().bitrate, config.max_bitrate);
+    EXPECT_FALSE(controller.decision().enable_fec);
+}
+
+TEST(QualityControllerTest, FecHysteresis) {
+    QualityController::Config config;
+    QualityController controller(config);
+
+    // Clean link turns FEC off
+    for (int i = 0; i < 5; ++i) {
+        controller.update(feedback(0.0f));
+    }
+    EXPECT_FALSE(controller.decision().enable_fec);
+
+    // Loss between the off and on thresholds doesn't turn it back on
+    for (int i = 0; i < 20; ++i) {
+        controller.update(feedback(0.008f));
+    }
+    EXPECT_FALSE(controller.decision().enable_fec);
+
+    // Sustained loss above the on threshold does
+    for (int i = 0; i < 5; ++i) {
+        controller.update(feedback(0.03f));
+    }
+    EXPECT_TRUE(controller.decision().enable_fec);
+    EXPECT_GE(controller.decision().packet_loss_perc, 1);
+
+    // ...and it stays on for loss between the thresholds
+    for (int i = 0; i < 20; ++i) {
+        controller.update(feedback(0.008f));
+    }
+    EXPECT_TRUE(controller.decision().enable_fec);
+}
+
+TEST(QualityControllerTest, StableInputsDoNotChangeDecision) {
+    QualityController::Config config;
+    QualityController controller(config);
+
+    for (int i = 0; i < 10; ++i) {
+        controller.update(feedback(0.02f, 20.0f));
+    }
+    const uint64_t adjustments = controller.adjustments();
+
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_FALSE(controller.update(feedback(0.02f, 20.0f)));
+    }
+    EXPECT_EQ(controller.adjustments(), adjustments);
+}
+
+TEST(QualityControllerTest, AggregatesFramesAtBitrateFloor) {
+    QualityController::Config config;
+    config.min_bitrate = 12000;
+    config.max_bitrate = 32000;
+    config.max_frames_per_packet = 3;
+    config.aggregate_after = 3;
+    QualityController controller(config);
+
+    // Bitrate goes first; frames per packet only once it can't go lower
+    while (controller.decision().bitrate > config.min_bitrate) {
+        EXPECT_EQ(controller.decision().frames_per_packet, 1u);
+        controller.update(feedback(0.15f));
+    }
+    for (int i = 0; i < 30; ++i) {
+        controller.update(feedback(0.15f));
+    }
+    EXPECT_EQ(controller.decision().frames_per_packet, 3u);  // Capped
+
+    // Recovery undoes aggregation before raising the bitrate
+    while (controller.decision().frames_per_packet > 1) {
+        controller.update(feedback(0.0f));
+        EXPECT_EQ(controller.decision().bitrate, config.min_bitrate);
+    }
+    for (int i = 0; i < 50; ++i) {
+        controller.update(feedback(0.0f));
+    }
+    EXPECT_GT(controller.decision().bitrate, config.min_bitrate);
+    EXPECT_EQ(controller.decision().frames_per_packet, 1u);
+}
+
+TEST(QualityControllerTest, NeverAggregatesByDefault) {
+    QualityController::Config config;
+    QualityController controller(config);
+
+    for (int i = 0; i < 50; ++i) {
+        controller.update(feedback(0.2f));
+    }
+    EXPECT_EQ(controller.decision().bitrate, config.min_bitrate);
+    EXPECT_EQ(controller.decision().frames_per_packet, 1u);
+}
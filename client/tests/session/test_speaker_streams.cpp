@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include "session/speaker_streams.h"
+
+using namespace voip;
+using namespace voip::session;
+
+namespace {
+
+constexpr uint64_t FRAME_US = 20000;
+constexpr ChannelId CHANNEL = 1;
+
+SpeakerStreams::Config small_config() {
+    SpeakerStreams::Config config;
+    config.jitter_buffer_frames = 5;  // Accepts up to 10 frames ahead
+    config.idle_timeout_us = 1000000;
+    config.max_streams = 4;
+    config.pool_size = 2;
+    return config;
+}
+
+audio::AudioPacket frame(SequenceNumber sequence) {
+    audio::AudioPacket packet;
+    packet.sequence = sequence;
+    packet.timestamp = Timestamp(0);
+    packet.samples.assign(960, 0.0f);
+    packet.frame_size = 960;
+    return packet;
+}
+
+bool keep_all(ChannelId) {
+    return true;
+}
+
+} // namespace
+
+TEST(SpeakerStreamsTest, OneStreamPerSpeakerOnFirstPacket) {
+    SpeakerStreams streams(small_config());
+    EXPECT_EQ(streams.stats().active, 0u);
+
+    SpeakerStream* alice = streams.route(CHANNEL, 7, 0, 1000, 1, 0);
+    SpeakerStream* bob = streams.route(CHANNEL, 8, 500, 9000, 1, 0);
+    ASSERT_NE(alice, nullptr);
+    ASSERT_NE(bob, nullptr);
+    EXPECT_NE(alice, bob);
+    EXPECT_EQ(streams.route(CHANNEL, 7, 1, 1000 + FRAME_US, 1, FRAME_US), alice);
+    EXPECT_EQ(streams.route(CHANNEL + 1, 7, 0, 1000, 1, FRAME_US)->key.channel_id, CHANNEL + 1);
+
+    const auto stats = streams.stats();
+    EXPECT_EQ(stats.active, 3u);
+    EXPECT_EQ(stats.opened, 3u);
+    EXPECT_EQ(stats.epoch_resets, 0u);
+}
+
+TEST(SpeakerStreamsTest, ReorderedAndDuplicatePacketsStayOnTheStream) {
+    SpeakerStreams streams(small_config());
+    SpeakerStream* stream = streams.route(CHANNEL, 7, 100, 100 * FRAME_US, 1, 0);
+    EXPECT_EQ(streams.route(CHANNEL, 7, 102, 102 * FRAME_US, 1, 0), stream);
+    EXPECT_EQ(streams.route(CHANNEL, 7, 101, 101 * FRAME_US, 1, 0), stream);
+    EXPECT_EQ(streams.route(CHANNEL, 7, 102, 102 * FRAME_US, 1, 0), stream);
+    EXPECT_EQ(stream->highest_sequence, 102u);
+    EXPECT_EQ(streams.stats().epoch_resets, 0u);
+}
+
+TEST(SpeakerStreamsTest, SequenceRestartOpensNewEpoch) {
+    SpeakerStreams streams(small_config());
+    SpeakerStream* before = nullptr;
+    for (SequenceNumber seq = 100; seq < 110; ++seq) {
+        before = streams.route(CHANNEL, 7, seq, seq * FRAME_US, 1, 0);
+        ASSERT_TRUE(before->jitter_buffer->push(frame(seq)));
+    }
+
+    // Sender restarted: numbering starts over, its clock kept going
+    SpeakerStream* after = streams.route(CHANNEL, 7, 0, 200 * FRAME_US, 1, 0);
+    ASSERT_NE(after, nullptr);
+    EXPECT_NE(after, before);
+    EXPECT_EQ(after->key.epoch, 1u);
+    EXPECT_TRUE(after->jitter_buffer->push(frame(0)));  // Not a "duplicate"
+    EXPECT_EQ(streams.stats().epoch_resets, 1u);
+
+    // A straggler from the old run still finds the old epoch
+    EXPECT_EQ(streams.route(CHANNEL, 7, 110, 110 * FRAME_US, 1, 0), before);
+    EXPECT_EQ(streams.route(CHANNEL, 7, 1, 201 * FRAME_US, 1, 0), after);
+}
+
+TEST(SpeakerStreamsTest, JumpPastJitterWindowOpensNewEpoch) {
+    SpeakerStreams streams(small_config());
+    SpeakerStream* before = streams.route(CHANNEL, 7, 0, 0, 1, 0);
+
+    // Ahead by more than the jitter buffer accepts: it would reject the rest
+    SpeakerStream* after = streams.route(CHANNEL, 7, 50, 50 * FRAME_US, 1, 0);
+    EXPECT_NE(after, before);
+    EXPECT_TRUE(after->jitter_buffer->push(frame(50)));
+    EXPECT_EQ(streams.stats().epoch_resets, 1u);
+}
+
+TEST(SpeakerStreamsTest, KeepsOnlyThePreviousEpoch) {
+    SpeakerStreams streams(small_config());
+    streams.route(CHANNEL, 7, 1000, 1 * FRAME_US, 1, 0);
+    streams.route(CHANNEL, 7, 0, 2 * FRAME_US, 1, 0);
+    streams.route(CHANNEL, 7, 2000, 3 * FRAME_US, 1, 0);
+    EXPECT_EQ(streams.stats().active, 2u);
+
+    // The first run is gone, so its late packets are dropped
+    EXPECT_EQ(streams.route(CHANNEL, 7, 1001, 1 * FRAME_US + 1, 1, 0), nullptr);
+    EXPECT_EQ(streams.stats().dropped, 1u);
+}
+
+TEST(SpeakerStreamsTest, ReclaimsIdleStreamsIntoPool) {
+    const auto config = small_config();
+    SpeakerStreams streams(config);
+    SpeakerStream* quiet = streams.route(CHANNEL, 7, 0, 0, 1, 0);
+    streams.route(CHANNEL, 8, 0, 0, 1, config.idle_timeout_us);
+    ASSERT_TRUE(quiet->jitter_buffer->push(frame(0)));
+
+    streams.reclaim(config.idle_timeout_us + 1, keep_all);
+    auto stats = streams.stats();
+    EXPECT_EQ(stats.active, 1u);
+    EXPECT_EQ(stats.reclaimed, 1u);
+    EXPECT_EQ(stats.pooled, 1u);
+
+    // The next new speaker reuses the reclaimed state, emptied
+    SpeakerStream* reused = streams.route(CHANNEL, 9, 0, 0, 1, config.idle_timeout_us + 1);
+    EXPECT_EQ(reused, quiet);
+    EXPECT_EQ(reused->key.user_id, 9u);
+    EXPECT_EQ(reused->jitter_buffer->size(), 0u);
+    EXPECT_EQ(streams.stats().pooled, 0u);
+}
+
+TEST(SpeakerStreamsTest, ReclaimsStreamsOfLeftChannels) {
+    SpeakerStreams streams(small_config());
+    streams.route(CHANNEL, 7, 0, 0, 1, 0);
+    streams.route(CHANNEL + 1, 7, 0, 0, 1, 0);
+
+    streams.reclaim(0, [](ChannelId channel_id) { return channel_id == CHANNEL; });
+    EXPECT_EQ(streams.stats().active, 1u);
+    EXPECT_EQ(streams.stats().reclaimed, 1u);
+}
+
+TEST(SpeakerStreamsTest, BoundedByEvictingLeastRecentlyHeard) {
+    const auto config = small_config();
+    SpeakerStreams streams(config);
+    for (UserId user = 1; user <= 100; ++user) {
+        streams.route(CHANNEL, user, 0, 0, 1, user * FRAME_US);
+        EXPECT_LE(streams.stats().active, config.max_streams);
+    }
+    const auto stats = streams.stats();
+    EXPECT_EQ(stats.active, config.max_streams);
+    EXPECT_EQ(stats.evicted, 100u - config.max_streams);
+    EXPECT_LE(stats.pooled, config.pool_size);
+
+    // The most recent speakers are the ones kept
+    size_t kept = 0;
+    streams.for_each([&](SpeakerStream& stream) {
+        EXPECT_GT(stream.key.user_id, 100u - config.max_streams);
+        ++kept;
+    });
+    EXPECT_EQ(kept, config.max_streams);
+}
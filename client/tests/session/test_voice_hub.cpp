@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+#include "session/voice_hub.h"
+#include "session/voice_session.h"
+#include "audio/virtual_audio_backend.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace voip;
+using namespace voip::session;
+
+namespace {
+
+// Silent manual-clock device: nothing runs unless a test advances it
+std::unique_ptr<audio::AudioBackend> quiet_backend() {
+    audio::VirtualAudioBackend::Config config;
+    config.clock = audio::VirtualAudioBackend::ClockMode::Manual;
+    return audio::VirtualAudioBackend::create(config).unwrap();
+}
+
+VoiceSession::Config session_config(uint16_t port) {
+    VoiceSession::Config config;
+    config.server_address = "127.0.0.1";
+    config.server_port = port;
+    config.keepalive_interval_ms = 0;
+    return config;
+}
+
+// Stands in for a session: records what it is handed, plays a constant
+class FakeMember : public VoiceHub::Member {
+public:
+    explicit FakeMember(float level) : level_(level) {}
+
+    void hub_capture(const float* pcm, size_t frames, uint64_t) override {
+        captured.emplace_back(pcm, pcm + frames);
+    }
+
+    void hub_playback(float* pcm, size_t frames, uint64_t) override {
+        std::fill(pcm, pcm + frames, level_);
+    }
+
+    void hub_tick() override {
+        ticks.fetch_add(1);
+    }
+
+    std::vector<std::vector<float>> captured;
+    std::atomic<uint64_t> ticks{0};
+
+private:
+    float level_;
+};
+
+struct ManualDevice {
+    audio::VirtualAudioBackend* device = nullptr;
+    std::unique_ptr<audio::AudioBackend> backend;
+};
+
+// Manual-clock device capturing a constant and writing playback to `output_path`
+ManualDevice manual_device(float input_level, const std::string& output_path) {
+    auto clip = std::make_shared<audio::AudioClip>();
+    clip->samples.assign(48000, input_level);
+
+    audio::VirtualAudioBackend::Config config;
+    config.input_clip = clip;
+    config.output_path = output_path;
+    config.clock = audio::VirtualAudioBackend::ClockMode::Manual;
+    auto backend = audio::VirtualAudioBackend::create(config).unwrap();
+
+    ManualDevice manual;
+    manual.device = backend.get();
+    manual.backend = std::move(backend);
+    return manual;
+}
+
+// Playback written by a manual device, once its hub stopped the streams
+std::vector<float> played(const std::string& path) {
+    auto output = audio::read_audio_file(path, 48000).unwrap();
+    std::remove(path.c_str());
+    return output.samples;
+}
+
+} // namespace
+
+TEST(VoiceHubTest, InitializesSharedEngine) {
+    VoiceHub hub;
+    EXPECT_EQ(hub.get_audio_engine(), nullptr);
+
+    ASSERT_TRUE(hub.initialize(VoiceHub::Config{}, quiet_backend()).is_ok());
+    EXPECT_NE(hub.get_audio_engine(), nullptr);
+    EXPECT_EQ(hub.session_count(), 0u);
+    EXPECT_TRUE(hub.initialize(VoiceHub::Config{}, quiet_backend()).is_err());
+
+    hub.shutdown();
+    EXPECT_EQ(hub.get_audio_engine(), nullptr);
+}
+
+TEST(VoiceHubTest, SessionNeedsInitializedHub) {
+    VoiceHub hub;
+    VoiceSession session;
+    EXPECT_TRUE(session.initialize(session_config(9001), hub).is_err());
+}
+
+TEST(VoiceHubTest, RejectsMismatchedFrameSize) {
+    VoiceHub hub;
+    ASSERT_TRUE(hub.initialize(VoiceHub::Config{}, quiet_backend()).is_ok());
+
+    auto config = session_config(9001);
+    config.frame_size = 480;
+    VoiceSession session;
+    EXPECT_TRUE(session.initialize(config, hub).is_err());
+    EXPECT_EQ(session.get_audio_engine(), nullptr);
+}
+
+TEST(VoiceHubTest, SessionsShareDevicesUntilLastStops) {
+    VoiceHub hub;
+    ASSERT_TRUE(hub.initialize(VoiceHub::Config{}, quiet_backend()).is_ok());
+
+    VoiceSession first;
+    VoiceSession second;
+    ASSERT_TRUE(first.initialize(session_config(9001), hub).is_ok());
+    ASSERT_TRUE(second.initialize(session_config(9002), hub).is_ok());
+    EXPECT_EQ(first.get_audio_engine(), hub.get_audio_engine());
+    EXPECT_EQ(second.get_audio_engine(), hub.get_audio_engine());
+
+    ASSERT_TRUE(first.start().is_ok());
+    ASSERT_TRUE(second.start().is_ok());
+    EXPECT_EQ(hub.session_count(), 2u);
+
+    first.stop();
+    EXPECT_EQ(hub.session_count(), 1u);
+    EXPECT_TRUE(second.is_active());
+
+    second.stop();
+    EXPECT_EQ(hub.session_count(), 0u);
+}
+
+TEST(VoiceHubTest, CapturedFrameReachesEverySession) {
+    const std::string path = testing::TempDir() + "voice_hub_capture.raw";
+    auto manual = manual_device(0.3f, path);
+    VoiceHub hub;
+    ASSERT_TRUE(hub.initialize(VoiceHub::Config{}, std::move(manual.backend)).is_ok());
+
+    FakeMember first(0.0f);
+    FakeMember second(0.0f);
+    ASSERT_TRUE(hub.attach(&first).is_ok());
+    ASSERT_TRUE(hub.attach(&second).is_ok());
+    EXPECT_TRUE(hub.attach(&first).is_err());
+
+    manual.device->advance(2);  // One 20ms codec frame
+    ASSERT_EQ(first.captured.size(), 1u);
+    ASSERT_EQ(second.captured.size(), 1u);
+    ASSERT_EQ(first.captured[0].size(), hub.config().frame_size);
+    EXPECT_EQ(first.captured[0], second.captured[0]);
+    EXPECT_NEAR(first.captured[0][100], 0.3f, 1e-6f);
+
+    // A detached session no longer sees captured audio
+    hub.detach(&first);
+    manual.device->advance(2);
+    EXPECT_EQ(first.captured.size(), 1u);
+    EXPECT_EQ(second.captured.size(), 2u);
+
+    hub.detach(&second);
+    std::remove(path.c_str());
+}
+
+TEST(VoiceHubTest, PlaybackIsClampedSumOfSessions) {
+    const std::string path = testing::TempDir() + "voice_hub_playback.raw";
+    auto manual = manual_device(0.0f, path);
+    VoiceHub hub;
+    ASSERT_TRUE(hub.initialize(VoiceHub::Config{}, std::move(manual.backend)).is_ok());
+    hub.get_audio_engine()->set_output_volume(1.0f);
+
+    FakeMember first(0.25f);
+    FakeMember second(0.125f);
+    FakeMember loud(0.75f);
+    ASSERT_TRUE(hub.attach(&first).is_ok());
+    ASSERT_TRUE(hub.attach(&second).is_ok());
+    manual.device->advance(4);
+
+    // Past full scale once a third session joins
+    ASSERT_TRUE(hub.attach(&loud).is_ok());
+    manual.device->advance(4);
+
+    hub.detach(&loud);
+    hub.detach(&second);
+    hub.detach(&first);
+    EXPECT_EQ(hub.dropped_frames(), 0u);
+
+    const auto samples = played(path);
+    ASSERT_EQ(samples.size(), 8u * 480);
+    EXPECT_NEAR(samples[4 * 480 - 1], 0.375f, 1.0f / 16384);
+    EXPECT_NEAR(samples.back(), 1.0f, 1.0f / 16384);
+    EXPECT_LE(*std::max_element(samples.begin(), samples.end()), 1.0f);
+}
+
+TEST(VoiceHubTest, WorkerTicksEverySession) {
+    // Real-time device: the worker thread keeps the pace
+    VoiceHub hub;
+    ASSERT_TRUE(hub.initialize(VoiceHub::Config{},
+                               audio::VirtualAudioBackend::create({}).unwrap()).is_ok());
+
+    FakeMember first(0.0f);
+    FakeMember second(0.0f);
+    ASSERT_TRUE(hub.attach(&first).is_ok());
+    ASSERT_TRUE(hub.attach(&second).is_ok());
+    while (first.ticks.load() < 3 || second.ticks.load() < 3) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    // Once detach() returns no tick is still running in the session
+    hub.detach(&first);
+    const uint64_t ticks = first.ticks.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_EQ(first.ticks.load(), ticks);
+    EXPECT_GT(second.ticks.load(), 3u);
+
+    hub.detach(&second);
+    EXPECT_EQ(hub.session_count(), 0u);
+}
+
+TEST(VoiceHubTest, ManualClockTicksSessionsPerCodecFrame) {
+    const std::string path = testing::TempDir() + "voice_hub_paced.raw";
+    auto manual = manual_device(0.0f, path);
+    VoiceHub hub;
+    ASSERT_TRUE(hub.initialize(VoiceHub::Config{}, std::move(manual.backend)).is_ok());
+
+    FakeMember first(0.0f);
+    FakeMember second(0.0f);
+    ASSERT_TRUE(hub.attach(&first).is_ok());
+    ASSERT_TRUE(hub.attach(&second).is_ok());
+
+    // Nothing runs between device ticks, however long the wall clock says
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(first.ticks.load(), 0u);
+
+    manual.device->advance(100);  // One second of audio, at once
+    EXPECT_EQ(first.ticks.load(), 50u);
+    EXPECT_EQ(second.ticks.load(), 50u);
+    EXPECT_EQ(first.captured.size(), 50u);
+    EXPECT_EQ(hub.worker_stats().ticks, 0u);
+
+    hub.detach(&second);
+    hub.detach(&first);
+    std::remove(path.c_str());
+}
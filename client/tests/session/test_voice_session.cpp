@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "session/voice_session.h"
+#include "audio/virtual_audio_backend.h"
+#include "network/udp_socket.h"
+#include "crypto/srtp_session.h"
+#include <array>
+#include <map>
+#include <vector>
+
+using namespace voip;
+using namespace voip::session;
+
+namespace {
+
+void close_loopback_socket(SocketType sock) {
+#ifdef _WIN32
+    closesocket(sock);
+#else
+    close(sock);
+#endif
+}
+
+// Blocking UDP socket on an ephemeral loopback port (stand-in server)
+SocketType open_loopback_socket(sockaddr_in& addr) {
+    SocketType sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock == INVALID_SOCKET) {
+        return INVALID_SOCKET;
+    }
+    addr = sockaddr_in{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(sock, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == SOCKET_ERROR) {
+        close_loopback_socket(sock);
+        return INVALID_SOCKET;
+    }
+#ifdef _WIN32
+    int addr_len = sizeof(addr);
+    DWORD timeout = 100;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+#else
+    socklen_t addr_len = sizeof(addr);
+    timeval tv{0, 100000};
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+#endif
+    getsockname(sock, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+    return sock;
+}
+
+// Manual-clock device capturing a steady tone-level signal
+std::unique_ptr<audio::VirtualAudioBackend> talking_device() {
+    auto clip = std::make_shared<audio::AudioClip>();
+    clip->samples.resize(48000);
+    for (size_t i = 0; i < clip->samples.size(); ++i) {
+        clip->samples[i] = (i / 24) % 2 ? 0.3f : -0.3f;  // 1 kHz square wave
+    }
+
+    audio::VirtualAudioBackend::Config config;
+    config.input_clip = clip;
+    config.loop_input = true;
+    config.clock = audio::VirtualAudioBackend::ClockMode::Manual;
+    return audio::VirtualAudioBackend::create(config).unwrap();
+}
+
+} // namespace
+
+TEST(VoiceSessionTest, MultiTargetPacketsKeepPerChannelSequenceContiguous) {
+    sockaddr_in server_addr{};
+    SocketType server = open_loopback_socket(server_addr);
+    ASSERT_NE(server, INVALID_SOCKET);
+
+    VoiceSession::Config config;
+    config.server_address = "127.0.0.1";
+    config.server_port = ntohs(server_addr.sin_port);
+    config.keepalive_interval_ms = 0;
+    config.frames_per_packet = 3;
+    config.adaptive_quality = false;
+    config.enable_vad = false;
+    config.enable_dtx = false;
+
+    auto device = talking_device();
+    audio::VirtualAudioBackend* clock = device.get();
+    VoiceSession session;
+    ASSERT_TRUE(session.initialize(config, std::move(device)).is_ok());
+
+    // SRTP on: the server decrypts every copy under one replay window
+    const std::array<uint8_t, 16> key{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    const std::array<uint8_t, 14> salt{21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34};
+    session.set_srtp_session(std::make_unique<crypto::SrtpSession>(key, salt));
+    crypto::SrtpSession server_srtp(key, salt);
+
+    const std::vector<ChannelId> channels = {1, 2, 3};
+    for (ChannelId channel : channels) {
+        session.start_ptt(channel);
+    }
+    ASSERT_TRUE(session.start().is_ok());
+
+    // The device clock runs the worker: 12 codec frames, about four 3-frame packets per channel
+    clock->advance(24);
+    session.stop();
+
+    std::map<ChannelId, std::vector<SequenceNumber>> sequences;
+    uint8_t buffer[2048];
+    for (;;) {
+        const auto received = recvfrom(server, reinterpret_cast<char*>(buffer), sizeof(buffer), 0, nullptr, nullptr);
+        if (received <= 0) {
+            break;
+        }
+        auto packet = network::VoicePacket::deserialize(buffer, static_cast<size_t>(received));
+        if (packet.is_ok()) {
+            EXPECT_FALSE(server_srtp.decrypt(packet.value().encrypted_payload).empty())
+                << "seq " << packet.value().header.sequence << " ch " << packet.value().header.channel_id;
+            sequences[packet.value().header.channel_id].push_back(packet.value().header.sequence);
+        }
+    }
+    close_loopback_socket(server);
+
+    ASSERT_EQ(sequences.size(), channels.size());
+    for (const auto& [channel, numbers] : sequences) {
+        ASSERT_GE(numbers.size(), 3u) << "channel " << channel;
+        for (size_t i = 1; i < numbers.size(); ++i) {
+            EXPECT_EQ(numbers[i] - numbers[i - 1], config.frames_per_packet) << "channel " << channel;
+        }
+        // Every channel carries the same numbering
+        EXPECT_EQ(numbers, sequences.begin()->second);
+    }
+}
@@ -0,0 +1,221 @@
+/**
+ * voip-impair-relay - Local UDP relay that simulates a bad network
+ *
+ * Point a client's voice port at the relay; it forwards to the real server
+ * with seeded loss, delay, jitter, reordering, duplication and a bandwidth
+ * cap applied to each direction. Same seed, same impairments, so a
+ * problem seen once can be replayed.
+ *
+ * Usage: voip-impair-relay [options]
+ *   --listen N          Port clients send to (default 9101)
+ *   --server HOST       Server address (default 127.0.0.1)
+ *   --port N            Server voice port (default 9001)
+ *   --loss PCT          Average packet loss in percent (default 0)
+ *   --burst N           Mean loss burst in packets; >1 uses Gilbert-Elliott (default 1)
+ *   --delay MS          Fixed one-way delay (default 0)
+ *   --jitter MS         Random extra delay scale (default 0)
+ *   --jitter-dist D     uniform, normal or pareto (default uniform)
+ *   --reorder PCT       Packets held back so later ones overtake (default 0)
+ *   --reorder-delay MS  How long they are held (default 30)
+ *   --duplicate PCT     Packets delivered twice (default 0)
+ *   --bandwidth KBPS    Bottleneck rate, 0 = unlimited (default 0)
+ *   --queue-ms MS       Bottleneck backlog before tail drop (default 200)
+ *   --direction D       both, up (client->server) or down (default both)
+ *   --seed N            Random seed (default 1)
+ */
+
+#include "network/impairment_relay.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace voip;
+using namespace voip::network;
+
+namespace {
+
+std::atomic<bool> g_running{true};
+
+void signal_handler(int signal) {
+    if (signal == SIGINT) {
+        g_running = false;
+    }
+}
+
+struct Options {
+    ImpairmentRelay::Config relay;
+    ImpairmentConfig impairment;
+    float loss_percent = 0.0f;
+    float burst = 1.0f;
+    std::string direction = "both";
+};
+
+void print_usage() {
+    std::cout << "Usage: voip-impair-relay [--listen N] [--server HOST] [--port N]\n"
+              << "                         [--loss PCT] [--burst N] [--delay MS] [--jitter MS]\n"
+              << "                         [--jitter-dist uniform|normal|pareto]\n"
+              << "                         [--reorder PCT] [--reorder-delay MS] [--duplicate PCT]\n"
+              << "                         [--bandwidth KBPS] [--queue-ms MS]\n"
+              << "                         [--direction both|up|down] [--seed N]\n";
+}
+
+bool parse_options(int argc, char* argv[], Options& options) {
+    options.relay.listen_port = 9101;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> const char* {
+            return i + 1 < argc ? argv[++i] : nullptr;
+        };
+        auto next_number = [&](auto& out) {
+            const char* value = next();
+            if (!value) {
+                return false;
+            }
+            out = static_cast<std::remove_reference_t<decltype(out)>>(std::strtod(value, nullptr));
+            return true;
+        };
+        auto next_percent = [&](float& out) {
+            if (!next_number(out)) {
+                return false;
+            }
+            out /= 100.0f;
+            return true;
+        };
+        auto next_string = [&](std::string& out) {
+            const char* value = next();
+            if (!value) {
+                return false;
+            }
+            out = value;
+            return true;
+        };
+
+        bool ok = true;
+        std::string distribution;
+        if (arg == "--listen") ok = next_number(options.relay.listen_port);
+        else if (arg == "--server") ok = next_string(options.relay.server_address);
+        else if (arg == "--port") ok = next_number(options.relay.server_port);
+        else if (arg == "--loss") ok = next_number(options.loss_percent);
+        else if (arg == "--burst") ok = next_number(options.burst);
+        else if (arg == "--delay") ok = next_number(options.impairment.delay_ms);
+        else if (arg == "--jitter") ok = next_number(options.impairment.jitter_ms);
+        else if (arg == "--jitter-dist") {
+            ok = next_string(distribution);
+            if (distribution == "uniform") options.impairment.jitter_distribution = DelayDistribution::Uniform;
+            else if (distribution == "normal") options.impairment.jitter_distribution = DelayDistribution::Normal;
+            else if (distribution == "pareto") options.impairment.jitter_distribution = DelayDistribution::Pareto;
+            else if (ok) {
+                std::cerr << "❌ Unknown jitter distribution: " << distribution << "\n";
+                return false;
+            }
+        }
+        else if (arg == "--reorder") ok = next_percent(options.impairment.reorder_rate);
+        else if (arg == "--reorder-delay") ok = next_number(options.impairment.reorder_delay_ms);
+        else if (arg == "--duplicate") ok = next_percent(options.impairment.duplicate_rate);
+        else if (arg == "--bandwidth") ok = next_number(options.impairment.bandwidth_kbps);
+        else if (arg == "--queue-ms") ok = next_number(options.impairment.queue_limit_ms);
+        else if (arg == "--direction") ok = next_string(options.direction);
+        else if (arg == "--seed") ok = next_number(options.impairment.seed);
+        else if (arg == "--help" || arg == "-h") {
+            print_usage();
+            std::exit(0);
+        }
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return false;
+        }
+        if (!ok) {
+            std::cerr << "❌ Missing value for " << arg << "\n";
+            return false;
+        }
+    }
+
+    if (options.direction != "both" && options.direction != "up" && options.direction != "down") {
+        std::cerr << "❌ --direction must be both, up or down\n";
+        return false;
+    }
+
+    // Loss model: bursts need the Gilbert-Elliott chain, isolated losses do not
+    const float loss = options.loss_percent / 100.0f;
+    if (loss > 0.0f && options.burst > 1.0f) {
+        const ImpairmentConfig chain = ImpairmentConfig::gilbert_elliott(loss, options.burst);
+        options.impairment.loss_model = chain.loss_model;
+        options.impairment.p_good_to_bad = chain.p_good_to_bad;
+        options.impairment.p_bad_to_good = chain.p_bad_to_good;
+        options.impairment.loss_good = chain.loss_good;
+        options.impairment.loss_bad = chain.loss_bad;
+    } else if (loss > 0.0f) {
+        options.impairment.loss_model = LossModel::Bernoulli;
+        options.impairment.loss_rate = loss;
+    }
+
+    // Independent randomness per direction, both derived from --seed
+    if (options.direction != "down") {
+        options.relay.upstream = options.impairment;
+    }
+    if (options.direction != "up") {
+        options.relay.downstream = options.impairment;
+        options.relay.downstream.seed = options.impairment.seed * 2 + 1;
+    }
+    return true;
+}
+
+void print_stats(const char* label, const ImpairmentStats& stats) {
+    std::cout << "  " << label << " packets:" << stats.packets << "  delivered:" << stats.delivered
+              << "  lost:" << stats.lost << "  queue drops:" << stats.queue_drops
+              << "  reordered:" << stats.reordered << "  duplicated:" << stats.duplicated << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return 1;
+    }
+
+    std::signal(SIGINT, signal_handler);
+
+    auto relay_result = ImpairmentRelay::start(options.relay);
+    if (!relay_result.is_ok()) {
+        std::cerr << "❌ " << relay_result.error().message() << "\n";
+        return 1;
+    }
+    auto relay = relay_result.unwrap();
+
+    const auto& impairment = options.impairment;
+    std::cout << "═══════════════════════════════════════════════\n";
+    std::cout << "  🌩️ VoIP Impairment Relay\n";
+    std::cout << "═══════════════════════════════════════════════\n";
+    std::cout << "  Listen:   " << relay->port() << " -> " << options.relay.server_address
+              << ":" << options.relay.server_port << " (" << options.direction << ")\n";
+    std::cout << "  Loss:     " << options.loss_percent << "%"
+              << (impairment.loss_model == LossModel::GilbertElliott
+                      ? " in bursts of ~" + std::to_string(options.burst) : std::string()) << "\n";
+    std::cout << "  Delay:    " << impairment.delay_ms << "ms + " << impairment.jitter_ms << "ms jitter\n";
+    std::cout << "  Reorder:  " << impairment.reorder_rate * 100.0f << "%   Duplicate: "
+              << impairment.duplicate_rate * 100.0f << "%\n";
+    if (impairment.bandwidth_kbps > 0) {
+        std::cout << "  Link:     " << impairment.bandwidth_kbps << " kbps, "
+                  << impairment.queue_limit_ms << "ms queue\n";
+    }
+    std::cout << "  Seed:     " << impairment.seed << "\n\n";
+    std::cout << "▶️  Relaying (Ctrl+C to stop)\n";
+
+    while (g_running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    const auto stats = relay->get_stats();
+    relay->stop();
+    std::cout << "\n📊 Totals\n";
+    print_stats("up  ", stats.upstream);
+    print_stats("down", stats.downstream);
+    return 0;
+}
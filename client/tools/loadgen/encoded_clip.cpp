@@ -0,0 +1,93 @@
+#include "encoded_clip.h"
+#include "audio/audio_file.h"
+#include "audio/opus_codec.h"
+#include "audio/resampler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace voip::loadgen {
+
+namespace {
+
+constexpr uint32_t CODEC_RATE = 48000;
+constexpr size_t FRAME_SIZE = 960;  // 20ms
+
+// Voiced harmonics under a syllable-rate envelope with short pauses,
+// so the encoder produces realistic (not pure-tone) packet sizes
+std::vector<float> synthesize_speech(size_t samples) {
+    std::vector<float> out(samples);
+    constexpr float pi = 3.14159265f;
+    for (size_t i = 0; i < samples; ++i) {
+        const float t = static_cast<float>(i) / CODEC_RATE;
+        const float pitch = 140.0f + 30.0f * std::sin(2.0f * pi * 0.7f * t);
+        float voice = 0.0f;
+        for (int h = 1; h <= 8; ++h) {
+            voice += std::sin(2.0f * pi * pitch * h * t) / static_cast<float>(h);
+        }
+        const float syllables = std::max(0.0f, std::sin(2.0f * pi * 4.0f * t));
+        const float phrase = std::fmod(t, 3.0f) < 2.4f ? 1.0f : 0.0f;
+        out[i] = 0.25f * voice * syllables * phrase;
+    }
+    return out;
+}
+
+} // namespace
+
+Result<std::shared_ptr<const EncodedClip>> encode_clip(const std::string& path, uint32_t bitrate) {
+    std::vector<float> pcm;
+    if (path.empty()) {
+        pcm = synthesize_speech(CODEC_RATE * 6);
+    } else {
+        auto clip_result = audio::read_audio_file(path);
+        if (!clip_result.is_ok()) {
+            return Err<std::shared_ptr<const EncodedClip>>(
+                clip_result.error().code(), clip_result.error().message());
+        }
+        auto clip = clip_result.unwrap();
+
+        if (clip.sample_rate == CODEC_RATE) {
+            pcm = std::move(clip.samples);
+        } else {
+            auto resampler_result = audio::Resampler::create(clip.sample_rate, CODEC_RATE, FRAME_SIZE);
+            if (!resampler_result.is_ok()) {
+                return Err<std::shared_ptr<const EncodedClip>>(
+                    resampler_result.error().code(), resampler_result.error().message());
+            }
+            auto resampler = resampler_result.unwrap();
+            std::vector<float> block(resampler->max_output_frames(FRAME_SIZE));
+            for (size_t pos = 0; pos < clip.samples.size(); pos += FRAME_SIZE) {
+                const size_t count = std::min(FRAME_SIZE, clip.samples.size() - pos);
+                const size_t produced = resampler->process(clip.samples.data() + pos, count,
+                                                           block.data(), block.size());
+                pcm.insert(pcm.end(), block.begin(), block.begin() + static_cast<std::ptrdiff_t>(produced));
+            }
+        }
+    }
+
+    OpusConfig opus_config;
+    opus_config.sample_rate = CODEC_RATE;
+    opus_config.bitrate = bitrate;
+    auto encoder_result = audio::OpusEncoder::create(opus_config);
+    if (!encoder_result.is_ok()) {
+        return Err<std::shared_ptr<const EncodedClip>>(
+            encoder_result.error().code(), encoder_result.error().message());
+    }
+    auto encoder = encoder_result.unwrap();
+
+    auto encoded = std::make_shared<EncodedClip>();
+    for (size_t pos = 0; pos + FRAME_SIZE <= pcm.size(); pos += FRAME_SIZE) {
+        auto packet_result = encoder->encode(pcm.data() + pos, FRAME_SIZE);
+        if (!packet_result.is_ok()) {
+            return Err<std::shared_ptr<const EncodedClip>>(
+                packet_result.error().code(), packet_result.error().message());
+        }
+        encoded->packets.push_back(std::move(packet_result.value().data));
+    }
+
+    if (encoded->packets.empty()) {
+        return Err<std::shared_ptr<const EncodedClip>>(ErrorCode::InvalidState, "Clip is shorter than one frame");
+    }
+    return Ok(std::shared_ptr<const EncodedClip>(std::move(encoded)));
+}
+
+} // namespace voip::loadgen
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "common/result.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace voip::loadgen {
+
+/**
+ * Prerecorded Opus stream shared read-only by every bot
+ *
+ * Encoding once up front keeps the codec off the hot path, which is what
+ * lets one core drive hundreds of talkers.
+ */
+struct EncodedClip {
+    std::vector<std::vector<uint8_t>> packets;  // One 20ms Opus frame each
+    uint32_t frame_us = 20000;
+};
+
+/**
+ * Encode an audio file (any rate, see read_audio_file) at 48kHz mono
+ * An empty path synthesizes a few seconds of speech-like tone bursts.
+ */
+Result<std::shared_ptr<const EncodedClip>> encode_clip(const std::string& path, uint32_t bitrate);
+
+} // namespace voip::loadgen
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace voip::loadgen {
+
+/**
+ * Just enough JSON for the control protocol
+ *
+ * Outgoing messages are built as strings; incoming ones are only probed for
+ * a few scalar fields. Nested objects are not understood, so only ask for
+ * keys that are unique within the message (type, success, user_id, ...).
+ */
+
+inline std::string json_escape(const std::string& value) {
+    std::string out;
+    out.reserve(value.size() + 2);
+    out += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+    return out;
+}
+
+// Position just past `"key":` and any whitespace, or npos
+inline size_t json_find_value(const std::string& json, const std::string& key) {
+    const std::string pattern = "\"" + key + "\"";
+    size_t pos = json.find(pattern);
+    while (pos != std::string::npos) {
+        size_t value = pos + pattern.size();
+        while (value < json.size() && (json[value] == ' ' || json[value] == '\t')) {
+            ++value;
+        }
+        if (value < json.size() && json[value] == ':') {
+            ++value;
+            while (value < json.size() && (json[value] == ' ' || json[value] == '\t')) {
+                ++value;
+            }
+            return value;
+        }
+        pos = json.find(pattern, pos + 1);
+    }
+    return std::string::npos;
+}
+
+inline std::optional<std::string> json_string_field(const std::string& json, const std::string& key) {
+    size_t pos = json_find_value(json, key);
+    if (pos == std::string::npos || json[pos] != '"') {
+        return std::nullopt;
+    }
+    std::string out;
+    for (++pos; pos < json.size() && json[pos] != '"'; ++pos) {
+        if (json[pos] == '\\' && pos + 1 < json.size()) {
+            ++pos;
+        }
+        out += json[pos];
+    }
+    return out;
+}
+
+inline std::optional<int64_t> json_int_field(const std::string& json, const std::string& key) {
+    const size_t pos = json_find_value(json, key);
+    if (pos == std::string::npos) {
+        return std::nullopt;
+    }
+    char* end = nullptr;
+    const long long value = std::strtoll(json.c_str() + pos, &end, 10);
+    if (end == json.c_str() + pos) {
+        return std::nullopt;  // null or not a number
+    }
+    return static_cast<int64_t>(value);
+}
+
+inline std::optional<bool> json_bool_field(const std::string& json, const std::string& key) {
+    const size_t pos = json_find_value(json, key);
+    if (pos == std::string::npos) {
+        return std::nullopt;
+    }
+    if (json.compare(pos, 4, "true") == 0) {
+        return true;
+    }
+    if (json.compare(pos, 5, "false") == 0) {
+        return false;
+    }
+    return std::nullopt;
+}
+
+// Array of small integers, e.g. a key sent as [12,250,...]
+inline std::optional<std::vector<uint8_t>> json_byte_array_field(const std::string& json, const std::string& key) {
+    size_t pos = json_find_value(json, key);
+    if (pos == std::string::npos || json[pos] != '[') {
+        return std::nullopt;
+    }
+    std::vector<uint8_t> out;
+    for (++pos; pos < json.size() && json[pos] != ']'; ) {
+        char* end = nullptr;
+        const long value = std::strtol(json.c_str() + pos, &end, 10);
+        if (end == json.c_str() + pos || value < 0 || value > 255) {
+            return std::nullopt;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+        pos = static_cast<size_t>(end - json.c_str());
+        while (pos < json.size() && (json[pos] == ',' || json[pos] == ' ')) {
+            ++pos;
+        }
+    }
+    return out;
+}
+
+} // namespace voip::loadgen
@@ -0,0 +1,351 @@
+#include "load_bot.h"
+#include "json_util.h"
+#include "crypto/key_exchange.h"
+#include "network/udp_socket.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace voip::loadgen {
+
+namespace {
+
+// Beyond this a stalled worker skips frames instead of bursting them
+constexpr uint64_t MAX_SEND_LAG_US = 100000;
+
+constexpr size_t MAX_DATAGRAM_SIZE = 1500;
+
+// Wait for a message of the given type; server "error" messages fail fast
+Result<std::string> wait_for(WebSocketConnection& control, const std::string& type, uint32_t timeout_ms) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+            return Err<std::string>(ErrorCode::Timeout, "Timed out waiting for " + type);
+        }
+
+        auto message_result = control.receive_text(static_cast<uint32_t>(remaining));
+        if (!message_result.is_ok()) {
+            return message_result;
+        }
+        const std::string& message = message_result.value();
+        const auto message_type = json_string_field(message, "type");
+        if (message_type == type) {
+            return message_result;
+        }
+        if (message_type == "error") {
+            return Err<std::string>(ErrorCode::InvalidState,
+                                    "Server error: " + json_string_field(message, "message").value_or(message));
+        }
+        // Anything else (channel_state, rosters, ...) is not needed
+    }
+}
+
+// Answer the key_exchange_init the server sends after authentication and
+// derive the same SRTP keys it does (as MainWindow does for VoiceSession)
+Result<std::unique_ptr<crypto::SrtpSession>> exchange_keys(WebSocketConnection& control, uint32_t timeout_ms) {
+    auto init_result = wait_for(control, "key_exchange_init", timeout_ms);
+    if (!init_result.is_ok()) {
+        return Err<std::unique_ptr<crypto::SrtpSession>>(init_result.error().code(), init_result.error().message());
+    }
+    const auto server_key = json_byte_array_field(init_result.value(), "public_key");
+    if (!server_key || server_key->size() != 32) {
+        return Err<std::unique_ptr<crypto::SrtpSession>>(ErrorCode::InvalidState, "Malformed key_exchange_init");
+    }
+    std::array<uint8_t, 32> peer_public_key{};
+    std::copy(server_key->begin(), server_key->end(), peer_public_key.begin());
+
+    try {
+        crypto::KeyExchange kx;
+        const auto public_key = kx.public_key_bytes();
+        const auto key_material = kx.derive_keys(peer_public_key);
+
+        std::string response = "{\"type\":\"key_exchange_response\",\"public_key\":[";
+        for (size_t i = 0; i < public_key.size(); ++i) {
+            response += (i ? "," : "") + std::to_string(public_key[i]);
+        }
+        response += "]}";
+        auto send_result = control.send_text(response);
+        if (!send_result.is_ok()) {
+            return Err<std::unique_ptr<crypto::SrtpSession>>(send_result.error().code(), send_result.error().message());
+        }
+        return Ok(std::make_unique<crypto::SrtpSession>(key_material.master_key, key_material.salt));
+    } catch (const std::exception& e) {
+        return Err<std::unique_ptr<crypto::SrtpSession>>(ErrorCode::InvalidState,
+                                                          std::string("Key exchange failed: ") + e.what());
+    }
+}
+
+} // namespace
+
+uint64_t now_us() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+Result<std::unique_ptr<LoadBot>> LoadBot::connect(const BotConfig& config) {
+    auto connect_result = WebSocketConnection::connect(
+        config.host, config.control_port, config.path, config.timeout_ms);
+    if (!connect_result.is_ok()) {
+        return Err<std::unique_ptr<LoadBot>>(connect_result.error().code(), connect_result.error().message());
+    }
+    auto control = connect_result.unwrap();
+
+    auto fail = [](const Error& error) {
+        return Err<std::unique_ptr<LoadBot>>(error.code(), error.message());
+    };
+
+    if (config.register_first) {
+        auto send_result = control->send_text(
+            "{\"type\":\"register\",\"username\":" + json_escape(config.username) +
+            ",\"password\":" + json_escape(config.password) + ",\"email\":null}");
+        if (!send_result.is_ok()) {
+            return fail(send_result.error());
+        }
+        // A failed registration usually means the account already exists;
+        // authentication below reports the real problem if not
+        auto register_result = wait_for(*control, "register_result", config.timeout_ms);
+        if (!register_result.is_ok()) {
+            return fail(register_result.error());
+        }
+    }
+
+    auto send_result = control->send_text(
+        "{\"type\":\"authenticate\",\"method\":\"password\",\"username\":" + json_escape(config.username) +
+        ",\"password\":" + json_escape(config.password) + ",\"token\":null}");
+    if (!send_result.is_ok()) {
+        return fail(send_result.error());
+    }
+    auto auth_result = wait_for(*control, "auth_result", config.timeout_ms);
+    if (!auth_result.is_ok()) {
+        return fail(auth_result.error());
+    }
+    const std::string& auth = auth_result.value();
+    const auto user_id = json_int_field(auth, "user_id");
+    if (!json_bool_field(auth, "success").value_or(false) || !user_id) {
+        return Err<std::unique_ptr<LoadBot>>(ErrorCode::AuthenticationFailed,
+            json_string_field(auth, "message").value_or("Authentication failed"));
+    }
+
+    // Without a response the server keeps this user on plaintext voice
+    std::unique_ptr<crypto::SrtpSession> srtp;
+    if (!config.plaintext) {
+        auto srtp_result = exchange_keys(*control, config.timeout_ms);
+        if (!srtp_result.is_ok()) {
+            return fail(srtp_result.error());
+        }
+        srtp = srtp_result.unwrap();
+    }
+
+    send_result = control->send_text(
+        "{\"type\":\"join_channel\",\"channel_id\":" + std::to_string(config.channel_id) + ",\"password\":null}");
+    if (!send_result.is_ok()) {
+        return fail(send_result.error());
+    }
+    auto join_result = wait_for(*control, "channel_joined", config.timeout_ms);
+    if (!join_result.is_ok()) {
+        return fail(join_result.error());
+    }
+
+    auto bot = std::unique_ptr<LoadBot>(new LoadBot(config, std::move(control), static_cast<UserId>(*user_id),
+                                                       std::move(srtp)));
+    auto voice_result = bot->open_voice_socket();
+    if (!voice_result.is_ok()) {
+        return fail(voice_result.error());
+    }
+    bot->control_->set_non_blocking();
+
+    return Ok(std::move(bot));
+}
+
+LoadBot::LoadBot(const BotConfig& config, std::unique_ptr<WebSocketConnection> control, UserId user_id,
+                 std::unique_ptr<crypto::SrtpSession> srtp)
+    : config_(config)
+    , control_(std::move(control))
+    , user_id_(user_id)
+    , srtp_(std::move(srtp))
+    , receive_buffer_(MAX_DATAGRAM_SIZE)
+{
+}
+
+LoadBot::~LoadBot() {
+    close_socket(voice_socket_);
+}
+
+Result<void> LoadBot::open_voice_socket() {
+    sockaddr_in server{};
+    if (!resolve_ipv4(config_.host, config_.voice_port, server)) {
+        return Err<void>(ErrorCode::NetworkConnectionFailed, "Cannot resolve " + config_.host);
+    }
+
+    voice_socket_ = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (voice_socket_ == INVALID_SOCKET) {
+        return Err<void>(ErrorCode::NetworkConnectionFailed, "Failed to create UDP socket");
+    }
+
+    // Connected UDP: plain send()/recv(), and only the server's datagrams arrive
+    if (::connect(voice_socket_, reinterpret_cast<const sockaddr*>(&server), sizeof(server)) != 0) {
+        return Err<void>(ErrorCode::NetworkConnectionFailed, "Failed to connect UDP socket");
+    }
+    set_non_blocking(voice_socket_, true);
+
+    // Same 1-byte presence packet VoiceSession sends after joining (never encrypted)
+    const uint8_t presence = 0;
+    send_voice(&presence, 1, now_us(), false);
+    return Ok();
+}
+
+void LoadBot::start(uint64_t now) {
+    start_us_ = now;
+    next_send_us_ = config_.talker && config_.clip ? now : UINT64_MAX;
+}
+
+bool LoadBot::is_talking(uint64_t now) const noexcept {
+    const uint64_t cycle_us = (static_cast<uint64_t>(config_.talk_ms) + config_.idle_ms) * 1000;
+    if (config_.idle_ms == 0 || cycle_us == 0) {
+        return true;
+    }
+    return (now - start_us_ + config_.phase_us) % cycle_us < static_cast<uint64_t>(config_.talk_ms) * 1000;
+}
+
+void LoadBot::on_timer(uint64_t now) {
+    const uint64_t frame_us = config_.clip->frame_us;
+    const uint64_t talk_us = static_cast<uint64_t>(config_.talk_ms) * 1000;
+    const uint64_t cycle_us = talk_us + static_cast<uint64_t>(config_.idle_ms) * 1000;
+
+    while (next_send_us_ <= now) {
+        if (now - next_send_us_ > MAX_SEND_LAG_US) {
+            const uint64_t skipped = (now - next_send_us_) / frame_us;
+            late_frames_ += skipped;
+            clip_pos_ += skipped;
+            next_send_us_ += skipped * frame_us;
+            continue;
+        }
+
+        if (is_talking(next_send_us_)) {
+            const auto& packet = config_.clip->packets[clip_pos_ % config_.clip->packets.size()];
+            clip_pos_++;
+            send_voice(packet.data(), packet.size(), now);
+            next_send_us_ += frame_us;
+        } else {
+            // Sleep through the idle part of the cycle
+            const uint64_t position = (next_send_us_ - start_us_ + config_.phase_us) % cycle_us;
+            next_send_us_ += cycle_us - position;
+        }
+    }
+}
+
+void LoadBot::send_voice(const uint8_t* payload, size_t size, uint64_t timestamp, bool encrypt) {
+    network::VoicePacket packet;
+    packet.header.magic = VOICE_PACKET_MAGIC;
+    packet.header.sequence = next_sequence_++;
+    packet.header.timestamp = timestamp;
+    packet.header.channel_id = config_.channel_id;
+    packet.header.user_id = user_id_;
+    if (srtp_ && encrypt) {
+        plaintext_.assign(payload, payload + size);
+        packet.encrypted_payload = srtp_->encrypt(plaintext_, next_srtp_index_++);
+        if (packet.encrypted_payload.empty()) {
+            return;
+        }
+    } else {
+        packet.encrypted_payload.assign(payload, payload + size);
+    }
+
+    const auto data = packet.serialize();
+    if (::send(voice_socket_, reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size()), 0)
+        == static_cast<int>(data.size())) {
+        packets_sent_++;
+    }
+}
+
+void LoadBot::on_voice_readable() {
+    while (true) {
+        const int received = ::recv(voice_socket_, reinterpret_cast<char*>(receive_buffer_.data()),
+                                    static_cast<int>(receive_buffer_.size()), 0);
+        if (received <= 0) {
+            break;  // Drained (or ICMP error from a server that went away)
+        }
+        const uint64_t arrival = now_us();
+
+        auto packet_result = network::VoicePacket::deserialize(receive_buffer_.data(), static_cast<size_t>(received));
+        if (!packet_result.is_ok()) {
+            continue;
+        }
+        auto& packet = packet_result.value();
+        const auto& header = packet.header;
+        if (header.user_id == user_id_) {
+            continue;
+        }
+        if (srtp_) {
+            // Decrypting is part of a listener's cost; a bad tag or replay is not a delivery
+            packet.encrypted_payload = srtp_->decrypt(packet.encrypted_payload);
+            if (packet.encrypted_payload.empty()) {
+                decrypt_failures_++;
+                continue;
+            }
+        }
+        packets_received_++;
+
+        auto [it, inserted] = senders_.try_emplace(header.user_id);
+        SenderStats& sender = it->second;
+        if (inserted) {
+            sender.first_sequence = header.sequence;
+            sender.highest_sequence = header.sequence;
+        } else if (header.sequence > sender.highest_sequence) {
+            sender.highest_sequence = header.sequence;
+        } else if (header.sequence < sender.first_sequence) {
+            sender.first_sequence = header.sequence;  // Reordered ahead of the first one seen
+        }
+        sender.received++;
+
+        // Presence packets carry no audio timing
+        if (packet.encrypted_payload.size() <= 1) {
+            continue;
+        }
+
+        const int64_t transit = static_cast<int64_t>(arrival) - static_cast<int64_t>(header.timestamp);
+        latency_.record(transit > 0 ? static_cast<uint64_t>(transit) : 0);
+
+        // RFC 3550 interarrival jitter
+        if (sender.has_transit) {
+            const double d = std::abs(static_cast<double>(transit - sender.last_transit));
+            sender.jitter += (d - sender.jitter) / 16.0;
+        }
+        sender.last_transit = transit;
+        sender.has_transit = true;
+    }
+}
+
+bool LoadBot::on_control_readable() {
+    // Server pushes (channel_state, rosters, pings) need no action
+    return control_->drain([](const std::string&) {}).is_ok();
+}
+
+BotReport LoadBot::report() const {
+    BotReport report;
+    report.username = config_.username;
+    report.user_id = user_id_;
+    report.channel_id = config_.channel_id;
+    report.connected = control_->is_open();
+    report.packets_sent = packets_sent_;
+    report.late_frames = late_frames_;
+    report.packets_received = packets_received_;
+    report.decrypt_failures = decrypt_failures_;
+    report.senders = static_cast<uint32_t>(senders_.size());
+    report.latency = latency_;
+
+    double jitter_sum = 0.0;
+    for (const auto& [user_id, sender] : senders_) {
+        report.packets_expected += sender.highest_sequence - sender.first_sequence + 1;
+        jitter_sum += sender.jitter;
+    }
+    if (!senders_.empty()) {
+        report.jitter_us = jitter_sum / static_cast<double>(senders_.size());
+    }
+    return report;
+}
+
+} // namespace voip::loadgen
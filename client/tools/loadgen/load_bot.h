@@ -0,0 +1,174 @@
+#pragma once
+
+#include "encoded_clip.h"
+#include "socket_util.h"
+#include "websocket_connection.h"
+#include "common/latency_histogram.h"
+#include "common/types.h"
+#include "crypto/srtp_session.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace voip::loadgen {
+
+/**
+ * Steady-clock microseconds, the same clock VoiceSession stamps packets
+ * with, so bots in one process measure one-way latency directly
+ */
+uint64_t now_us() noexcept;
+
+/**
+ * Per-bot settings
+ */
+struct BotConfig {
+    std::string host = "127.0.0.1";
+    uint16_t control_port = 9000;
+    uint16_t voice_port = 9001;
+    std::string path = "/control";
+    uint32_t timeout_ms = 5000;
+
+    std::string username;
+    std::string password;
+    bool register_first = false;     // Create the account before logging in
+    bool plaintext = false;          // Skip the SRTP key exchange (no crypto cost: optimistic)
+
+    ChannelId channel_id = 1;
+
+    // Push-to-talk duty cycle (talkers only)
+    bool talker = false;
+    uint32_t talk_ms = 3000;
+    uint32_t idle_ms = 3000;
+    uint64_t phase_us = 0;           // Offset into the cycle, spreads talkers out
+
+    std::shared_ptr<const EncodedClip> clip;
+};
+
+/**
+ * What a bot saw during the run
+ */
+struct BotReport {
+    std::string username;
+    UserId user_id = 0;
+    ChannelId channel_id = 0;
+    bool connected = false;
+    std::string error;
+
+    uint64_t packets_sent = 0;
+    uint64_t late_frames = 0;        // Frames skipped because the worker fell behind
+    uint64_t packets_received = 0;
+    uint64_t packets_expected = 0;   // From per-sender sequence ranges
+    uint64_t decrypt_failures = 0;   // Received packets SRTP rejected (not counted as received)
+    uint32_t senders = 0;
+    double jitter_us = 0.0;          // Mean of per-sender RFC 3550 jitter
+    LatencyHistogram latency;
+
+    [[nodiscard]] double loss_percent() const noexcept {
+        if (packets_expected == 0 || packets_received >= packets_expected) {
+            return 0.0;
+        }
+        return 100.0 * static_cast<double>(packets_expected - packets_received)
+                     / static_cast<double>(packets_expected);
+    }
+};
+
+/**
+ * LoadBot - One simulated client
+ *
+ * Speaks the same control protocol and voice packet format as VoiceSession
+ * but owns no threads or audio devices: login (and the SRTP key exchange,
+ * unless plaintext) is blocking, after which a
+ * worker thread drives many bots from one poll() loop. Talkers send the
+ * shared prerecorded clip on a 20ms schedule while their PTT is held,
+ * encrypting every packet like VoiceSession does; every bot decrypts what
+ * it hears and tracks loss, jitter and latency per sender.
+ *
+ * Thread Safety: Not thread-safe. Owned by one worker thread.
+ */
+class LoadBot {
+public:
+    /**
+     * Log in, join the channel and register the voice address (blocking)
+     */
+    static Result<std::unique_ptr<LoadBot>> connect(const BotConfig& config);
+
+    ~LoadBot();
+
+    // Disable copy
+    LoadBot(const LoadBot&) = delete;
+    LoadBot& operator=(const LoadBot&) = delete;
+
+    /**
+     * Begin the PTT schedule (talkers) at the given time
+     */
+    void start(uint64_t now);
+
+    /**
+     * Next time on_timer() has work, UINT64_MAX for listeners
+     */
+    [[nodiscard]] uint64_t next_deadline() const noexcept { return next_send_us_; }
+
+    /**
+     * Send every frame that is due
+     */
+    void on_timer(uint64_t now);
+
+    /**
+     * Read all pending voice packets
+     */
+    void on_voice_readable();
+
+    /**
+     * Drain control messages; false once the connection is gone
+     */
+    bool on_control_readable();
+
+    [[nodiscard]] SocketType voice_socket() const noexcept { return voice_socket_; }
+    [[nodiscard]] SocketType control_socket() const noexcept { return control_->socket(); }
+    [[nodiscard]] bool is_connected() const noexcept { return control_->is_open(); }
+
+    [[nodiscard]] BotReport report() const;
+
+private:
+    struct SenderStats {
+        SequenceNumber first_sequence = 0;
+        SequenceNumber highest_sequence = 0;
+        uint64_t received = 0;
+        int64_t last_transit = 0;
+        double jitter = 0.0;
+        bool has_transit = false;
+    };
+
+    LoadBot(const BotConfig& config, std::unique_ptr<WebSocketConnection> control, UserId user_id,
+            std::unique_ptr<crypto::SrtpSession> srtp);
+
+    Result<void> open_voice_socket();
+    void send_voice(const uint8_t* payload, size_t size, uint64_t timestamp, bool encrypt = true);
+    [[nodiscard]] bool is_talking(uint64_t now) const noexcept;
+
+    BotConfig config_;
+    std::unique_ptr<WebSocketConnection> control_;
+    UserId user_id_;
+    SocketType voice_socket_ = INVALID_SOCKET;
+    std::unique_ptr<crypto::SrtpSession> srtp_;  // nullptr when plaintext
+
+    // Transmit
+    SequenceNumber next_sequence_ = 0;
+    uint32_t next_srtp_index_ = 1;
+    std::vector<uint8_t> plaintext_;
+    uint64_t start_us_ = 0;
+    uint64_t next_send_us_ = UINT64_MAX;
+    size_t clip_pos_ = 0;
+    uint64_t packets_sent_ = 0;
+    uint64_t late_frames_ = 0;
+    std::vector<uint8_t> receive_buffer_;
+
+    // Receive
+    std::unordered_map<UserId, SenderStats> senders_;
+    uint64_t packets_received_ = 0;
+    uint64_t decrypt_failures_ = 0;
+    LatencyHistogram latency_;
+};
+
+} // namespace voip::loadgen
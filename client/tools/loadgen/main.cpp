@@ -0,0 +1,518 @@
+/**
+ * voip-loadgen - Headless load generator
+ *
+ * Spawns many simulated clients in one process. Each bot logs in over the
+ * control WebSocket, joins a channel and (if it is a talker) transmits a
+ * prerecorded Opus clip on a push-to-talk duty cycle, SRTP-encrypted after
+ * the same key exchange the client does. Bots are spread over
+ * one worker thread per core, each running a single poll() loop, so a
+ * thousand talkers fit on one box.
+ *
+ * Usage: voip-loadgen [options]
+ *   --server HOST       Server address (default 127.0.0.1)
+ *   --port N            Control port (default 9000)
+ *   --voice-port N      Voice UDP port (default 9001)
+ *   --path PATH         WebSocket path (default /control)
+ *   --bots N            Simulated clients (default 100)
+ *   --talkers N         How many of them talk (default all)
+ *   --channels N        Spread bots over N channels (default 1)
+ *   --channel-base ID   First channel ID (default 1)
+ *   --user-prefix NAME  Usernames are NAME0, NAME1, ... (default loadbot)
+ *   --password PASS     Password for every bot (default loadbot-password)
+ *   --register          Create the accounts before logging in
+ *   --plaintext         Skip the SRTP key exchange (results are labelled
+ *                       optimistic: no encryption cost on either side)
+ *   --talk-ms N         PTT held (default 3000)
+ *   --idle-ms N         PTT released (default 3000, 0 = always talking)
+ *   --clip FILE         WAV/raw speech to send (default: synthesized)
+ *   --bitrate N         Opus bitrate for the clip (default 32000)
+ *   --threads N         Worker threads (default: one per core)
+ *   --ramp-ms N         Delay between logins per worker (default 10)
+ *   --duration S        Measured run time in seconds (default 30)
+ *   --per-bot           Print a line per bot
+ *   --csv FILE          Write per-bot results as CSV
+ */
+
+#include "load_bot.h"
+#include "common/logger.h"
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <latch>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace voip;
+using namespace voip::loadgen;
+
+namespace {
+
+std::atomic<bool> g_running{true};
+
+void signal_handler(int signal) {
+    if (signal == SIGINT) {
+        g_running = false;
+    }
+}
+
+struct Options {
+    BotConfig bot;
+    uint32_t bots = 100;
+    int64_t talkers = -1;
+    uint32_t channels = 1;
+    ChannelId channel_base = 1;
+    std::string user_prefix = "loadbot";
+    std::string clip_path;
+    uint32_t bitrate = 32000;
+    uint32_t threads = 0;
+    uint32_t ramp_ms = 10;
+    uint32_t duration_s = 30;
+    bool per_bot = false;
+    std::string csv_path;
+};
+
+void print_usage() {
+    std::cout << "Usage: voip-loadgen [--server HOST] [--port N] [--voice-port N] [--path PATH]\n"
+              << "                    [--bots N] [--talkers N] [--channels N] [--channel-base ID]\n"
+              << "                    [--user-prefix NAME] [--password PASS] [--register] [--plaintext]\n"
+              << "                    [--talk-ms N] [--idle-ms N] [--clip FILE] [--bitrate N]\n"
+              << "                    [--threads N] [--ramp-ms N] [--duration S]\n"
+              << "                    [--per-bot] [--csv FILE]\n";
+}
+
+bool parse_options(int argc, char* argv[], Options& options) {
+    options.bot.password = "loadbot-password";
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> const char* {
+            return i + 1 < argc ? argv[++i] : nullptr;
+        };
+        auto next_number = [&](auto& out) {
+            const char* value = next();
+            if (!value) {
+                return false;
+            }
+            out = static_cast<std::remove_reference_t<decltype(out)>>(std::strtoll(value, nullptr, 10));
+            return true;
+        };
+        auto next_string = [&](std::string& out) {
+            const char* value = next();
+            if (!value) {
+                return false;
+            }
+            out = value;
+            return true;
+        };
+
+        bool ok = true;
+        if (arg == "--server") ok = next_string(options.bot.host);
+        else if (arg == "--port") ok = next_number(options.bot.control_port);
+        else if (arg == "--voice-port") ok = next_number(options.bot.voice_port);
+        else if (arg == "--path") ok = next_string(options.bot.path);
+        else if (arg == "--bots") ok = next_number(options.bots);
+        else if (arg == "--talkers") ok = next_number(options.talkers);
+        else if (arg == "--channels") ok = next_number(options.channels);
+        else if (arg == "--channel-base") ok = next_number(options.channel_base);
+        else if (arg == "--user-prefix") ok = next_string(options.user_prefix);
+        else if (arg == "--password") ok = next_string(options.bot.password);
+        else if (arg == "--register") options.bot.register_first = true;
+        else if (arg == "--plaintext") options.bot.plaintext = true;
+        else if (arg == "--talk-ms") ok = next_number(options.bot.talk_ms);
+        else if (arg == "--idle-ms") ok = next_number(options.bot.idle_ms);
+        else if (arg == "--clip") ok = next_string(options.clip_path);
+        else if (arg == "--bitrate") ok = next_number(options.bitrate);
+        else if (arg == "--threads") ok = next_number(options.threads);
+        else if (arg == "--ramp-ms") ok = next_number(options.ramp_ms);
+        else if (arg == "--duration") ok = next_number(options.duration_s);
+        else if (arg == "--per-bot") options.per_bot = true;
+        else if (arg == "--csv") ok = next_string(options.csv_path);
+        else if (arg == "--help" || arg == "-h") {
+            print_usage();
+            std::exit(0);
+        }
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return false;
+        }
+        if (!ok) {
+            std::cerr << "❌ Missing value for " << arg << "\n";
+            return false;
+        }
+    }
+
+    if (options.bots == 0 || options.channels == 0) {
+        std::cerr << "❌ --bots and --channels must be positive\n";
+        return false;
+    }
+    if (options.talkers < 0 || options.talkers > options.bots) {
+        options.talkers = options.bots;
+    }
+    if (options.threads == 0) {
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    options.threads = std::min(options.threads, options.bots);
+    return true;
+}
+
+// Each bot holds two sockets; the default soft limit (often 1024) is too low
+void raise_file_limit(uint32_t bots) {
+#ifndef _WIN32
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < static_cast<rlim_t>(bots) * 2 + 64) {
+        std::cerr << "⚠️ Open file limit " << limit.rlim_cur << " is too low for "
+                  << bots << " bots (raise ulimit -n)\n";
+    }
+#else
+    (void)bots;
+#endif
+}
+
+/**
+ * One thread driving a subset of the bots
+ */
+struct Worker {
+    std::vector<BotConfig> configs;
+    std::vector<std::unique_ptr<LoadBot>> bots;
+    std::vector<BotReport> failed;
+
+    // Published about once a second for the progress line
+    std::atomic<uint32_t> connected{0};
+    std::atomic<uint64_t> packets_sent{0};
+    std::atomic<uint64_t> packets_received{0};
+
+    std::thread thread;
+};
+
+void setup_bots(Worker& worker, uint32_t ramp_ms) {
+    for (const auto& config : worker.configs) {
+        if (!g_running) {
+            break;
+        }
+        auto bot_result = LoadBot::connect(config);
+        if (bot_result.is_ok()) {
+            worker.bots.push_back(bot_result.unwrap());
+            worker.connected++;
+        } else {
+            BotReport report;
+            report.username = config.username;
+            report.channel_id = config.channel_id;
+            report.error = bot_result.error().message();
+            worker.failed.push_back(std::move(report));
+        }
+        if (ramp_ms > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(ramp_ms));
+        }
+    }
+}
+
+void run_bots(Worker& worker, uint64_t start, uint64_t deadline) {
+    auto& bots = worker.bots;
+    for (auto& bot : bots) {
+        bot->start(start);
+    }
+
+    // Two entries per bot: control, voice
+    std::vector<PollFd> fds(bots.size() * 2);
+    for (size_t i = 0; i < bots.size(); ++i) {
+        fds[2 * i].fd = bots[i]->control_socket();
+        fds[2 * i].events = POLLIN;
+        fds[2 * i + 1].fd = bots[i]->voice_socket();
+        fds[2 * i + 1].events = POLLIN;
+    }
+
+    uint64_t next_publish = start + 1000000;
+    uint64_t now = now_us();
+    while (g_running && now < deadline) {
+        uint64_t wake = std::min(deadline, next_publish);
+        for (const auto& bot : bots) {
+            wake = std::min(wake, bot->next_deadline());
+        }
+        const int timeout_ms = wake > now ? static_cast<int>((wake - now) / 1000) : 0;
+
+        if (poll_sockets(fds.data(), fds.size(), timeout_ms) > 0) {
+            for (size_t i = 0; i < bots.size(); ++i) {
+                if (fds[2 * i].revents != 0 && !bots[i]->on_control_readable()) {
+                    fds[2 * i].fd = INVALID_SOCKET;  // Disconnected; poll ignores negative fds
+                    worker.connected--;
+                }
+                if (fds[2 * i + 1].revents != 0) {
+                    bots[i]->on_voice_readable();
+                }
+            }
+        }
+
+        now = now_us();
+        for (auto& bot : bots) {
+            if (bot->next_deadline() <= now) {
+                bot->on_timer(now);
+            }
+        }
+
+        if (now >= next_publish) {
+            uint64_t sent = 0;
+            uint64_t received = 0;
+            for (const auto& bot : bots) {
+                const auto report = bot->report();
+                sent += report.packets_sent;
+                received += report.packets_received;
+            }
+            worker.packets_sent = sent;
+            worker.packets_received = received;
+            next_publish += 1000000;
+        }
+    }
+}
+
+void print_report(const std::vector<BotReport>& reports, double seconds, const Options& options) {
+    LatencyHistogram latency;
+    uint64_t sent = 0, received = 0, expected = 0, late = 0, decrypt_failures = 0;
+    double jitter_sum = 0.0;
+    uint32_t connected = 0, with_senders = 0;
+
+    for (const auto& report : reports) {
+        if (!report.error.empty()) {
+            continue;
+        }
+        connected++;
+        sent += report.packets_sent;
+        received += report.packets_received;
+        expected += report.packets_expected;
+        late += report.late_frames;
+        decrypt_failures += report.decrypt_failures;
+        latency.merge(report.latency);
+        if (report.senders > 0) {
+            jitter_sum += report.jitter_us;
+            with_senders++;
+        }
+    }
+
+    if (options.per_bot) {
+        std::cout << "\n  bot                  user  chan     sent     recv   loss%  jitter_ms    p50_ms    p99_ms\n";
+        for (const auto& report : reports) {
+            std::cout << "  " << std::left << std::setw(18) << report.username << std::right;
+            if (!report.error.empty()) {
+                std::cout << "  ❌ " << report.error << "\n";
+                continue;
+            }
+            std::cout << std::setw(6) << report.user_id
+                      << std::setw(6) << report.channel_id
+                      << std::setw(9) << report.packets_sent
+                      << std::setw(9) << report.packets_received
+                      << std::fixed << std::setprecision(2)
+                      << std::setw(8) << report.loss_percent()
+                      << std::setw(11) << report.jitter_us / 1000.0
+                      << std::setw(10) << report.latency.percentile(50) / 1000.0
+                      << std::setw(10) << report.latency.percentile(99) / 1000.0
+                      << (report.connected ? "" : "  (disconnected)") << "\n";
+        }
+    }
+
+    const double loss = expected > received
+        ? 100.0 * static_cast<double>(expected - received) / static_cast<double>(expected) : 0.0;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n═══════════════════════════════════════════════\n";
+    std::cout << "  📊 Load Test Results (" << std::setprecision(1) << seconds << "s)\n";
+    std::cout << "═══════════════════════════════════════════════\n";
+    std::cout << "  Bots:       " << connected << "/" << reports.size() << " connected\n";
+    if (options.bot.plaintext) {
+        std::cout << "  Voice:      ⚠️ PLAINTEXT (--plaintext): no SRTP cost, capacity is optimistic\n";
+    } else {
+        std::cout << "  Voice:      SRTP (AES-128-GCM) both ways\n";
+    }
+    std::cout << "  Sent:       " << sent << " packets (" << static_cast<uint64_t>(sent / seconds) << "/s)";
+    if (late > 0) {
+        std::cout << ", ⚠️ " << late << " frames late";
+    }
+    std::cout << "\n";
+    std::cout << "  Received:   " << received << " packets (" << static_cast<uint64_t>(received / seconds) << "/s)";
+    if (decrypt_failures > 0) {
+        std::cout << ", ⚠️ " << decrypt_failures << " failed to decrypt";
+    }
+    std::cout << "\n";
+    std::cout << std::setprecision(2);
+    std::cout << "  Loss:       " << loss << "%\n";
+    std::cout << "  Jitter:     " << (with_senders ? jitter_sum / with_senders / 1000.0 : 0.0) << "ms (mean per stream)\n";
+    std::cout << "  Latency:    p50 " << latency.percentile(50) / 1000.0
+              << "ms  p95 " << latency.percentile(95) / 1000.0
+              << "ms  p99 " << latency.percentile(99) / 1000.0
+              << "ms  max " << latency.max() / 1000.0 << "ms\n";
+}
+
+bool write_csv(const std::vector<BotReport>& reports, const std::string& path, bool plaintext) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << "username,user_id,channel_id,connected,error,packets_sent,late_frames,packets_received,"
+           "packets_expected,loss_percent,senders,jitter_ms,latency_p50_ms,latency_p95_ms,"
+           "latency_p99_ms,latency_max_ms,decrypt_failures,srtp\n";
+    for (const auto& report : reports) {
+        out << report.username << "," << report.user_id << "," << report.channel_id << ","
+            << (report.connected ? 1 : 0) << ",\"" << report.error << "\","
+            << report.packets_sent << "," << report.late_frames << ","
+            << report.packets_received << "," << report.packets_expected << ","
+            << report.loss_percent() << "," << report.senders << ","
+            << report.jitter_us / 1000.0 << ","
+            << report.latency.percentile(50) / 1000.0 << ","
+            << report.latency.percentile(95) / 1000.0 << ","
+            << report.latency.percentile(99) / 1000.0 << ","
+            << report.latency.max() / 1000.0 << ","
+            << report.decrypt_failures << "," << (plaintext ? 0 : 1) << "\n";
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // Log writer thread up before the bot workers log
+    voip::Logger::start();
+
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage();
+        return 1;
+    }
+
+    std::signal(SIGINT, signal_handler);
+    raise_file_limit(options.bots);
+    if (!sockets_startup()) {
+        std::cerr << "❌ Failed to initialize sockets\n";
+        return 1;
+    }
+
+    std::cout << "═══════════════════════════════════════════════\n";
+    std::cout << "  🤖 VoIP Load Generator\n";
+    std::cout << "═══════════════════════════════════════════════\n";
+    std::cout << "  Server:   " << options.bot.host << ":" << options.bot.control_port
+              << " (voice " << options.bot.voice_port << ")\n";
+    std::cout << "  Bots:     " << options.bots << " (" << options.talkers << " talking) in "
+              << options.channels << " channel(s)\n";
+    std::cout << "  PTT:      " << options.bot.talk_ms << "ms on / " << options.bot.idle_ms << "ms off\n";
+    std::cout << "  Voice:    " << (options.bot.plaintext ? "plaintext (optimistic)" : "SRTP") << "\n";
+    std::cout << "  Threads:  " << options.threads << "\n\n";
+
+    auto clip_result = encode_clip(options.clip_path, options.bitrate);
+    if (!clip_result.is_ok()) {
+        std::cerr << "❌ Failed to prepare clip: " << clip_result.error().message() << "\n";
+        return 1;
+    }
+    options.bot.clip = clip_result.unwrap();
+    std::cout << "🎵 Clip: " << options.bot.clip->packets.size() << " frames ("
+              << (options.clip_path.empty() ? "synthesized" : options.clip_path) << ")\n";
+
+    // Assign bots round-robin so every worker gets a share of talkers
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (uint32_t i = 0; i < options.threads; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    std::mt19937_64 rng(std::random_device{}());
+    const uint64_t cycle_us = (static_cast<uint64_t>(options.bot.talk_ms) + options.bot.idle_ms) * 1000;
+    for (uint32_t i = 0; i < options.bots; ++i) {
+        BotConfig config = options.bot;
+        config.username = options.user_prefix + std::to_string(i);
+        config.channel_id = options.channel_base + i % options.channels;
+        config.talker = static_cast<int64_t>(i) < options.talkers;
+        config.phase_us = cycle_us > 0 ? rng() % cycle_us : 0;
+        workers[i % options.threads]->configs.push_back(std::move(config));
+    }
+
+    // Workers log their bots in, then wait for a common start time
+    std::latch setup_done(static_cast<std::ptrdiff_t>(workers.size()));
+    std::latch go(1);
+    std::atomic<uint64_t> start_us{0};
+    std::atomic<uint64_t> deadline_us{0};
+    for (auto& worker : workers) {
+        Worker* w = worker.get();
+        w->thread = std::thread([&, w]() {
+            setup_bots(*w, options.ramp_ms);
+            setup_done.count_down();
+            go.wait();
+            run_bots(*w, start_us.load(), deadline_us.load());
+        });
+    }
+
+    std::cout << "🔌 Connecting " << options.bots << " bots...\n";
+    while (!setup_done.try_wait()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        uint32_t connected = 0;
+        for (const auto& worker : workers) {
+            connected += worker->connected;
+        }
+        std::cout << "\r   " << connected << "/" << options.bots << " connected" << std::flush;
+    }
+
+    uint32_t connected = 0;
+    for (const auto& worker : workers) {
+        connected += worker->connected;
+    }
+    std::cout << "\r   " << connected << "/" << options.bots << " connected\n";
+    std::cout << "▶️  Running for " << options.duration_s << "s (Ctrl+C to stop early)\n";
+
+    const uint64_t start = now_us();
+    start_us = start;
+    deadline_us = start + static_cast<uint64_t>(options.duration_s) * 1000000;
+    go.count_down();
+
+    while (g_running && now_us() < deadline_us) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        uint64_t sent = 0, received = 0;
+        connected = 0;
+        for (const auto& worker : workers) {
+            sent += worker->packets_sent;
+            received += worker->packets_received;
+            connected += worker->connected;
+        }
+        std::cout << "\r📊 " << (now_us() - start) / 1000000 << "s  bots:" << connected
+                  << "  sent:" << sent << "  recv:" << received << "   " << std::flush;
+    }
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+    const double seconds = static_cast<double>(std::min(now_us(), deadline_us.load()) - start) / 1e6;
+    std::cout << "\n";
+
+    std::vector<BotReport> reports;
+    for (auto& worker : workers) {
+        for (const auto& bot : worker->bots) {
+            reports.push_back(bot->report());
+        }
+        for (auto& failed : worker->failed) {
+            reports.push_back(std::move(failed));
+        }
+    }
+    std::sort(reports.begin(), reports.end(), [](const BotReport& a, const BotReport& b) {
+        return a.username.size() != b.username.size() ? a.username.size() < b.username.size()
+                                                        : a.username < b.username;
+    });
+
+    print_report(reports, std::max(seconds, 0.001), options);
+    if (!options.csv_path.empty()) {
+        if (write_csv(reports, options.csv_path, options.bot.plaintext)) {
+            std::cout << "💾 Per-bot results written to " << options.csv_path << "\n";
+        } else {
+            std::cerr << "❌ Cannot write " << options.csv_path << "\n";
+        }
+    }
+
+    workers.clear();  // Close every connection before tearing down sockets
+    sockets_cleanup();
+    return connected > 0 ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "network/udp_socket.h"  // Platform socket headers, SocketType
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#include <winsock2.h>
+using PollFd = WSAPOLLFD;
+#else
+#include <poll.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <cerrno>
+using PollFd = pollfd;
+#endif
+
+namespace voip::loadgen {
+
+/**
+ * Small cross-platform socket helpers for the load generator
+ */
+
+inline bool sockets_startup() {
+#ifdef _WIN32
+    WSADATA wsa_data;
+    return WSAStartup(MAKEWORD(2, 2), &wsa_data) == 0;
+#else
+    return true;
+#endif
+}
+
+inline void sockets_cleanup() {
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+inline void close_socket(SocketType socket) {
+    if (socket == INVALID_SOCKET) {
+        return;
+    }
+#ifdef _WIN32
+    closesocket(socket);
+#else
+    ::close(socket);
+#endif
+}
+
+inline bool set_non_blocking(SocketType socket, bool enable) {
+#ifdef _WIN32
+    u_long mode = enable ? 1 : 0;
+    return ioctlsocket(socket, FIONBIO, &mode) == 0;
+#else
+    const int flags = fcntl(socket, F_GETFL, 0);
+    return fcntl(socket, F_SETFL, enable ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK)) == 0;
+#endif
+}
+
+inline bool would_block() {
+#ifdef _WIN32
+    const int err = WSAGetLastError();
+    return err == WSAEWOULDBLOCK || err == WSAETIMEDOUT;
+#else
+    return errno == EWOULDBLOCK || errno == EAGAIN;
+#endif
+}
+
+inline int poll_sockets(PollFd* fds, size_t count, int timeout_ms) {
+#ifdef _WIN32
+    return WSAPoll(fds, static_cast<ULONG>(count), timeout_ms);
+#else
+    return ::poll(fds, static_cast<nfds_t>(count), timeout_ms);
+#endif
+}
+
+/**
+ * Resolve an IPv4 address for host:port
+ */
+inline bool resolve_ipv4(const std::string& host, uint16_t port, sockaddr_in& out) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || !result) {
+        return false;
+    }
+    out = *reinterpret_cast<const sockaddr_in*>(result->ai_addr);
+    out.sin_port = htons(port);
+    freeaddrinfo(result);
+    return true;
+}
+
+} // namespace voip::loadgen
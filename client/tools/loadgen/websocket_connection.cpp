@@ -0,0 +1,341 @@
+#include "websocket_connection.h"
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+#include <chrono>
+#include <cstring>
+
+namespace voip::loadgen {
+
+namespace {
+
+constexpr uint8_t OPCODE_CONTINUATION = 0x0;
+constexpr uint8_t OPCODE_TEXT = 0x1;
+constexpr uint8_t OPCODE_CLOSE = 0x8;
+constexpr uint8_t OPCODE_PING = 0x9;
+constexpr uint8_t OPCODE_PONG = 0xA;
+
+constexpr const char* WEBSOCKET_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+constexpr size_t MAX_MESSAGE_SIZE = 1 << 20;
+
+std::string base64(const uint8_t* data, size_t size) {
+    std::string out(4 * ((size + 2) / 3), '\0');
+    const int written = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(out.data()), data, static_cast<int>(size));
+    out.resize(static_cast<size_t>(written));
+    return out;
+}
+
+void set_timeout(SocketType socket, uint32_t timeout_ms) {
+#ifdef _WIN32
+    DWORD timeout = timeout_ms;
+#else
+    timeval timeout{};
+    timeout.tv_sec = static_cast<time_t>(timeout_ms / 1000);
+    timeout.tv_usec = static_cast<suseconds_t>((timeout_ms % 1000) * 1000);
+#endif
+    setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+    setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+}
+
+} // namespace
+
+Result<std::unique_ptr<WebSocketConnection>> WebSocketConnection::connect(
+    const std::string& host,
+    uint16_t port,
+    const std::string& path,
+    uint32_t timeout_ms
+) {
+    sockaddr_in addr{};
+    if (!resolve_ipv4(host, port, addr)) {
+        return Err<std::unique_ptr<WebSocketConnection>>(
+            ErrorCode::NetworkConnectionFailed, "Cannot resolve " + host);
+    }
+
+    SocketType sock = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET) {
+        return Err<std::unique_ptr<WebSocketConnection>>(
+            ErrorCode::NetworkConnectionFailed, "Failed to create socket");
+    }
+    set_timeout(sock, timeout_ms);
+
+    // Owns the socket from here on
+    auto connection = std::unique_ptr<WebSocketConnection>(new WebSocketConnection(sock));
+
+    if (::connect(sock, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        return Err<std::unique_ptr<WebSocketConnection>>(
+            ErrorCode::NetworkConnectionFailed,
+            "Cannot connect to " + host + ":" + std::to_string(port));
+    }
+
+    auto handshake_result = connection->handshake(host, port, path);
+    if (!handshake_result.is_ok()) {
+        return Err<std::unique_ptr<WebSocketConnection>>(
+            handshake_result.error().code(), handshake_result.error().message());
+    }
+
+    return Ok(std::move(connection));
+}
+
+WebSocketConnection::WebSocketConnection(SocketType socket)
+    : socket_(socket)
+{
+}
+
+WebSocketConnection::~WebSocketConnection() {
+    if (open_) {
+        (void)send_frame(OPCODE_CLOSE, nullptr, 0);  // Best effort
+    }
+    close_socket(socket_);
+}
+
+Result<void> WebSocketConnection::handshake(const std::string& host, uint16_t port, const std::string& path) {
+    uint8_t nonce[16];
+    RAND_bytes(nonce, sizeof(nonce));
+    const std::string key = base64(nonce, sizeof(nonce));
+
+    const std::string request =
+        "GET " + path + " HTTP/1.1\r\n"
+        "Host: " + host + ":" + std::to_string(port) + "\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Key: " + key + "\r\n"
+        "Sec-WebSocket-Version: 13\r\n\r\n";
+
+    if (::send(socket_, request.data(), static_cast<int>(request.size()), 0) != static_cast<int>(request.size())) {
+        return Err<void>(ErrorCode::NetworkSendFailed, "Failed to send upgrade request");
+    }
+
+    // Read the response headers; anything after them is already frame data
+    std::string response;
+    size_t header_end = std::string::npos;
+    char buffer[1024];
+    while (header_end == std::string::npos) {
+        const int received = ::recv(socket_, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            return Err<void>(ErrorCode::NetworkReceiveFailed, "No upgrade response");
+        }
+        response.append(buffer, static_cast<size_t>(received));
+        header_end = response.find("\r\n\r\n");
+        if (response.size() > 16384) {
+            return Err<void>(ErrorCode::NetworkReceiveFailed, "Upgrade response too large");
+        }
+    }
+
+    if (response.compare(0, 12, "HTTP/1.1 101") != 0) {
+        return Err<void>(ErrorCode::NetworkConnectionFailed,
+                        "Upgrade rejected: " + response.substr(0, response.find("\r\n")));
+    }
+
+    // Sec-WebSocket-Accept = base64(SHA1(key + GUID))
+    const std::string accept_source = key + WEBSOCKET_GUID;
+    uint8_t digest[SHA_DIGEST_LENGTH];
+    SHA1(reinterpret_cast<const unsigned char*>(accept_source.data()), accept_source.size(), digest);
+    if (response.find(base64(digest, sizeof(digest))) == std::string::npos) {
+        return Err<void>(ErrorCode::NetworkConnectionFailed, "Bad Sec-WebSocket-Accept");
+    }
+
+    rx_buffer_.assign(response.begin() + static_cast<std::ptrdiff_t>(header_end + 4), response.end());
+    return Ok();
+}
+
+Result<void> WebSocketConnection::send_text(const std::string& text) {
+    return send_frame(OPCODE_TEXT, reinterpret_cast<const uint8_t*>(text.data()), text.size());
+}
+
+Result<void> WebSocketConnection::send_frame(uint8_t opcode, const uint8_t* payload, size_t size) {
+    if (!open_) {
+        return Err<void>(ErrorCode::NetworkSendFailed, "Connection closed");
+    }
+
+    tx_buffer_.clear();
+    tx_buffer_.push_back(static_cast<uint8_t>(0x80 | opcode));  // FIN
+    if (size < 126) {
+        tx_buffer_.push_back(static_cast<uint8_t>(0x80 | size));
+    } else if (size <= 0xFFFF) {
+        tx_buffer_.push_back(0x80 | 126);
+        tx_buffer_.push_back(static_cast<uint8_t>(size >> 8));
+        tx_buffer_.push_back(static_cast<uint8_t>(size));
+    } else {
+        tx_buffer_.push_back(0x80 | 127);
+        for (int i = 7; i >= 0; --i) {
+            tx_buffer_.push_back(static_cast<uint8_t>(static_cast<uint64_t>(size) >> (8 * i)));
+        }
+    }
+
+    uint8_t mask[4];
+    RAND_bytes(mask, sizeof(mask));
+    tx_buffer_.insert(tx_buffer_.end(), mask, mask + 4);
+    for (size_t i = 0; i < size; ++i) {
+        tx_buffer_.push_back(payload[i] ^ mask[i % 4]);
+    }
+
+    // Control messages are small; a short write only happens if the
+    // server stops reading, which the bot treats as a failure
+    size_t sent = 0;
+    while (sent < tx_buffer_.size()) {
+        const int result = ::send(socket_, reinterpret_cast<const char*>(tx_buffer_.data() + sent),
+                                  static_cast<int>(tx_buffer_.size() - sent), 0);
+        if (result <= 0) {
+            if (result < 0 && would_block()) {
+                PollFd pfd{};
+                pfd.fd = socket_;
+                pfd.events = POLLOUT;
+                poll_sockets(&pfd, 1, 100);
+                continue;
+            }
+            open_ = false;
+            return Err<void>(ErrorCode::NetworkSendFailed, "WebSocket send failed");
+        }
+        sent += static_cast<size_t>(result);
+    }
+    return Ok();
+}
+
+Result<std::string> WebSocketConnection::receive_text(uint32_t timeout_ms) {
+    std::string message;
+    bool received = false;
+    auto capture = [&](const std::string& text) {
+        if (!received) {
+            message = text;
+            received = true;
+        } else {
+            pending_.push_back(text);
+        }
+    };
+
+    if (!pending_.empty()) {
+        message = std::move(pending_.front());
+        pending_.erase(pending_.begin());
+        return Ok(std::move(message));
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!received) {
+        if (!process_frames(capture)) {
+            return Err<std::string>(ErrorCode::InvalidPacket, "WebSocket protocol error");
+        }
+        if (received) {
+            break;
+        }
+        if (!open_) {
+            return Err<std::string>(ErrorCode::NetworkReceiveFailed, "Connection closed");
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return Err<std::string>(ErrorCode::Timeout, "Timed out waiting for server");
+        }
+
+        char buffer[4096];
+        const int count = ::recv(socket_, buffer, sizeof(buffer), 0);
+        if (count == 0) {
+            open_ = false;
+        } else if (count < 0 && !would_block()) {
+            open_ = false;
+        } else if (count > 0) {
+            rx_buffer_.insert(rx_buffer_.end(), buffer, buffer + count);
+        }
+    }
+
+    return Ok(std::move(message));
+}
+
+void WebSocketConnection::set_non_blocking() {
+    voip::loadgen::set_non_blocking(socket_, true);
+}
+
+Result<void> WebSocketConnection::drain(const MessageCallback& callback) {
+    for (auto& text : pending_) {
+        callback(text);
+    }
+    pending_.clear();
+
+    char buffer[4096];
+    while (open_) {
+        const int count = ::recv(socket_, buffer, sizeof(buffer), 0);
+        if (count > 0) {
+            rx_buffer_.insert(rx_buffer_.end(), buffer, buffer + count);
+            continue;
+        }
+        if (count < 0 && would_block()) {
+            break;
+        }
+        open_ = false;
+    }
+
+    if (!process_frames(callback)) {
+        open_ = false;
+        return Err<void>(ErrorCode::InvalidPacket, "WebSocket protocol error");
+    }
+    if (!open_) {
+        return Err<void>(ErrorCode::NetworkReceiveFailed, "Connection closed");
+    }
+    return Ok();
+}
+
+bool WebSocketConnection::process_frames(const MessageCallback& callback) {
+    size_t pos = 0;
+    while (rx_buffer_.size() - pos >= 2) {
+        const uint8_t* frame = rx_buffer_.data() + pos;
+        const size_t available = rx_buffer_.size() - pos;
+        const bool fin = (frame[0] & 0x80) != 0;
+        const uint8_t opcode = frame[0] & 0x0F;
+        const bool masked = (frame[1] & 0x80) != 0;
+        uint64_t length = frame[1] & 0x7F;
+        size_t header = 2;
+
+        if (length == 126) {
+            if (available < 4) break;
+            length = (static_cast<uint64_t>(frame[2]) << 8) | frame[3];
+            header = 4;
+        } else if (length == 127) {
+            if (available < 10) break;
+            length = 0;
+            for (int i = 0; i < 8; ++i) {
+                length = (length << 8) | frame[2 + i];
+            }
+            header = 10;
+        }
+        if (length > MAX_MESSAGE_SIZE) {
+            return false;
+        }
+        const size_t mask_size = masked ? 4 : 0;  // Servers must not mask, but tolerate it
+        if (available < header + mask_size + length) {
+            break;
+        }
+
+        std::string payload(reinterpret_cast<const char*>(frame + header + mask_size),
+                            static_cast<size_t>(length));
+        if (masked) {
+            for (size_t i = 0; i < payload.size(); ++i) {
+                payload[i] = static_cast<char>(payload[i] ^ frame[header + (i % 4)]);
+            }
+        }
+        pos += header + mask_size + static_cast<size_t>(length);
+
+        switch (opcode) {
+            case OPCODE_TEXT:
+            case OPCODE_CONTINUATION:
+                fragment_ += payload;
+                if (fragment_.size() > MAX_MESSAGE_SIZE) {
+                    return false;
+                }
+                if (fin) {
+                    callback(fragment_);
+                    fragment_.clear();
+                }
+                break;
+            case OPCODE_PING:
+                (void)send_frame(OPCODE_PONG, reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+                break;
+            case OPCODE_CLOSE:
+                open_ = false;
+                break;
+            default:
+                break;  // Binary and pong frames are ignored
+        }
+    }
+
+    rx_buffer_.erase(rx_buffer_.begin(), rx_buffer_.begin() + static_cast<std::ptrdiff_t>(pos));
+    return true;
+}
+
+} // namespace voip::loadgen
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "socket_util.h"
+#include "common/result.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace voip::loadgen {
+
+/**
+ * WebSocketConnection - Minimal RFC 6455 client for the control protocol
+ *
+ * Plain ws:// only, text messages only. Used blocking while a bot logs in,
+ * then switched to non-blocking and drained from the worker's poll loop.
+ * Pings are answered automatically. Much lighter than QWebSocket, so a
+ * single process can hold a thousand control connections.
+ *
+ * Thread Safety: Not thread-safe. Owned by one worker thread.
+ */
+class WebSocketConnection {
+public:
+    using MessageCallback = std::function<void(const std::string& text)>;
+
+    /**
+     * Connect and complete the HTTP upgrade (blocking)
+     */
+    static Result<std::unique_ptr<WebSocketConnection>> connect(
+        const std::string& host,
+        uint16_t port,
+        const std::string& path,
+        uint32_t timeout_ms
+    );
+
+    ~WebSocketConnection();
+
+    // Disable copy
+    WebSocketConnection(const WebSocketConnection&) = delete;
+    WebSocketConnection& operator=(const WebSocketConnection&) = delete;
+
+    /**
+     * Send a text message (masked, as required for clients)
+     */
+    Result<void> send_text(const std::string& text);
+
+    /**
+     * Wait for the next text message (blocking mode only)
+     */
+    Result<std::string> receive_text(uint32_t timeout_ms);
+
+    /**
+     * Switch to non-blocking mode for the poll loop
+     */
+    void set_non_blocking();
+
+    /**
+     * Read whatever is available and deliver complete text messages
+     * Returns an error once the connection has closed
+     */
+    Result<void> drain(const MessageCallback& callback);
+
+    [[nodiscard]] SocketType socket() const noexcept { return socket_; }
+    [[nodiscard]] bool is_open() const noexcept { return open_; }
+
+private:
+    explicit WebSocketConnection(SocketType socket);
+
+    Result<void> handshake(const std::string& host, uint16_t port, const std::string& path);
+
+    // Send one masked frame
+    Result<void> send_frame(uint8_t opcode, const uint8_t* payload, size_t size);
+
+    // Parse complete frames out of rx_buffer_; returns false on protocol error
+    bool process_frames(const MessageCallback& callback);
+
+    SocketType socket_;
+    bool open_ = true;
+    std::vector<uint8_t> rx_buffer_;
+    std::string fragment_;       // Text message being reassembled
+    std::vector<std::string> pending_;  // Messages that arrived behind the one awaited
+    std::vector<uint8_t> tx_buffer_;
+};
+
+} // namespace voip::loadgen
@@ -1,6 +1,8 @@
+use crate::network::voice_header::{VoiceAliasTable, COMPACT_FORMAT, LEGACY_FORMAT};
 use crate::types::{ChannelId, UserId, UserInfo, ControlMessage};
-use std::collections::HashMap;
-use tokio::sync::{RwLock, mpsc};
+use std::collections::{HashMap, HashSet};
+use std::sync::atomic::{AtomicU64, Ordering};
+use tokio::sync::{RwLock, RwLockReadGuard, mpsc};
 use tracing::{debug, info, warn};
 
 /// WebSocket sender for a user
@@ -34,6 +36,15 @@ pub struct ChannelManager {
     
     /// Map of user_id -> username
     user_names: RwLock<HashMap<UserId, String>>,
+
+    /// Bumped on every membership change so clients can tell if cached rosters are stale
+    roster_version: AtomicU64,
+
+    /// Voice-plane aliases for the compact header
+    voice_aliases: RwLock<VoiceAliasTable>,
+
+    /// Users that negotiated the compact header (they get the alias table)
+    compact_users: RwLock<HashSet<UserId>>,
 }
 
 impl ChannelManager {
@@ -42,6 +53,9 @@ impl ChannelManager {
             channels: RwLock::new(HashMap::new()),
             user_sockets: RwLock::new(HashMap::new()),
             user_names: RwLock::new(HashMap::new()),
+            roster_version: AtomicU64::new(1),
+            voice_aliases: RwLock::new(VoiceAliasTable::default()),
+            compact_users: RwLock::new(HashSet::new()),
         }
     }
     
@@ -52,8 +66,15 @@ impl ChannelManager {
         
         sockets.insert(user_id, sender);
         names.insert(user_id, username.clone());
+        drop(sockets);
+        drop(names);
         
         info!("✅ Registered user {} (ID: {}) for WebSocket broadcasts", username, user_id);
+
+        let assigned = self.voice_aliases.write().await.assign_user(user_id);
+        if matches!(assigned, Some((_, true))) {
+            self.broadcast_voice_aliases().await;
+        }
     }
     
     /// Unregister a user's WebSocket connection
@@ -72,6 +93,36 @@ impl ChannelManager {
         for channel in channels.values_mut() {
             channel.users.retain(|u| u.id != user_id);
         }
+        self.roster_version.fetch_add(1, Ordering::Relaxed);
+        drop(channels);
+        drop(sockets);
+        drop(names);
+
+        self.compact_users.write().await.remove(&user_id);
+        if self.voice_aliases.write().await.release_user(user_id) {
+            self.broadcast_voice_aliases().await;
+        }
+    }
+    
+    /// Drop a user's WebSocket sender but keep their channel membership
+    /// (the session is parked waiting for the client to resume)
+    ///
+    /// Returns false, leaving things alone, if `sender` is no longer the
+    /// user's registered connection (they already reconnected elsewhere)
+    pub async fn detach_user(&self, user_id: UserId, sender: &WsSender) -> bool {
+        let mut sockets = self.user_sockets.write().await;
+        match sockets.get(&user_id) {
+            Some(current) if current.same_channel(sender) => {
+                sockets.remove(&user_id);
+                true
+            }
+            _ => false,
+        }
+    }
+    
+    /// Current roster version
+    pub fn roster_version(&self) -> u64 {
+        self.roster_version.load(Ordering::Relaxed)
     }
     
     /// Add a user to a channel
@@ -87,10 +138,18 @@ impl ChannelManager {
         if !channel.users.iter().any(|u| u.id == user.id) {
             info!("👤 User {} (ID: {}) joining channel {}", user.name, user.id, channel_id);
             channel.users.push(user.clone());
+            self.roster_version.fetch_add(1, Ordering::Relaxed);
         }
         
         // Return current user list
-        channel.users.clone()
+        let users = channel.users.clone();
+        drop(channels);
+
+        let assigned = self.voice_aliases.write().await.assign_channel(channel_id);
+        if matches!(assigned, Some((_, true))) {
+            self.broadcast_voice_aliases().await;
+        }
+        users
     }
     
     /// Remove a user from a channel
@@ -99,6 +158,7 @@ impl ChannelManager {
         
         if let Some(channel) = channels.get_mut(&channel_id) {
             channel.users.retain(|u| u.id != user_id);
+            self.roster_version.fetch_add(1, Ordering::Relaxed);
             info!("👋 User ID {} left channel {}", user_id, channel_id);
         }
     }
@@ -165,6 +225,48 @@ impl ChannelManager {
         }
     }
     
+    /// Record the voice header formats a client supports; returns the one the
+    /// server will send it
+    pub async fn set_voice_format(&self, user_id: UserId, formats: &[String]) -> &'static str {
+        let mut compact_users = self.compact_users.write().await;
+        if formats.iter().any(|format| format == COMPACT_FORMAT) {
+            compact_users.insert(user_id);
+            COMPACT_FORMAT
+        } else {
+            compact_users.remove(&user_id);
+            LEGACY_FORMAT
+        }
+    }
+
+    /// Whether packets to this user may use the compact header
+    pub async fn uses_compact_header(&self, user_id: UserId) -> bool {
+        self.compact_users.read().await.contains(&user_id)
+    }
+
+    /// Alias table, for encoding and decoding compact headers
+    pub async fn voice_aliases(&self) -> RwLockReadGuard<'_, VoiceAliasTable> {
+        self.voice_aliases.read().await
+    }
+
+    /// The alias table as a `voice_aliases` message
+    pub async fn voice_aliases_message(&self, format: &str) -> ControlMessage {
+        let (users, channels) = self.voice_aliases.read().await.snapshot();
+        ControlMessage::VoiceAliases {
+            format: format.to_string(),
+            users,
+            channels,
+        }
+    }
+
+    /// Send the alias table to every client using the compact header
+    async fn broadcast_voice_aliases(&self) {
+        let message = self.voice_aliases_message(COMPACT_FORMAT).await;
+        let compact_users = self.compact_users.read().await;
+        for user_id in compact_users.iter() {
+            self.send_to_user(*user_id, &message).await;
+        }
+    }
+
     /// Get all channels and their user counts (for listing)
     pub async fn get_all_channels(&self) -> Vec<(ChannelId, String, usize)> {
         let channels = self.channels.read().await;
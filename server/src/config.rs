@@ -1,5 +1,5 @@
 use serde::Deserialize;
-use std::net::SocketAddr;
+use std::net::{IpAddr, SocketAddr};
 
 #[derive(Debug, Deserialize, Clone)]
 pub struct ServerConfig {
@@ -68,15 +68,20 @@ impl ServerConfig {
     }
     
     pub fn control_addr(&self) -> SocketAddr {
-        format!("{}:{}", self.server.bind_address, self.server.control_port)
-            .parse()
-            .expect("Invalid control address")
+        SocketAddr::new(self.bind_ip(), self.server.control_port)
     }
     
     pub fn voice_addr(&self) -> SocketAddr {
-        format!("{}:{}", self.server.bind_address, self.server.voice_port)
+        SocketAddr::new(self.bind_ip(), self.server.voice_port)
+    }
+
+    /// "0.0.0.0" for IPv4 only, "::" for dual-stack IPv6 + IPv4
+    fn bind_ip(&self) -> IpAddr {
+        self.server
+            .bind_address
+            .trim_matches(|c| c == '[' || c == ']')
             .parse()
-            .expect("Invalid voice address")
+            .expect("Invalid bind address")
     }
 }
 
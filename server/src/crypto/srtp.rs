@@ -4,6 +4,7 @@ use aes_gcm::{
     Aes128Gcm, Nonce,
 };
 use rand::RngCore;
+use std::sync::atomic::{AtomicU32, Ordering};
 use std::sync::Arc;
 use tokio::sync::Mutex;
 
@@ -17,8 +18,15 @@ pub struct SrtpSession {
     replay_window: Arc<Mutex<ReplayWindow>>,
     /// Session ID for logging
     session_id: u64,
+    /// Next index for packets the server sends under this key
+    next_index: AtomicU32,
 }
 
+/// First index the server sends under a user's key. The client numbers its
+/// own packets from 1 under the same key, so the upper half keeps the two
+/// directions from ever sharing a nonce.
+const SERVER_INDEX_BASE: u32 = 1 << 31;
+
 /// Replay attack protection
 struct ReplayWindow {
     /// Highest sequence number seen
@@ -51,6 +59,7 @@ impl SrtpSession {
             salt: salt_array,
             replay_window: Arc::new(Mutex::new(ReplayWindow::new())),
             session_id,
+            next_index: AtomicU32::new(SERVER_INDEX_BASE),
         })
     }
 
@@ -94,6 +103,17 @@ impl SrtpSession {
         Ok(encrypted)
     }
 
+    /// Encrypt a packet for this session's user under the next index
+    ///
+    /// Every packet sent to a user gets its own index, whichever sender or
+    /// channel it came from: the user's replay window would reject a
+    /// second packet with the same index, and two senders' packets would
+    /// otherwise share a nonce under this key.
+    pub fn encrypt_next(&self, plaintext: &[u8]) -> Result<Vec<u8>> {
+        let index = self.next_index.fetch_add(1, Ordering::Relaxed) | SERVER_INDEX_BASE;
+        self.encrypt(plaintext, index)
+    }
+
     /// Decrypt a voice packet
     pub async fn decrypt(&self, encrypted: &[u8]) -> Result<Vec<u8>> {
         if encrypted.len() < 4 + 16 {
@@ -272,6 +292,25 @@ mod tests {
         assert!(session.decrypt(&encrypted2).await.is_err());
     }
 
+    #[tokio::test]
+    async fn test_srtp_encrypt_next_never_repeats_index() {
+        let (master_key, salt) = SrtpSession::generate_key_material();
+        let server = SrtpSession::new(&master_key, &salt, 1).unwrap();
+        let recipient = SrtpSession::new(&master_key, &salt, 1).unwrap();
+
+        // One talker's packet fanned out on two channels the recipient is in,
+        // then a second talker's packet that carries the same header sequence
+        let plaintext = b"Same packet";
+        let first = server.encrypt_next(plaintext).unwrap();
+        let second = server.encrypt_next(plaintext).unwrap();
+        let other = server.encrypt_next(b"Other talker").unwrap();
+        assert_ne!(first[..4], second[..4]);
+
+        assert_eq!(recipient.decrypt(&first).await.unwrap(), plaintext);
+        assert_eq!(recipient.decrypt(&second).await.unwrap(), plaintext);
+        assert!(recipient.decrypt(&other).await.is_ok());
+    }
+
     #[test]
     fn test_nonce_derivation() {
         let (master_key, salt) = SrtpSession::generate_key_material();
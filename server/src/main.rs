@@ -88,6 +88,9 @@ async fn main() -> Result<()> {
     // Create pending key exchanges storage
     let pending_key_exchanges = std::sync::Arc::new(tokio::sync::RwLock::new(std::collections::HashMap::new()));
 
+    // Create storage for sessions waiting to be resumed after a dropped connection
+    let parked_sessions = std::sync::Arc::new(network::resume::ParkedSessions::new());
+
     // Create server state with database-backed repositories
     let state = std::sync::Arc::new(network::tls::ServerState {
         jwt_secret: config.security.jwt_secret.clone(),
@@ -101,6 +104,7 @@ async fn main() -> Result<()> {
         permission_checker: permission_checker.clone(),
         srtp_sessions: srtp_sessions.clone(),
         pending_key_exchanges: pending_key_exchanges.clone(),
+        parked_sessions,
     });
 
     // Start UDP voice server
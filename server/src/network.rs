@@ -2,3 +2,5 @@
 
 pub mod udp;
 pub mod tls;
+pub mod resume;
+pub mod voice_header;
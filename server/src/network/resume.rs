@@ -0,0 +1,143 @@
+use crate::types::{Session, UserId};
+use std::collections::HashMap;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::time::Duration;
+use tokio::sync::RwLock;
+use tracing::info;
+
+/// How long a dropped control connection keeps its session
+pub const RESUME_GRACE_PERIOD: Duration = Duration::from_secs(30);
+
+/// A session whose WebSocket dropped, waiting to be resumed
+struct ParkedSession {
+    session: Session,
+    resume_token: String,
+    epoch: u64,
+}
+
+/// Sessions kept alive across a control-plane drop
+///
+/// When a WebSocket closes the session is parked instead of torn down: channel
+/// membership and the SRTP session stay in place, so voice keeps flowing and a
+/// reconnecting client can pick up where it left off with one `resume` message.
+/// If nobody resumes within the grace period the session is cleaned up as usual.
+pub struct ParkedSessions {
+    sessions: RwLock<HashMap<UserId, ParkedSession>>,
+    next_epoch: AtomicU64,
+}
+
+impl ParkedSessions {
+    pub fn new() -> Self {
+        Self {
+            sessions: RwLock::new(HashMap::new()),
+            next_epoch: AtomicU64::new(1),
+        }
+    }
+
+    /// Generate a single-use resume token
+    pub fn new_token() -> String {
+        uuid::Uuid::new_v4().to_string()
+    }
+
+    /// Park a session; returns the epoch to pass to `expire` after the grace period
+    pub async fn park(&self, session: Session, resume_token: String) -> u64 {
+        let epoch = self.next_epoch.fetch_add(1, Ordering::Relaxed);
+
+        info!("⏸️  Parked session for user {} (ID: {})", session.username, session.user_id);
+        let mut sessions = self.sessions.write().await;
+        sessions.insert(session.user_id, ParkedSession { session, resume_token, epoch });
+        epoch
+    }
+
+    /// Take a parked session back if the resume token matches
+    pub async fn take(&self, user_id: UserId, resume_token: &str) -> Option<Session> {
+        let mut sessions = self.sessions.write().await;
+        match sessions.get(&user_id) {
+            Some(parked) if parked.resume_token == resume_token => {
+                sessions.remove(&user_id).map(|parked| parked.session)
+            }
+            _ => None,
+        }
+    }
+
+    /// Remove a parked session regardless of token (the user logged in afresh)
+    pub async fn discard(&self, user_id: UserId) -> Option<Session> {
+        let mut sessions = self.sessions.write().await;
+        sessions.remove(&user_id).map(|parked| parked.session)
+    }
+
+    /// Remove a session whose grace period ran out, unless it was resumed
+    /// (and possibly parked again) in the meantime
+    pub async fn expire(&self, user_id: UserId, epoch: u64) -> Option<Session> {
+        let mut sessions = self.sessions.write().await;
+        match sessions.get(&user_id) {
+            Some(parked) if parked.epoch == epoch => {
+                sessions.remove(&user_id).map(|parked| parked.session)
+            }
+            _ => None,
+        }
+    }
+
+    /// Number of parked sessions
+    pub async fn count(&self) -> usize {
+        let sessions = self.sessions.read().await;
+        sessions.len()
+    }
+}
+
+impl Default for ParkedSessions {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn session(user_id: UserId) -> Session {
+        Session {
+            user_id,
+            org_id: 1,
+            username: format!("user_{}", user_id),
+            roles: vec![],
+            channels: vec![1, 2],
+            last_sequence: 0,
+            resume_token: None,
+        }
+    }
+
+    #[tokio::test]
+    async fn test_take_requires_matching_token() {
+        let parked = ParkedSessions::new();
+        parked.park(session(1), "secret".to_string()).await;
+
+        assert!(parked.take(1, "wrong").await.is_none());
+        let resumed = parked.take(1, "secret").await.unwrap();
+        assert_eq!(resumed.channels, vec![1, 2]);
+        assert_eq!(parked.count().await, 0);
+    }
+
+    #[tokio::test]
+    async fn test_expire_skips_resumed_sessions() {
+        let parked = ParkedSessions::new();
+        let first = parked.park(session(1), "a".to_string()).await;
+
+        // Resumed and dropped again before the first grace period ran out
+        parked.take(1, "a").await.unwrap();
+        let second = parked.park(session(1), "b".to_string()).await;
+
+        assert!(parked.expire(1, first).await.is_none());
+        assert!(parked.expire(1, second).await.is_some());
+        assert_eq!(parked.count().await, 0);
+    }
+
+    #[tokio::test]
+    async fn test_discard_removes_session() {
+        let parked = ParkedSessions::new();
+        parked.park(session(7), "token".to_string()).await;
+
+        assert!(parked.discard(7).await.is_some());
+        assert!(parked.discard(7).await.is_none());
+    }
+}
@@ -2,6 +2,7 @@ use crate::error::{Result, VoipError};
 use crate::types::{ChannelRosterInfo, ControlMessage, Session, UserInfo, UserId, RoleId};
 use crate::auth;
 use crate::channel_manager::ChannelManager;
+use super::resume::{ParkedSessions, RESUME_GRACE_PERIOD};
 use crate::{
     db,
     permissions::PermissionChecker,
@@ -37,6 +38,7 @@ pub struct ServerState {
     pub permission_checker: Arc<PermissionChecker>,
     pub srtp_sessions: Arc<crate::crypto::SrtpSessionManager>,
     pub pending_key_exchanges: Arc<RwLock<HashMap<UserId, crate::crypto::KeyExchange>>>,
+    pub parked_sessions: Arc<ParkedSessions>,
 }
 
 /// WebSocket control handler with admin API routes
@@ -101,7 +103,7 @@ async fn handle_socket(mut socket: WebSocket, state: Arc<ServerState>) {
     
     // Send challenge
     let challenge = ControlMessage::Challenge {
-        methods: vec!["password".to_string(), "token".to_string()],
+        methods: vec!["password".to_string(), "token".to_string(), "resume".to_string()],
         server_version: env!("CARGO_PKG_VERSION").to_string(),
     };
     
@@ -187,28 +189,35 @@ async fn handle_socket(mut socket: WebSocket, state: Arc<ServerState>) {
     }
     
     // Cleanup on disconnect
-    if let Some(sess) = &session {
-        info!("🔌 User {} (ID: {}) disconnected", sess.username, sess.user_id);
+    if let Some(mut sess) = session {
+        if !state.channel_manager.detach_user(sess.user_id, &tx).await {
+            // The client already reconnected on a new socket; that one owns the session now
+            info!("🔌 Stale connection for user {} (ID: {}) closed", sess.username, sess.user_id);
+        } else if let Some(resume_token) = sess.resume_token.take() {
+            info!("🔌 User {} (ID: {}) disconnected, holding session for {}s",
+                  sess.username, sess.user_id, RESUME_GRACE_PERIOD.as_secs());
 
-        // Unregister from channel manager
-        state.channel_manager.unregister_user(sess.user_id).await;
-
-        // Remove SRTP session (cleanup encryption keys)
-        state.srtp_sessions.remove_session(sess.user_id).await;
-
-        // Remove pending key exchange if any
-        {
-            let mut pending = state.pending_key_exchanges.write().await;
-            pending.remove(&sess.user_id);
-        }
+            // A key exchange in flight cannot be completed from another socket
+            {
+                let mut pending = state.pending_key_exchanges.write().await;
+                pending.remove(&sess.user_id);
+            }
 
-        // Notify all channels the user was in
-        for channel_id in &sess.channels {
-            let msg = ControlMessage::UserLeft {
-                channel_id: *channel_id,
-                user_id: sess.user_id,
-            };
-            state.channel_manager.broadcast_to_channel(*channel_id, &msg, None).await;
+            // Keep channel membership and SRTP keys so voice keeps flowing
+            // while the client reconnects
+            let user_id = sess.user_id;
+            let epoch = state.parked_sessions.park(sess, resume_token).await;
+            let state = state.clone();
+            tokio::spawn(async move {
+                tokio::time::sleep(RESUME_GRACE_PERIOD).await;
+                if let Some(expired) = state.parked_sessions.expire(user_id, epoch).await {
+                    info!("⌛ Session for user {} (ID: {}) was not resumed", expired.username, user_id);
+                    release_session(&state, &expired).await;
+                }
+            });
+        } else {
+            info!("🔌 User {} (ID: {}) disconnected", sess.username, sess.user_id);
+            release_session(&state, &sess).await;
         }
     }
     
@@ -294,6 +303,10 @@ async fn handle_control_message(
                                     1, // 1 hour
                                 )?;
 
+                                // A fresh login replaces any session still waiting to be resumed
+                                release_parked_session(state, authenticated_user.id).await;
+
+                                let resume_token = ParkedSessions::new_token();
                                 *authenticated = true;
                                 *session = Some(Session {
                                     user_id: authenticated_user.id,
@@ -302,6 +315,7 @@ async fn handle_control_message(
                                     roles: role_ids,
                                     channels: vec![],
                                     last_sequence: 0,
+                                    resume_token: Some(resume_token.clone()),
                                 });
 
                                 // Register user with channel manager for broadcasts
@@ -322,24 +336,12 @@ async fn handle_control_message(
                                     session_token: Some(token),
                                     voice_key: Some("demo_voice_key".to_string()),
                                     message: Some("Authentication successful".to_string()),
+                                    resume_token: Some(resume_token),
                                 };
                                 send_message(socket, &response).await?;
 
                                 // Initiate key exchange for voice encryption
-                                let kx = crate::crypto::KeyExchange::new();
-                                let server_public_key = kx.public_key_bytes();
-
-                                // Store key exchange object for when client responds
-                                {
-                                    let mut pending = state.pending_key_exchanges.write().await;
-                                    pending.insert(authenticated_user.id, kx);
-                                }
-
-                                let key_exchange_msg = ControlMessage::KeyExchangeInit {
-                                    public_key: server_public_key,
-                                };
-                                send_message(socket, &key_exchange_msg).await?;
-                                info!("🔑 Sent key exchange init to user {}", authenticated_user.id);
+                                start_key_exchange(socket, state, authenticated_user.id).await?;
                             }
                             Ok(None) => {
                                 warn!("Failed login attempt for user: {}", user);
@@ -351,6 +353,7 @@ async fn handle_control_message(
                                     session_token: None,
                                     voice_key: None,
                                     message: Some("Invalid credentials".to_string()),
+                                    resume_token: None,
                                 };
                                 send_message(socket, &response).await?;
                             }
@@ -364,6 +367,7 @@ async fn handle_control_message(
                                     session_token: None,
                                     voice_key: None,
                                     message: Some("Authentication error".to_string()),
+                                    resume_token: None,
                                 };
                                 send_message(socket, &response).await?;
                             }
@@ -387,13 +391,12 @@ async fn handle_control_message(
                                 };
 
                                 // Calculate permissions from roles
-                                let mut total_permissions: u32 = 0;
-                                for role_id in &claims.roles {
-                                    if let Ok(Some(role)) = state.role_repo.get_role(*role_id).await {
-                                        total_permissions |= role.permissions.bits();
-                                    }
-                                }
+                                let total_permissions = role_permissions(state, &claims.roles).await;
+
+                                // A fresh login replaces any session still waiting to be resumed
+                                release_parked_session(state, claims.sub).await;
 
+                                let resume_token = ParkedSessions::new_token();
                                 *authenticated = true;
                                 *session = Some(Session {
                                     user_id: claims.sub,
@@ -402,6 +405,7 @@ async fn handle_control_message(
                                     roles: claims.roles.clone(),
                                     channels: vec![],
                                     last_sequence: 0,
+                                    resume_token: Some(resume_token.clone()),
                                 });
 
                                 // Register user with channel manager for broadcasts
@@ -417,24 +421,12 @@ async fn handle_control_message(
                                     session_token: Some(tok),
                                     voice_key: Some("demo_voice_key".to_string()),
                                     message: Some("Token validated".to_string()),
+                                    resume_token: Some(resume_token),
                                 };
                                 send_message(socket, &response).await?;
 
                                 // Initiate key exchange for voice encryption
-                                let kx = crate::crypto::KeyExchange::new();
-                                let server_public_key = kx.public_key_bytes();
-
-                                // Store key exchange object for when client responds
-                                {
-                                    let mut pending = state.pending_key_exchanges.write().await;
-                                    pending.insert(claims.sub, kx);
-                                }
-
-                                let key_exchange_msg = ControlMessage::KeyExchangeInit {
-                                    public_key: server_public_key,
-                                };
-                                send_message(socket, &key_exchange_msg).await?;
-                                info!("🔑 Sent key exchange init to user {}", claims.sub);
+                                start_key_exchange(socket, state, claims.sub).await?;
                             }
                             Err(_) => {
                                 let response = ControlMessage::AuthResult {
@@ -445,6 +437,7 @@ async fn handle_control_message(
                                     session_token: None,
                                     voice_key: None,
                                     message: Some("Invalid token".to_string()),
+                                    resume_token: None,
                                 };
                                 send_message(socket, &response).await?;
                             }
@@ -701,6 +694,27 @@ async fn handle_control_message(
             Ok(true)
         }
         
+        ControlMessage::VoiceFormat { formats } => {
+            match session {
+                Some(ref sess) if *authenticated => {
+                    let format = state.channel_manager.set_voice_format(sess.user_id, &formats).await;
+                    info!("🗜️ User {} voice header format: {}", sess.user_id, format);
+
+                    // The alias table comes with the answer; later changes are broadcast
+                    let response = state.channel_manager.voice_aliases_message(format).await;
+                    send_message(socket, &response).await?;
+                }
+                _ => {
+                    let response = ControlMessage::Error {
+                        code: "not_authenticated".to_string(),
+                        message: "Must authenticate first".to_string(),
+                    };
+                    send_message(socket, &response).await?;
+                }
+            }
+            Ok(true)
+        }
+
         ControlMessage::Ping { timestamp } => {
             let response = ControlMessage::Pong {
                 timestamp,
@@ -734,9 +748,10 @@ async fn handle_control_message(
 
             info!("User {} (ID: {}) requesting all channel rosters", sess.username, sess.user_id);
 
-            // Get all channels from the database
-            let all_channels = match state.channel_repo.get_channels_by_org(sess.org_id).await {
-                Ok(channels) => channels,
+            // Read the version first: a change racing with the build shows up as stale next time
+            let roster_version = state.channel_manager.roster_version();
+            let rosters = match build_rosters(state, sess).await {
+                Ok(rosters) => rosters,
                 Err(e) => {
                     error!("Error fetching channels: {:?}", e);
                     let response = ControlMessage::Error {
@@ -748,36 +763,145 @@ async fn handle_control_message(
                 }
             };
 
-            // Build roster list for channels user has JOIN permission for
-            let mut rosters = Vec::new();
-            for channel in all_channels {
-                // Check if user has JOIN permission for this channel
-                match state.permission_checker.can_join_channel(sess.user_id, sess.org_id, channel.id).await {
-                    Ok(true) => {
-                        // User has permission - include this channel's roster
-                        let users = state.channel_manager.get_channel_users(channel.id).await;
-                        rosters.push(ChannelRosterInfo {
-                            channel_id: channel.id,
-                            channel_name: channel.name,
-                            users,
-                        });
-                    }
-                    Ok(false) => {
-                        // User doesn't have permission - skip this channel
+            // Send response with all channel rosters
+            let count = rosters.len();
+            let response = ControlMessage::AllChannelRosters {
+                channels: rosters,
+                roster_version,
+            };
+            send_message(socket, &response).await?;
+            info!("✅ Sent rosters for {} channels to user {}", count, sess.username);
+
+            Ok(true)
+        }
+
+        ControlMessage::Resume { session_token, resume_token, channels, roster_version } => {
+            if *authenticated {
+                let response = ControlMessage::Error {
+                    code: "already_authenticated".to_string(),
+                    message: "Already authenticated".to_string(),
+                };
+                send_message(socket, &response).await?;
+                return Ok(true);
+            }
+
+            let claims = match auth::verify_jwt(&session_token, &state.jwt_secret) {
+                Ok(claims) => claims,
+                Err(_) => {
+                    let response = ControlMessage::ResumeFailed {
+                        message: "Session expired".to_string(),
+                    };
+                    send_message(socket, &response).await?;
+                    return Ok(true);
+                }
+            };
+
+            // Warm resume: the old connection's session is still parked, with its
+            // channel membership and SRTP keys intact
+            let parked = match resume_token.as_deref() {
+                Some(token) => state.parked_sessions.take(claims.sub, token).await,
+                None => None,
+            };
+            let warm = parked.is_some();
+            let mut sess = match parked {
+                Some(sess) => sess,
+                None => {
+                    // Cold resume: the grace period ran out (or the token is wrong),
+                    // rebuild the session from the JWT and rejoin below
+                    release_parked_session(state, claims.sub).await;
+                    let username = match state.user_repo.get_user_by_id(claims.sub).await {
+                        Ok(Some(user)) => user.username,
+                        _ => format!("user_{}", claims.sub),
+                    };
+                    Session {
+                        user_id: claims.sub,
+                        org_id: claims.org,
+                        username,
+                        roles: claims.roles.clone(),
+                        channels: vec![],
+                        last_sequence: 0,
+                        resume_token: None,
                     }
+                }
+            };
+
+            state.channel_manager.register_user(sess.user_id, sess.username.clone(), tx.clone()).await;
+
+            // Rejoin whatever the client still thinks it is in, with the same checks
+            // as JoinChannel; password-protected channels need an explicit join
+            for channel_id in channels {
+                if sess.channels.contains(&channel_id) {
+                    continue;
+                }
+                let password_ok = matches!(
+                    state.permission_checker.verify_channel_password(channel_id, None).await,
+                    Ok(true)
+                );
+                let allowed = matches!(
+                    state.permission_checker.can_join_channel(sess.user_id, sess.org_id, channel_id).await,
+                    Ok(true)
+                );
+                if !password_ok || !allowed {
+                    debug!("User {} not rejoined to channel {} on resume", sess.user_id, channel_id);
+                    continue;
+                }
+
+                let user_info = UserInfo {
+                    id: sess.user_id,
+                    name: sess.username.clone(),
+                    speaking: false,
+                };
+                state.channel_manager.join_channel(channel_id, user_info.clone()).await;
+                sess.channels.push(channel_id);
+
+                let notification = ControlMessage::ChannelState {
+                    channel_id,
+                    event: "user_joined".to_string(),
+                    user: Some(user_info),
+                };
+                state.channel_manager.broadcast_to_channel(channel_id, &notification, Some(sess.user_id)).await;
+            }
+
+            // Only resend rosters the client doesn't already have
+            let current_version = state.channel_manager.roster_version();
+            let rosters = if roster_version == Some(current_version) {
+                None
+            } else {
+                match build_rosters(state, &sess).await {
+                    Ok(rosters) => Some(rosters),
                     Err(e) => {
-                        warn!("Error checking permission for channel {}: {:?}", channel.id, e);
-                        // Skip on error
+                        warn!("Error fetching rosters on resume: {:?}", e);
+                        None
                     }
                 }
-            }
+            };
 
-            // Send response with all channel rosters
-            let response = ControlMessage::AllChannelRosters {
-                channels: rosters.clone(),
+            let key_exchange_required = !state.srtp_sessions.has_session(sess.user_id).await;
+            let new_resume_token = ParkedSessions::new_token();
+            sess.resume_token = Some(new_resume_token.clone());
+
+            info!("✅ User {} (ID: {}) resumed session ({}, {} channels)",
+                  sess.username, sess.user_id, if warm { "warm" } else { "cold" }, sess.channels.len());
+
+            let response = ControlMessage::Resumed {
+                user_id: sess.user_id,
+                org_id: sess.org_id,
+                permissions: role_permissions(state, &sess.roles).await,
+                session_token,
+                resume_token: new_resume_token,
+                channels: sess.channels.clone(),
+                roster_version: current_version,
+                rosters,
+                key_exchange_required,
             };
+            let user_id = sess.user_id;
+            *authenticated = true;
+            *session = Some(sess);
             send_message(socket, &response).await?;
-            info!("✅ Sent rosters for {} channels to user {}", rosters.len(), sess.username);
+
+            if key_exchange_required {
+                start_key_exchange(socket, state, user_id).await?;
+            }
 
             Ok(true)
         }
@@ -942,6 +1066,95 @@ async fn handle_control_message(
 }
 
 /// Send control message
+/// Aggregate permissions of a set of roles (bitwise OR)
+async fn role_permissions(state: &Arc<ServerState>, roles: &[RoleId]) -> u32 {
+    let mut total_permissions: u32 = 0;
+    for role_id in roles {
+        if let Ok(Some(role)) = state.role_repo.get_role(*role_id).await {
+            total_permissions |= role.permissions.bits();
+        }
+    }
+    total_permissions
+}
+
+/// Send KeyExchangeInit and remember the server half until the client responds
+async fn start_key_exchange(socket: &mut WebSocket, state: &Arc<ServerState>, user_id: UserId) -> Result<()> {
+    let kx = crate::crypto::KeyExchange::new();
+    let server_public_key = kx.public_key_bytes();
+
+    // Store key exchange object for when client responds
+    {
+        let mut pending = state.pending_key_exchanges.write().await;
+        pending.insert(user_id, kx);
+    }
+
+    let key_exchange_msg = ControlMessage::KeyExchangeInit {
+        public_key: server_public_key,
+    };
+    send_message(socket, &key_exchange_msg).await?;
+    info!("🔑 Sent key exchange init to user {}", user_id);
+    Ok(())
+}
+
+/// Rosters for every channel in the user's organization they may join
+async fn build_rosters(state: &Arc<ServerState>, sess: &Session) -> Result<Vec<ChannelRosterInfo>> {
+    let all_channels = state.channel_repo.get_channels_by_org(sess.org_id).await?;
+
+    let mut rosters = Vec::new();
+    for channel in all_channels {
+        // Check if user has JOIN permission for this channel
+        match state.permission_checker.can_join_channel(sess.user_id, sess.org_id, channel.id).await {
+            Ok(true) => {
+                let users = state.channel_manager.get_channel_users(channel.id).await;
+                rosters.push(ChannelRosterInfo {
+                    channel_id: channel.id,
+                    channel_name: channel.name,
+                    users,
+                });
+            }
+            Ok(false) => {
+                // User doesn't have permission - skip this channel
+            }
+            Err(e) => {
+                warn!("Error checking permission for channel {}: {:?}", channel.id, e);
+                // Skip on error
+            }
+        }
+    }
+    Ok(rosters)
+}
+
+/// Tear down a session: channel membership, encryption keys, pending key exchange
+async fn release_session(state: &Arc<ServerState>, sess: &Session) {
+    // Unregister from channel manager
+    state.channel_manager.unregister_user(sess.user_id).await;
+
+    // Remove SRTP session (cleanup encryption keys)
+    state.srtp_sessions.remove_session(sess.user_id).await;
+
+    // Remove pending key exchange if any
+    {
+        let mut pending = state.pending_key_exchanges.write().await;
+        pending.remove(&sess.user_id);
+    }
+
+    // Notify all channels the user was in
+    for channel_id in &sess.channels {
+        let msg = ControlMessage::UserLeft {
+            channel_id: *channel_id,
+            user_id: sess.user_id,
+        };
+        state.channel_manager.broadcast_to_channel(*channel_id, &msg, None).await;
+    }
+}
+
+/// Release a parked session that will not be resumed (the user logged in again)
+async fn release_parked_session(state: &Arc<ServerState>, user_id: UserId) {
+    if let Some(parked) = state.parked_sessions.discard(user_id).await {
+        release_session(state, &parked).await;
+    }
+}
+
 async fn send_message(socket: &mut WebSocket, msg: &ControlMessage) -> Result<()> {
     let json = serde_json::to_string(msg)
         .map_err(|e| VoipError::Other(format!("JSON serialization failed: {}", e)))?;
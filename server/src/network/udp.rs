@@ -1,13 +1,26 @@
 use crate::error::{Result, VoipError};
-use crate::types::{VoicePacket, VoicePacketHeader, VOICE_PACKET_MAGIC, VOICE_PACKET_HEADER_SIZE};
+use crate::types::{
+    UserId, VoicePacket, VoicePacketHeader, KEEPALIVE_ECHO_MAGIC, KEEPALIVE_MAGIC,
+    KEEPALIVE_PACKET_SIZE, VOICE_PACKET_MAGIC, VOICE_PACKET_HEADER_SIZE,
+};
 use crate::routing::VoiceRouter;
 use crate::channel_manager::ChannelManager;
+use super::voice_header::{
+    CompactHeader, StreamExtender, VoiceAliasTable, COMPACT_HEADER_MAX_SIZE, COMPACT_HEADER_VERSION,
+};
 use crate::crypto::SrtpSessionManager;
+use socket2::{Domain, Protocol, Socket, Type};
 use tokio::net::UdpSocket;
 use std::net::SocketAddr;
 use std::sync::Arc;
 use tracing::{debug, warn, error, info};
 
+/// Expedited Forwarding, as the clients mark their voice packets
+const VOICE_DSCP: u32 = 46;
+
+/// Socket buffers for all clients' voice (about a second of 1000 streams)
+const VOICE_SOCKET_BUFFER_BYTES: usize = 4 * 1024 * 1024;
+
 /// UDP Voice Server
 ///
 /// Handles incoming voice packets and routes them to channel members
@@ -26,12 +39,9 @@ impl UdpVoiceServer {
         channel_manager: Arc<ChannelManager>,
         srtp_sessions: Arc<SrtpSessionManager>,
     ) -> Result<Self> {
-        let socket = UdpSocket::bind(addr).await?;
+        let socket = UdpSocket::from_std(Self::voice_socket(addr)?)?;
         info!("🎤 UDP voice server listening on {}", socket.local_addr()?);
 
-        // Set socket options for optimal voice traffic
-        socket.set_broadcast(false)?;
-
         Ok(Self {
             socket: Arc::new(socket),
             router,
@@ -40,6 +50,38 @@ impl UdpVoiceServer {
         })
     }
     
+    /// Create the voice socket: EF-marked so voice wins against bulk traffic
+    /// on shared links, with room to absorb bursts from many clients
+    fn voice_socket(addr: SocketAddr) -> Result<std::net::UdpSocket> {
+        let socket = Socket::new(Domain::for_address(addr), Type::DGRAM, Some(Protocol::UDP))?;
+
+        let traffic_class = VOICE_DSCP << 2;
+        if addr.is_ipv6() {
+            // "::" also serves IPv4 clients (v4-mapped); those use IP_TOS
+            socket.set_only_v6(false)?;
+            #[cfg(target_os = "linux")]
+            if let Err(e) = socket.set_tclass_v6(traffic_class) {
+                warn!("Cannot set IPv6 traffic class on voice socket: {:?}", e);
+            }
+        }
+        if let Err(e) = socket.set_tos_v4(traffic_class) {
+            if addr.is_ipv4() {
+                warn!("Cannot set DSCP on voice socket: {:?}", e);
+            }
+        }
+        if let Err(e) = socket.set_recv_buffer_size(VOICE_SOCKET_BUFFER_BYTES) {
+            warn!("Cannot size voice socket receive buffer: {:?}", e);
+        }
+        if let Err(e) = socket.set_send_buffer_size(VOICE_SOCKET_BUFFER_BYTES) {
+            warn!("Cannot size voice socket send buffer: {:?}", e);
+        }
+        socket.set_broadcast(false)?;
+        socket.set_nonblocking(true)?;
+        socket.bind(&addr.into())?;
+
+        Ok(socket.into())
+    }
+
     /// Start receiving packets (spawns background task)
     pub fn start(self: Arc<Self>) -> tokio::task::JoinHandle<()> {
         tokio::spawn(async move {
@@ -50,14 +92,34 @@ impl UdpVoiceServer {
     /// Main receive loop
     async fn receive_loop(&self) {
         let mut buffer = vec![0u8; 2048]; // Max UDP packet size
+        // Restores full sequence numbers/timestamps of compact-header streams
+        let mut extender = StreamExtender::default();
         
         loop {
             match self.socket.recv_from(&mut buffer).await {
                 Ok((len, peer_addr)) => {
                     debug!("Received {} bytes from {}", len, peer_addr);
+
+                    // Keepalive probe: refresh the NAT binding and echo it straight back.
+                    // User 0 is a client racing candidate paths before it has picked one.
+                    if let Some((user, echo)) = Self::keepalive_echo(&buffer[..len]) {
+                        if user != 0 {
+                            self.router.register_udp_address(user, peer_addr).await;
+                        }
+                        if let Err(e) = self.socket.send_to(&echo, peer_addr).await {
+                            debug!("Failed to echo keepalive to {}: {:?}", peer_addr, e);
+                        }
+                        continue;
+                    }
                     
-                    // Parse packet
-                    match Self::parse_voice_packet(&buffer[..len]) {
+                    // Parse packet (compact header or legacy)
+                    let parsed = if buffer[..len].first() == Some(&COMPACT_HEADER_VERSION) {
+                        let aliases = self.channel_manager.voice_aliases().await;
+                        Self::parse_compact_packet(&buffer[..len], &aliases, &mut extender)
+                    } else {
+                        Self::parse_voice_packet(&buffer[..len])
+                    };
+                    match parsed {
                         Ok(packet) => {
                             // Copy packed struct fields to avoid alignment issues
                             let seq = packet.header.sequence;
@@ -103,8 +165,10 @@ impl UdpVoiceServer {
                                     // Get SRTP session for recipient
                                     match self.srtp_sessions.get_session(channel_user.id).await {
                                         Some(recipient_srtp) => {
-                                            // Re-encrypt for this recipient
-                                            match recipient_srtp.encrypt(&plaintext_audio, seq as u32) {
+                                            // Re-encrypt for this recipient under its own next
+                                            // index: the header sequence repeats across the
+                                            // talker's target channels and between talkers
+                                            match recipient_srtp.encrypt_next(&plaintext_audio) {
                                                 Ok(encrypted_for_recipient) => {
                                                     // Create new packet for recipient
                                                     let recipient_packet = VoicePacket {
@@ -114,7 +178,7 @@ impl UdpVoiceServer {
 
                                                     // Look up UDP address for this user
                                                     if let Some(udp_addr) = self.router.get_udp_address(channel_user.id).await {
-                                                        if let Ok(data) = Self::serialize_packet(&recipient_packet) {
+                                                        if let Ok(data) = self.serialize_for(channel_user.id, &recipient_packet).await {
                                                             match self.socket.send_to(&data, udp_addr).await {
                                                                 Ok(_) => {
                                                                     sent_count += 1;
@@ -142,7 +206,7 @@ impl UdpVoiceServer {
                                             };
 
                                             if let Some(udp_addr) = self.router.get_udp_address(channel_user.id).await {
-                                                if let Ok(data) = Self::serialize_packet(&recipient_packet) {
+                                                if let Ok(data) = self.serialize_for(channel_user.id, &recipient_packet).await {
                                                     match self.socket.send_to(&data, udp_addr).await {
                                                         Ok(_) => {
                                                             sent_count += 1;
@@ -177,6 +241,21 @@ impl UdpVoiceServer {
         }
     }
     
+    /// If `data` is a keepalive probe, return the sender and the echo to send back
+    ///
+    /// The echo is the probe with its magic swapped, so the client can match it
+    /// against its own sequence number and send timestamp.
+    fn keepalive_echo(data: &[u8]) -> Option<(UserId, [u8; KEEPALIVE_PACKET_SIZE])> {
+        let mut echo: [u8; KEEPALIVE_PACKET_SIZE] = data.try_into().ok()?;
+        if u32::from_be_bytes(echo[0..4].try_into().ok()?) != KEEPALIVE_MAGIC {
+            return None;
+        }
+
+        let user_id = u32::from_be_bytes(echo[16..20].try_into().ok()?);
+        echo[0..4].copy_from_slice(&KEEPALIVE_ECHO_MAGIC.to_be_bytes());
+        Some((user_id, echo))
+    }
+
     /// Parse raw bytes into VoicePacket
     fn parse_voice_packet(data: &[u8]) -> Result<VoicePacket> {
         if data.len() < VOICE_PACKET_HEADER_SIZE {
@@ -220,6 +299,66 @@ impl UdpVoiceServer {
         })
     }
     
+    /// Parse a compact-header packet: IDs come from the alias table, full
+    /// sequence number and timestamp from the stream's history
+    fn parse_compact_packet(
+        data: &[u8],
+        aliases: &VoiceAliasTable,
+        extender: &mut StreamExtender,
+    ) -> Result<VoicePacket> {
+        let (compact, size) = CompactHeader::read(data)
+            .ok_or_else(|| VoipError::InvalidPacket("Truncated compact header".to_string()))?;
+
+        let (Some(user_id), Some(channel_id)) =
+            (aliases.user_for(compact.user_alias), aliases.channel_for(compact.channel_alias))
+        else {
+            return Err(VoipError::InvalidPacket(format!(
+                "Unknown voice alias: user {}, channel {}",
+                compact.user_alias, compact.channel_alias
+            )));
+        };
+
+        let encrypted_payload = data[size..].to_vec();
+        if encrypted_payload.is_empty() {
+            return Err(VoipError::InvalidPacket("No payload".to_string()));
+        }
+
+        let (sequence, timestamp) = extender.restore(user_id, channel_id, &compact);
+        Ok(VoicePacket {
+            header: VoicePacketHeader {
+                magic: VOICE_PACKET_MAGIC,
+                sequence,
+                timestamp,
+                channel_id,
+                user_id,
+            },
+            encrypted_payload,
+        })
+    }
+
+    /// Serialize for one recipient: the compact header if it negotiated that
+    /// and both aliases are known, the legacy header otherwise
+    async fn serialize_for(&self, recipient: UserId, packet: &VoicePacket) -> Result<Vec<u8>> {
+        if self.channel_manager.uses_compact_header(recipient).await {
+            let aliases = self.channel_manager.voice_aliases().await;
+            if let (Some(user_alias), Some(channel_alias)) = (
+                aliases.user_alias(packet.header.user_id),
+                aliases.channel_alias(packet.header.channel_id),
+            ) {
+                return Ok(Self::serialize_compact(packet, user_alias, channel_alias));
+            }
+        }
+        Self::serialize_packet(packet)
+    }
+
+    fn serialize_compact(packet: &VoicePacket, user_alias: u16, channel_alias: u16) -> Vec<u8> {
+        let mut data = Vec::with_capacity(COMPACT_HEADER_MAX_SIZE + packet.encrypted_payload.len());
+        CompactHeader::new(user_alias, channel_alias, packet.header.sequence, packet.header.timestamp)
+            .write(&mut data);
+        data.extend_from_slice(&packet.encrypted_payload);
+        data
+    }
+
     /// Send voice packet to peer
     pub async fn send_to(&self, packet: &VoicePacket, addr: SocketAddr) -> Result<()> {
         let data = Self::serialize_packet(packet)?;
@@ -324,6 +463,59 @@ mod tests {
         assert!(result.is_err());
     }
     
+    #[test]
+    fn test_keepalive_echo() {
+        let mut probe = [0u8; KEEPALIVE_PACKET_SIZE];
+        probe[0..4].copy_from_slice(&KEEPALIVE_MAGIC.to_be_bytes());
+        probe[4..8].copy_from_slice(&7u32.to_be_bytes());
+        probe[8..16].copy_from_slice(&123456u64.to_be_bytes());
+        probe[16..20].copy_from_slice(&42u32.to_be_bytes());
+
+        let (user_id, echo) = UdpVoiceServer::keepalive_echo(&probe).unwrap();
+        assert_eq!(user_id, 42);
+        assert_eq!(&echo[0..4], &KEEPALIVE_ECHO_MAGIC.to_be_bytes());
+        assert_eq!(&echo[4..], &probe[4..]);
+
+        // Echoes and voice packets are not probes
+        assert!(UdpVoiceServer::keepalive_echo(&echo).is_none());
+        assert!(UdpVoiceServer::keepalive_echo(&probe[..KEEPALIVE_PACKET_SIZE - 1]).is_none());
+        let mut voice = vec![0u8; 128];
+        voice[0..4].copy_from_slice(&VOICE_PACKET_MAGIC.to_be_bytes());
+        assert!(UdpVoiceServer::keepalive_echo(&voice).is_none());
+    }
+
+    #[test]
+    fn test_compact_roundtrip() {
+        let mut aliases = VoiceAliasTable::default();
+        let (user_alias, _) = aliases.assign_user(42).unwrap();
+        let (channel_alias, _) = aliases.assign_channel(5).unwrap();
+
+        let packet = VoicePacket {
+            header: VoicePacketHeader {
+                magic: VOICE_PACKET_MAGIC,
+                sequence: 123,
+                timestamp: 999999,
+                channel_id: 5,
+                user_id: 42,
+            },
+            encrypted_payload: vec![1, 2, 3, 4, 5],
+        };
+
+        let data = UdpVoiceServer::serialize_compact(&packet, user_alias, channel_alias);
+        assert_eq!(data.len(), 9 + 5);
+
+        let mut extender = StreamExtender::default();
+        let parsed = UdpVoiceServer::parse_compact_packet(&data, &aliases, &mut extender).unwrap();
+        let (sequence, timestamp) = (parsed.header.sequence, parsed.header.timestamp);
+        let (channel_id, user_id) = (parsed.header.channel_id, parsed.header.user_id);
+        assert_eq!((sequence, timestamp, channel_id, user_id), (123, 999999, 5, 42));
+        assert_eq!(parsed.encrypted_payload, vec![1, 2, 3, 4, 5]);
+
+        // Aliases the server never handed out are rejected
+        let unknown = UdpVoiceServer::serialize_compact(&packet, user_alias + 1, channel_alias);
+        assert!(UdpVoiceServer::parse_compact_packet(&unknown, &aliases, &mut extender).is_err());
+    }
+
     #[tokio::test]
     async fn test_serialize_deserialize() {
         let packet = VoicePacket {
@@ -0,0 +1,367 @@
+// Compact voice header (format "compact_v1")
+//
+// The legacy header spends 28 bytes on magic, 64-bit sequence and timestamp and
+// 32-bit channel/user IDs. The compact one is typically 9:
+//
+//   version (1) | user alias (varint) | channel alias (varint) |
+//   sequence low 16 bits (2, BE) | timestamp low 32 bits (4, BE, microseconds)
+//
+// Aliases are short per-server IDs handed out over the control plane (see
+// `VoiceAliasTable`). Sequence and timestamp carry only their low bits; the
+// receiver restores the rest from the last value it saw on the same stream, so
+// a lost packet never desynchronizes it the way a delta against the previous
+// packet would. Everything is read byte by byte, never through a cast.
+
+use crate::types::{ChannelId, UserId, VoiceAlias};
+use std::collections::HashMap;
+use std::time::{Duration, Instant};
+
+/// First byte of a compact packet (legacy packets start with the 'V' of 'VOIP')
+pub const COMPACT_HEADER_VERSION: u8 = 0xC1;
+
+/// Version byte, two 3-byte varints, sequence and timestamp
+pub const COMPACT_HEADER_MAX_SIZE: usize = 1 + 3 + 3 + 2 + 4;
+
+/// Format names used in `voice_format` negotiation
+pub const COMPACT_FORMAT: &str = "compact_v1";
+pub const LEGACY_FORMAT: &str = "legacy";
+
+const SEQUENCE_BITS: u32 = 16;
+const TIMESTAMP_BITS: u32 = 32;
+
+/// Compact header fields as they appear on the wire
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct CompactHeader {
+    pub user_alias: u16,
+    pub channel_alias: u16,
+    pub sequence_lsb: u16,
+    pub timestamp_lsb: u32,
+}
+
+impl CompactHeader {
+    pub fn new(user_alias: u16, channel_alias: u16, sequence: u64, timestamp: u64) -> Self {
+        Self {
+            user_alias,
+            channel_alias,
+            sequence_lsb: sequence as u16,
+            timestamp_lsb: timestamp as u32,
+        }
+    }
+
+    /// Append the encoded header to `out`
+    pub fn write(&self, out: &mut Vec<u8>) {
+        out.push(COMPACT_HEADER_VERSION);
+        write_varint(out, self.user_alias);
+        write_varint(out, self.channel_alias);
+        out.extend_from_slice(&self.sequence_lsb.to_be_bytes());
+        out.extend_from_slice(&self.timestamp_lsb.to_be_bytes());
+    }
+
+    /// Parse a header from the front of `data`; returns it and its encoded size
+    pub fn read(data: &[u8]) -> Option<(Self, usize)> {
+        if *data.first()? != COMPACT_HEADER_VERSION {
+            return None;
+        }
+        let mut pos = 1;
+        let user_alias = read_varint(data, &mut pos)?;
+        let channel_alias = read_varint(data, &mut pos)?;
+        let sequence = data.get(pos..pos + 2)?;
+        let timestamp = data.get(pos + 2..pos + 6)?;
+        let header = Self {
+            user_alias,
+            channel_alias,
+            sequence_lsb: u16::from_be_bytes([sequence[0], sequence[1]]),
+            timestamp_lsb: u32::from_be_bytes([timestamp[0], timestamp[1], timestamp[2], timestamp[3]]),
+        };
+        Some((header, pos + 6))
+    }
+}
+
+/// LEB128: 7 bits per byte, low bits first; aliases under 128 take one byte
+fn write_varint(out: &mut Vec<u8>, mut value: u16) {
+    while value >= 0x80 {
+        out.push((value as u8 & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out.push(value as u8);
+}
+
+fn read_varint(data: &[u8], pos: &mut usize) -> Option<u16> {
+    let mut value: u32 = 0;
+    for shift in [0, 7, 14] {
+        let byte = *data.get(*pos)?;
+        *pos += 1;
+        value |= u32::from(byte & 0x7F) << shift;
+        if byte & 0x80 == 0 {
+            return u16::try_from(value).ok();
+        }
+    }
+    None
+}
+
+/// The value ending in `lsb` (low `bits` bits) closest to `reference`
+pub fn extend_lsb(reference: u64, lsb: u64, bits: u32) -> u64 {
+    let range = 1u64 << bits;
+    let half = range / 2;
+    let candidate = (reference & !(range - 1)) | lsb;
+    if candidate < reference && reference - candidate > half {
+        candidate.wrapping_add(range)
+    } else if candidate > reference && candidate - reference > half && candidate >= range {
+        candidate - range
+    } else {
+        candidate
+    }
+}
+
+/// Restores full sequence numbers and timestamps per (sender, channel) stream
+///
+/// Only the receiving side keeps state; the first packet of a stream sets its
+/// reference, so restored values match the sender's up to a constant multiple
+/// of the field range - which ordering and jitter measurement don't notice.
+///
+/// A stream silent for `STREAM_IDLE` (push-to-talk released) has its timestamp
+/// reference re-seeded by the time that passed: past 2^31 us the low bits alone
+/// no longer tell which wrap the sender is on. The sequence only moves when
+/// packets are sent, so it keeps its reference. At most `MAX_STREAMS` streams
+/// are tracked; idle ones, then the longest silent, make room.
+#[derive(Default)]
+pub struct StreamExtender {
+    streams: HashMap<(UserId, ChannelId), Stream>,
+}
+
+struct Stream {
+    sequence: u64,
+    timestamp: u64,
+    last_seen: Instant,
+}
+
+impl StreamExtender {
+    pub const STREAM_IDLE: Duration = Duration::from_secs(5);
+    pub const MAX_STREAMS: usize = 4096;
+
+    pub fn restore(&mut self, user: UserId, channel: ChannelId, header: &CompactHeader) -> (u64, u64) {
+        self.restore_at(user, channel, header, Instant::now())
+    }
+
+    /// `restore` at a given time (tests drive the clock)
+    pub fn restore_at(&mut self, user: UserId, channel: ChannelId, header: &CompactHeader, now: Instant) -> (u64, u64) {
+        let seq_lsb = u64::from(header.sequence_lsb);
+        let ts_lsb = u64::from(header.timestamp_lsb);
+        if !self.streams.contains_key(&(user, channel)) && self.streams.len() >= Self::MAX_STREAMS {
+            self.evict(now);
+        }
+        let entry = self.streams.entry((user, channel)).or_insert(Stream {
+            sequence: seq_lsb,
+            timestamp: ts_lsb,
+            last_seen: now,
+        });
+        let idle = now.saturating_duration_since(entry.last_seen);
+        if idle > Self::STREAM_IDLE {
+            let elapsed_us = u64::try_from(idle.as_micros()).unwrap_or(u64::MAX);
+            entry.timestamp = entry.timestamp.saturating_add(elapsed_us);
+        }
+        entry.last_seen = now;
+
+        let sequence = extend_lsb(entry.sequence, seq_lsb, SEQUENCE_BITS);
+        let timestamp = extend_lsb(entry.timestamp, ts_lsb, TIMESTAMP_BITS);
+        // Late packets restore against the newest value but don't move it back
+        if sequence >= entry.sequence {
+            entry.sequence = sequence;
+            entry.timestamp = timestamp;
+        }
+        (sequence, timestamp)
+    }
+
+    pub fn stream_count(&self) -> usize {
+        self.streams.len()
+    }
+
+    fn evict(&mut self, now: Instant) {
+        self.streams
+            .retain(|_, stream| now.saturating_duration_since(stream.last_seen) <= Self::STREAM_IDLE);
+        if self.streams.len() >= Self::MAX_STREAMS {
+            let oldest = self.streams.iter().min_by_key(|(_, stream)| stream.last_seen);
+            if let Some(key) = oldest.map(|(key, _)| *key) {
+                self.streams.remove(&key);
+            }
+        }
+    }
+}
+
+/// Short voice-plane aliases for users and channels
+///
+/// Every registered user and every joined channel gets the smallest free alias
+/// (from 1); clients that negotiated the compact format receive the whole table
+/// whenever it changes.
+#[derive(Default)]
+pub struct VoiceAliasTable {
+    users: HashMap<UserId, u16>,
+    user_by_alias: HashMap<u16, UserId>,
+    channels: HashMap<ChannelId, u16>,
+    channel_by_alias: HashMap<u16, ChannelId>,
+}
+
+impl VoiceAliasTable {
+    /// Alias for `user`, assigning one if needed; the flag says whether it is new
+    pub fn assign_user(&mut self, user: UserId) -> Option<(u16, bool)> {
+        Self::assign(&mut self.users, &mut self.user_by_alias, user)
+    }
+
+    pub fn assign_channel(&mut self, channel: ChannelId) -> Option<(u16, bool)> {
+        Self::assign(&mut self.channels, &mut self.channel_by_alias, channel)
+    }
+
+    /// Returns true if the user had an alias
+    pub fn release_user(&mut self, user: UserId) -> bool {
+        match self.users.remove(&user) {
+            Some(alias) => {
+                self.user_by_alias.remove(&alias);
+                true
+            }
+            None => false,
+        }
+    }
+
+    pub fn user_alias(&self, user: UserId) -> Option<u16> {
+        self.users.get(&user).copied()
+    }
+
+    pub fn channel_alias(&self, channel: ChannelId) -> Option<u16> {
+        self.channels.get(&channel).copied()
+    }
+
+    pub fn user_for(&self, alias: u16) -> Option<UserId> {
+        self.user_by_alias.get(&alias).copied()
+    }
+
+    pub fn channel_for(&self, alias: u16) -> Option<ChannelId> {
+        self.channel_by_alias.get(&alias).copied()
+    }
+
+    /// (users, channels) as sent in `voice_aliases`
+    pub fn snapshot(&self) -> (Vec<VoiceAlias>, Vec<VoiceAlias>) {
+        let collect = |map: &HashMap<u32, u16>| {
+            let mut entries: Vec<VoiceAlias> = map.iter().map(|(&id, &alias)| VoiceAlias { id, alias }).collect();
+            entries.sort_by_key(|entry| entry.alias);
+            entries
+        };
+        (collect(&self.users), collect(&self.channels))
+    }
+
+    fn assign(ids: &mut HashMap<u32, u16>, by_alias: &mut HashMap<u16, u32>, id: u32) -> Option<(u16, bool)> {
+        if let Some(&alias) = ids.get(&id) {
+            return Some((alias, false));
+        }
+        let alias = (1..=u16::MAX).find(|alias| !by_alias.contains_key(alias))?;
+        ids.insert(id, alias);
+        by_alias.insert(alias, id);
+        Some((alias, true))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_compact_header_roundtrip() {
+        let header = CompactHeader::new(5, 300, 0x1_2345, 0xAB_CDEF_0123);
+        let mut data = Vec::new();
+        header.write(&mut data);
+        // Alias 300 needs two varint bytes
+        assert_eq!(data.len(), 1 + 1 + 2 + 2 + 4);
+
+        data.extend_from_slice(&[9, 9, 9]);
+        let (parsed, size) = CompactHeader::read(&data).unwrap();
+        assert_eq!(parsed, header);
+        assert_eq!(size, 10);
+        assert_eq!(parsed.sequence_lsb, 0x2345);
+        assert_eq!(parsed.timestamp_lsb, 0xCDEF_0123);
+    }
+
+    #[test]
+    fn test_compact_header_rejects_truncated() {
+        let mut data = Vec::new();
+        CompactHeader::new(1, 1, 7, 7).write(&mut data);
+        assert_eq!(data.len(), 9);
+        for len in 0..data.len() {
+            assert!(CompactHeader::read(&data[..len]).is_none());
+        }
+        // Legacy packets are not compact
+        assert!(CompactHeader::read(&0x564F4950u32.to_be_bytes()).is_none());
+    }
+
+    #[test]
+    fn test_extend_lsb_wraps() {
+        assert_eq!(extend_lsb(65535, 0, 16), 65536);
+        assert_eq!(extend_lsb(65536, 65535, 16), 65535);
+        assert_eq!(extend_lsb(10, 65530, 16), 65530);
+        assert_eq!(extend_lsb(0x1_0000_0005, 3, 32), 0x1_0000_0003);
+    }
+
+    #[test]
+    fn test_stream_extender_survives_loss() {
+        let mut extender = StreamExtender::default();
+        let mut restored = Vec::new();
+        // Every third packet lost across a sequence wrap
+        for seq in (65500u64..65600).filter(|seq| seq % 3 != 0) {
+            let header = CompactHeader::new(1, 1, seq, seq * 20_000);
+            restored.push(extender.restore(7, 100, &header));
+        }
+        let first = restored[0];
+        for (sequence, timestamp) in &restored {
+            assert_eq!(sequence - first.0, (timestamp - first.1) / 20_000);
+        }
+        assert_eq!(restored.last().unwrap().0 - first.0, 65599 - 65500);
+    }
+
+    #[test]
+    fn test_stream_extender_reseeds_after_long_silence() {
+        let mut extender = StreamExtender::default();
+        let start = Instant::now();
+        let ts0 = 5_000_000_000u64;
+        let first = extender.restore_at(7, 100, &CompactHeader::new(1, 1, 100, ts0), start);
+
+        // Push-to-talk released for 40 minutes, past half the 32-bit timestamp range
+        let pause = Duration::from_secs(40 * 60);
+        let ts1 = ts0 + pause.as_micros() as u64;
+        let resumed = extender.restore_at(7, 100, &CompactHeader::new(1, 1, 101, ts1), start + pause);
+        assert_eq!(resumed.0, first.0 + 1);
+        assert_eq!(resumed.1 - first.1, ts1 - ts0);
+    }
+
+    #[test]
+    fn test_stream_extender_bounds_table() {
+        let mut extender = StreamExtender::default();
+        let start = Instant::now();
+        let senders = (StreamExtender::MAX_STREAMS + 100) as u32;
+        for user in 0..senders {
+            let now = start + Duration::from_micros(u64::from(user));
+            extender.restore_at(user, 100, &CompactHeader::new(1, 1, 5, 0), now);
+        }
+        assert_eq!(extender.stream_count(), StreamExtender::MAX_STREAMS);
+
+        // Once they fall idle, a new stream sweeps them all out
+        let later = start + StreamExtender::STREAM_IDLE + Duration::from_secs(1);
+        let (sequence, _) = extender.restore_at(senders, 100, &CompactHeader::new(1, 1, 9, 0), later);
+        assert_eq!(sequence, 9);
+        assert_eq!(extender.stream_count(), 1);
+    }
+
+    #[test]
+    fn test_alias_table_reuses_freed_aliases() {
+        let mut table = VoiceAliasTable::default();
+        assert_eq!(table.assign_user(10), Some((1, true)));
+        assert_eq!(table.assign_user(20), Some((2, true)));
+        assert_eq!(table.assign_user(10), Some((1, false)));
+        assert!(table.release_user(10));
+        assert_eq!(table.user_for(1), None);
+        assert_eq!(table.assign_user(30), Some((1, true)));
+        assert_eq!(table.assign_channel(100), Some((1, true)));
+        assert_eq!(table.channel_for(1), Some(100));
+
+        let (users, channels) = table.snapshot();
+        assert_eq!(users.iter().map(|a| (a.id, a.alias)).collect::<Vec<_>>(), vec![(30, 1), (20, 2)]);
+        assert_eq!(channels.len(), 1);
+    }
+}
@@ -14,6 +14,12 @@ pub const VOICE_PACKET_HEADER_SIZE: usize = 28;
 pub const AES_GCM_NONCE_SIZE: usize = 12;
 pub const AES_GCM_TAG_SIZE: usize = 16;
 
+// Keepalive probe: magic, sequence u32, sent_at_us u64, user_id u32 (big-endian).
+// The server echoes it back with the echo magic; everything else is opaque.
+pub const KEEPALIVE_MAGIC: u32 = 0x56504B41; // 'VPKA'
+pub const KEEPALIVE_ECHO_MAGIC: u32 = 0x56504B45; // 'VPKE'
+pub const KEEPALIVE_PACKET_SIZE: usize = 20;
+
 /// Voice packet header (network format)
 #[repr(C, packed)]
 #[derive(Debug, Clone, Copy)]
@@ -108,6 +114,7 @@ pub struct Session {
     pub roles: Vec<RoleId>,
     pub channels: Vec<ChannelId>,
     pub last_sequence: SequenceNumber,
+    pub resume_token: Option<String>,  // Single-use; rotated on every (re)connect
 }
 
 /// JWT Claims
@@ -158,6 +165,15 @@ pub enum ControlMessage {
         timestamp: i64,
     },
     RequestAllChannelRosters,
+    Resume {
+        session_token: String,
+        resume_token: Option<String>,
+        channels: Vec<ChannelId>,     // Channels the client believes it is in
+        roster_version: Option<u64>,  // Version of the client's cached rosters
+    },
+    VoiceFormat {
+        formats: Vec<String>,  // Voice header formats the client can use, preferred first
+    },
 
     // Admin/Management (Client to server)
     AssignRole {
@@ -193,6 +209,8 @@ pub enum ControlMessage {
         session_token: Option<String>,
         voice_key: Option<String>,
         message: Option<String>,
+        #[serde(default)]
+        resume_token: Option<String>,
     },
     RegisterResult {
         success: bool,
@@ -223,6 +241,27 @@ pub enum ControlMessage {
     },
     AllChannelRosters {
         channels: Vec<ChannelRosterInfo>,
+        #[serde(default)]
+        roster_version: u64,
+    },
+    Resumed {
+        user_id: UserId,
+        org_id: OrgId,
+        permissions: u32,
+        session_token: String,
+        resume_token: String,
+        channels: Vec<ChannelId>,
+        roster_version: u64,
+        rosters: Option<Vec<ChannelRosterInfo>>,  // None when the client's cache is current
+        key_exchange_required: bool,
+    },
+    ResumeFailed {
+        message: String,
+    },
+    VoiceAliases {
+        format: String,          // Header format the server will send this client
+        users: Vec<VoiceAlias>,
+        channels: Vec<VoiceAlias>,
     },
     Pong {
         timestamp: i64,
@@ -252,6 +291,13 @@ pub struct UserInfo {
     pub speaking: bool,
 }
 
+/// Short voice-plane alias for a user or channel ID (compact voice header)
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Serialize, Deserialize)]
+pub struct VoiceAlias {
+    pub id: u32,
+    pub alias: u16,
+}
+
 #[derive(Debug, Clone, Serialize, Deserialize)]
 pub struct ChannelRosterInfo {
     pub channel_id: ChannelId,